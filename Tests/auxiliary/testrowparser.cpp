@@ -0,0 +1,280 @@
+/*  KSRowParser Tests
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#include "testrowparser.h"
+
+#include <cmath>
+#include <cstring>
+
+#include <QDir>
+#include <QTemporaryFile>
+
+namespace {
+
+// Rows of the synthetic asteroid file used by the benchmarks
+const int benchmark_rows = 100000;
+
+enum { COL_NAME, COL_COUNT, COL_QUOTED, COL_EMPTY, COL_VALUE, COL_LAST, CSV_COLUMNS };
+
+const KSRowParser::Column csv_columns[CSV_COLUMNS] = {
+  { "name", 0 }, { "count", 0 }, { "quoted", 0 }, { "empty", 0 }, { "value", 0 }, { "last", 0 }
+};
+
+// Numeric columns of the asteroid file, as in AsteroidsComponent
+enum { COL_FULL_NAME, COL_EPOCH_MJD, COL_Q, COL_A, COL_E, COL_I, COL_W, COL_OM, COL_MA, COL_H, COL_NEO, ASTEROID_COLUMNS };
+
+const KSRowParser::Column asteroid_columns[ASTEROID_COLUMNS] = {
+  { "full name", 0 }, { "epoch_mjd", 0 }, { "q", 0 }, { "a", 0 }, { "e", 0 }, { "i", 0 }, { "w", 0 },
+  { "om", 0 }, { "ma", 0 }, { "H", 0 }, { "neo", 0 }
+};
+
+QList< QPair<QString, KSParser::DataTypes> > AsteroidSequence() {
+  QList< QPair<QString, KSParser::DataTypes> > sequence;
+  sequence.append(qMakePair(QString("full name"), KSParser::D_QSTRING));
+  sequence.append(qMakePair(QString("epoch_mjd"), KSParser::D_INT));
+  sequence.append(qMakePair(QString("q"), KSParser::D_DOUBLE));
+  sequence.append(qMakePair(QString("a"), KSParser::D_DOUBLE));
+  sequence.append(qMakePair(QString("e"), KSParser::D_DOUBLE));
+  sequence.append(qMakePair(QString("i"), KSParser::D_DOUBLE));
+  sequence.append(qMakePair(QString("w"), KSParser::D_DOUBLE));
+  sequence.append(qMakePair(QString("om"), KSParser::D_DOUBLE));
+  sequence.append(qMakePair(QString("ma"), KSParser::D_DOUBLE));
+  sequence.append(qMakePair(QString("H"), KSParser::D_DOUBLE));
+  sequence.append(qMakePair(QString("neo"), KSParser::D_QSTRING));
+  return sequence;
+}
+
+double Uniform(double low, double high) {
+  return low + (high - low) * qrand() / RAND_MAX;
+}
+
+}  // namespace
+
+TestRowParser::TestRowParser(): QObject() {
+}
+
+TestRowParser::~TestRowParser() {
+}
+
+QString TestRowParser::WriteFile(const QString &contents) {
+  QTemporaryFile temp_file;
+  temp_file.setAutoRemove(false);
+  if (!temp_file.open())
+    return QString();
+  temp_file.write(contents.toUtf8());
+  temp_file.close();
+  files_.append(temp_file.fileName());
+  return temp_file.fileName();
+}
+
+void TestRowParser::initTestCase() {
+  /*
+   * Asteroid-like file with the numbers written with 17 significant digits,
+   * like the orbital elements of asteroids.dat
+   */
+  qsrand(42);
+  QString contents("# full name,epoch_mjd,q,a,e,i,w,om,ma,H,neo\n");
+  for (int n = 1; n <= benchmark_rows; ++n) {
+    double e = Uniform(0.0, 0.4), a = Uniform(2.0, 3.5);
+    contents += QString("\"%1 Asteroid%1\",57800,%2,%3,%4,%5,%6,%7,%8,%9,%10\n")
+                .arg(n).arg(a * (1 - e), 0, 'g', 17).arg(a, 0, 'g', 17).arg(e, 0, 'g', 17)
+                .arg(Uniform(0, 30), 0, 'g', 17).arg(Uniform(0, 360), 0, 'g', 17)
+                .arg(Uniform(0, 360), 0, 'g', 17).arg(Uniform(0, 360), 0, 'g', 17)
+                .arg(Uniform(5, 20), 0, 'f', 1).arg(n % 10 ? "N" : "Y");
+  }
+  asteroid_file_name_ = WriteFile(contents);
+  QVERIFY(!asteroid_file_name_.isEmpty());
+}
+
+void TestRowParser::cleanupTestCase() {
+  foreach (const QString &file_name, files_)
+    QFile::remove(file_name);
+}
+
+void TestRowParser::CSVRows() {
+  /*
+   * Skipped: comments, empty lines, missing or extra fields, and fields
+   * with no matching quote.
+   */
+  QString file_name = WriteFile(
+      "\n"
+      "# comment,1,\"a\",,2.5,x\n"
+      "first,1,\"a, b\",,2.5,x\n"
+      "short,1,\"a\",,2.5\n"
+      "long,1,\"a\",,2.5,x,y\n"
+      "unmatched,1,\",,2.5,x\n"
+      "second,-2,\"isn't\"(, )\"pi\",,  -3.141 ,\"\"\r\n"
+      "third,3,,,1e-3,last");
+  KSRowParser parser(file_name, '#', csv_columns, CSV_COLUMNS, ',');
+  QVERIFY(parser.IsOpen());
+  QCOMPARE(parser.ColumnCount(), int(CSV_COLUMNS));
+
+  QVERIFY(parser.ReadNextRow());
+  QCOMPARE(parser[COL_NAME].toString(), QString("first"));
+  QCOMPARE(parser[COL_COUNT].toInt(), 1);
+  QCOMPARE(parser[COL_QUOTED].toString(), QString("a, b"));
+  QVERIFY(parser[COL_EMPTY].isEmpty());
+  QCOMPARE(parser[COL_VALUE].toDouble(), 2.5);
+  QVERIFY(parser[COL_LAST] == "x");
+
+  QVERIFY(parser.ReadNextRow());
+  QCOMPARE(parser[COL_NAME].toString(), QString("second"));
+  QCOMPARE(parser[COL_COUNT].toInt(), -2);
+  QCOMPARE(parser[COL_QUOTED].toString(), QString("isn't\"(, )\"pi"));
+  QCOMPARE(parser[COL_VALUE].toDouble(), -3.141);
+  QVERIFY(parser[COL_LAST].isEmpty());
+
+  QVERIFY(parser.ReadNextRow());
+  QCOMPARE(parser[COL_NAME].toString(), QString("third"));
+  QVERIFY(parser[COL_QUOTED].isEmpty());
+  QCOMPARE(parser[COL_VALUE].toDouble(), 1e-3);
+  QCOMPARE(parser[COL_LAST].toString(), QString("last"));
+
+  QVERIFY(!parser.ReadNextRow());
+  QVERIFY(!parser.ReadNextRow());
+}
+
+void TestRowParser::FixedWidthRows() {
+  enum { COL_FLAG, COL_ID, COL_MAG, COL_LONGNAME, FW_COLUMNS };
+  const KSRowParser::Column columns[FW_COLUMNS] = {
+    { "flag", 1 }, { "id", 4 }, { "mag", 6 }, { "longname", 0 }
+  };
+
+  QString file_name = WriteFile(
+      "#comment that is long enough\n"
+      "N 224  3.4 Andromeda Galaxy  \n"
+      "I  12\n"
+      " 1234      \n"
+      "M   1   8.4\n");
+  KSRowParser parser(file_name, '#', columns, FW_COLUMNS);
+
+  QVERIFY(parser.ReadNextRow());
+  QVERIFY(parser[COL_FLAG] == "N");
+  QCOMPARE(parser[COL_ID].toInt(), 224);
+  QCOMPARE(parser[COL_MAG].toFloat(), 3.4f);
+  QCOMPARE(parser[COL_LONGNAME].toString(), QString("Andromeda Galaxy"));
+
+  // "I  12" is too short
+  QVERIFY(parser.ReadNextRow());
+  QVERIFY(parser[COL_FLAG].isEmpty());
+  QCOMPARE(parser[COL_ID].toInt(), 1234);
+  QVERIFY(parser[COL_MAG].isEmpty());
+  QVERIFY(parser[COL_LONGNAME].isEmpty());
+
+  QVERIFY(parser.ReadNextRow());
+  QVERIFY(parser[COL_FLAG] == "M");
+  QCOMPARE(parser[COL_ID].toInt(), 1);
+  QCOMPARE(parser[COL_MAG].toDouble(), 8.4);
+  QVERIFY(parser[COL_LONGNAME].isEmpty());
+
+  QVERIFY(!parser.ReadNextRow());
+}
+
+void TestRowParser::Numbers() {
+  const char *invalid[] = { "", "  ", ".", "-", "1e", "1.2.3", "12a", "a12", "1 2" };
+  for (unsigned int n = 0; n < sizeof(invalid) / sizeof(invalid[0]); ++n) {
+    KSRowParser::Field field(invalid[n], invalid[n] + strlen(invalid[n]));
+    bool ok = true;
+    QCOMPARE(field.toDouble(&ok), 0.0);
+    QVERIFY(!ok);
+    ok = true;
+    QCOMPARE(field.toInt(&ok), 0);
+    QVERIFY(!ok);
+  }
+
+  bool ok = true;
+  KSRowParser::Field too_large("2147483648", "2147483648" + 10);
+  QCOMPARE(too_large.toInt(&ok), 0);
+  QVERIFY(!ok);
+
+  // Same values as QString::toDouble(), to the last unit of the mantissa
+  qsrand(7);
+  for (int n = 0; n < 100000; ++n) {
+    double value = pow(10.0, Uniform(-12.0, 12.0)) * (n % 2 ? -1.0 : 1.0);
+    QByteArray text = QByteArray::number(value, n % 3 ? 'g' : 'f', 1 + n % 17);
+    KSRowParser::Field field(text.constData(), text.constData() + text.size());
+
+    double expected = QString(text).toDouble();
+    double parsed = field.toDouble(&ok);
+    QVERIFY(ok);
+
+    qint64 a, b;
+    memcpy(&a, &expected, sizeof(a));
+    memcpy(&b, &parsed, sizeof(b));
+    if (qAbs(a - b) > 1)
+      QFAIL(qPrintable(QString("%1 read as %2").arg(QString(text)).arg(parsed, 0, 'g', 17)));
+  }
+}
+
+void TestRowParser::ReadMissingFile() {
+  KSRowParser parser(QDir::tempPath() + "/no_such_file_for_ksrowparser.csv", '#', csv_columns, CSV_COLUMNS, ',');
+  QVERIFY(!parser.IsOpen());
+  QVERIFY(!parser.ReadNextRow());
+}
+
+void TestRowParser::CompareWithKSParser() {
+  KSParser old_parser(asteroid_file_name_, '#', AsteroidSequence());
+  KSRowParser parser(asteroid_file_name_, '#', asteroid_columns, ASTEROID_COLUMNS, ',');
+
+  int rows = 0;
+  while (parser.ReadNextRow()) {
+    QVERIFY(old_parser.HasNextRow());
+    QHash<QString, QVariant> row_content = old_parser.ReadNextRow();
+
+    QCOMPARE(parser[COL_FULL_NAME].toString(), row_content["full name"].toString());
+    QCOMPARE(parser[COL_EPOCH_MJD].toInt(), row_content["epoch_mjd"].toInt());
+    QVERIFY(qFuzzyCompare(parser[COL_A].toDouble(), row_content["a"].toDouble()));
+    QVERIFY(qFuzzyCompare(parser[COL_E].toDouble(), row_content["e"].toDouble()));
+    QVERIFY(qFuzzyCompare(parser[COL_MA].toDouble(), row_content["ma"].toDouble()));
+    QCOMPARE(parser[COL_NEO] == "Y", row_content["neo"].toString() == "Y");
+    ++rows;
+  }
+  QCOMPARE(rows, benchmark_rows);
+}
+
+/*
+ * Parse throughput: read all the rows of the asteroid file and convert all
+ * the fields, as AsteroidsComponent does.
+ */
+
+void TestRowParser::BenchmarkKSParser() {
+  const QList< QPair<QString, KSParser::DataTypes> > sequence = AsteroidSequence();
+  double sum = 0;
+
+  QBENCHMARK {
+    KSParser parser(asteroid_file_name_, '#', sequence);
+    while (parser.HasNextRow()) {
+      QHash<QString, QVariant> row_content = parser.ReadNextRow();
+      QString name = row_content["full name"].toString().trimmed();
+      sum += row_content["epoch_mjd"].toInt() + row_content["q"].toDouble() + row_content["a"].toDouble()
+             + row_content["e"].toDouble() + row_content["i"].toDouble() + row_content["w"].toDouble()
+             + row_content["om"].toDouble() + row_content["ma"].toDouble() + row_content["H"].toDouble()
+             + (row_content["neo"].toString() == "Y") + name.size();
+    }
+  }
+  QVERIFY(sum > 0);
+}
+
+void TestRowParser::BenchmarkKSRowParser() {
+  double sum = 0;
+
+  QBENCHMARK {
+    KSRowParser parser(asteroid_file_name_, '#', asteroid_columns, ASTEROID_COLUMNS, ',');
+    while (parser.ReadNextRow()) {
+      QString name = parser[COL_FULL_NAME].trimmed().toString();
+      sum += parser[COL_EPOCH_MJD].toInt() + parser[COL_Q].toDouble() + parser[COL_A].toDouble()
+             + parser[COL_E].toDouble() + parser[COL_I].toDouble() + parser[COL_W].toDouble()
+             + parser[COL_OM].toDouble() + parser[COL_MA].toDouble() + parser[COL_H].toDouble()
+             + (parser[COL_NEO] == "Y") + name.size();
+    }
+  }
+  QVERIFY(sum > 0);
+}
+
+QTEST_GUILESS_MAIN(TestRowParser)
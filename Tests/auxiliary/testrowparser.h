@@ -0,0 +1,41 @@
+/*  KSRowParser Tests
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef TESTROWPARSER_H
+#define TESTROWPARSER_H
+
+#include <QtTest/QtTest>
+
+#include "ksparser.h"
+#include "ksrowparser.h"
+
+class TestRowParser: public QObject {
+  Q_OBJECT
+ public:
+  TestRowParser();
+  ~TestRowParser();
+ private slots:
+  void initTestCase();
+  void cleanupTestCase();
+  void CSVRows();
+  void FixedWidthRows();
+  void Numbers();
+  void ReadMissingFile();
+  void CompareWithKSParser();
+  void BenchmarkKSParser();
+  void BenchmarkKSRowParser();
+
+ private:
+  QString WriteFile(const QString &contents);
+
+  QStringList files_;
+  QString asteroid_file_name_;
+};
+
+#endif  // TESTROWPARSER_H
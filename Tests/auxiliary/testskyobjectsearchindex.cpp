@@ -0,0 +1,90 @@
+/*  Sky Object Search Index Tests
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+/* Project Includes */
+#include "testskyobjectsearchindex.h"
+#include "skyobjects/skyobject.h"
+
+namespace
+{
+
+/** @return satellites named after @p names, as SatellitesComponent loads them */
+QList<SkyObject *> loadSatellites( const QStringList &names )
+{
+    QList<SkyObject *> satellites;
+    foreach ( const QString &name, names )
+        satellites.append( new SkyObject( SkyObject::SATELLITE, dms( 0.0 ), dms( 0.0 ), 0.0, name ) );
+    return satellites;
+}
+
+/** @return the entries of the object lists for @p objects */
+QVector<SkyObjectSearchIndex::Entry> entries( const QList<SkyObject *> &objects )
+{
+    QVector<SkyObjectSearchIndex::Entry> list;
+    foreach ( SkyObject *o, objects )
+        list.append( qMakePair( o->name(), static_cast<const SkyObject *>( o ) ) );
+    return list;
+}
+
+const QStringList satelliteNames = QStringList() << "ISS (ZARYA)" << "HST" << "NOAA 19" << "NOAA 18" << "Iridium 33";
+
+}
+
+void TestSkyObjectSearchIndex::initTestCase() {
+    m_Objects = loadSatellites( satelliteNames );
+    m_Entries = entries( m_Objects );
+}
+
+void TestSkyObjectSearchIndex::cleanupTestCase() {
+    qDeleteAll( m_Objects );
+}
+
+void TestSkyObjectSearchIndex::testSearch() {
+    SkyObjectSearchIndex index( m_Entries );
+    QCOMPARE( index.count(), satelliteNames.size() );
+
+    // Sorted by name, ignoring case
+    QCOMPARE( index.entry( 0 ).first, QString( "HST" ) );
+    QCOMPARE( index.entry( 1 ).first, QString( "Iridium 33" ) );
+
+    QCOMPARE( index.search( QString() ).size(), satelliteNames.size() );
+    QCOMPARE( index.search( "noaa" ).size(), 2 );
+    QCOMPARE( index.search( "ar" ).size(), 1 );
+    QCOMPARE( index.firstPrefixMatch( "noaa" ), 3 );
+    QCOMPARE( index.firstPrefixMatch( "Zarya" ), -1 );
+
+    QVector<int> previous = index.search( "noaa" );
+    QVERIFY( SkyObjectSearchIndex::narrows( "NOAA 1", "noaa" ) );
+    QCOMPARE( index.search( "NOAA 1", &previous ), previous );
+
+    QVERIFY( index.containsName( "HST" ) );
+    QVERIFY( ! index.containsName( "hst" ) );
+}
+
+void TestSkyObjectSearchIndex::testReload() {
+    SkyObjectSearchIndex index( m_Entries );
+
+    // The satellites loaded again after a TLE update: the same names and count, other objects
+    QList<SkyObject *> reloaded = loadSatellites( satelliteNames );
+    QVector<SkyObjectSearchIndex::Entry> reloadedEntries = entries( reloaded );
+    QCOMPARE( reloadedEntries.size(), m_Entries.size() );
+
+    // The rebuilt index refers to the new objects only
+    SkyObjectSearchIndex rebuilt( reloadedEntries );
+    QCOMPARE( rebuilt.count(), index.count() );
+    foreach ( int row, rebuilt.search( QString() ) ) {
+        QCOMPARE( rebuilt.entry( row ).first, index.entry( row ).first );
+        QVERIFY( reloaded.contains( const_cast<SkyObject *>( rebuilt.entry( row ).second ) ) );
+        QVERIFY( ! m_Objects.contains( const_cast<SkyObject *>( rebuilt.entry( row ).second ) ) );
+    }
+
+    qDeleteAll( reloaded );
+}
+
+QTEST_GUILESS_MAIN(TestSkyObjectSearchIndex)
@@ -0,0 +1,45 @@
+/*  Sky Object Search Index Tests
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef TESTSKYOBJECTSEARCHINDEX_H
+#define TESTSKYOBJECTSEARCHINDEX_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+#include "skyobjectsearchindex.h"
+
+class SkyObject;
+
+/**
+ * @class TestSkyObjectSearchIndex
+ * @short Tests of the name index of the find dialog
+ */
+
+class TestSkyObjectSearchIndex : public QObject {
+
+    Q_OBJECT
+
+public:
+
+    TestSkyObjectSearchIndex() : QObject() {};
+    ~TestSkyObjectSearchIndex() {};
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void testSearch();
+    void testReload();
+
+private:
+    QList<SkyObject *> m_Objects;
+    QVector<SkyObjectSearchIndex::Entry> m_Entries;
+};
+
+#endif
@@ -0,0 +1,320 @@
+/*  Tiled Image Renderer Tests
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+/* Project Includes */
+#include "testtiledimagerenderer.h"
+
+/* Qt Includes */
+#include <QPainter>
+#include <QTemporaryDir>
+
+/* STL Includes */
+#include <cstring>
+
+namespace
+{
+
+const QSize skySize( 1000, 700 );
+const int starCount = 2000;
+
+/** @return a random coordinate below @p max, on a grid of 1/8 pixel so that moving it by whole pixels is exact */
+double coordinate( int max )
+{
+    return ( qrand() % ( 8 * max ) ) / 8.0;
+}
+
+/** Draw a star of @p radius at @p center */
+void drawStar( QPainter &p, const QPointF &center, double radius )
+{
+    p.setBrush( QColor::fromHsv( qrand() % 360, 60, 255 ) );
+    p.drawEllipse( center, radius, radius );
+}
+
+/** Draw labels across the boundaries of the tiles of the tests, as SkyLabeler places them */
+void drawLabels( QPainter &p, const QSize &size )
+{
+    QFont font = p.font();
+    font.setPointSize( 9 );
+    p.setFont( font );
+    p.setPen( QColor( 230, 230, 120 ) );
+    for ( int y = 40; y < size.height(); y += 64 )
+        for ( int x = 20; x < size.width(); x += 90 )
+            p.drawText( QPointF( x + 0.25, y + 0.125 ), QString( "Star %1-%2" ).arg( x ).arg( y ) );
+}
+
+/**
+ * Record in @p picture a sky map of @p size, as SkyQPainter draws it: antialiased lines, polygons, stars, images and
+ * labels.
+ */
+void recordSky( QPicture &picture, const QSize &size, int stars )
+{
+    picture.setBoundingRect( QRect( QPoint(), size ) );
+    QPainter p( &picture );
+    p.setRenderHint( QPainter::Antialiasing, true );
+    p.fillRect( QRect( QPoint(), size ), QColor( 0, 0, 40 ) );
+
+    // Milky Way
+    p.setPen( Qt::NoPen );
+    p.setBrush( QColor( 120, 120, 160, 60 ) );
+    QPolygonF milkyWay;
+    for ( int i = 0; i < 12; ++i )
+        milkyWay << QPointF( coordinate( size.width() ), coordinate( size.height() ) );
+    p.drawPolygon( milkyWay );
+
+    // Coordinate grid and constellation lines
+    p.setBrush( Qt::NoBrush );
+    QPen pen( QColor( 80, 80, 160 ), 3 );
+    pen.setCapStyle( Qt::RoundCap );
+    pen.setJoinStyle( Qt::RoundJoin );
+    p.setPen( pen );
+    for ( int k = 0; k < 20; ++k ) {
+        QPolygonF line;
+        for ( int i = 0; i < 8; ++i )
+            line << QPointF( coordinate( size.width() ), coordinate( size.height() ) );
+        p.drawPolyline( line );
+    }
+
+    // Stars, and more of them on the boundaries of the tiles of the tests
+    p.setPen( Qt::NoPen );
+    for ( int i = 0; i < stars; ++i )
+        drawStar( p, QPointF( coordinate( size.width() ), coordinate( size.height() ) ), 1.0 + ( qrand() % 48 ) / 8.0 );
+    for ( int x = 64; x < size.width(); x += 64 )
+        for ( int y = 50; y < size.height(); y += 100 )
+            drawStar( p, QPointF( x - 0.375, y + 0.625 ), 2.5 );
+    for ( int y = 64; y < size.height(); y += 64 )
+        for ( int x = 50; x < size.width(); x += 100 )
+            drawStar( p, QPointF( x + 0.125, y - 0.5 ), 2.5 );
+
+    // A deep-sky image across a corner of the tiles
+    QImage image( 40, 30, QImage::Format_ARGB32_Premultiplied );
+    for ( int y = 0; y < image.height(); ++y )
+        for ( int x = 0; x < image.width(); ++x )
+            image.setPixel( x, y, qRgb( 6 * x, 8 * y, 128 ) );
+    p.drawImage( QPoint( 240, 240 ), image );
+
+    drawLabels( p, size );
+
+    // A clip set by the picture itself
+    p.setClipRect( QRect( 100, 100, size.width() / 2, size.height() / 2 ) );
+    p.setPen( QPen( Qt::red, 5 ) );
+    p.drawEllipse( QPointF( size.width() / 3.0, size.height() / 3.0 ), size.width() / 3.0, size.height() / 3.0 );
+    p.end();
+}
+
+/** @return pixel @p x, @p y of @p image as it is stored */
+QRgb rawPixel( const QImage &image, int x, int y )
+{
+    return reinterpret_cast<const QRgb *>( image.constScanLine( y ) )[x];
+}
+
+/** Add to @p renderer the sky, centered in the image, and the legend over it, as ImageExporter does */
+void addLayers( TiledImageRenderer &renderer, const QPicture &sky, const QPicture &legend )
+{
+    const QSize size = renderer.size();
+    const QPoint offset( ( size.width() - skySize.width() ) / 2, ( size.height() - skySize.height() ) / 2 );
+    renderer.addLayer( sky, offset, QRect( offset, skySize ) );
+    renderer.addLayer( legend );
+}
+
+}
+
+void TestTiledImageRenderer::initTestCase() {
+    qDebug() << "Tiles render" << ( TiledImageRenderer::rendersConcurrently() ? "concurrently" : "one after the other" );
+
+    qsrand( 11 );
+    recordSky( m_Sky, skySize, starCount );
+
+    // A translucent legend in the top left corner
+    QPainter p( &m_Legend );
+    p.setPen( QPen( Qt::white, 1 ) );
+    p.setBrush( QColor( 0, 0, 0, 160 ) );
+    p.drawRect( 10, 10, 300, 120 );
+    p.drawText( QRect( 20, 20, 280, 100 ), Qt::AlignLeft | Qt::AlignTop, "Legend\nStar magnitudes" );
+    p.end();
+}
+
+void TestTiledImageRenderer::testTiles() {
+    TiledImageRenderer renderer( QSize( 1000, 700 ), 256 );
+    const QList<QRect> tiles = renderer.tiles();
+    QCOMPARE( tiles.size(), 4 * 3 );
+    QCOMPARE( tiles.first(), QRect( 0, 0, 256, 256 ) );
+    QCOMPARE( tiles[1], QRect( 256, 0, 256, 256 ) );
+    QCOMPARE( tiles.last(), QRect( 768, 512, 232, 188 ) );
+
+    // The tiles cover the image once
+    QRegion covered;
+    int area = 0;
+    foreach ( const QRect &tile, tiles ) {
+        QVERIFY( ! covered.intersects( tile ) );
+        covered += tile;
+        area += tile.width() * tile.height();
+    }
+    QCOMPARE( covered, QRegion( 0, 0, 1000, 700 ) );
+    QCOMPARE( area, 1000 * 700 );
+
+    QVERIFY( TiledImageRenderer( QSize(), 256 ).tiles().isEmpty() );
+}
+
+void TestTiledImageRenderer::testBoundaries_data() {
+    QTest::addColumn<QSize>( "size" );
+    QTest::addColumn<int>( "tileSize" );
+
+    QTest::newRow( "sky map, 64" ) << skySize << 64;
+    QTest::newRow( "sky map, 100" ) << skySize << 100;
+    QTest::newRow( "padded, 128" ) << QSize( 1300, 900 ) << 128;
+    QTest::newRow( "cropped, 256" ) << QSize( 700, 500 ) << 256;
+    QTest::newRow( "single tile" ) << skySize << 2048;
+}
+
+void TestTiledImageRenderer::testBoundaries() {
+    QFETCH( QSize, size );
+    QFETCH( int, tileSize );
+
+    TiledImageRenderer renderer( size, tileSize );
+    addLayers( renderer, m_Sky, m_Legend );
+
+    const QImage single = renderer.render();
+    QCOMPARE( single.size(), size );
+
+    QImage tiled( size, QImage::Format_ARGB32_Premultiplied );
+    tiled.fill( Qt::black );
+    int bands = 0;
+    QVERIFY( renderer.renderBands( [&tiled, &bands]( const QImage &band, int y ) -> bool {
+        QPainter p( &tiled );
+        p.setCompositionMode( QPainter::CompositionMode_Source );
+        p.drawImage( 0, y, band );
+        ++bands;
+        return true;
+    } ) );
+    QCOMPARE( bands, ( size.height() + tileSize - 1 ) / tileSize );
+
+    // The pixels on both sides of each boundary between the tiles
+    for ( int x = tileSize; x < size.width(); x += tileSize ) {
+        for ( int y = 0; y < size.height(); ++y ) {
+            for ( int c = x - 1; c <= x; ++c ) {
+                if ( rawPixel( tiled, c, y ) != rawPixel( single, c, y ) )
+                    QFAIL( qPrintable( QString( "Pixel %1, %2 differs at a vertical boundary" ).arg( c ).arg( y ) ) );
+            }
+        }
+    }
+    for ( int y = tileSize; y < size.height(); y += tileSize ) {
+        for ( int x = 0; x < size.width(); ++x ) {
+            for ( int r = y - 1; r <= y; ++r ) {
+                if ( rawPixel( tiled, x, r ) != rawPixel( single, x, r ) )
+                    QFAIL( qPrintable( QString( "Pixel %1, %2 differs at a horizontal boundary" ).arg( x ).arg( r ) ) );
+            }
+        }
+    }
+
+    // And everywhere else
+    QVERIFY( tiled == single );
+
+    // The sky is drawn only in its part of the image
+    if ( size.width() > skySize.width() ) {
+        QCOMPARE( single.pixel( size.width() - 1, size.height() - 1 ), qRgb( 255, 255, 255 ) );
+        QVERIFY( single.pixel( size.width() / 2, size.height() / 2 ) != qRgb( 255, 255, 255 ) );
+    }
+
+    // Stopping after the first band
+    bands = 0;
+    QVERIFY( ! renderer.renderBands( [&bands]( const QImage &, int ) -> bool { ++bands; return false; } ) );
+    QCOMPARE( bands, 1 );
+}
+
+void TestTiledImageRenderer::testLabels() {
+    // Only labels, so that a difference can only come from the text
+    QPicture labels;
+    labels.setBoundingRect( QRect( QPoint(), skySize ) );
+    QPainter p( &labels );
+    p.fillRect( QRect( QPoint(), skySize ), Qt::black );
+    drawLabels( p, skySize );
+    p.end();
+
+    TiledImageRenderer renderer( skySize, 64 );
+    renderer.addLayer( labels );
+    const QImage single = renderer.render();
+
+    // The labels are drawn
+    int textPixels = 0;
+    for ( int y = 0; y < skySize.height(); ++y )
+        for ( int x = 0; x < skySize.width(); ++x )
+            if ( rawPixel( single, x, y ) != qRgb( 0, 0, 0 ) )
+                ++textPixels;
+    QVERIFY( textPixels > 1000 );
+
+    // Pixel by pixel, with the tiles rendered as the exporter renders them
+    QImage tiled( skySize, QImage::Format_ARGB32_Premultiplied );
+    QVERIFY( renderer.renderBands( [&tiled]( const QImage &band, int y ) -> bool {
+        for ( int j = 0; j < band.height(); ++j )
+            memcpy( tiled.scanLine( y + j ), band.constScanLine( j ), band.bytesPerLine() );
+        return true;
+    } ) );
+    for ( int y = 0; y < skySize.height(); ++y ) {
+        for ( int x = 0; x < skySize.width(); ++x ) {
+            if ( rawPixel( tiled, x, y ) != rawPixel( single, x, y ) )
+                QFAIL( qPrintable( QString( "Pixel %1, %2 of a label differs" ).arg( x ).arg( y ) ) );
+        }
+    }
+}
+
+void TestTiledImageRenderer::testSavePnm() {
+    QTemporaryDir dir;
+    QVERIFY( dir.isValid() );
+
+    TiledImageRenderer renderer( QSize( 1100, 800 ), 128 );
+    addLayers( renderer, m_Sky, m_Legend );
+    const QImage single = renderer.render().convertToFormat( QImage::Format_RGB32 );
+
+    // Written row by row
+    const QString pnm = dir.path() + "/sky.pnm";
+    QVERIFY( renderer.save( pnm, "PNM" ) );
+    QImage loaded( pnm, "PPM" );
+    QVERIFY( ! loaded.isNull() );
+    QCOMPARE( loaded.convertToFormat( QImage::Format_RGB32 ), single );
+
+    // Encoded once complete
+    const QString png = dir.path() + "/sky.png";
+    QVERIFY( renderer.save( png, "PNG" ) );
+    loaded = QImage( png, "PNG" );
+    QVERIFY( ! loaded.isNull() );
+    QCOMPARE( loaded.convertToFormat( QImage::Format_RGB32 ), single );
+
+    QVERIFY( ! renderer.save( dir.path() + "/missing/sky.pnm", "PNM" ) );
+}
+
+void TestTiledImageRenderer::benchmarkRender_data() {
+    QTest::addColumn<bool>( "tiled" );
+
+    QTest::newRow( "single pass" ) << false;
+    QTest::newRow( "tiled" ) << true;
+}
+
+void TestTiledImageRenderer::benchmarkRender() {
+    QFETCH( bool, tiled );
+
+    // A poster-sized sky
+    const QSize size( 4000, 3000 );
+    QPicture sky;
+    qsrand( 13 );
+    recordSky( sky, size, 50000 );
+    TiledImageRenderer renderer( size );
+    renderer.addLayer( sky );
+
+    int rows = 0;
+    QBENCHMARK {
+        if ( tiled )
+            renderer.renderBands( [&rows]( const QImage &band, int ) -> bool { rows += band.height(); return true; } );
+        else
+            rows += renderer.render().height();
+    }
+    QVERIFY( rows > 0 );
+}
+
+// Labels need a QGuiApplication
+QTEST_MAIN(TestTiledImageRenderer)
@@ -0,0 +1,47 @@
+/*  Tiled Image Renderer Tests
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef TESTTILEDIMAGERENDERER_H
+#define TESTTILEDIMAGERENDERER_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+#include "tiledimagerenderer.h"
+
+/**
+ * @class TestTiledImageRenderer
+ * @short Tests of the tiled rendering against the single pass, and benchmarks of large images
+ */
+
+class TestTiledImageRenderer : public QObject {
+
+    Q_OBJECT
+
+public:
+
+    TestTiledImageRenderer() : QObject() {};
+    ~TestTiledImageRenderer() {};
+
+private slots:
+    void initTestCase();
+    void testTiles();
+    void testBoundaries_data();
+    void testBoundaries();
+    void testLabels();
+    void testSavePnm();
+    void benchmarkRender_data();
+    void benchmarkRender();
+
+private:
+    QPicture m_Sky;
+    QPicture m_Legend;
+};
+
+#endif
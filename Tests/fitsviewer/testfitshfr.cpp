@@ -0,0 +1,66 @@
+/*  FITS HFR Statistics Tests
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+/* Project Includes */
+#include "testfitshfr.h"
+
+namespace
+{
+
+/** @return a detected star at @p x, @p y */
+Edge star( float x, float y, float HFR )
+{
+    Edge center;
+    center.x = x;
+    center.y = y;
+    center.val = 100;
+    center.scanned = 1;
+    center.width = 5;
+    center.HFR = HFR;
+    center.sum = 1000;
+    return center;
+}
+
+}
+
+void TestFITSHFR::testSigmaClippedMedian() {
+    QCOMPARE( FITSData::sigmaClippedMedian( QVector<double>() ), -1.0 );
+    QCOMPARE( FITSData::sigmaClippedMedian( QVector<double>() << 2.0 ), 2.0 );
+    QCOMPARE( FITSData::sigmaClippedMedian( QVector<double>() << 4.0 << 1.0 << 3.0 << 2.0 ), 2.5 );
+
+    // A hot pixel detected as a star is rejected, and does not move the median
+    QVector<double> HFRs;
+    HFRs << 2.0 << 2.1 << 1.9 << 2.0 << 2.2 << 1.8 << 2.0 << 2.1 << 1.9 << 2.0 << 15.0;
+    QCOMPARE( FITSData::sigmaClippedMedian( HFRs ), 2.0 );
+}
+
+void TestFITSHFR::testHFRMap() {
+    // Three stars top left, one top right, none bottom left, two bottom right including one on the border of the image
+    Edge stars[] = { star( 10, 10, 2 ), star( 20, 20, 3 ), star( 30, 30, 4 ), star( 80, 10, 5 ),
+                     star( 90, 90, 6 ), star( 100, 100, 7 ) };
+    QList<Edge *> centers;
+    for ( unsigned int i = 0; i < sizeof( stars ) / sizeof( stars[0] ); ++i )
+        centers.append( &stars[i] );
+
+    QVector<double> HFRMap = FITSData::getHFRMap( centers, 100, 100, 2, 2 );
+    QCOMPARE( HFRMap.size(), 4 );
+    QCOMPARE( HFRMap[0], 3.0 );
+    QCOMPARE( HFRMap[1], 5.0 );
+    QCOMPARE( HFRMap[2], -1.0 );
+    QCOMPARE( HFRMap[3], 6.5 );
+
+    // A single region holds all the stars
+    QCOMPARE( FITSData::getHFRMap( centers, 100, 100, 1, 1 ), QVector<double>() << 4.5 );
+
+    // No image, or no regions
+    QCOMPARE( FITSData::getHFRMap( centers, 0, 0, 2, 2 ), QVector<double>( 4, -1 ) );
+    QVERIFY( FITSData::getHFRMap( centers, 100, 100, 0, 2 ).isEmpty() );
+}
+
+QTEST_GUILESS_MAIN(TestFITSHFR)
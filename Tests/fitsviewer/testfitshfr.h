@@ -0,0 +1,37 @@
+/*  FITS HFR Statistics Tests
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef TESTFITSHFR_H
+#define TESTFITSHFR_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+#include "fitsdata.h"
+
+/**
+ * @class TestFITSHFR
+ * @short Tests of the robust HFR statistics of FITSData
+ */
+
+class TestFITSHFR : public QObject {
+
+    Q_OBJECT
+
+public:
+
+    TestFITSHFR() : QObject() {};
+    ~TestFITSHFR() {};
+
+private slots:
+    void testSigmaClippedMedian();
+    void testHFRMap();
+};
+
+#endif
@@ -0,0 +1,258 @@
+/*  INDI Listener Tests
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+/* Project Includes */
+#include "test_indilistener.h"
+
+#include <cstring>
+
+#include <basedevice.h>
+#include <indiproperty.h>
+
+/**
+ * A device counting the updates it receives.
+ */
+class FakeDevice : public ISD::GDInterface
+{
+public:
+    FakeDevice( const QByteArray &name, DeviceFamily type ) : name( name ), type( type ), updates( 0 ), misrouted( 0 ) {}
+
+    void registerProperty( INDI::Property * ) {}
+    void removeProperty( INDI::Property * ) {}
+    void processSwitch( ISwitchVectorProperty * ) {}
+    void processText( ITextVectorProperty * ) {}
+    void processNumber( INumberVectorProperty *nvp )
+    {
+        ++updates;
+        if ( strcmp( nvp->device, name.constData() ) )
+            ++misrouted;
+    }
+    void processLight( ILightVectorProperty * ) {}
+    void processBLOB( IBLOB * ) {}
+    void processMessage( int ) {}
+
+    QList<INDI::Property *> getProperties() { return QList<INDI::Property *>(); }
+    DeviceFamily getType() { return type; }
+    DriverInfo * getDriverInfo() { return NULL; }
+    DeviceInfo * getDeviceInfo() { return NULL; }
+    INDI::BaseDevice * getBaseDevice() { return NULL; }
+
+    bool setConfig( INDIConfig ) { return false; }
+    const char * getDeviceName() { return name.constData(); }
+    bool isConnected() { return true; }
+    bool getMinMaxStep( const QString &, const QString &, double *, double *, double * ) { return false; }
+    IPState getState( const QString & ) { return IPS_IDLE; }
+    IPerm getPermission( const QString & ) { return IP_RO; }
+
+    bool Connect() { return true; }
+    bool Disconnect() { return true; }
+    bool runCommand( int, void * ) { return false; }
+    bool setProperty( QObject * ) { return false; }
+
+    QByteArray name;
+    DeviceFamily type;
+    int updates;
+    int misrouted;
+};
+
+void TestINDIListener::cleanup()
+{
+    qDeleteAll( m_Properties );
+    m_Properties.clear();
+    qDeleteAll( m_Vectors );
+    m_Vectors.clear();
+}
+
+INDIListener * TestINDIListener::createListener( int idleDevices )
+{
+    INDIListener *listener = new INDIListener( NULL );
+
+    // An observatory with many devices, connected before the ones streaming updates
+    for ( int k = 0; k < idleDevices; ++k ) {
+        FakeDevice *device = new FakeDevice( QString( "Auxiliary %1" ).arg( k ).toLatin1(), KSTARS_AUXILIARY );
+        listener->devices.append( device );
+        addProperty( listener, device, "DEVICE_STATUS" );
+    }
+
+    m_Mount = new FakeDevice( "Telescope Simulator", KSTARS_TELESCOPE );
+    m_CCD = new FakeDevice( "CCD Simulator", KSTARS_CCD );
+    m_Guider = new FakeDevice( "Guide Simulator", KSTARS_CCD );
+    m_Focuser = new FakeDevice( "Focuser Simulator", KSTARS_FOCUSER );
+    listener->devices << m_Mount << m_CCD << m_Guider << m_Focuser;
+
+    m_Coordinates = addProperty( listener, m_Mount, "EQUATORIAL_EOD_COORD" );
+    m_Temperature = addProperty( listener, m_CCD, "CCD_TEMPERATURE" );
+    m_Exposure = addProperty( listener, m_CCD, "CCD_EXPOSURE" );
+    m_GuideExposure = addProperty( listener, m_Guider, "CCD_EXPOSURE" );
+    m_FocusPosition = addProperty( listener, m_Focuser, "ABS_FOCUS_POSITION" );
+
+    return listener;
+}
+
+INumberVectorProperty * TestINDIListener::addProperty( INDIListener *listener, FakeDevice *device, const char *name )
+{
+    INumberVectorProperty *nvp = new INumberVectorProperty;
+    memset( nvp, 0, sizeof( INumberVectorProperty ) );
+    strncpy( nvp->device, device->getDeviceName(), MAXINDIDEVICE - 1 );
+    strncpy( nvp->name, name, MAXINDINAME - 1 );
+    m_Vectors.append( nvp );
+
+    INDI::Property *prop = new INDI::Property();
+    prop->setProperty( nvp );
+    prop->setType( INDI_NUMBER );
+    prop->setRegistered( true );
+    prop->setDynamic( false );
+    m_Properties.append( prop );
+
+    listener->registerProperty( prop );
+    return nvp;
+}
+
+QVector<INumberVectorProperty *> TestINDIListener::recordedStream() const
+{
+    QVector<INumberVectorProperty *> stream;
+    for ( int tenths = 0; tenths < 600; ++tenths ) {
+        stream.append( m_Coordinates );
+        if ( tenths % 10 == 0 )
+            stream << m_Temperature << m_Exposure;
+        if ( tenths % 10 == 5 )
+            stream << m_GuideExposure << m_FocusPosition;
+    }
+    return stream;
+}
+
+void TestINDIListener::linearProcessNumber( INDIListener *listener, INumberVectorProperty *nvp )
+{
+    foreach ( ISD::GDInterface *gd, listener->devices ) {
+        if ( !strcmp( gd->getDeviceName(), nvp->device ) ) {
+            gd->processNumber( nvp );
+            break;
+        }
+    }
+}
+
+void TestINDIListener::testDispatch()
+{
+    INDIListener *listener = createListener( 8 );
+    QCOMPARE( listener->propertyIndex.size(), 8 + 5 );
+
+    QVector<INumberVectorProperty *> stream = recordedStream();
+    QCOMPARE( stream.size(), 840 );
+
+    foreach ( INumberVectorProperty *nvp, stream )
+        listener->processNumber( nvp );
+
+    QCOMPARE( m_Mount->updates, 600 );
+    QCOMPARE( m_CCD->updates, 120 );
+    QCOMPARE( m_Guider->updates, 60 );
+    QCOMPARE( m_Focuser->updates, 60 );
+    foreach ( ISD::GDInterface *gd, listener->devices )
+        QCOMPARE( static_cast<FakeDevice *>( gd )->misrouted, 0 );
+
+    delete listener;
+}
+
+void TestINDIListener::testUnregisteredProperty()
+{
+    INDIListener *listener = createListener( 0 );
+
+    // A property updated before it was registered is still found by device name
+    INumberVectorProperty nvp;
+    memset( &nvp, 0, sizeof( INumberVectorProperty ) );
+    strcpy( nvp.device, "Focuser Simulator" );
+    strcpy( nvp.name, "FOCUS_TEMPERATURE" );
+    listener->processNumber( &nvp );
+    QCOMPARE( m_Focuser->updates, 1 );
+    QCOMPARE( m_Focuser->misrouted, 0 );
+
+    // Updates of unknown devices are dropped
+    strcpy( nvp.device, "Unknown Device" );
+    listener->processNumber( &nvp );
+    QCOMPARE( m_Mount->updates + m_CCD->updates + m_Guider->updates + m_Focuser->updates, 1 );
+
+    delete listener;
+}
+
+void TestINDIListener::testRemoveProperty()
+{
+    INDIListener *listener = createListener( 0 );
+    QCOMPARE( listener->propertyIndex.size(), 5 );
+
+    listener->removeProperty( m_Properties.at( 1 ) );
+    QCOMPARE( listener->propertyIndex.size(), 4 );
+    QVERIFY( listener->propertyIndex.device( m_Temperature ) == NULL );
+    QVERIFY( listener->propertyIndex.device( m_Exposure ) == m_CCD );
+
+    listener->propertyIndex.removeDevice( m_CCD );
+    QCOMPARE( listener->propertyIndex.size(), 3 );
+    QVERIFY( listener->propertyIndex.device( m_Exposure ) == NULL );
+    QVERIFY( listener->propertyIndex.device( m_GuideExposure ) == m_Guider );
+
+    delete listener;
+}
+
+void TestINDIListener::testReplaceDevice()
+{
+    INDIPropertyIndex index;
+    FakeDevice generic( "Telescope Simulator", KSTARS_UNKNOWN ), telescope( "Telescope Simulator", KSTARS_TELESCOPE );
+    FakeDevice focuser( "Focuser Simulator", KSTARS_FOCUSER );
+    int connection, coordinates, position;
+
+    index.insert( &connection, &generic );
+    index.insert( &position, &focuser );
+    index.insert( NULL, &generic );
+    QCOMPARE( index.size(), 2 );
+
+    // The properties of a device decorated as a telescope follow the decorator
+    index.replaceDevice( &generic, &telescope );
+    index.insert( &coordinates, &telescope );
+    QVERIFY( index.device( &connection ) == &telescope );
+    QVERIFY( index.device( &coordinates ) == &telescope );
+    QVERIFY( index.device( &position ) == &focuser );
+    QCOMPARE( index.size(), 3 );
+}
+
+void TestINDIListener::benchmarkReplay_data()
+{
+    QTest::addColumn<int>( "idleDevices" );
+    QTest::addColumn<bool>( "indexed" );
+
+    QTest::newRow( "4 devices, names" ) << 0 << false;
+    QTest::newRow( "4 devices, index" ) << 0 << true;
+    QTest::newRow( "32 devices, names" ) << 28 << false;
+    QTest::newRow( "32 devices, index" ) << 28 << true;
+}
+
+void TestINDIListener::benchmarkReplay()
+{
+    QFETCH( int, idleDevices );
+    QFETCH( bool, indexed );
+
+    INDIListener *listener = createListener( idleDevices );
+    QVector<INumberVectorProperty *> stream = recordedStream();
+
+    // One iteration replays 840 updates
+    if ( indexed ) {
+        QBENCHMARK {
+            foreach ( INumberVectorProperty *nvp, stream )
+                listener->processNumber( nvp );
+        }
+    } else {
+        QBENCHMARK {
+            foreach ( INumberVectorProperty *nvp, stream )
+                linearProcessNumber( listener, nvp );
+        }
+    }
+
+    QCOMPARE( m_Mount->misrouted + m_CCD->misrouted + m_Guider->misrouted + m_Focuser->misrouted, 0 );
+
+    delete listener;
+}
+
+QTEST_GUILESS_MAIN(TestINDIListener)
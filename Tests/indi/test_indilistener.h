@@ -0,0 +1,67 @@
+/*  INDI Listener Tests
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef TEST_INDILISTENER_H
+#define TEST_INDILISTENER_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+#define UNIT_TEST
+
+#include "indi/indilistener.h"
+
+class FakeDevice;
+
+/**
+ * @class TestINDIListener
+ * @short Tests for the dispatch of INDI property updates to the devices
+ *
+ * A recorded session of a mount, a main camera, a guide camera and a focuser is replayed through the listener.
+ */
+
+class TestINDIListener : public QObject {
+
+    Q_OBJECT
+
+public:
+
+    TestINDIListener() : QObject() {};
+    ~TestINDIListener() {};
+
+private slots:
+    void cleanup();
+    void testDispatch();
+    void testUnregisteredProperty();
+    void testRemoveProperty();
+    void testReplaceDevice();
+    void benchmarkReplay_data();
+    void benchmarkReplay();
+
+private:
+    /** Create a listener with the four devices of the session, after @p idleDevices devices without updates */
+    INDIListener * createListener( int idleDevices );
+
+    /** Add a number property of @p device and register it with the listener */
+    INumberVectorProperty * addProperty( INDIListener *listener, FakeDevice *device, const char *name );
+
+    /** @return one minute of updates: coordinates at 10 Hz, temperature, exposures and focus at 1 Hz */
+    QVector<INumberVectorProperty *> recordedStream() const;
+
+    /** Dispatch @p nvp like INDIListener::processNumber() did before the property index */
+    static void linearProcessNumber( INDIListener *listener, INumberVectorProperty *nvp );
+
+    FakeDevice *m_Mount, *m_CCD, *m_Guider, *m_Focuser;
+    INumberVectorProperty *m_Coordinates, *m_Temperature, *m_Exposure, *m_GuideExposure, *m_FocusPosition;
+
+    QList<INDI::Property *> m_Properties;
+    QList<INumberVectorProperty *> m_Vectors;
+};
+
+#endif
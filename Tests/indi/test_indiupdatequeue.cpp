@@ -0,0 +1,190 @@
+/*  INDI Update Queue Tests
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+/* Project Includes */
+#include "test_indiupdatequeue.h"
+
+#include <cstring>
+
+namespace
+{
+
+const int interval = 50;
+const int burstSize = 10000;
+const int batchSize = 100;
+
+/** A number vector of @p count elements, like INDI::BaseDevice creates when the property is defined */
+struct NumberVector
+{
+    NumberVector( const char *device, const char *name, int count = 1 ) : numbers( count )
+    {
+        memset( &vector, 0, sizeof( INumberVectorProperty ) );
+        memset( numbers.data(), 0, count * sizeof( INumber ) );
+        strncpy( vector.device, device, MAXINDIDEVICE - 1 );
+        strncpy( vector.name, name, MAXINDINAME - 1 );
+        vector.np = numbers.data();
+        vector.nnp = count;
+        vector.s = IPS_IDLE;
+    }
+
+    INumberVectorProperty vector;
+    QVector<INumber> numbers;
+};
+
+/** What the INDI Control Panel would show */
+struct Panel
+{
+    Panel() : dispatches( 0 ), lastValue( -1 ), lastState( IPS_IDLE ) {}
+
+    void update( INumberVectorProperty *nvp )
+    {
+        ++dispatches;
+        lastValue = nvp->np[0].value;
+        if ( nvp->s != lastState )
+            transitions.append( qMakePair( nvp->s, lastValue ) );
+        lastState = nvp->s;
+    }
+
+    int dispatches;
+    double lastValue;
+    IPState lastState;
+    QList<QPair<IPState, double> > transitions;
+};
+
+}
+
+void TestINDIUpdateQueue::testBurst()
+{
+    INDIUpdateQueue queue;
+    queue.setDefaultInterval( interval );
+
+    NumberVector coordinates( "Telescope Simulator", "EQUATORIAL_EOD_COORD", 2 );
+    Panel panel;
+    connect( &queue, &INDIUpdateQueue::newNumber, [&]( INumberVectorProperty *nvp ) { panel.update( nvp ); } );
+
+    // A mount slewing four times, each slew ending with an Ok update
+    QElapsedTimer elapsed;
+    elapsed.start();
+    for ( int k = 0; k < burstSize; ++k ) {
+        coordinates.numbers[0].value = k;
+        coordinates.numbers[1].value = -k;
+        coordinates.vector.s = ( k % 2500 == 2499 ) ? IPS_OK : IPS_BUSY;
+        queue.queueNumber( &coordinates.vector );
+
+        if ( k % batchSize == batchSize - 1 )
+            QTest::qWait( 5 );
+    }
+    QTRY_COMPARE( queue.pendingCount(), 0 );
+    qint64 msecs = elapsed.elapsed();
+
+    // The final state was shown
+    QCOMPARE( panel.lastValue, double( burstSize - 1 ) );
+    QCOMPARE( panel.lastState, IPS_OK );
+
+    // No state transition was lost, each shown with the update making it
+    QCOMPARE( panel.transitions.size(), 8 );
+    for ( int slew = 0; slew < 4; ++slew ) {
+        QCOMPARE( panel.transitions[2 * slew].first, IPS_BUSY );
+        QCOMPARE( panel.transitions[2 * slew + 1].first, IPS_OK );
+        QCOMPARE( panel.transitions[2 * slew + 1].second, 2500.0 * slew + 2499.0 );
+    }
+
+    // At most one dispatch per interval, besides the transitions
+    int bound = int( msecs / interval ) + 1 + panel.transitions.size();
+    qDebug() << burstSize << "updates in" << msecs << "ms," << panel.dispatches << "dispatches, bound" << bound;
+    QVERIFY( panel.dispatches <= bound );
+    QVERIFY( panel.dispatches < burstSize / 10 );
+}
+
+void TestINDIUpdateQueue::testBLOB()
+{
+    INDIUpdateQueue queue;
+    queue.setDefaultInterval( interval );
+
+    int dispatches = 0;
+    IBLOB *lastBLOB = NULL;
+    connect( &queue, &INDIUpdateQueue::newBLOB, [&]( IBLOB *bp ) { ++dispatches; lastBLOB = bp; } );
+
+    QVector<IBLOB> frames( burstSize );
+    for ( int k = 0; k < burstSize; ++k ) {
+        queue.queueBLOB( &frames[k] );
+        QCOMPARE( lastBLOB, &frames[k] );
+    }
+
+    QCOMPARE( dispatches, burstSize );
+    QCOMPARE( queue.pendingCount(), 0 );
+}
+
+void TestINDIUpdateQueue::testIntervals()
+{
+    INDIUpdateQueue queue;
+    queue.setDefaultInterval( 60000 );
+    queue.setInterval( "CCD_EXPOSURE", 0 );
+
+    NumberVector exposure( "CCD Simulator", "CCD_EXPOSURE" );
+    NumberVector temperature( "CCD Simulator", "CCD_TEMPERATURE" );
+    Panel exposurePanel, temperaturePanel;
+    connect( &queue, &INDIUpdateQueue::newNumber, [&]( INumberVectorProperty *nvp ) {
+        ( nvp == &exposure.vector ? exposurePanel : temperaturePanel ).update( nvp );
+    } );
+
+    for ( int k = 0; k < 1000; ++k ) {
+        exposure.numbers[0].value = 1000 - k;
+        temperature.numbers[0].value = k;
+        queue.queueNumber( &exposure.vector );
+        queue.queueNumber( &temperature.vector );
+    }
+
+    // Without an interval every update is dispatched
+    QCOMPARE( exposurePanel.dispatches, 1000 );
+    QCOMPARE( exposurePanel.lastValue, 1.0 );
+
+    // Only the first temperature, the latest one is held back until the interval is over
+    QCOMPARE( temperaturePanel.dispatches, 1 );
+    QCOMPARE( queue.pendingCount(), 1 );
+
+    queue.flush();
+    QCOMPARE( temperaturePanel.dispatches, 2 );
+    QCOMPARE( temperaturePanel.lastValue, 999.0 );
+    QCOMPARE( queue.pendingCount(), 0 );
+
+    // Changing the interval applies to the properties already seen
+    queue.setInterval( "CCD_TEMPERATURE", 0 );
+    queue.queueNumber( &temperature.vector );
+    QCOMPARE( temperaturePanel.dispatches, 3 );
+}
+
+void TestINDIUpdateQueue::testRemoveDevice()
+{
+    INDIUpdateQueue queue;
+    queue.setDefaultInterval( interval );
+
+    NumberVector coordinates( "Telescope Simulator", "EQUATORIAL_EOD_COORD" );
+    NumberVector focus( "Focuser Simulator", "ABS_FOCUS_POSITION" );
+    Panel panel;
+    connect( &queue, &INDIUpdateQueue::newNumber, [&]( INumberVectorProperty *nvp ) { panel.update( nvp ); } );
+
+    for ( int k = 0; k < 10; ++k ) {
+        queue.queueNumber( &coordinates.vector );
+        queue.queueNumber( &focus.vector );
+    }
+    QCOMPARE( panel.dispatches, 2 );
+    QCOMPARE( queue.pendingCount(), 2 );
+
+    // The vectors of a removed device are deleted, their updates must not be dispatched
+    queue.removeDevice( "Telescope Simulator" );
+    QCOMPARE( queue.pendingCount(), 1 );
+    queue.removeProperty( &focus.vector );
+    QCOMPARE( queue.pendingCount(), 0 );
+
+    QTest::qWait( 2 * interval );
+    QCOMPARE( panel.dispatches, 2 );
+}
+
+QTEST_GUILESS_MAIN(TestINDIUpdateQueue)
@@ -0,0 +1,39 @@
+/*  INDI Update Queue Tests
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef TEST_INDIUPDATEQUEUE_H
+#define TEST_INDIUPDATEQUEUE_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+#include "indi/indiupdatequeue.h"
+
+/**
+ * @class TestINDIUpdateQueue
+ * @short Tests for the coalescing of the property updates shown in the INDI Control Panel
+ */
+
+class TestINDIUpdateQueue : public QObject {
+
+    Q_OBJECT
+
+public:
+
+    TestINDIUpdateQueue() : QObject() {};
+    ~TestINDIUpdateQueue() {};
+
+private slots:
+    void testBurst();
+    void testBLOB();
+    void testIntervals();
+    void testRemoveDevice();
+};
+
+#endif
@@ -0,0 +1,175 @@
+/*  Moving Object Index Tests
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+/* Project Includes */
+#include "test_movingobjectindex.h"
+#include "ksnumbers.h"
+#include "skyobjects/skyobject.h"
+#include "auxiliary/dms.h"
+
+namespace
+{
+
+const double jd = 2457800.5; // 2017-02-10 0h UT
+const double magLimit = 14.0;
+const int hoverCount = 100;
+
+double uniform( double low, double high )
+{
+    return low + ( high - low ) * qrand() / RAND_MAX;
+}
+
+/** Point uniformly distributed on the sky */
+SkyPoint randomPoint()
+{
+    double ra = uniform( 0.0, 24.0 );
+    double dec = asin( uniform( -1.0, 1.0 ) ) / dms::DegToRad;
+    return SkyPoint( ra, dec );
+}
+
+QList<SkyObject *> randomObjects( int count )
+{
+    QList<SkyObject *> objects;
+    objects.reserve( count );
+    for ( int k = 0; k < count; ++k ) {
+        SkyPoint p = randomPoint();
+        objects.append( new SkyObject( SkyObject::ASTEROID, p.ra(), p.dec(), uniform( 5.0, 20.0 ) ) );
+    }
+    return objects;
+}
+
+/** The search done by AsteroidsComponent::objectNearest() before the index */
+SkyObject * linearNearest( const QList<SkyObject *> &objects, SkyPoint *p, double &maxrad )
+{
+    SkyObject *oBest = 0;
+    foreach ( SkyObject *o, objects ) {
+        if ( o->mag() > magLimit ) continue;
+
+        double r = o->angularDistanceTo( p ).Degrees();
+        if ( r < maxrad ) {
+            oBest = o;
+            maxrad = r;
+        }
+    }
+    return oBest;
+}
+
+}
+
+void TestMovingObjectIndex::initTestCase() {
+    m_Mesh = SkyMesh::Create( 3 );
+}
+
+void TestMovingObjectIndex::cleanupTestCase() {
+}
+
+SkyObject * TestMovingObjectIndex::indexedNearest( const MovingObjectIndex &index, SkyPoint *p, double &maxrad ) {
+    // SkyMesh::aperture() without KStarsData: the objects are indexed by their J2000.0 positions
+    SkyPoint center( p->ra(), p->dec() );
+    center.precessFromAnyEpoch( jd, J2000 );
+    m_Mesh->index( &center, maxrad + 1.0, OBJ_NEAREST_BUF );
+    return index.objectNearest( p, maxrad, magLimit );
+}
+
+void TestMovingObjectIndex::testUpdate() {
+    qsrand( 42 );
+    QList<SkyObject *> objects = randomObjects( 5000 );
+    KSNumbers num( jd );
+
+    MovingObjectIndex index( m_Mesh );
+    QCOMPARE( index.count(), 0 );
+
+    // Every object is in exactly one trixel, and updating again replaces the content
+    for ( int pass = 0; pass < 2; ++pass ) {
+        index.update( objects, &num );
+        QCOMPARE( index.count(), objects.size() );
+
+        int total = 0;
+        for ( int t = 0; t < m_Mesh->size(); ++t )
+            total += index.objects( t ).size();
+        QCOMPARE( total, objects.size() );
+    }
+
+    index.clear();
+    QCOMPARE( index.count(), 0 );
+    for ( int t = 0; t < m_Mesh->size(); ++t )
+        QVERIFY( index.objects( t ).isEmpty() );
+
+    qDeleteAll( objects );
+}
+
+void TestMovingObjectIndex::testObjectNearest() {
+    qsrand( 7 );
+    QList<SkyObject *> objects = randomObjects( 20000 );
+    KSNumbers num( jd );
+
+    MovingObjectIndex index( m_Mesh );
+    index.update( objects, &num );
+
+    // Hover radii from the closest to the widest zoom levels
+    const double radii[] = { 0.05, 0.5, 4.0, 20.0 };
+    for ( int k = 0; k < 1000; ++k ) {
+        SkyPoint p = randomPoint();
+        double maxrad = radii[ k % 4 ];
+        double linearRad = maxrad;
+
+        SkyObject *indexed = indexedNearest( index, &p, maxrad );
+        SkyObject *linear = linearNearest( objects, &p, linearRad );
+
+        QCOMPARE( indexed, linear );
+        QCOMPARE( maxrad, linearRad );
+    }
+
+    qDeleteAll( objects );
+}
+
+void TestMovingObjectIndex::benchmarkHover_data() {
+    QTest::addColumn<int>( "count" );
+    QTest::addColumn<bool>( "indexed" );
+
+    const int counts[] = { 1000, 10000, 100000, 600000 };
+    for ( int k = 0; k < 4; ++k ) {
+        QTest::newRow( QString( "%1 linear" ).arg( counts[k] ).toLatin1() ) << counts[k] << false;
+        QTest::newRow( QString( "%1 indexed" ).arg( counts[k] ).toLatin1() ) << counts[k] << true;
+    }
+}
+
+void TestMovingObjectIndex::benchmarkHover() {
+    QFETCH( int, count );
+    QFETCH( bool, indexed );
+
+    qsrand( 42 );
+    QList<SkyObject *> objects = randomObjects( count );
+    KSNumbers num( jd );
+
+    MovingObjectIndex index( m_Mesh );
+    index.update( objects, &num );
+
+    QVector<SkyPoint> hover;
+    for ( int k = 0; k < hoverCount; ++k )
+        hover.append( randomPoint() );
+
+    // Hover radius of SkyMap::slotTransientLabel() at the default zoom factor
+    const double hoverRadius = 1000.0 / 250.0;
+
+    // Time of hoverCount hover labels
+    QBENCHMARK {
+        for ( int k = 0; k < hoverCount; ++k ) {
+            double maxrad = hoverRadius;
+            if ( indexed )
+                indexedNearest( index, &hover[k], maxrad );
+            else
+                linearNearest( objects, &hover[k], maxrad );
+        }
+    }
+
+    qDeleteAll( objects );
+}
+
+QTEST_GUILESS_MAIN( TestMovingObjectIndex )
@@ -0,0 +1,47 @@
+/*  Moving Object Index Tests
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef TEST_MOVINGOBJECTINDEX_H
+#define TEST_MOVINGOBJECTINDEX_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+#include "skycomponents/movingobjectindex.h"
+
+/**
+ * @class TestMovingObjectIndex
+ * @short Tests for the trixel index of asteroids and comets
+ */
+
+class TestMovingObjectIndex : public QObject {
+
+    Q_OBJECT
+
+public:
+
+    TestMovingObjectIndex() : QObject() {};
+    ~TestMovingObjectIndex() {};
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void testUpdate();
+    void testObjectNearest();
+    void benchmarkHover_data();
+    void benchmarkHover();
+
+private:
+    /** Query the index around @p p like SkyMapComposite::objectNearest() */
+    SkyObject * indexedNearest( const MovingObjectIndex &index, SkyPoint *p, double &maxrad );
+
+    SkyMesh *m_Mesh;
+};
+
+#endif
@@ -0,0 +1,191 @@
+/*  Orbital Elements Tests
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+/* Project Includes */
+#include "test_orbitalelements.h"
+#include "ksnumbers.h"
+#include "skyobjects/ksasteroid.h"
+#include "skyobjects/kscomet.h"
+#include "auxiliary/dms.h"
+
+namespace
+{
+
+const double jd = 2457800.5; // 2017-02-10 0h UT
+const int benchmarkSize = 600000;
+
+double uniform( double low, double high )
+{
+    return low + ( high - low ) * qrand() / RAND_MAX;
+}
+
+/** Elements of a synthetic main-belt asteroid, angles in degrees */
+typedef struct
+{
+    double a, e, i, w, N, M;
+} Elements;
+
+QVector<Elements> syntheticBelt( int count )
+{
+    QVector<Elements> belt;
+    belt.reserve( count );
+    qsrand( 42 );
+    for ( int k = 0; k < count; ++k ) {
+        Elements el;
+        el.a = uniform( 2.0, 3.5 );
+        el.e = uniform( 0.0, 0.4 );
+        el.i = uniform( 0.0, 30.0 );
+        el.w = uniform( 0.0, 360.0 );
+        el.N = uniform( 0.0, 360.0 );
+        el.M = uniform( 0.0, 360.0 );
+        belt.append( el );
+    }
+    return belt;
+}
+
+double period( double a )
+{
+    return 365.2568984 * pow( a, 1.5 );
+}
+
+}
+
+void TestOrbitalElements::initTestCase() {
+    // Mean orbit of the Earth at J2000.0, its position does not need KStarsData
+    KSNumbers num( jd );
+    m_Earth = new KSAsteroid( 0, "Earth", QString(), J2000, 1.00000011, 0.01671022, dms( 0.00005 ), dms( 102.94719 ),
+                              dms( 0.0 ), dms( 357.51716 ), 0.0, 0.0 );
+    m_Earth->findGeocentricPosition( &num );
+}
+
+void TestOrbitalElements::cleanupTestCase() {
+    delete m_Earth;
+}
+
+void TestOrbitalElements::compare( QList<KSPlanetBase *> &bodies, const OrbitalElements &elements, double tolerance ) {
+    QCOMPARE( elements.size(), bodies.size() );
+
+    KSNumbers num( jd );
+    const QVector<OrbitPosition> positions = elements.solve( jd );
+
+    for ( int k = 0; k < bodies.size(); ++k ) {
+        KSPlanetBase *scalar = bodies[k];
+        QScopedPointer<KSPlanetBase> batch( static_cast<KSPlanetBase *>( scalar->clone() ) );
+
+        scalar->findGeocentricPosition( &num, m_Earth );
+        batch->findGeocentricPositionFrom( positions[k], &num, m_Earth );
+
+        double dRA = fabs( scalar->ra().Degrees() - batch->ra().Degrees() );
+        dRA = qMin( dRA, 360.0 - dRA ) * cos( scalar->dec().radians() );
+        QVERIFY2( dRA < tolerance, qPrintable( QString( "%1: RA differs by %2" ).arg( scalar->name() ).arg( dRA ) ) );
+        QVERIFY2( fabs( scalar->dec().Degrees() - batch->dec().Degrees() ) < tolerance, qPrintable( scalar->name() ) );
+        QVERIFY( fabs( scalar->rsun() - batch->rsun() ) < 1e-4 * scalar->rsun() );
+        QVERIFY( fabs( scalar->rearth() - batch->rearth() ) < 1e-4 * scalar->rearth() );
+    }
+
+    qDeleteAll( bodies );
+    bodies.clear();
+}
+
+void TestOrbitalElements::testAsteroids() {
+    /*
+     * The scalar path iterates until the eccentric anomaly changes by
+     * less than 0.001 degree, and does not iterate at all below an
+     * eccentricity of 0.05, where its first approximation is off by up
+     * to e^3 radians.
+     */
+    const QVector<Elements> belt = syntheticBelt( 2000 );
+
+    auto check = [&]( bool lowEccentricity, double tolerance ) {
+        QList<KSPlanetBase *> bodies;
+        OrbitalElements elements;
+        for ( int k = 0; k < belt.size(); ++k ) {
+            const Elements &el = belt[k];
+            if ( ( el.e <= 0.05 ) != lowEccentricity )
+                continue;
+            KSAsteroid *asteroid = new KSAsteroid( k, QString( "Asteroid %1" ).arg( k ), QString(), 2457600.5, el.a, el.e,
+                                                   dms( el.i ), dms( el.w ), dms( el.N ), dms( el.M ), 10.0, 0.15 );
+            bodies.append( asteroid );
+            elements.append( asteroid );
+        }
+        compare( bodies, elements, tolerance );
+    };
+
+    check( false, 2e-3 );
+    check( true, 0.02 );
+
+    // Bodies can also be appended from their elements, with the same results
+    QList<KSPlanetBase *> bodies;
+    bodies.append( new KSAsteroid( 1, "Ceres", QString(), 2457800.5, 2.7691652, 0.0760090, dms( 10.59407 ),
+                                   dms( 73.59769 ), dms( 80.30553 ), dms( 77.37210 ), 3.34, 0.12 ) );
+    OrbitalElements elements;
+    elements.appendElliptic( 2457800.5, 77.37210, period( 2.7691652 ), 2.7691652, 0.0760090, 10.59407, 73.59769, 80.30553 );
+    compare( bodies, elements, 2e-3 );
+}
+
+void TestOrbitalElements::testComets() {
+    /*
+     * Elliptic orbits up to an eccentricity of 0.98, near-parabolic
+     * ones above.
+     */
+    QList<KSPlanetBase *> bodies;
+    OrbitalElements elements;
+
+    qsrand( 7 );
+    for ( int k = 0; k < 1000; ++k ) {
+        double e = ( k % 2 ) ? uniform( 0.1, 0.98 ) : uniform( 0.981, 0.999 );
+        double Tp = 20160000.0 + 100.0 * int( uniform( 1, 12.99 ) ) + int( uniform( 1, 28.99 ) ) + uniform( 0.0, 0.99 );
+        KSComet *comet = new KSComet( QString( "C/2016 A%1" ).arg( k ), QString(), 2457600.5, uniform( 0.3, 4.0 ), e,
+                                      dms( uniform( 0.0, 180.0 ) ), dms( uniform( 0.0, 360.0 ) ), dms( uniform( 0.0, 360.0 ) ),
+                                      Tp, 10.0, 15.0, 10.0, 5.0 );
+        bodies.append( comet );
+        elements.append( comet );
+    }
+    compare( bodies, elements, 2e-3 );
+}
+
+void TestOrbitalElements::benchmarkScalar() {
+    const QVector<Elements> belt = syntheticBelt( benchmarkSize );
+    KSNumbers num( jd );
+    KSAsteroid asteroid( 0, "Asteroid", QString(), 2457600.5, 1.0, 0.0, dms( 0.0 ), dms( 0.0 ), dms( 0.0 ), dms( 0.0 ), 10.0, 0.15 );
+    KSPlanetBase *body = &asteroid;
+
+    QBENCHMARK {
+        foreach ( const Elements &el, belt ) {
+            asteroid.set_a( el.a );
+            asteroid.set_e( el.e );
+            asteroid.set_P( period( el.a ) );
+            asteroid.set_i( el.i );
+            asteroid.set_w( el.w );
+            asteroid.set_N( el.N );
+            asteroid.set_M( el.M );
+            body->findGeocentricPosition( &num, m_Earth );
+        }
+    }
+}
+
+void TestOrbitalElements::benchmarkBatch() {
+    const QVector<Elements> belt = syntheticBelt( benchmarkSize );
+    KSNumbers num( jd );
+    KSAsteroid asteroid( 0, "Asteroid", QString(), 2457600.5, 1.0, 0.0, dms( 0.0 ), dms( 0.0 ), dms( 0.0 ), dms( 0.0 ), 10.0, 0.15 );
+    KSPlanetBase *body = &asteroid;
+
+    OrbitalElements elements;
+    elements.reserve( belt.size() );
+    foreach ( const Elements &el, belt )
+        elements.appendElliptic( 2457600.5, el.M, period( el.a ), el.a, el.e, el.i, el.w, el.N );
+
+    QBENCHMARK {
+        const QVector<OrbitPosition> positions = elements.solve( jd );
+        foreach ( const OrbitPosition &position, positions )
+            body->findGeocentricPositionFrom( position, &num, m_Earth );
+    }
+}
+
+QTEST_GUILESS_MAIN( TestOrbitalElements )
@@ -0,0 +1,48 @@
+/*  Orbital Elements Tests
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef TEST_ORBITALELEMENTS_H
+#define TEST_ORBITALELEMENTS_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+#define UNIT_TEST
+
+#include "skyobjects/orbitalelements.h"
+
+/**
+ * @class TestOrbitalElements
+ * @short Tests for the batch computation of asteroid and comet positions
+ */
+
+class TestOrbitalElements : public QObject {
+
+    Q_OBJECT
+
+public:
+
+    TestOrbitalElements() : QObject() {};
+    ~TestOrbitalElements() {};
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void testAsteroids();
+    void testComets();
+    void benchmarkScalar();
+    void benchmarkBatch();
+
+private:
+    void compare( QList<KSPlanetBase *> &bodies, const OrbitalElements &elements, double tolerance );
+
+    KSPlanetBase *m_Earth;
+};
+
+#endif
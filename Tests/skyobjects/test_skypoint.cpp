@@ -22,6 +22,68 @@
 #include "time/kstarsdatetime.h"
 #include "auxiliary/dms.h"
 
+namespace
+{
+
+// Parameters of the Observing List Wizard's default observability filter
+const int skySize = 100000;
+const double latitude = 43.7;
+const double startLST = 17.3;       // Local sidereal time at 18:00 [Hours]
+const double solarHours = 6.;       // 18:00 to midnight
+
+/** @return points spread uniformly over the sky, always the same ones */
+QVector<SkyPoint> syntheticSky( int count )
+{
+    QVector<SkyPoint> sky;
+    sky.reserve( count );
+    qsrand( 42 );
+    for ( int i = 0; i < count; ++i ) {
+        double ra = 360. * qrand() / RAND_MAX;
+        double dec = asin( 2. * qrand() / RAND_MAX - 1. ) / dms::DegToRad;
+        sky.append( SkyPoint( dms( ra ), dms( dec ) ) );
+    }
+    return sky;
+}
+
+dms lstAt( double lst0, double solarHoursLater )
+{
+    return dms( ( lst0 + solarHoursLater * SIDEREALSECOND ) * 15. );
+}
+
+/** The filter ObsListWizard used to apply: the altitude at every hour of the interval, excluding its end */
+bool hourlyObservable( SkyPoint p, const dms &lat, double lst0, double hours, double minAlt, double maxAlt )
+{
+    for ( double h = 0; h < hours; h += 1. ) {
+        dms LST = lstAt( lst0, h );
+        p.EquatorialToHorizontal( &LST, &lat );
+        if ( p.alt().Degrees() >= minAlt && p.alt().Degrees() <= maxAlt )
+            return true;
+    }
+    return false;
+}
+
+/** Lowest and highest altitudes sampled every step hours, including the end of the interval */
+void sampledRange( SkyPoint p, const dms &lat, double lst0, double hours, double step, double &lowest, double &highest )
+{
+    lowest = 90.;
+    highest = -90.;
+    for ( int i = 0; i * step <= hours + step / 2.; ++i ) {
+        dms LST = lstAt( lst0, qMin( i * step, hours ) );
+        p.EquatorialToHorizontal( &LST, &lat );
+        lowest = qMin( lowest, p.alt().Degrees() );
+        highest = qMax( highest, p.alt().Degrees() );
+    }
+}
+
+bool analyticObservable( const SkyPoint &p, const dms &lat, double lst0, double hours, double minAlt, double maxAlt )
+{
+    double lowest, highest;
+    p.altitudeRange( lat, lstAt( lst0, 0 ), hours * SIDEREALSECOND, lowest, highest );
+    return highest >= minAlt && lowest <= maxAlt;
+}
+
+}
+
 
 void TestSkyPoint::testPrecession() {
     /*
@@ -95,4 +157,92 @@ void TestSkyPoint::testPrecession() {
 
 }
 
+void TestSkyPoint::testAltitudeRange() {
+    /*
+     * The extremes found from the hour angles must be those of
+     * the altitude sampled every 10 seconds along the interval.
+     */
+    constexpr double step = 10. / 3600.;
+    constexpr double tolerance = 0.05; // Altitude change in 5 seconds near the zenith, in degrees
+
+    const QVector<SkyPoint> sky = syntheticSky( 200 );
+    const double latitudes[] = { -33.9, 0., 43.7, 78.2 };
+    const double durations[] = { 0.5, 6., 30. };
+
+    for ( double lat : latitudes ) {
+        for ( double hours : durations ) {
+            for ( const SkyPoint &p : sky ) {
+                double lowest, highest, sampledLowest, sampledHighest;
+                p.altitudeRange( dms( lat ), lstAt( startLST, 0 ), hours * SIDEREALSECOND, lowest, highest );
+                sampledRange( p, dms( lat ), startLST, hours, step, sampledLowest, sampledHighest );
+
+                QVERIFY( sampledLowest >= lowest - 1e-6 );
+                QVERIFY( sampledHighest <= highest + 1e-6 );
+                QVERIFY( sampledLowest - lowest < tolerance );
+                QVERIFY( highest - sampledHighest < tolerance );
+            }
+        }
+    }
+}
+
+void TestSkyPoint::testObservableFilter() {
+    /*
+     * Every object the hourly sampler found observable must still be
+     * found. The analytic filter also finds the objects which are in
+     * the altitude range only between two samples or during the last
+     * hour, check those with a fine sampler.
+     */
+    const QVector<SkyPoint> sky = syntheticSky( skySize );
+    const dms lat( latitude );
+    const double bands[][2] = { { 15., 90. }, { 30., 32. } };
+
+    for ( const auto &band : bands ) {
+        int observable = 0, missed = 0, added = 0;
+        for ( const SkyPoint &p : sky ) {
+            bool hourly = hourlyObservable( p, lat, startLST, solarHours, band[0], band[1] );
+            bool analytic = analyticObservable( p, lat, startLST, solarHours, band[0], band[1] );
+
+            if ( analytic )
+                ++observable;
+            if ( hourly && ! analytic )
+                ++missed;
+            if ( analytic && ! hourly ) {
+                ++added;
+                double lowest, highest;
+                sampledRange( p, lat, startLST, solarHours, 10. / 3600., lowest, highest );
+                QVERIFY( highest >= band[0] - 0.05 && lowest <= band[1] + 0.05 );
+            }
+        }
+        qDebug() << "Altitudes" << band[0] << "to" << band[1] << ":" << observable << "observable objects,"
+                 << added << "not seen by the hourly sampler";
+        QCOMPARE( missed, 0 );
+    }
+}
+
+void TestSkyPoint::benchmarkHourlySampler() {
+    const QVector<SkyPoint> sky = syntheticSky( skySize );
+    const dms lat( latitude );
+    int observable = 0;
+    QBENCHMARK {
+        observable = 0;
+        for ( const SkyPoint &p : sky )
+            if ( hourlyObservable( p, lat, startLST, solarHours, 15., 90. ) )
+                ++observable;
+    }
+    QVERIFY( observable > 0 );
+}
+
+void TestSkyPoint::benchmarkAltitudeRange() {
+    const QVector<SkyPoint> sky = syntheticSky( skySize );
+    const dms lat( latitude );
+    int observable = 0;
+    QBENCHMARK {
+        observable = 0;
+        for ( const SkyPoint &p : sky )
+            if ( analyticObservable( p, lat, startLST, solarHours, 15., 90. ) )
+                ++observable;
+    }
+    QVERIFY( observable > 0 );
+}
+
 QTEST_GUILESS_MAIN( TestSkyPoint )
@@ -44,6 +44,10 @@ public:
 
 private slots:
     void testPrecession();
+    void testAltitudeRange();
+    void testObservableFilter();
+    void benchmarkHourlySampler();
+    void benchmarkAltitudeRange();
 };
 
 #endif
@@ -0,0 +1,239 @@
+/*  Trail Buffer Tests
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+/* Project Includes */
+#include "test_trailbuffer.h"
+#include "projections/stereographicprojector.h"
+
+namespace
+{
+
+const int trailCount = 1000;
+const int trailLength = 500;
+
+/** @return the view of the sky map centered on @p focus, with the horizontal coordinates */
+ViewParams viewParams( SkyPoint *focus )
+{
+    ViewParams p;
+    p.width = 1920;
+    p.height = 1080;
+    p.zoomFactor = 250;
+    p.useRefraction = false;
+    p.useAltAz = true;
+    p.fillGround = false;
+    p.focus = focus;
+    return p;
+}
+
+/** Compare the coordinates of @p a and @p b */
+void compare( const SkyPoint &a, const SkyPoint &b, double tolerance )
+{
+    QVERIFY( fabs( a.ra().Degrees() - b.ra().Degrees() ) < tolerance );
+    QVERIFY( fabs( a.dec().Degrees() - b.dec().Degrees() ) < tolerance );
+    QVERIFY( fabs( a.alt().Degrees() - b.alt().Degrees() ) < tolerance );
+    // The azimuth is undefined at the zenith and nadir
+    if ( fabs( a.alt().Degrees() ) < 89.9 ) {
+        double dAz = fabs( a.az().Degrees() - b.az().Degrees() );
+        QVERIFY( qMin( dAz, 360.0 - dAz ) < tolerance );
+    }
+}
+
+}
+
+void TestTrailBuffer::initTestCase() {
+    // Slow paths across the whole sky, as the trails of asteroids over months
+    const dms LST( 75.0 ), lat( 48.0 );
+    qsrand( 7 );
+    m_Points.resize( trailCount );
+    for ( int i = 0; i < trailCount; ++i ) {
+        double ra = 360.0 * qrand() / RAND_MAX;
+        double dec = asin( 2.0 * qrand() / RAND_MAX - 1.0 ) / dms::DegToRad;
+        double dRA = 0.5 * qrand() / RAND_MAX - 0.25, dDec = 0.2 * qrand() / RAND_MAX - 0.1;
+        for ( int k = 0; k < trailLength; ++k ) {
+            SkyPoint p( dms( ra + k * dRA ).reduce(), dms( qBound( -89.0, dec + k * dDec, 89.0 ) ) );
+            p.EquatorialToHorizontal( &LST, &lat );
+            m_Points[i].append( p );
+        }
+    }
+}
+
+void TestTrailBuffer::testRing() {
+    const QList<SkyPoint> &points = m_Points.first();
+    TrailBuffer trail;
+    QVERIFY( trail.isEmpty() );
+
+    // Grow the ring while it wraps around
+    int first = 0, next = 0;
+    while ( next < 100 ) {
+        trail.append( points[next], QString::number( next ) );
+        ++next;
+        if ( next % 3 == 0 ) {
+            trail.removeFirst();
+            ++first;
+        }
+    }
+    QCOMPARE( trail.size(), next - first );
+    for ( int i = 0; i < trail.size(); ++i ) {
+        compare( trail.at( i ), points[ first + i ], 1e-6 );
+        QCOMPARE( trail.label( i ), QString::number( first + i ) );
+    }
+
+    trail.removeLast();
+    QCOMPARE( trail.size(), next - first - 1 );
+    QCOMPARE( trail.label( trail.size() - 1 ), QString::number( next - 2 ) );
+
+    // A trail of constant length, as KSPlanetBase keeps it
+    for ( int k = next; k < trailLength; ++k ) {
+        trail.append( points[k], QString::number( k ) );
+        trail.removeFirst();
+    }
+    QCOMPARE( trail.label( 0 ), QString::number( trailLength - trail.size() ) );
+    compare( trail.at( trail.size() - 1 ), points.last(), 1e-6 );
+
+    trail.clear();
+    QVERIFY( trail.isEmpty() );
+    trail.append( points.first() );
+    QCOMPARE( trail.size(), 1 );
+    compare( trail.at( 0 ), points.first(), 1e-6 );
+}
+
+void TestTrailBuffer::testHorizontal() {
+    TrailBuffer trail;
+    foreach ( const SkyPoint &p, m_Points.first() )
+        trail.append( p );
+
+    const dms lat( -33.5 );
+    for ( double lst = 0.0; lst < 360.0; lst += 37.0 ) {
+        const dms LST( lst );
+        trail.updateHorizontal( &LST, &lat );
+        for ( int i = 0; i < trail.size(); ++i ) {
+            SkyPoint p = m_Points.first().at( i );
+            p.EquatorialToHorizontal( &LST, &lat );
+            compare( trail.at( i ), p, 1e-5 );
+        }
+    }
+}
+
+void TestTrailBuffer::testProjection() {
+    SkyPoint focus;
+    focus.setAlt( 40.0 );
+    focus.setAz( 180.0 );
+    ViewParams view = viewParams( &focus );
+    StereographicProjector proj( view );
+
+    TrailBuffer trail;
+    foreach ( const SkyPoint &p, m_Points[1] )
+        trail.append( p );
+
+    const QVector<QPointF> &points = trail.project( &proj );
+    QCOMPARE( points.size(), trail.size() );
+    for ( int i = 0; i < trail.size(); ++i ) {
+        SkyPoint p = m_Points[1].at( i );
+        bool visible;
+        QPointF expected = proj.toScreen( &p, true, &visible );
+        QVERIFY( fabs( points[i].x() - expected.x() ) < 1e-3 && fabs( points[i].y() - expected.y() ) < 1e-3 );
+        QCOMPARE( trail.isVisible( i ), visible );
+    }
+
+    // Setting the same view again keeps the positions
+    quint64 revision = proj.revision();
+    proj.setViewParams( view );
+    QCOMPARE( proj.revision(), revision );
+    QPointF last = trail.project( &proj ).last();
+
+    // Moving the trail or the view computes them again
+    const dms LST( 10.0 ), lat( 48.0 );
+    trail.updateHorizontal( &LST, &lat );
+    QVERIFY( trail.project( &proj ).last() != last );
+    last = trail.project( &proj ).last();
+
+    focus.setAz( 190.0 );
+    proj.setViewParams( view );
+    QVERIFY( proj.revision() != revision );
+    QVERIFY( trail.project( &proj ).last() != last );
+
+    StereographicProjector other( view );
+    QVERIFY( other.revision() != proj.revision() );
+}
+
+void TestTrailBuffer::benchmarkUpdate_data() {
+    QTest::addColumn<bool>( "buffer" );
+
+    QTest::newRow( "SkyPoint list" ) << false;
+    QTest::newRow( "TrailBuffer" ) << true;
+}
+
+void TestTrailBuffer::benchmarkUpdate() {
+    QFETCH( bool, buffer );
+    const dms lat( 48.0 );
+    dms LST( 75.0 );
+
+    if ( buffer ) {
+        QVector<TrailBuffer> trails( trailCount );
+        for ( int i = 0; i < trailCount; ++i )
+            foreach ( const SkyPoint &p, m_Points[i] )
+                trails[i].append( p );
+
+        QBENCHMARK {
+            LST.setD( LST.Degrees() + 0.25 );
+            for ( int i = 0; i < trailCount; ++i )
+                trails[i].updateHorizontal( &LST, &lat );
+        }
+    } else {
+        // What TrailObject::updateTrail() did for each point
+        QVector< QList<SkyPoint> > trails = m_Points;
+        QBENCHMARK {
+            LST.setD( LST.Degrees() + 0.25 );
+            for ( int i = 0; i < trailCount; ++i )
+                for ( int k = 0; k < trails[i].size(); ++k )
+                    trails[i][k].EquatorialToHorizontal( &LST, &lat );
+        }
+    }
+}
+
+void TestTrailBuffer::benchmarkProject_data() {
+    QTest::addColumn<bool>( "cached" );
+
+    QTest::newRow( "every point" ) << false;
+    QTest::newRow( "cached" ) << true;
+}
+
+void TestTrailBuffer::benchmarkProject() {
+    QFETCH( bool, cached );
+    SkyPoint focus;
+    focus.setAlt( 40.0 );
+    focus.setAz( 180.0 );
+    StereographicProjector proj( viewParams( &focus ) );
+
+    // Frames drawn without moving the view, nor the trails
+    double sum = 0.0;
+    if ( cached ) {
+        QVector<TrailBuffer> trails( trailCount );
+        for ( int i = 0; i < trailCount; ++i )
+            foreach ( const SkyPoint &p, m_Points[i] )
+                trails[i].append( p );
+
+        QBENCHMARK {
+            for ( int i = 0; i < trailCount; ++i )
+                sum += trails[i].project( &proj ).last().x();
+        }
+    } else {
+        QBENCHMARK {
+            for ( int i = 0; i < trailCount; ++i ) {
+                for ( int k = 0; k < trailLength; ++k ) {
+                    SkyPoint p = m_Points[i].at( k );
+                    sum += proj.toScreen( &p ).x();
+                }
+            }
+        }
+    }
+    QVERIFY( sum == sum );
+}
+
+QTEST_GUILESS_MAIN(TestTrailBuffer)
@@ -0,0 +1,46 @@
+/*  Trail Buffer Tests
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef TEST_TRAILBUFFER_H
+#define TEST_TRAILBUFFER_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+#include "skyobjects/trailbuffer.h"
+
+/**
+ * @class TestTrailBuffer
+ * @short Tests for the ring buffer of trail points, and benchmarks of long trails on many objects
+ */
+
+class TestTrailBuffer : public QObject {
+
+    Q_OBJECT
+
+public:
+
+    TestTrailBuffer() : QObject() {};
+    ~TestTrailBuffer() {};
+
+private slots:
+    void initTestCase();
+    void testRing();
+    void testHorizontal();
+    void testProjection();
+    void benchmarkUpdate_data();
+    void benchmarkUpdate();
+    void benchmarkProject_data();
+    void benchmarkProject();
+
+private:
+    QVector< QList<SkyPoint> > m_Points;
+};
+
+#endif
@@ -0,0 +1,162 @@
+/*  Altitude Curve Cache Tests
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+/* Project Includes */
+#include "test_altitudecurvecache.h"
+#include "geolocation.h"
+#include "skyobjects/skyobject.h"
+
+namespace
+{
+
+const int objectCount = 500;
+
+/** @return the start of the Observing Planner plot of @p date at @p geo, 12 hours before local midnight */
+KStarsDateTime plotStart( const QDate &date, const GeoLocation *geo )
+{
+    return geo->LTtoUT( KStarsDateTime( date, QTime( 0, 0, 0 ) ) ).addSecs( -12.0 * 3600.0 );
+}
+
+/** @return the altitude of @p p @p hour hours after @p start, computed as the tools did for each sample */
+double sampleAltitude( const SkyPoint *p, const GeoLocation *geo, const KStarsDateTime &start, double hour )
+{
+    SkyPoint sp = *p;
+    KStarsDateTime ut = start.addSecs( hour * 3600.0 );
+    dms LST = geo->GSTtoLST( ut.gst() );
+    sp.EquatorialToHorizontal( &LST, geo->lat() );
+    return sp.alt().Degrees();
+}
+
+}
+
+void TestAltitudeCurveCache::initTestCase() {
+    // Objects spread over the whole sky, as a large observing list
+    qsrand( 42 );
+    for ( int i = 0; i < objectCount; ++i ) {
+        double ra = 360.0 * qrand() / RAND_MAX;
+        double dec = asin( 2.0 * qrand() / RAND_MAX - 1.0 ) / dms::DegToRad;
+        m_Objects.append( new SkyObject( SkyObject::GALAXY, dms( ra ), dms( dec ), 10.0, QString( "Object %1" ).arg( i ) ) );
+    }
+
+    m_Locations.append( new GeoLocation( dms( -0.0015 ), dms( 51.4778 ), "Greenwich", "", "United Kingdom", 0.0 ) );
+    m_Locations.append( new GeoLocation( dms( -70.6483 ), dms( -33.4569 ), "Santiago", "", "Chile", -4.0 ) );
+    m_Locations.append( new GeoLocation( dms( 18.9553 ), dms( 69.6492 ), "Tromso", "", "Norway", 1.0 ) );
+}
+
+void TestAltitudeCurveCache::cleanupTestCase() {
+    qDeleteAll( m_Objects );
+    qDeleteAll( m_Locations );
+}
+
+void TestAltitudeCurveCache::testCompute_data() {
+    QTest::addColumn<int>( "location" );
+    QTest::addColumn<double>( "step" );
+    QTest::addColumn<int>( "count" );
+
+    QTest::newRow( "Greenwich, Altitude vs. Time" ) << 0 << 0.25 << 97;
+    QTest::newRow( "Santiago, Observing Planner" ) << 1 << 0.5 << 49;
+    QTest::newRow( "Tromso, one week" ) << 2 << 1.0 << 7 * 24 + 1;
+}
+
+void TestAltitudeCurveCache::testCompute() {
+    QFETCH( int, location );
+    QFETCH( double, step );
+    QFETCH( int, count );
+    const GeoLocation *geo = m_Locations[location];
+    const KStarsDateTime start = plotStart( QDate( 2017, 3, 20 ), geo );
+
+    double maxError = 0.0;
+    foreach ( SkyObject *o, m_Objects ) {
+        QVector<double> altitudes = AltitudeCurveCache::compute( *o, geo, start, step, count );
+        QCOMPARE( altitudes.size(), count );
+        for ( int i = 0; i < count; ++i )
+            maxError = qMax( maxError, fabs( altitudes[i] - sampleAltitude( o, geo, start, i * step ) ) );
+    }
+
+    qDebug() << geo->name() << "largest difference" << maxError * 3600.0 << "arcsec";
+    QVERIFY( maxError < 0.001 );
+}
+
+void TestAltitudeCurveCache::testCache() {
+    AltitudeCurveCache *cache = AltitudeCurveCache::Instance();
+    cache->clear();
+
+    const GeoLocation *geo = m_Locations[0];
+    const KStarsDateTime start = plotStart( QDate( 2017, 3, 20 ), geo );
+    SkyObject *o = m_Objects.first();
+
+    QVector<double> curve = cache->altitudes( o, geo, start, 0.5, 49 );
+    QCOMPARE( curve, AltitudeCurveCache::compute( *o, geo, start, 0.5, 49 ) );
+    QCOMPARE( cache->size(), 1 );
+
+    // Plotting the same object again reuses the curve
+    QCOMPARE( cache->altitudes( o, geo, start, 0.5, 49 ), curve );
+    QCOMPARE( cache->size(), 1 );
+
+    // Another date, location, sampling or position is another curve
+    QVector<double> nextDay = cache->altitudes( o, geo, start.addDays( 1 ), 0.5, 49 );
+    QVERIFY( nextDay != curve );
+    QCOMPARE( cache->size(), 2 );
+
+    QVector<double> elsewhere = cache->altitudes( o, m_Locations[1], start, 0.5, 49 );
+    QVERIFY( elsewhere != curve );
+    QCOMPARE( cache->size(), 3 );
+
+    cache->altitudes( o, geo, start, 0.25, 97 );
+    QCOMPARE( cache->size(), 4 );
+
+    SkyObject moved( *o );
+    moved.setDec( dms( o->dec().Degrees() + 1.0 ) );
+    QVERIFY( cache->altitudes( &moved, geo, start, 0.5, 49 ) != curve );
+    QCOMPARE( cache->size(), 5 );
+
+    cache->clear();
+    QCOMPARE( cache->size(), 0 );
+}
+
+void TestAltitudeCurveCache::benchmarkPlot_data() {
+    QTest::addColumn<QString>( "method" );
+
+    QTest::newRow( "per sample" ) << "sample";
+    QTest::newRow( "single pass" ) << "compute";
+    QTest::newRow( "cached" ) << "cache";
+}
+
+void TestAltitudeCurveCache::benchmarkPlot() {
+    QFETCH( QString, method );
+    const GeoLocation *geo = m_Locations[0];
+    const KStarsDateTime start = plotStart( QDate( 2017, 3, 20 ), geo );
+
+    // The Observing Planner curve of every object in the list
+    AltitudeCurveCache *cache = AltitudeCurveCache::Instance();
+    cache->clear();
+    if ( method == "cache" ) {
+        foreach ( SkyObject *o, m_Objects )
+            cache->altitudes( o, geo, start, 0.5, 49 );
+    }
+
+    double sum = 0.0;
+    QBENCHMARK {
+        foreach ( SkyObject *o, m_Objects ) {
+            if ( method == "sample" ) {
+                for ( double h = 0.0; h <= 24.0; h += 0.5 )
+                    sum += sampleAltitude( o, geo, start, h );
+            } else if ( method == "compute" ) {
+                sum += AltitudeCurveCache::compute( *o, geo, start, 0.5, 49 ).last();
+            } else {
+                sum += cache->altitudes( o, geo, start, 0.5, 49 ).last();
+            }
+        }
+    }
+    QVERIFY( sum == sum );
+
+    cache->clear();
+}
+
+QTEST_GUILESS_MAIN(TestAltitudeCurveCache)
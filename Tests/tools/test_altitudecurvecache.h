@@ -0,0 +1,49 @@
+/*  Altitude Curve Cache Tests
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef TEST_ALTITUDECURVECACHE_H
+#define TEST_ALTITUDECURVECACHE_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+#include "tools/altitudecurvecache.h"
+
+class GeoLocation;
+class SkyObject;
+
+/**
+ * @class TestAltitudeCurveCache
+ * @short Tests of the altitude curves against per-sample coordinate conversions, and plotting benchmarks
+ */
+
+class TestAltitudeCurveCache : public QObject {
+
+    Q_OBJECT
+
+public:
+
+    TestAltitudeCurveCache() : QObject() {};
+    ~TestAltitudeCurveCache() {};
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void testCompute_data();
+    void testCompute();
+    void testCache();
+    void benchmarkPlot_data();
+    void benchmarkPlot();
+
+private:
+    QList<SkyObject *> m_Objects;
+    QList<GeoLocation *> m_Locations;
+};
+
+#endif
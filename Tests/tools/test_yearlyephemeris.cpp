@@ -0,0 +1,248 @@
+/*  Yearly Ephemeris Tests
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+/* Project Includes */
+#include "test_yearlyephemeris.h"
+#include "geolocation.h"
+#include "ksnumbers.h"
+#include "skyobjects/ksasteroid.h"
+
+/**
+ * An asteroid whose coordinates are updated with the given Earth instead of the one of the sky map.
+ * SkyObject::riseSetTime() and the other per-day functions compute its positions through updateCoords().
+ */
+class TestBody : public KSAsteroid
+{
+public:
+    TestBody( const QString &name, double a, double e, double i, double w, double N, double M, const TestBody *earth )
+        : KSAsteroid( 0, name, QString(), J2000, a, e, dms( i ), dms( w ), dms( N ), dms( M ), 0.0, 0.0 ), m_Earth( earth ) {}
+
+    virtual TestBody * clone() const { return new TestBody( *this ); }
+
+    virtual void updateCoords( const KSNumbers *num, bool includePlanets=true, const CachingDms * =0, const CachingDms * =0, bool =false ) {
+        if ( includePlanets )
+            findGeocentricPosition( num );
+    }
+
+    /** Compute the apparent geocentric position at @p num */
+    bool findGeocentricPosition( const KSNumbers *num, const KSPlanetBase * =0 ) {
+        if ( ! m_Earth )
+            return KSAsteroid::findGeocentricPosition( num );
+
+        QScopedPointer<TestBody> earth( m_Earth->clone() );
+        earth->findGeocentricPosition( num );
+        return KSAsteroid::findGeocentricPosition( num, earth.data() );
+    }
+
+private:
+    const TestBody *m_Earth;
+};
+
+namespace
+{
+
+const int year = 2017;
+
+/** @return the time between @p a and @p b, from 0 to 12 hours */
+int secondsApart( const QTime &a, const QTime &b )
+{
+    int d = qAbs( a.secsTo( b ) );
+    return qMin( d, 86400 - d );
+}
+
+/** @return the apparent position of @p body at @p jd, with its altitude and azimuth at @p geo */
+SkyPoint horizontalPosition( const TestBody *body, double jd, const GeoLocation *geo )
+{
+    QScopedPointer<TestBody> copy( body->clone() );
+    KSNumbers num( jd );
+    copy->updateCoords( &num );
+
+    SkyPoint p = *copy;
+    CachingDms LST = geo->GSTtoLST( KStarsDateTime( jd ).gst() );
+    p.EquatorialToHorizontal( &LST, geo->lat() );
+    return p;
+}
+
+/** @return the hour angle of @p body at @p jd, from -180 to 180 degrees */
+double hourAngle( const TestBody *body, double jd, const GeoLocation *geo )
+{
+    SkyPoint p = horizontalPosition( body, jd, geo );
+    CachingDms LST = geo->GSTtoLST( KStarsDateTime( jd ).gst() );
+    return remainder( LST.Degrees() - p.ra().Degrees(), 360.0 );
+}
+
+}
+
+void TestYearlyEphemeris::initTestCase() {
+    // Mean orbits at J2000.0
+    m_Earth = new TestBody( "Earth", 1.00000011, 0.01671022, 0.00005, 102.94719, 0.0, 357.51716, NULL );
+    m_Planets.append( new TestBody( "Mercury", 0.38709927, 0.20563593, 7.00497902, 29.12703035, 48.33076593, 174.79252722, m_Earth ) );
+    m_Planets.append( new TestBody( "Venus", 0.72333566, 0.00677672, 3.39467605, 54.92262463, 76.67984255, 50.37663232, m_Earth ) );
+    m_Planets.append( new TestBody( "Mars", 1.52371034, 0.09339410, 1.84969142, 286.49683150, 49.55953891, 19.39019754, m_Earth ) );
+    m_Planets.append( new TestBody( "Jupiter", 5.20288700, 0.04838624, 1.30439695, 274.25457074, 100.47390909, 19.66796068, m_Earth ) );
+
+    m_Locations.append( new GeoLocation( dms( -0.0015 ), dms( 51.4778 ), "Greenwich", "", "United Kingdom", 0.0 ) );
+    m_Locations.append( new GeoLocation( dms( -70.6483 ), dms( -33.4569 ), "Santiago", "", "Chile", -4.0 ) );
+    m_Locations.append( new GeoLocation( dms( 18.9553 ), dms( 69.6492 ), "Tromso", "", "Norway", 1.0 ) );
+}
+
+void TestYearlyEphemeris::cleanupTestCase() {
+    qDeleteAll( m_Planets );
+    qDeleteAll( m_Locations );
+    delete m_Earth;
+}
+
+QList<const KSPlanetBase *> TestYearlyEphemeris::bodies() const {
+    QList<const KSPlanetBase *> bodies;
+    foreach ( TestBody *planet, m_Planets )
+        bodies.append( planet );
+    return bodies;
+}
+
+void TestYearlyEphemeris::testFit() {
+    const double jd0 = KStarsDateTime( QDate( year, 1, 1 ), QTime( 0, 0, 0 ) ).djd();
+    const double jd1 = jd0 + 365.0;
+
+    QVector< QVector<EphemerisPoint> > points = KSPlanetBase::ephemeris( bodies(), YearlyEphemeris::sampleTimes( jd0, jd1 ), 0, m_Earth );
+
+    for ( int i = 0; i < m_Planets.size(); ++i ) {
+        YearlyEphemeris ephemeris( jd0, jd1, points[i] );
+
+        double maxError = 0.0;
+        for ( double jd = jd0; jd < jd1; jd += 0.37 ) {
+            QScopedPointer<TestBody> body( m_Planets[i]->clone() );
+            KSNumbers num( jd );
+            body->updateCoords( &num );
+
+            SkyPoint fitted;
+            dms ra, dec;
+            ephemeris.position( jd, ra, dec );
+            fitted.setRA( ra );
+            fitted.setDec( dec );
+            maxError = qMax( maxError, body->angularDistanceTo( &fitted ).Degrees() * 3600.0 );
+        }
+
+        qDebug() << m_Planets[i]->name() << "largest error of the fit" << maxError << "arcsec";
+        QVERIFY( maxError < 0.5 );
+    }
+}
+
+void TestYearlyEphemeris::testEvents_data() {
+    QTest::addColumn<int>( "location" );
+
+    QTest::newRow( "Greenwich" ) << 0;
+    QTest::newRow( "Santiago" ) << 1;
+    QTest::newRow( "Tromso" ) << 2;
+}
+
+void TestYearlyEphemeris::testEvents() {
+    QFETCH( int, location );
+    const GeoLocation *geo = m_Locations[location];
+
+    QVector< QVector<RiseSetTransit> > events = YearlyEphemeris::compute( bodies(), year, 1, geo, m_Earth );
+    QCOMPARE( events.size(), m_Planets.size() );
+
+    for ( int i = 0; i < m_Planets.size(); ++i ) {
+        const TestBody *body = m_Planets[i];
+        const QVector<RiseSetTransit> &days = events[i];
+        const double h0 = body->elevationCorrection().Degrees();
+        QCOMPARE( days.size(), 365 );
+
+        int compared = 0;
+        for ( int k = 0; k < days.size(); ++k ) {
+            const RiseSetTransit &day = days[k];
+            const KStarsDateTime &kdt = day.dt;
+            QCOMPARE( kdt.date().dayOfYear(), k + 1 );
+
+            // The events are exact for the positions of the body
+            if ( day.riseJD != 0.0 ) {
+                QVERIFY( fabs( horizontalPosition( body, day.riseJD, geo ).alt().Degrees() - h0 ) < 0.01 );
+                QVERIFY( fabs( horizontalPosition( body, day.setJD, geo ).alt().Degrees() - h0 ) < 0.01 );
+            }
+            QVERIFY( fabs( hourAngle( body, day.transitJD, geo ) ) < 0.01 );
+
+            // The per-day functions may pick the event of the previous or next day, allow for the change in one day
+            int riseDrift = 0, setDrift = 0, transitDrift = 0;
+            double altitudeDrift = 0.0;
+            for ( int n = qMax( 0, k - 1 ); n <= qMin( days.size() - 1, k + 1 ); ++n ) {
+                if ( day.rise.isValid() && days[n].rise.isValid() ) {
+                    riseDrift = qMax( riseDrift, secondsApart( day.rise, days[n].rise ) );
+                    setDrift = qMax( setDrift, secondsApart( day.set, days[n].set ) );
+                }
+                transitDrift = qMax( transitDrift, secondsApart( day.transit, days[n].transit ) );
+                altitudeDrift = qMax( altitudeDrift, fabs( day.transitAltitude.Degrees() - days[n].transitAltitude.Degrees() ) );
+            }
+
+            // As SkyCalendar computed them before
+            QTime rise = body->riseSetTime( kdt, geo, true, true );
+            QTime set = body->riseSetTime( kdt, geo, false, true );
+            QTime transit = body->transitTime( kdt, geo );
+            dms transitAltitude = body->transitAltitude( kdt, geo );
+
+            // transitTime() converts the hour angle to solar instead of sidereal time, up to 4 minutes off
+            QVERIFY2( secondsApart( day.transit, transit ) <= 300 + transitDrift,
+                      qPrintable( QString( "%1 transit on %2: %3, was %4" ).arg( body->name() ).arg( kdt.date().toString( Qt::ISODate ) )
+                                  .arg( day.transit.toString() ).arg( transit.toString() ) ) );
+            QVERIFY( fabs( day.transitAltitude.Degrees() - transitAltitude.Degrees() ) <= 0.05 + altitudeDrift );
+
+            // riseSetTime() ignores refraction to decide if the body rises, skip the days around the limit
+            SkyPoint p = body->recomputeCoords( kdt, geo );
+            if ( fabs( fabs( p.dec().Degrees() ) - ( 90.0 - fabs( geo->lat()->Degrees() ) ) ) < 2.0 )
+                continue;
+
+            bool risesAndSets = rise.isValid() && set.isValid() && rise != set;
+            QCOMPARE( day.rise.isValid(), risesAndSets );
+            QCOMPARE( day.set.isValid(), risesAndSets );
+            if ( risesAndSets ) {
+                QVERIFY2( secondsApart( day.rise, rise ) <= 120 + riseDrift,
+                          qPrintable( QString( "%1 rise on %2: %3, was %4" ).arg( body->name() ).arg( kdt.date().toString( Qt::ISODate ) )
+                                      .arg( day.rise.toString() ).arg( rise.toString() ) ) );
+                QVERIFY2( secondsApart( day.set, set ) <= 120 + setDrift,
+                          qPrintable( QString( "%1 set on %2: %3, was %4" ).arg( body->name() ).arg( kdt.date().toString( Qt::ISODate ) )
+                                      .arg( day.set.toString() ).arg( set.toString() ) ) );
+            }
+            ++compared;
+        }
+
+        qDebug() << geo->name() << body->name() << compared << "days compared";
+        QVERIFY( compared > 0 );
+    }
+}
+
+void TestYearlyEphemeris::benchmarkYear_data() {
+    QTest::addColumn<bool>( "batch" );
+
+    QTest::newRow( "per day" ) << false;
+    QTest::newRow( "yearly ephemeris" ) << true;
+}
+
+void TestYearlyEphemeris::benchmarkYear() {
+    QFETCH( bool, batch );
+    const GeoLocation *geo = m_Locations[0];
+
+    if ( batch ) {
+        QBENCHMARK {
+            YearlyEphemeris::compute( bodies(), year, 1, geo, m_Earth );
+        }
+    } else {
+        // The calls SkyCalendar made for each planet and day
+        QBENCHMARK {
+            foreach ( TestBody *body, m_Planets ) {
+                for ( KStarsDateTime kdt( QDate( year, 1, 1 ), QTime( 12, 0, 0 ) ); kdt.date().year() == year; kdt = kdt.addDays( 1 ) ) {
+                    body->riseSetTime( kdt, geo, true, true );
+                    body->riseSetTime( kdt, geo, false, true );
+                    body->transitTime( kdt, geo );
+                    body->transitAltitude( kdt, geo );
+                }
+            }
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(TestYearlyEphemeris)
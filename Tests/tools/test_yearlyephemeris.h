@@ -0,0 +1,54 @@
+/*  Yearly Ephemeris Tests
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef TEST_YEARLYEPHEMERIS_H
+#define TEST_YEARLYEPHEMERIS_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+#include "tools/yearlyephemeris.h"
+
+class GeoLocation;
+class TestBody;
+
+/**
+ * @class TestYearlyEphemeris
+ * @short Regression tests of the Sky Calendar events against SkyObject::riseSetTime() and transitTime()
+ *
+ * The planets are asteroids on their mean J2000 orbits, so that their positions do not need KStarsData.
+ */
+
+class TestYearlyEphemeris : public QObject {
+
+    Q_OBJECT
+
+public:
+
+    TestYearlyEphemeris() : QObject() {};
+    ~TestYearlyEphemeris() {};
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void testFit();
+    void testEvents_data();
+    void testEvents();
+    void benchmarkYear_data();
+    void benchmarkYear();
+
+private:
+    QList<const KSPlanetBase *> bodies() const;
+
+    TestBody *m_Earth;
+    QList<TestBody *> m_Planets;
+    QList<GeoLocation *> m_Locations;
+};
+
+#endif
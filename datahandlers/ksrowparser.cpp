@@ -0,0 +1,285 @@
+/*  KSRowParser
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#include "ksrowparser.h"
+
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+#include <QDebug>
+
+namespace {
+
+// Significant digits kept in the mantissa, the most that fit in 64 bits
+const int MAX_DIGITS = 19;
+
+// Powers of ten exactly representable with the 64 bit mantissa of a long double
+const long double POWERS_OF_TEN[] = {
+    1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L,
+    1e10L, 1e11L, 1e12L, 1e13L, 1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L,
+    1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L, 1e26L, 1e27L
+};
+const int MAX_EXACT_POWER = 27;
+
+inline bool IsSpace(char c) {
+    return c == ' ' || c == '\t';
+}
+
+inline bool IsDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+inline long double PowerOfTen(int exponent) {
+    if (exponent <= MAX_EXACT_POWER)
+        return POWERS_OF_TEN[exponent];
+    return std::pow(10.0L, exponent);
+}
+
+}  // namespace
+
+KSRowParser::Field KSRowParser::Field::trimmed() const {
+    const char *begin = begin_, *end = end_;
+    while (begin < end && IsSpace(*begin))
+        ++begin;
+    while (end > begin && IsSpace(end[-1]))
+        --end;
+    return Field(begin, end);
+}
+
+QString KSRowParser::Field::toString() const {
+    return QString::fromUtf8(begin_, size());
+}
+
+bool KSRowParser::Field::operator==(const char *text) const {
+    int length = int(strlen(text));
+    return length == size() && memcmp(begin_, text, length) == 0;
+}
+
+int KSRowParser::Field::toInt(bool *ok) const {
+    Field field = trimmed();
+    const char *p = field.begin_, *end = field.end_;
+
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        negative = (*p++ == '-');
+
+    if (p == end) {
+        if (ok) *ok = false;
+        return 0;
+    }
+
+    qint64 value = 0;
+    for (; p < end; ++p) {
+        if (IsDigit(*p))
+            value = value * 10 + (*p - '0');
+        if (!IsDigit(*p) || value > INT_MAX) {
+            if (ok) *ok = false;
+            return 0;
+        }
+    }
+
+    if (ok) *ok = true;
+    return int(negative ? -value : value);
+}
+
+double KSRowParser::Field::toDouble(bool *ok) const {
+    Field field = trimmed();
+    const char *p = field.begin_, *end = field.end_;
+
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        negative = (*p++ == '-');
+
+    /*
+     * The significant digits are accumulated in an integer, and the value
+     * is scaled once by a power of ten. Digits past MAX_DIGITS only move the
+     * decimal exponent.
+     */
+    quint64 mantissa = 0;
+    int digits = 0, exponent = 0;
+    bool has_digits = false;
+
+    for (; p < end && IsDigit(*p); ++p) {
+        has_digits = true;
+        if (digits < MAX_DIGITS) {
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa != 0)
+                ++digits;
+        } else {
+            ++exponent;
+        }
+    }
+
+    if (p < end && *p == '.') {
+        for (++p; p < end && IsDigit(*p); ++p) {
+            has_digits = true;
+            if (digits < MAX_DIGITS) {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa != 0)
+                    ++digits;
+                --exponent;
+            }
+        }
+    }
+
+    if (has_digits && p < end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        bool negative_exponent = false;
+        if (p < end && (*p == '-' || *p == '+'))
+            negative_exponent = (*p++ == '-');
+
+        if (p == end)
+            has_digits = false;
+
+        int e = 0;
+        for (; p < end && IsDigit(*p); ++p) {
+            if (e < 10000)
+                e = e * 10 + (*p - '0');
+        }
+        exponent += negative_exponent ? -e : e;
+    }
+
+    if (!has_digits || p != end) {
+        if (ok) *ok = false;
+        return 0.0;
+    }
+
+    long double value = mantissa;
+    if (mantissa != 0) {
+        if (exponent < 0)
+            value /= PowerOfTen(-exponent);
+        else if (exponent > 0)
+            value *= PowerOfTen(exponent);
+    }
+
+    if (ok) *ok = true;
+    return double(negative ? -value : value);
+}
+
+KSRowParser::KSRowParser(const QString &filename, const char comment_char,
+                         const Column *columns, int column_count,
+                         const char delimiter)
+    : begin_(0), end_(0), pos_(0), columns_(columns),
+      fields_(column_count), comment_char_(comment_char),
+      delimiter_(delimiter), fixed_width_(false), min_length_(0) {
+    Open(filename);
+}
+
+KSRowParser::KSRowParser(const QString &filename, const char comment_char,
+                         const Column *columns, int column_count)
+    : begin_(0), end_(0), pos_(0), columns_(columns),
+      fields_(column_count), comment_char_(comment_char),
+      delimiter_('\0'), fixed_width_(true), min_length_(0) {
+    // The last column extends to the end of the line
+    for (int i = 0; i < column_count - 1; ++i)
+        min_length_ += columns_[i].width;
+    Open(filename);
+}
+
+KSRowParser::~KSRowParser() {
+    // QFile unmaps the file when it is destroyed
+}
+
+void KSRowParser::Open(const QString &filename) {
+    file_.setFileName(filename);
+    if (!file_.open(QIODevice::ReadOnly)) {
+        qWarning() << "Unable to open file: " << filename;
+        return;
+    }
+
+    const uchar *mapped = file_.size() > 0 ? file_.map(0, file_.size()) : 0;
+    if (mapped) {
+        begin_ = reinterpret_cast<const char *>(mapped);
+        end_ = begin_ + file_.size();
+    } else {
+        // Some files, like Qt resources, cannot be mapped
+        buffer_ = file_.readAll();
+        begin_ = buffer_.constData();
+        end_ = begin_ + buffer_.size();
+    }
+    pos_ = begin_;
+    qDebug() << "File opened: " << filename;
+}
+
+bool KSRowParser::ReadNextRow() {
+    while (pos_ < end_) {
+        const char *line = pos_;
+        const char *line_end = static_cast<const char *>(memchr(line, '\n', end_ - line));
+        if (line_end) {
+            pos_ = line_end + 1;
+        } else {
+            line_end = end_;
+            pos_ = end_;
+        }
+        if (line_end > line && line_end[-1] == '\r')
+            --line_end;
+
+        if (line == line_end || *line == comment_char_)
+            continue;
+
+        if (fixed_width_ ? SplitFixedWidth(line, line_end) : SplitCSV(line, line_end))
+            return true;
+    }
+    return false;
+}
+
+bool KSRowParser::SplitCSV(const char *line, const char *line_end) {
+    const int column_count = fields_.size();
+    Field *fields = fields_.data();
+    int n = 0;
+
+    const char *p = line;
+    for (;;) {
+        const char *begin = p, *end;
+        if (p < line_end && *p == '"') {
+            // Up to the quote closing the field, quotes inside are kept
+            const char *q = p + 1;
+            while (q < line_end && !(*q == '"' && (q + 1 == line_end || q[1] == delimiter_)))
+                ++q;
+            if (q == line_end)
+                return false;  // No matching quote, skip the row
+            begin = p + 1;
+            end = q;
+            p = q + 1;
+        } else {
+            end = static_cast<const char *>(memchr(p, delimiter_, line_end - p));
+            if (!end)
+                end = line_end;
+            p = end;
+        }
+
+        if (n == column_count)
+            return false;  // Too many fields
+        fields[n++] = Field(begin, end);
+
+        if (p == line_end)
+            break;
+        ++p;  // Skip the delimiter
+    }
+
+    return n == column_count;
+}
+
+bool KSRowParser::SplitFixedWidth(const char *line, const char *line_end) {
+    if (line_end - line < min_length_)
+        return false;
+
+    const int column_count = fields_.size();
+    Field *fields = fields_.data();
+
+    const char *p = line;
+    for (int i = 0; i < column_count - 1; ++i) {
+        fields[i] = Field(p, p + columns_[i].width).trimmed();
+        p += columns_[i].width;
+    }
+    fields[column_count - 1] = Field(p, line_end).trimmed();
+
+    return true;
+}
@@ -0,0 +1,153 @@
+/*  KSRowParser
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef KSTARS_KSROWPARSER_H
+#define KSTARS_KSROWPARSER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Typed reader of CSV and fixed width text files, the fast sibling of KSParser.
+ *
+ * The file is memory-mapped and each row is split in place: a field is a view
+ * on the file contents, and numbers are converted from it directly, so reading
+ * a row allocates nothing. Fields are accessed by column index instead of by
+ * name, the columns being described by a static array known at compile time.
+ *
+ * Usage:
+ * 1) describe the columns
+ *      enum { COL_NAME, COL_MAG, COLUMN_COUNT };
+ *      static const KSRowParser::Column columns[COLUMN_COUNT] = {
+ *          { "name", 0 }, { "mag", 0 } };
+ * 2) KSRowParser parser(filename, '#', columns, COLUMN_COUNT, ',');
+ *    while (parser.ReadNextRow()) {
+ *      QString name = parser[COL_NAME].toString();
+ *      float mag = parser[COL_MAG].toFloat();
+ *      ...
+ *    }
+ *
+ * Rows are handled as in KSParser: comment lines, empty lines and rows with
+ * the wrong number of fields are skipped, and empty or broken numbers are
+ * read as 0. Fixed width columns are counted in bytes.
+ **/
+class KSRowParser {
+ public:
+    /**
+     * @brief Description of a column
+     * name Name of the column, for documentation and debugging
+     * width Width in bytes for fixed width files, unused for CSV files.
+     *       The last column extends to the end of the line.
+     **/
+    struct Column {
+        const char *name;
+        int width;
+    };
+
+    /**
+     * @brief View on one field of the current row.
+     * It points into the file contents and stays valid as long as the parser.
+     **/
+    class Field {
+     public:
+        Field() : begin_(0), end_(0) {}
+        Field(const char *begin, const char *end) : begin_(begin), end_(end) {}
+
+        bool isEmpty() const { return begin_ == end_; }
+        int size() const { return int(end_ - begin_); }
+        const char *data() const { return begin_; }
+
+        /** @return the field without leading and trailing spaces */
+        Field trimmed() const;
+
+        /** @return the field decoded from UTF-8 */
+        QString toString() const;
+
+        /** @return the field as an integer, or 0 if it is not one */
+        int toInt(bool *ok = 0) const;
+
+        /**
+         * @return the field as a double, or 0.0 if it is not a number.
+         * The conversion does not depend on the locale, and is at most one
+         * unit in the last place away from QString::toDouble().
+         **/
+        double toDouble(bool *ok = 0) const;
+
+        /** @return the field as a float, or 0.0 if it is not a number */
+        float toFloat(bool *ok = 0) const { return float(toDouble(ok)); }
+
+        /** @return true if the field is exactly @p text */
+        bool operator==(const char *text) const;
+        bool operator!=(const char *text) const { return !(*this == text); }
+
+     private:
+        const char *begin_;
+        const char *end_;
+    };
+
+    /**
+     * @brief Open a CSV file.
+     * Fields starting with a quote extend to the next quote followed by the
+     * delimiter or the end of the line, and the quotes are removed.
+     *
+     * @param filename Full Path (Dir + Filename) of source file
+     * @param comment_char Character signifying a comment line
+     * @param columns Description of the @p column_count columns
+     * @param delimiter Character separating the fields
+     **/
+    KSRowParser(const QString &filename, const char comment_char,
+                const Column *columns, int column_count, const char delimiter);
+
+    /**
+     * @brief Open a fixed width file, with the widths of @p columns.
+     * Fields are trimmed, and lines shorter than all the columns but the last
+     * are skipped.
+     **/
+    KSRowParser(const QString &filename, const char comment_char,
+                const Column *columns, int column_count);
+
+    ~KSRowParser();
+
+    /** @return true if the file could be read */
+    bool IsOpen() const { return begin_ != 0; }
+
+    /**
+     * @brief Read the next valid row.
+     * @return false at the end of the file
+     **/
+    bool ReadNextRow();
+
+    /** @return field @p column of the current row */
+    const Field &operator[](int column) const { return fields_[column]; }
+
+    /** @return the number of columns */
+    int ColumnCount() const { return fields_.size(); }
+
+ private:
+    void Open(const QString &filename);
+    bool SplitCSV(const char *line, const char *line_end);
+    bool SplitFixedWidth(const char *line, const char *line_end);
+
+    QFile file_;
+    QByteArray buffer_;  // File contents if it cannot be mapped
+    const char *begin_;
+    const char *end_;
+    const char *pos_;
+
+    const Column *columns_;
+    QVector<Field> fields_;
+    char comment_char_;
+    char delimiter_;
+    bool fixed_width_;
+    int min_length_;
+};
+
+#endif  // KSTARS_KSROWPARSER_H
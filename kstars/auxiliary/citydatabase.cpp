@@ -0,0 +1,459 @@
+/*  City Database
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#include "citydatabase.h"
+
+#include "geolocation.h"
+#include "kspaths.h"
+
+#include <KLocalizedString>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QDebug>
+
+// Layout of the index database, bump when the tables change
+#define CITY_INDEX_VERSION  1
+#define CITY_COLUMNS        "id, Name, Province, Country, Latitude, Longitude, TZ, TZRule, ReadOnly"
+
+CityDatabase::CityDatabase( QMap<QString, TimeZoneRule> *rulebook ) : m_Rulebook( rulebook ), m_AllLoaded( false )
+{
+}
+
+CityDatabase::~CityDatabase()
+{
+    qDeleteAll( m_Locations );
+}
+
+QString CityDatabase::fingerprint() const
+{
+    QStringList parts;
+    parts << QString::number( CITY_INDEX_VERSION ) << KLocalizedString::languages().join( ',' );
+
+    QStringList files;
+    files << KSPaths::locate( QStandardPaths::GenericDataLocation, "citydb.sqlite" )
+          << KSPaths::writableLocation( QStandardPaths::GenericDataLocation ) + "mycitydb.sqlite";
+
+    foreach( const QString &file, files )
+    {
+        QFileInfo info( file );
+        if ( info.exists() )
+            parts << info.absoluteFilePath() << QString::number( info.size() ) << QString::number( info.lastModified().toMSecsSinceEpoch() );
+        else
+            parts << "-";
+    }
+
+    return parts.join( '|' );
+}
+
+bool CityDatabase::open()
+{
+    QSqlDatabase citydb = QSqlDatabase::addDatabase( "QSQLITE", "citydb" );
+    QString dbfile = KSPaths::locate( QStandardPaths::GenericDataLocation, "citydb.sqlite" );
+    citydb.setDatabaseName( dbfile );
+
+    // The dialogs write new cities through this connection
+    QSqlDatabase mycitydb = QSqlDatabase::addDatabase( "QSQLITE", "mycitydb" );
+    mycitydb.setDatabaseName( KSPaths::writableLocation( QStandardPaths::GenericDataLocation ) + "mycitydb.sqlite" );
+
+    QDir().mkpath( KSPaths::writableLocation( QStandardPaths::CacheLocation ) );
+    QSqlDatabase index = QSqlDatabase::addDatabase( "QSQLITE", "cityindex" );
+    index.setDatabaseName( KSPaths::writableLocation( QStandardPaths::CacheLocation ) + "cityindex.sqlite" );
+    if ( index.open() == false )
+    {
+        qWarning() << "Unable to open city index" << index.databaseName() << index.lastError().text();
+        return false;
+    }
+
+    QString print = fingerprint();
+
+    QSqlQuery query( index );
+    if ( query.exec( "SELECT value FROM meta WHERE key = 'fingerprint'" ) == false || query.next() == false
+            || query.value( 0 ).toString() != print )
+    {
+        query.finish();
+        if ( rebuild( print ) == false )
+            return false;
+    }
+
+    query.finish();
+    if ( query.exec( "SELECT COUNT(*) FROM city" ) == false || query.next() == false )
+    {
+        qDebug() << query.lastError();
+        return false;
+    }
+
+    return query.value( 0 ).toInt() > 0;
+}
+
+bool CityDatabase::rebuild( const QString &print )
+{
+    qDebug() << "Rebuilding city index";
+
+    QSqlDatabase index = QSqlDatabase::database( "cityindex" );
+    QSqlQuery query( index );
+
+    index.transaction();
+
+    QStringList statements;
+    statements << "DROP TABLE IF EXISTS city"
+               << "DROP TABLE IF EXISTS meta"
+               << "CREATE TABLE city ( "
+                  "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+                  "Name TEXT, Province TEXT, Country TEXT, "
+                  "Latitude REAL, Longitude REAL, TZ REAL, TZRule TEXT, ReadOnly INTEGER, "
+                  "FullName TEXT, NameKey TEXT, ProvinceKey TEXT, CountryKey TEXT)"
+               << "CREATE TABLE meta ( key TEXT PRIMARY KEY, value TEXT )";
+
+    foreach( const QString &statement, statements )
+    {
+        if ( query.exec( statement ) == false )
+        {
+            qWarning() << query.lastError();
+            index.rollback();
+            return false;
+        }
+    }
+
+    QSqlQuery insert( index );
+    insert.prepare( "INSERT INTO city(Name, Province, Country, Latitude, Longitude, TZ, TZRule, ReadOnly, FullName, NameKey, ProvinceKey, CountryKey) "
+                    "VALUES(:Name, :Province, :Country, :Latitude, :Longitude, :TZ, :TZRule, :ReadOnly, :FullName, :NameKey, :ProvinceKey, :CountryKey)" );
+
+    if ( copyCities( "citydb", true, insert ) == false )
+    {
+        index.rollback();
+        return false;
+    }
+
+    // The user's cities are optional
+    if ( QFile::exists( QSqlDatabase::database( "mycitydb", false ).databaseName() ) )
+        copyCities( "mycitydb", false, insert );
+
+    // Indexes are faster to build after the rows are in
+    statements.clear();
+    statements << "CREATE INDEX city_fullname ON city(FullName)"
+               << "CREATE INDEX city_name ON city(NameKey)"
+               << "CREATE INDEX city_province ON city(ProvinceKey)"
+               << "CREATE INDEX city_country ON city(CountryKey)"
+               << "CREATE INDEX city_position ON city(Latitude, Longitude)";
+
+    foreach( const QString &statement, statements )
+    {
+        if ( query.exec( statement ) == false )
+        {
+            qWarning() << query.lastError();
+            index.rollback();
+            return false;
+        }
+    }
+
+    query.prepare( "INSERT INTO meta(key, value) VALUES('fingerprint', :value)" );
+    query.bindValue( ":value", print );
+    if ( query.exec() == false )
+    {
+        qWarning() << query.lastError();
+        index.rollback();
+        return false;
+    }
+
+    return index.commit();
+}
+
+bool CityDatabase::copyCities( const QString &connection, bool readOnly, QSqlQuery &insert )
+{
+    QSqlDatabase source = QSqlDatabase::database( connection, false );
+    if ( source.open() == false )
+    {
+        qWarning() << "Unable to open city database file " << source.databaseName() << source.lastError().text();
+        return false;
+    }
+
+    bool rc = true;
+
+    {
+        QSqlQuery get_query( source );
+        if ( get_query.exec( "SELECT * FROM city" ) == false )
+        {
+            qDebug() << get_query.lastError();
+            rc = false;
+        }
+
+        while ( rc && get_query.next() )
+        {
+            GeoLocation location( dms( get_query.value(5).toString() ), dms( get_query.value(4).toString() ),
+                                  get_query.value(1).toString(), get_query.value(2).toString(), get_query.value(3).toString(),
+                                  get_query.value(6).toDouble(), &( (*m_Rulebook)[ get_query.value(7).toString() ] ), readOnly );
+
+            bindCity( insert, location );
+            insert.bindValue( ":TZRule", get_query.value(7).toString() );
+
+            if ( insert.exec() == false )
+            {
+                qWarning() << insert.lastError();
+                rc = false;
+            }
+        }
+    }
+
+    source.close();
+    return rc;
+}
+
+void CityDatabase::bindCity( QSqlQuery &query, const GeoLocation &location )
+{
+    query.bindValue( ":Name", location.name() );
+    query.bindValue( ":Province", location.province() );
+    query.bindValue( ":Country", location.country() );
+    query.bindValue( ":Latitude", location.lat()->Degrees() );
+    query.bindValue( ":Longitude", location.lng()->Degrees() );
+    query.bindValue( ":TZ", location.TZ0() );
+    query.bindValue( ":ReadOnly", location.isReadOnly() ? 1 : 0 );
+    query.bindValue( ":FullName", location.fullName() );
+    query.bindValue( ":NameKey", location.translatedName().toLower() );
+    query.bindValue( ":ProvinceKey", location.translatedProvince().toLower() );
+    query.bindValue( ":CountryKey", location.translatedCountry().toLower() );
+}
+
+QString CityDatabase::prefixCondition( const QString &city, const QString &province, const QString &country, QVariantList &values )
+{
+    QStringList conditions;
+    QStringList columns, prefixes;
+    columns << "NameKey" << "ProvinceKey" << "CountryKey";
+    prefixes << city << province << country;
+
+    for ( int i=0; i < columns.size(); i++ )
+    {
+        if ( prefixes[i].isEmpty() )
+            continue;
+
+        // A range on the key can use its index, unlike LIKE
+        QString key = prefixes[i].toLower();
+        conditions << QString( "%1 >= ? AND %1 < ?" ).arg( columns[i] );
+        values << key << QString( key + QChar( 0xFFFF ) );
+    }
+
+    if ( conditions.isEmpty() )
+        return QString();
+
+    return " WHERE " + conditions.join( " AND " );
+}
+
+QList<GeoLocation *> CityDatabase::locations( QSqlQuery &query )
+{
+    QList<GeoLocation *> result;
+
+    while ( query.next() )
+    {
+        qint64 id = query.value(0).toLongLong();
+        GeoLocation *location = m_Locations.value( id );
+
+        if ( location == NULL )
+        {
+            location = new GeoLocation( dms( query.value(5).toDouble() ), dms( query.value(4).toDouble() ),
+                                        query.value(1).toString(), query.value(2).toString(), query.value(3).toString(),
+                                        query.value(6).toDouble(), &( (*m_Rulebook)[ query.value(7).toString() ] ),
+                                        query.value(8).toInt() != 0 );
+            m_Locations.insert( id, location );
+            m_Ids.insert( location, id );
+        }
+
+        result.append( location );
+    }
+
+    return result;
+}
+
+int CityDatabase::count( const QString &city, const QString &province, const QString &country )
+{
+    QVariantList values;
+    QSqlQuery query( QSqlDatabase::database( "cityindex" ) );
+    query.prepare( "SELECT COUNT(*) FROM city" + prefixCondition( city, province, country, values ) );
+    foreach( const QVariant &value, values )
+        query.addBindValue( value );
+
+    if ( query.exec() == false || query.next() == false )
+    {
+        qWarning() << query.lastError();
+        return 0;
+    }
+
+    return query.value( 0 ).toInt();
+}
+
+QList<GeoLocation *> CityDatabase::find( const QString &city, const QString &province, const QString &country, int offset, int limit )
+{
+    QVariantList values;
+    QSqlQuery query( QSqlDatabase::database( "cityindex" ) );
+    query.prepare( "SELECT " CITY_COLUMNS " FROM city" + prefixCondition( city, province, country, values ) +
+                   " ORDER BY FullName LIMIT ? OFFSET ?" );
+    foreach( const QVariant &value, values )
+        query.addBindValue( value );
+    query.addBindValue( limit );
+    query.addBindValue( offset );
+
+    if ( query.exec() == false )
+    {
+        qWarning() << query.lastError();
+        return QList<GeoLocation *>();
+    }
+
+    return locations( query );
+}
+
+QList<GeoLocation *> CityDatabase::findNear( double longitude, double latitude, double radius )
+{
+    QSqlQuery query( QSqlDatabase::database( "cityindex" ) );
+    query.prepare( "SELECT " CITY_COLUMNS " FROM city WHERE Latitude > :minLat AND Latitude < :maxLat "
+                   "AND Longitude > :minLng AND Longitude < :maxLng ORDER BY FullName" );
+    query.bindValue( ":minLat", latitude - radius );
+    query.bindValue( ":maxLat", latitude + radius );
+    query.bindValue( ":minLng", longitude - radius );
+    query.bindValue( ":maxLng", longitude + radius );
+
+    if ( query.exec() == false )
+    {
+        qWarning() << query.lastError();
+        return QList<GeoLocation *>();
+    }
+
+    return locations( query );
+}
+
+int CityDatabase::position( const QString &fullName )
+{
+    QSqlQuery query( QSqlDatabase::database( "cityindex" ) );
+    query.prepare( "SELECT COUNT(*) FROM city WHERE FullName < :FullName" );
+    query.bindValue( ":FullName", fullName );
+
+    if ( query.exec() == false || query.next() == false )
+        return -1;
+
+    return query.value( 0 ).toInt();
+}
+
+GeoLocation * CityDatabase::locationNamed( const QString &city, const QString &province, const QString &country )
+{
+    QSqlQuery query( QSqlDatabase::database( "cityindex" ) );
+    query.prepare( "SELECT " CITY_COLUMNS " FROM city WHERE NameKey = :NameKey ORDER BY id" );
+    query.bindValue( ":NameKey", city.toLower() );
+
+    if ( query.exec() == false )
+    {
+        qWarning() << query.lastError();
+        return NULL;
+    }
+
+    // Keys ignore case, names must match exactly
+    foreach( GeoLocation *location, locations( query ) )
+    {
+        if ( location->translatedName() == city &&
+                ( province.isEmpty() || location->translatedProvince() == province ) &&
+                ( country.isEmpty() || location->translatedCountry() == country ) )
+            return location;
+    }
+
+    return NULL;
+}
+
+const QVector<QPointF> & CityDatabase::positions()
+{
+    if ( m_Positions.isEmpty() )
+    {
+        QSqlQuery query( QSqlDatabase::database( "cityindex" ) );
+        if ( query.exec( "SELECT Longitude, Latitude FROM city" ) )
+        {
+            while ( query.next() )
+                m_Positions.append( QPointF( query.value(0).toDouble(), query.value(1).toDouble() ) );
+        }
+    }
+
+    return m_Positions;
+}
+
+QList<GeoLocation *> & CityDatabase::allCities()
+{
+    if ( m_AllLoaded == false )
+    {
+        m_AllCities = find( QString(), QString(), QString() );
+        m_AllLoaded = true;
+    }
+
+    return m_AllCities;
+}
+
+GeoLocation * CityDatabase::addCity( const GeoLocation &location, const QString &ruleName )
+{
+    QSqlDatabase index = QSqlDatabase::database( "cityindex" );
+    QSqlQuery query( index );
+    query.prepare( "INSERT INTO city(Name, Province, Country, Latitude, Longitude, TZ, TZRule, ReadOnly, FullName, NameKey, ProvinceKey, CountryKey) "
+                   "VALUES(:Name, :Province, :Country, :Latitude, :Longitude, :TZ, :TZRule, :ReadOnly, :FullName, :NameKey, :ProvinceKey, :CountryKey)" );
+    bindCity( query, location );
+    query.bindValue( ":TZRule", ruleName );
+
+    if ( query.exec() == false )
+    {
+        qWarning() << query.lastError();
+        return NULL;
+    }
+
+    GeoLocation *city = new GeoLocation( location );
+    qint64 id = query.lastInsertId().toLongLong();
+    m_Locations.insert( id, city );
+    m_Ids.insert( city, id );
+
+    if ( m_AllLoaded )
+        m_AllCities.append( city );
+    m_Positions.clear();
+
+    return city;
+}
+
+void CityDatabase::updateCity( GeoLocation *location, const QString &ruleName )
+{
+    if ( m_Ids.contains( location ) == false )
+        return;
+
+    QSqlQuery query( QSqlDatabase::database( "cityindex" ) );
+    query.prepare( "UPDATE city SET Name = :Name, Province = :Province, Country = :Country, Latitude = :Latitude, Longitude = :Longitude, "
+                   "TZ = :TZ, TZRule = :TZRule, ReadOnly = :ReadOnly, FullName = :FullName, NameKey = :NameKey, ProvinceKey = :ProvinceKey, "
+                   "CountryKey = :CountryKey WHERE id = :id" );
+    bindCity( query, *location );
+    query.bindValue( ":TZRule", ruleName );
+    query.bindValue( ":id", m_Ids.value( location ) );
+
+    if ( query.exec() == false )
+        qWarning() << query.lastError();
+
+    m_Positions.clear();
+}
+
+void CityDatabase::removeCity( GeoLocation *location )
+{
+    if ( m_Ids.contains( location ) )
+    {
+        qint64 id = m_Ids.take( location );
+        m_Locations.remove( id );
+
+        QSqlQuery query( QSqlDatabase::database( "cityindex" ) );
+        query.prepare( "DELETE FROM city WHERE id = :id" );
+        query.bindValue( ":id", id );
+        if ( query.exec() == false )
+            qWarning() << query.lastError();
+    }
+
+    m_AllCities.removeOne( location );
+    m_Positions.clear();
+    delete location;
+}
@@ -0,0 +1,117 @@
+/*  City Database
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef CITYDATABASE_H
+#define CITYDATABASE_H
+
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QPointF>
+#include <QString>
+#include <QVariant>
+#include <QVector>
+
+class GeoLocation;
+class QSqlQuery;
+class TimeZoneRule;
+
+/**
+ *@class CityDatabase
+ *@short Indexed queries on the cities of citydb.sqlite and mycitydb.sqlite.
+ *
+ * The cities of both databases are copied once into an index database in the cache directory, with coordinates in degrees
+ * and lower case translated names. Its indexes serve name prefix searches, exact name lookups and searches by position. The
+ * index is rebuilt whenever either city database or the translation language changes.
+ *
+ * GeoLocation objects are only created for the cities a query returns, and each city is created once. The database owns
+ * them, they stay valid until the city is removed or the database is destroyed.
+ *@version 1.0
+ */
+class CityDatabase
+{
+public:
+
+    explicit CityDatabase( QMap<QString, TimeZoneRule> *rulebook );
+    ~CityDatabase();
+
+    /**
+     * @brief open Open the city databases and rebuild the index if they changed.
+     * @return true if at least one city is available.
+     */
+    bool open();
+
+    /** @return number of cities whose translated name, province and country start with the given texts, ignoring case */
+    int count( const QString &city, const QString &province, const QString &country );
+
+    /**
+     * @brief find Find the cities whose translated name, province and country start with the given texts, ignoring case.
+     * @param offset number of matching cities to skip
+     * @param limit maximum number of cities to return, -1 for all
+     * @return matching cities sorted by full name
+     */
+    QList<GeoLocation *> find( const QString &city, const QString &province, const QString &country, int offset=0, int limit=-1 );
+
+    /** @return cities less than radius degrees of longitude and latitude away from a position, sorted by full name */
+    QList<GeoLocation *> findNear( double longitude, double latitude, double radius );
+
+    /** @return position of the city with this full name among all cities sorted by full name */
+    int position( const QString &fullName );
+
+    /** @return city with this translated name, and province and country unless they are empty, or NULL */
+    GeoLocation * locationNamed( const QString &city, const QString &province=QString(), const QString &country=QString() );
+
+    /** @return longitude (x) and latitude (y) of all cities in degrees */
+    const QVector<QPointF> & positions();
+
+    /** @return all cities sorted by full name. They are all created on the first call, prefer the queries above. */
+    QList<GeoLocation *> & allCities();
+
+    /**
+     * @brief addCity Add a city that was saved in the user's city database.
+     * @param ruleName name of the daylight saving time rule of the city
+     * @return the new city, owned by the database, or NULL if it could not be inserted
+     */
+    GeoLocation * addCity( const GeoLocation &location, const QString &ruleName );
+
+    /** Store the changed fields of a city that was updated in the user's city database. */
+    void updateCity( GeoLocation *location, const QString &ruleName );
+
+    /** Remove and delete a city that was removed from the user's city database. */
+    void removeCity( GeoLocation *location );
+
+private:
+
+    /** @return identification of the city databases and language the index is built from */
+    QString fingerprint() const;
+
+    bool rebuild( const QString &print );
+
+    /** Copy the cities of one source database into the index. */
+    bool copyCities( const QString &connection, bool readOnly, QSqlQuery &insert );
+
+    /** Bind the fields of location to insert or update its index row. */
+    static void bindCity( QSqlQuery &query, const GeoLocation &location );
+
+    /** @return query selecting the index rows that match the prefixes, with the values to bind to it */
+    static QString prefixCondition( const QString &city, const QString &province, const QString &country, QVariantList &values );
+
+    /** @return cities of an executed query selecting CITY_COLUMNS */
+    QList<GeoLocation *> locations( QSqlQuery &query );
+
+    QMap<QString, TimeZoneRule> *m_Rulebook;
+
+    QHash<qint64, GeoLocation *> m_Locations;
+    QHash<GeoLocation *, qint64> m_Ids;
+    QList<GeoLocation *> m_AllCities;
+    bool m_AllLoaded;
+    QVector<QPointF> m_Positions;
+};
+
+#endif // CITYDATABASE_H
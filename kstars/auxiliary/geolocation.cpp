@@ -156,7 +156,7 @@ void GeoLocation::TopocentricVelocity(double vtopo[], dms gst) {
     vtopo[2] = 0.;
 }
 
-double GeoLocation::LMST( double jd )
+double GeoLocation::LMST( double jd ) const
 {
     int divresult;
     double ut, tu, gmst, theta;
@@ -257,7 +257,7 @@ public:
     /** @Return Local Mean Sidereal Time.
      * @param jd Julian date
      */
-    double LMST( double jd );
+    double LMST( double jd ) const;
 
     bool isReadOnly() const;
     void setReadOnly(bool value);
@@ -21,16 +21,21 @@
 #include "kstars.h"
 #include "skyqpainter.h"
 #include "skymap.h"
+#include "tiledimagerenderer.h"
 
 #include <KJob>
 #include <KIO/StoredTransferJob>
 
 /* Qt Includes */
+#include <QPicture>
 #include <QTemporaryFile>
 #include <QStatusBar>
 #include <QtSvg/QSvgGenerator>
 
-ImageExporter::ImageExporter( QObject *parent ) : QObject( parent ), m_includeLegend( false ), m_Size( 0 )
+// Raster images larger than this many pixels are rendered in tiles
+#define TILED_EXPORT_PIXELS     ( 4096 * 4096 )
+
+ImageExporter::ImageExporter( QObject *parent ) : QObject( parent ), m_includeLegend( false ), m_tiledExport( false ), m_Size( 0 )
 {
     m_Legend = new Legend;
 
@@ -97,6 +102,11 @@ bool ImageExporter::exportRasterGraphics(const QString &fileName)
         height = map->height();
     }
 
+    if ( m_tiledExport || qint64( width ) * height > TILED_EXPORT_PIXELS )
+    {
+        return exportTiledRasterGraphics(fileName, format, QSize(width, height));
+    }
+
     QPixmap skyimage(map->width(), map->height());
     QPixmap outimage(width, height);
     outimage.fill();
@@ -164,6 +174,46 @@ bool ImageExporter::exportRasterGraphics(const QString &fileName)
         return true;
     }
 }
+
+bool ImageExporter::exportTiledRasterGraphics(const QString &fileName, const char *format, const QSize &size)
+{
+    SkyMap *map = SkyMap::Instance();
+    QRect mapRect(0, 0, map->width(), map->height());
+
+    // Record the sky image once, so that the labels are placed over the whole map as in a single pass
+    QPicture skyimage;
+    skyimage.setBoundingRect(mapRect);
+    map->exportSkyImage(&skyimage);
+    qApp->processEvents();
+
+    // Center the sky image as exportRasterGraphics() does: cropped if the image is smaller, padded with white if it is larger
+    QPoint offset((size.width() - map->width())/2, (size.height() - map->height())/2);
+
+    TiledImageRenderer renderer(size);
+    renderer.addLayer(skyimage, offset, mapRect.translated(offset));
+
+    if( m_includeLegend )
+    {
+        QPicture legend;
+        legend.setBoundingRect(QRect(QPoint(), size));
+        addLegend(&legend);
+        renderer.addLayer(legend);
+    }
+
+    if(!renderer.save(fileName, format))
+    {
+        m_lastErrorMessage = i18n("Error: Unable to save image: %1 ", fileName);
+        qDebug() << m_lastErrorMessage;
+        return false;
+    }
+
+    else
+    {
+        KStars::Instance()->statusBar()->showMessage(i18n ("Saved image to %1", fileName));
+        return true;
+    }
+}
+
 void ImageExporter::addLegend(SkyQPainter *painter)
 {
     m_Legend->paintLegend(painter);
@@ -78,6 +78,13 @@ public Q_SLOTS:
      */
     inline void includeLegend( bool include ) { m_includeLegend = include; }
 
+    /**
+     * @short Render raster images in tiles?
+     * @param tiled The sky image will be recorded once, then rendered concurrently in tiles and saved band by band, if the flag is set to true
+     * @note Raster images larger than 4096x4096 pixels are always rendered in tiles.
+     */
+    inline void setTiledExport( bool tiled ) { m_tiledExport = tiled; }
+
     /**
      * @short Set legend transparency
      * @param alpha Transparency level
@@ -99,10 +106,12 @@ public Q_SLOTS:
 private:
     void exportSvg(const QString &fileName);
     bool exportRasterGraphics(const QString &fileName);
+    bool exportTiledRasterGraphics(const QString &fileName, const char *format, const QSize &size);
     void addLegend(SkyQPainter *painter);
     void addLegend(QPaintDevice *pd);
 
     bool m_includeLegend;
+    bool m_tiledExport;
     Legend *m_Legend;
     QSize *m_Size;
     QString m_lastErrorMessage;
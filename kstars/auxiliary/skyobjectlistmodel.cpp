@@ -16,9 +16,13 @@
 
 #include "skyobjectlistmodel.h"
 #include "skyobject.h"
+#include "skyobjectsearchindex.h"
+
+// Number of search results passed on to views at a time
+#define SEARCH_RESULT_BATCH 500
 
 SkyObjectListModel::SkyObjectListModel(QObject *parent)
-    :QAbstractListModel(parent)
+    :QAbstractListModel(parent), searchIndex(0), fetchedRows(0)
 {
 
 }
@@ -30,9 +34,16 @@ QHash<int, QByteArray> SkyObjectListModel::roleNames() const {
     return roles;
 }
 
+const QPair<QString, const SkyObject *> & SkyObjectListModel::entry(int row) const {
+    if(searchIndex) {
+        return searchIndex->entry(searchRows[row]);
+    }
+    return skyObjects[row];
+}
+
 int SkyObjectListModel::indexOf(QString objectName) const {
-    for(int i = 0; i < skyObjects.size(); ++i) {
-        if(skyObjects[i].first == objectName) {
+    for(int i = 0; i < entryCount(); ++i) {
+        if(entry(i).first == objectName) {
             return i;
         }
     }
@@ -44,18 +55,46 @@ QVariant SkyObjectListModel::data(const QModelIndex &index, int role) const {
         return QVariant();
     }
     if(role == Qt::DisplayRole) {
-        return QVariant(skyObjects[index.row()].first);
+        return QVariant(entry(index.row()).first);
     } else if(role == SkyObjectRole) {
-        return qVariantFromValue((void *) skyObjects[index.row()].second);
+        return qVariantFromValue((void *) entry(index.row()).second);
     }
     return QVariant();
 }
 
+bool SkyObjectListModel::canFetchMore(const QModelIndex &parent) const {
+    if(parent.isValid() || !searchIndex) {
+        return false;
+    }
+    return fetchedRows < searchRows.size();
+}
+
+void SkyObjectListModel::fetchMore(const QModelIndex &parent) {
+    if(canFetchMore(parent)) {
+        fetchUpTo(fetchedRows + SEARCH_RESULT_BATCH - 1);
+    }
+}
+
+void SkyObjectListModel::fetchUpTo(int row) {
+    if(!searchIndex || row < fetchedRows) {
+        return;
+    }
+
+    int last = qMin(row, searchRows.size() - 1);
+    if(last < fetchedRows) {
+        return;
+    }
+
+    beginInsertRows(QModelIndex(), fetchedRows, last);
+    fetchedRows = last + 1;
+    endInsertRows();
+}
+
 QStringList SkyObjectListModel::filter(QRegExp regEx) {
     QStringList filteredList;
-    for(int i = 0; i < skyObjects.size(); ++i) {
-        if(regEx.exactMatch(skyObjects[i].first)) {
-            filteredList.append(skyObjects[i].first);
+    for(int i = 0; i < entryCount(); ++i) {
+        if(regEx.exactMatch(entry(i).first)) {
+            filteredList.append(entry(i).first);
         }
     }
     return filteredList;
@@ -64,6 +103,19 @@ QStringList SkyObjectListModel::filter(QRegExp regEx) {
 void SkyObjectListModel::setSkyObjectsList(QVector<QPair<QString, const SkyObject *>> sObjects) {
     emit beginResetModel();
     skyObjects = sObjects;
+    searchIndex = 0;
+    searchRows.clear();
+    fetchedRows = 0;
+
+    emit endResetModel();
+}
+
+void SkyObjectListModel::setSearchResults(const SkyObjectSearchIndex *index, const QVector<int> &rows) {
+    emit beginResetModel();
+    skyObjects.clear();
+    searchIndex = index;
+    searchRows = rows;
+    fetchedRows = qMin(rows.size(), SEARCH_RESULT_BATCH);
 
     emit endResetModel();
 }
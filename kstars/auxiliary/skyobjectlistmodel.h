@@ -21,6 +21,7 @@
 #include <QDebug>
 
 class SkyObject;
+class SkyObjectSearchIndex;
 
 /** @class SkyObjectListModel
  * A model used in Find Object Dialog in QML. Each entry is a QString (name of object) and pointer to
@@ -39,9 +40,12 @@ public:
 
     explicit SkyObjectListModel(QObject *parent = 0);
 
-    virtual int rowCount(const QModelIndex&) const { return skyObjects.size(); }
+    virtual int rowCount(const QModelIndex&) const { return searchIndex ? fetchedRows : skyObjects.size(); }
     virtual QVariant data(const QModelIndex &index, int role) const;
 
+    virtual bool canFetchMore(const QModelIndex &parent) const;
+    virtual void fetchMore(const QModelIndex &parent);
+
     virtual QHash<int, QByteArray> roleNames() const;
 
     /**
@@ -59,8 +63,29 @@ public:
 
     void setSkyObjectsList(QVector<QPair<QString, const SkyObject *>> sObjects);
 
+    /**
+     * @short Show the rows of a search index found by a search.
+     * Rows are passed on to views in batches as they scroll, so large results are shown without delay.
+     * The index must stay valid until another list or result is set.
+     * @param index search index the rows refer to
+     * @param rows rows of index to show, in display order
+     */
+    void setSearchResults(const SkyObjectSearchIndex *index, const QVector<int> &rows);
+
+    /**
+     * @short Make sure a row of the search results is passed on to views.
+     * @param row row of the model, i.e. position in the search results
+     */
+    void fetchUpTo(int row);
+
 private:
+    const QPair<QString, const SkyObject *> & entry(int row) const;
+    int entryCount() const { return searchIndex ? searchRows.size() : skyObjects.size(); }
+
     QVector<QPair<QString, const SkyObject *>> skyObjects;
+    const SkyObjectSearchIndex *searchIndex;
+    QVector<int> searchRows;
+    int fetchedRows;
 };
 
 #endif
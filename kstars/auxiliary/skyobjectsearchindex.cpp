@@ -0,0 +1,148 @@
+/*  Sky Object Search Index
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#include "skyobjectsearchindex.h"
+
+#include <algorithm>
+
+SkyObjectSearchIndex::SkyObjectSearchIndex(const QVector<Entry> &objects)
+{
+    QVector<QString> keys;
+    keys.reserve(objects.count());
+    foreach(const Entry &oneEntry, objects)
+        keys.append(oneEntry.first.toCaseFolded());
+
+    QVector<int> order(objects.count());
+    for (int i=0; i < order.count(); i++)
+        order[i] = i;
+
+    std::stable_sort(order.begin(), order.end(), [&keys, &objects](int a, int b)
+    {
+        int rc = keys[a].compare(keys[b]);
+        if (rc != 0)
+            return rc < 0;
+        return objects[a].first < objects[b].first;
+    });
+
+    m_Entries.reserve(objects.count());
+    m_Keys.reserve(objects.count());
+
+    foreach(int i, order)
+    {
+        // The same object is often listed twice under the same name
+        if (m_Entries.isEmpty() == false && m_Entries.last() == objects[i])
+            continue;
+
+        m_Entries.append(objects[i]);
+        m_Keys.append(keys[i]);
+    }
+
+    for (int row=0; row < m_Keys.count(); row++)
+    {
+        const QString &key = m_Keys[row];
+        for (int i=0; i + 3 <= key.size(); i++)
+        {
+            QVector<int> &rows = m_Trigrams[trigram(key.constData() + i)];
+            // A name may contain the same trigram more than once
+            if (rows.isEmpty() || rows.last() != row)
+                rows.append(row);
+        }
+    }
+}
+
+QVector<int> SkyObjectSearchIndex::search(const QString &text, const QVector<int> *previous) const
+{
+    QString key = text.toCaseFolded();
+    QVector<int> result;
+
+    if (previous)
+    {
+        foreach(int row, *previous)
+        {
+            if (m_Keys[row].contains(key))
+                result.append(row);
+        }
+
+        return result;
+    }
+
+    if (key.isEmpty())
+    {
+        result.resize(m_Keys.count());
+        for (int row=0; row < result.count(); row++)
+            result[row] = row;
+        return result;
+    }
+
+    if (key.size() < 3)
+    {
+        for (int row=0; row < m_Keys.count(); row++)
+        {
+            if (m_Keys[row].contains(key))
+                result.append(row);
+        }
+
+        return result;
+    }
+
+    // Only names that contain every trigram of the key can match, check those of the rarest one
+    const QVector<int> *candidates = NULL;
+    for (int i=0; i + 3 <= key.size(); i++)
+    {
+        QHash<quint64, QVector<int> >::const_iterator it = m_Trigrams.constFind(trigram(key.constData() + i));
+        if (it == m_Trigrams.constEnd())
+            return result;
+
+        if (candidates == NULL || it.value().count() < candidates->count())
+            candidates = &it.value();
+    }
+
+    foreach(int row, *candidates)
+    {
+        if (key.size() == 3 || m_Keys[row].contains(key))
+            result.append(row);
+    }
+
+    return result;
+}
+
+int SkyObjectSearchIndex::lowerBound(const QString &key) const
+{
+    return std::lower_bound(m_Keys.constBegin(), m_Keys.constEnd(), key) - m_Keys.constBegin();
+}
+
+int SkyObjectSearchIndex::firstPrefixMatch(const QString &text) const
+{
+    QString key = text.toCaseFolded();
+    int row = lowerBound(key);
+
+    if (row < m_Keys.count() && m_Keys[row].startsWith(key))
+        return row;
+
+    return -1;
+}
+
+bool SkyObjectSearchIndex::containsName(const QString &name) const
+{
+    QString key = name.toCaseFolded();
+
+    for (int row = lowerBound(key); row < m_Keys.count() && m_Keys[row] == key; row++)
+    {
+        if (m_Entries[row].first == name)
+            return true;
+    }
+
+    return false;
+}
+
+bool SkyObjectSearchIndex::narrows(const QString &text, const QString &previous)
+{
+    // Any name containing text then also contains previous
+    return text.toCaseFolded().contains(previous.toCaseFolded());
+}
@@ -0,0 +1,80 @@
+/*  Sky Object Search Index
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef SKYOBJECTSEARCHINDEX_H
+#define SKYOBJECTSEARCHINDEX_H
+
+#include <QHash>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+class SkyObject;
+
+/**
+ *@class SkyObjectSearchIndex
+ *@short Index of object names for substring searches as the user types.
+ *
+ * The names are sorted ignoring case, so rows are in display order and all names starting with a given text form one
+ * contiguous range that is found by binary search. Substring searches of three or more characters only check the names that
+ * contain every trigram of the search text. Searches for a text that extends the previous search text only check the previous
+ * results.
+ *
+ * The index refers to the objects, it must be rebuilt when they are deleted. See SkyMapComposite::objectListsRevision().
+ *@version 1.0
+ */
+class SkyObjectSearchIndex
+{
+public:
+
+    typedef QPair<QString, const SkyObject *> Entry;
+
+    explicit SkyObjectSearchIndex(const QVector<Entry> &objects);
+
+    /** @return number of names in the index */
+    int count() const { return m_Entries.count(); }
+
+    /** @return name and object of row, rows are sorted by name */
+    const Entry & entry(int row) const { return m_Entries[row]; }
+
+    /**
+     * @brief search Find all names containing text, ignoring case.
+     * @param text text to search for. An empty text matches all names.
+     * @param previous if not NULL, the result of an earlier search for a text that text contains. Only those rows are checked.
+     * @return matching rows in ascending order
+     */
+    QVector<int> search(const QString &text, const QVector<int> *previous=0) const;
+
+    /** @return first row whose name starts with text, ignoring case, or -1 */
+    int firstPrefixMatch(const QString &text) const;
+
+    /** @return true if the index contains exactly name, including case */
+    bool containsName(const QString &name) const;
+
+    /** @return true if a search for text may be narrowed down from the results of a search for previous */
+    static bool narrows(const QString &text, const QString &previous);
+
+private:
+
+    static quint64 trigram(const QChar *c)
+    {
+        return (static_cast<quint64>(c[0].unicode()) << 32) | (static_cast<quint64>(c[1].unicode()) << 16) | c[2].unicode();
+    }
+
+    /** @return first row whose key is not less than key */
+    int lowerBound(const QString &key) const;
+
+    QVector<Entry> m_Entries;
+    // Case folded names, in the same order
+    QVector<QString> m_Keys;
+    // Rows of the names containing each trigram, in ascending order
+    QHash<quint64, QVector<int> > m_Trigrams;
+};
+
+#endif // SKYOBJECTSEARCHINDEX_H
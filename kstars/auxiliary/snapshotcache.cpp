@@ -0,0 +1,193 @@
+/*  Catalog Snapshot Cache
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#include "snapshotcache.h"
+
+#include "kspaths.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDebug>
+
+#define SNAPSHOT_MAGIC      0x4B53534E  // "KSSN"
+// Layout of the snapshot header. Component payloads are versioned separately.
+#define SNAPSHOT_FORMAT     1
+
+SnapshotCache::SnapshotCache(const QString &name, quint32 version) : m_Name(name), m_Version(version)
+{
+    m_Map      = NULL;
+    m_Stream   = NULL;
+    m_SaveFile = NULL;
+}
+
+SnapshotCache::~SnapshotCache()
+{
+    close();
+
+    // A snapshot that was never committed is discarded
+    if (m_SaveFile)
+    {
+        delete m_Stream;
+        m_SaveFile->cancelWriting();
+        delete m_SaveFile;
+    }
+}
+
+void SnapshotCache::addSource(const QString &filename)
+{
+    m_Sources << filename;
+}
+
+void SnapshotCache::addKey(const QString &key)
+{
+    m_Keys << key;
+}
+
+QString SnapshotCache::fileName() const
+{
+    return KSPaths::writableLocation(QStandardPaths::CacheLocation) + m_Name + ".snapshot";
+}
+
+QByteArray SnapshotCache::fingerprint() const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    foreach(const QString &source, m_Sources)
+    {
+        QFileInfo info(source);
+        if (source.isEmpty() || info.exists() == false)
+            return QByteArray();
+
+        hash.addData(info.absoluteFilePath().toUtf8());
+        hash.addData(QByteArray::number(info.size()));
+        hash.addData(QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
+    }
+
+    foreach(const QString &key, m_Keys)
+        hash.addData(key.toUtf8());
+
+    return hash.result();
+}
+
+QDataStream * SnapshotCache::open()
+{
+    close();
+
+    QByteArray expected = fingerprint();
+    if (expected.isEmpty())
+        return NULL;
+
+    m_File.setFileName(fileName());
+    if (m_File.open(QIODevice::ReadOnly) == false)
+        return NULL;
+
+    m_Map = m_File.map(0, m_File.size());
+    if (m_Map == NULL)
+    {
+        close();
+        return NULL;
+    }
+
+    // The stream reads straight from the mapped pages, nothing is copied
+    m_Data   = QByteArray::fromRawData(reinterpret_cast<const char *>(m_Map), m_File.size());
+    m_Stream = new QDataStream(m_Data);
+    m_Stream->setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic=0, format=0, version=0;
+    QByteArray stored;
+
+    *m_Stream >> magic >> format >> version >> stored;
+
+    if (m_Stream->status() != QDataStream::Ok || magic != SNAPSHOT_MAGIC || format != SNAPSHOT_FORMAT || version != m_Version
+            || stored != expected)
+    {
+        qDebug() << "Snapshot" << m_Name << "is out of date.";
+        close();
+        return NULL;
+    }
+
+    return m_Stream;
+}
+
+void SnapshotCache::close()
+{
+    if (m_SaveFile)
+        return;
+
+    delete m_Stream;
+    m_Stream = NULL;
+    m_Data.clear();
+
+    if (m_Map)
+    {
+        m_File.unmap(m_Map);
+        m_Map = NULL;
+    }
+
+    m_File.close();
+}
+
+QDataStream * SnapshotCache::create()
+{
+    close();
+
+    QByteArray print = fingerprint();
+    if (print.isEmpty())
+        return NULL;
+
+    QDir().mkpath(QFileInfo(fileName()).absolutePath());
+
+    m_SaveFile = new QSaveFile(fileName());
+    if (m_SaveFile->open(QIODevice::WriteOnly) == false)
+    {
+        qWarning() << "Cannot write snapshot" << fileName() << m_SaveFile->errorString();
+        delete m_SaveFile;
+        m_SaveFile = NULL;
+        return NULL;
+    }
+
+    m_Stream = new QDataStream(m_SaveFile);
+    m_Stream->setVersion(QDataStream::Qt_5_0);
+
+    *m_Stream << static_cast<quint32>(SNAPSHOT_MAGIC) << static_cast<quint32>(SNAPSHOT_FORMAT) << m_Version << print;
+
+    return m_Stream;
+}
+
+bool SnapshotCache::commit()
+{
+    if (m_SaveFile == NULL)
+        return false;
+
+    bool rc = false;
+
+    if (m_Stream->status() == QDataStream::Ok)
+        rc = m_SaveFile->commit();
+    else
+        m_SaveFile->cancelWriting();
+
+    if (rc == false)
+        qWarning() << "Failed to write snapshot" << fileName();
+
+    delete m_Stream;
+    m_Stream = NULL;
+    delete m_SaveFile;
+    m_SaveFile = NULL;
+
+    return rc;
+}
+
+void SnapshotCache::remove()
+{
+    close();
+    QFile::remove(fileName());
+}
@@ -0,0 +1,95 @@
+/*  Catalog Snapshot Cache
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef SNAPSHOTCACHE_H
+#define SNAPSHOTCACHE_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QDataStream>
+#include <QFile>
+
+class QSaveFile;
+
+/**
+ *@class SnapshotCache
+ *@short Binary cache of data parsed from text catalogs.
+ *
+ * A component registers the source files it parses, and any other key its parsed data depends on (e.g. the sky mesh level),
+ * then tries open(). If a snapshot written from the very same sources exists, open() maps it into memory and returns a stream
+ * positioned at the payload, so the component can rebuild its objects without touching the text files. Otherwise the component
+ * parses as usual and saves what it parsed with create() and commit().
+ *
+ * Snapshots are invalidated when a source file changes path, size or modification time, when any key changes, or when the
+ * component bumps its version because its payload layout changed. Snapshots are written atomically, so a crash while saving
+ * never leaves a truncated snapshot behind.
+ *@version 1.0
+ */
+class SnapshotCache
+{
+public:
+
+    /**
+     * @param name base name of the snapshot file in the cache directory.
+     * @param version version of the payload layout. Bump it whenever the payload written by the component changes.
+     */
+    SnapshotCache(const QString &name, quint32 version);
+    ~SnapshotCache();
+
+    /** Make the snapshot depend on a source file. */
+    void addSource(const QString &filename);
+
+    /** Make the snapshot depend on an arbitrary key. */
+    void addKey(const QString &key);
+
+    /**
+     * @brief open Map a valid snapshot into memory.
+     * @return stream positioned at the payload, or NULL if there is no valid snapshot. The stream is owned by the cache and is
+     * valid until close() is called or the cache is destroyed.
+     */
+    QDataStream * open();
+
+    /** Unmap the snapshot. */
+    void close();
+
+    /**
+     * @brief create Start writing a new snapshot for the current sources.
+     * @return stream the payload is to be written to, or NULL if the cache directory is not writable.
+     */
+    QDataStream * create();
+
+    /**
+     * @brief commit Finish writing the snapshot started by create().
+     * @return true if the snapshot was written completely and replaced the old one.
+     */
+    bool commit();
+
+    /** Delete the snapshot file, e.g. when its payload turned out to be corrupt. */
+    void remove();
+
+    QString fileName() const;
+
+private:
+
+    QByteArray fingerprint() const;
+
+    QString m_Name;
+    quint32 m_Version;
+    QStringList m_Sources;
+    QStringList m_Keys;
+
+    QFile m_File;
+    uchar *m_Map;
+    QByteArray m_Data;
+    QDataStream *m_Stream;
+    QSaveFile *m_SaveFile;
+};
+
+#endif // SNAPSHOTCACHE_H
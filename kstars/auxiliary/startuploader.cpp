@@ -0,0 +1,217 @@
+/*  Startup Task Loader
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#include "startuploader.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QtConcurrent>
+#include <QDebug>
+
+// How long to wait for a worker task before processing pending events again, in ms.
+#define EVENT_INTERVAL  50
+
+StartupLoader::StartupLoader(QObject *parent) : QObject(parent), m_TotalElapsed(0)
+{
+}
+
+StartupLoader::~StartupLoader()
+{
+    m_Pool.waitForDone();
+    qDeleteAll(m_Tasks);
+}
+
+void StartupLoader::addTask(const QString &id, const QString &label, std::function<void()> task, const QStringList &dependencies,
+                            Affinity affinity, const QString &resource)
+{
+    if (findTask(id))
+    {
+        qWarning() << "StartupLoader: task" << id << "is already registered.";
+        return;
+    }
+
+    Task *oneTask = new Task;
+
+    oneTask->id           = id;
+    oneTask->label        = label;
+    oneTask->function     = task;
+    oneTask->dependencies = dependencies;
+    oneTask->affinity     = affinity;
+    oneTask->resource     = resource;
+    oneTask->state        = TASK_PENDING;
+    oneTask->elapsed      = -1;
+
+    m_Tasks.append(oneTask);
+}
+
+StartupLoader::Task *StartupLoader::findTask(const QString &id) const
+{
+    foreach(Task *oneTask, m_Tasks)
+    {
+        if (oneTask->id == id)
+            return oneTask;
+    }
+
+    return NULL;
+}
+
+bool StartupLoader::isReady(const Task *task) const
+{
+    if (task->state != TASK_PENDING)
+        return false;
+
+    if (task->resource.isEmpty() == false && m_BusyResources.contains(task->resource))
+        return false;
+
+    foreach(const QString &dependency, task->dependencies)
+    {
+        Task *other = findTask(dependency);
+        if (other == NULL || other->state != TASK_DONE)
+            return false;
+    }
+
+    return true;
+}
+
+void StartupLoader::finish(Task *task)
+{
+    task->state = TASK_DONE;
+
+    if (task->resource.isEmpty() == false)
+        m_BusyResources.remove(task->resource);
+
+    qDebug() << "Startup:" << task->id << "loaded in" << task->elapsed << "ms";
+}
+
+bool StartupLoader::run()
+{
+    Q_ASSERT(QThread::currentThread() == qApp->thread());
+
+    foreach(Task *oneTask, m_Tasks)
+    {
+        foreach(const QString &dependency, oneTask->dependencies)
+        {
+            if (findTask(dependency) == NULL)
+            {
+                qWarning() << "StartupLoader: task" << oneTask->id << "depends on unknown task" << dependency;
+                return false;
+            }
+        }
+    }
+
+    QElapsedTimer totalTimer;
+    totalTimer.start();
+
+    int completed=0, running=0;
+
+    while (completed < m_Tasks.count())
+    {
+        Task *mainTask = NULL;
+
+        // Start all worker tasks that are ready, and pick the first main thread task that is
+        foreach(Task *oneTask, m_Tasks)
+        {
+            if (isReady(oneTask) == false)
+                continue;
+
+            if (oneTask->affinity == MainThread)
+            {
+                if (mainTask == NULL)
+                    mainTask = oneTask;
+                continue;
+            }
+
+            oneTask->state = TASK_RUNNING;
+            if (oneTask->resource.isEmpty() == false)
+                m_BusyResources.insert(oneTask->resource);
+            running++;
+
+            if (oneTask->label.isEmpty() == false)
+                emit progressText(oneTask->label);
+
+            QtConcurrent::run(&m_Pool, [this, oneTask]()
+            {
+                QElapsedTimer taskTimer;
+                taskTimer.start();
+
+                oneTask->function();
+
+                oneTask->elapsed = taskTimer.elapsed();
+
+                QMutexLocker locker(&m_FinishedMutex);
+                m_Finished.append(oneTask);
+                m_FinishedCondition.wakeAll();
+            });
+        }
+
+        if (mainTask)
+        {
+            mainTask->state = TASK_RUNNING;
+            if (mainTask->resource.isEmpty() == false)
+                m_BusyResources.insert(mainTask->resource);
+
+            if (mainTask->label.isEmpty() == false)
+                emit progressText(mainTask->label);
+
+            QElapsedTimer taskTimer;
+            taskTimer.start();
+
+            mainTask->function();
+
+            mainTask->elapsed = taskTimer.elapsed();
+            finish(mainTask);
+            completed++;
+        }
+        else if (running == 0)
+        {
+            foreach(Task *oneTask, m_Tasks)
+            {
+                if (oneTask->state == TASK_PENDING)
+                    qWarning() << "StartupLoader: task" << oneTask->id << "has cyclic dependencies and was not executed.";
+            }
+
+            m_TotalElapsed = totalTimer.elapsed();
+            return false;
+        }
+
+        // Collect worker tasks that are done. Only block if there is nothing we can do on the main thread.
+        QList<Task *> finished;
+        {
+            QMutexLocker locker(&m_FinishedMutex);
+            if (m_Finished.isEmpty() && mainTask == NULL)
+                m_FinishedCondition.wait(&m_FinishedMutex, EVENT_INTERVAL);
+            finished = m_Finished;
+            m_Finished.clear();
+        }
+
+        foreach(Task *oneTask, finished)
+        {
+            finish(oneTask);
+            running--;
+            completed++;
+        }
+
+        // Keep the splash screen alive and deliver progress messages posted by the workers
+        QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+    }
+
+    m_TotalElapsed = totalTimer.elapsed();
+
+    qDebug() << "Startup:" << m_Tasks.count() << "tasks loaded in" << m_TotalElapsed << "ms";
+
+    return true;
+}
+
+qint64 StartupLoader::elapsed(const QString &id) const
+{
+    Task *oneTask = findTask(id);
+
+    return oneTask ? oneTask->elapsed : -1;
+}
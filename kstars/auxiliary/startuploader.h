@@ -0,0 +1,119 @@
+/*  Startup Task Loader
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef STARTUPLOADER_H
+#define STARTUPLOADER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QSet>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThreadPool>
+
+#include <functional>
+
+/**
+ *@class StartupLoader
+ *@short Runs startup loading tasks concurrently, respecting their dependencies.
+ *
+ * Each task has an ID, a label shown in the splash screen and a list of IDs of tasks that must be complete before it starts.
+ * Tasks run on a thread pool unless they have main thread affinity, e.g. because they create pixmaps or use a database
+ * connection owned by the main thread. Main thread tasks are executed by run() itself as soon as their dependencies are met,
+ * so they overlap with the worker tasks.
+ *
+ * Tasks sharing a resource name never run at the same time. Use this for tasks that write to shared, non thread-safe
+ * structures such as the sky mesh.
+ *
+ * run() blocks until all tasks are complete and logs the time each task took.
+ *@version 1.0
+ */
+class StartupLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    typedef enum
+    {
+        WorkerThread,
+        MainThread
+    } Affinity;
+
+    explicit StartupLoader(QObject *parent=0);
+    ~StartupLoader();
+
+    /**
+     * @brief addTask Register a task. Tasks may be added until run() is called.
+     * @param id unique ID of the task, used by other tasks to refer to it as a dependency.
+     * @param label Translated text shown in the splash screen when the task starts.
+     * @param task function to execute.
+     * @param dependencies IDs of tasks that must be complete before this task starts.
+     * @param affinity thread the task must run in.
+     * @param resource tasks with the same non-empty resource are serialized.
+     */
+    void addTask(const QString &id, const QString &label, std::function<void()> task, const QStringList &dependencies=QStringList(),
+                 Affinity affinity=WorkerThread, const QString &resource=QString());
+
+    /**
+     * @brief run Execute all tasks and wait for them to complete. Must be called from the main thread.
+     * @return false if a dependency is unknown or cyclic. Tasks that could not be started are not executed.
+     */
+    bool run();
+
+    /** @return time in milliseconds the task took, or -1 if it did not run. */
+    qint64 elapsed(const QString &id) const;
+
+    /** @return wall clock time in milliseconds of the last run() */
+    qint64 totalElapsed() const { return m_TotalElapsed; }
+
+signals:
+    /** Emitted from the main thread whenever a task starts */
+    void progressText(const QString &message);
+
+private:
+
+    typedef enum
+    {
+        TASK_PENDING,
+        TASK_RUNNING,
+        TASK_DONE
+    } TaskState;
+
+    typedef struct
+    {
+        QString id;
+        QString label;
+        std::function<void()> function;
+        QStringList dependencies;
+        Affinity affinity;
+        QString resource;
+        TaskState state;
+        qint64 elapsed;
+    } Task;
+
+    bool isReady(const Task *task) const;
+    void finish(Task *task);
+    Task *findTask(const QString &id) const;
+
+    QList<Task *> m_Tasks;
+    QSet<QString> m_BusyResources;
+    qint64 m_TotalElapsed;
+
+    QThreadPool m_Pool;
+
+    // Worker tasks report completion here
+    QMutex m_FinishedMutex;
+    QWaitCondition m_FinishedCondition;
+    QList<Task *> m_Finished;
+};
+
+#endif // STARTUPLOADER_H
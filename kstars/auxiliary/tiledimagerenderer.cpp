@@ -0,0 +1,173 @@
+/*  Tiled Image Renderer
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#include "tiledimagerenderer.h"
+
+#include <cstring>
+
+#include <QFile>
+#include <QFontDatabase>
+#include <QGuiApplication>
+#include <QPainter>
+#include <QtConcurrent>
+
+namespace
+{
+
+/** Renders the tiles of a band in the threads of QtConcurrent */
+struct TileFunctor
+{
+    typedef QImage result_type;
+
+    explicit TileFunctor( const TiledImageRenderer *renderer ) : m_Renderer( renderer ) {}
+
+    QImage operator()( const QRect &rect ) const { return m_Renderer->renderTile( rect ); }
+
+    const TiledImageRenderer *m_Renderer;
+};
+
+/** Copy the rows of @p tile into @p band, at column @p x */
+void copyTile( const QImage &tile, QImage &band, int x )
+{
+    const int bytes = tile.width() * 4;
+    for ( int j = 0; j < tile.height(); ++j )
+        memcpy( band.scanLine( j ) + 4 * x, tile.constScanLine( j ), bytes );
+}
+
+}
+
+bool TiledImageRenderer::rendersConcurrently() {
+    // The recorded drawings contain labels. Without the support of the platform, fonts are only rendered in the GUI thread.
+    return qobject_cast<QGuiApplication *>( QCoreApplication::instance() ) && QFontDatabase::supportsThreadedFontRendering();
+}
+
+TiledImageRenderer::TiledImageRenderer( const QSize &size, int tileSize )
+    : m_Size( size ), m_TileSize( qMax( 1, tileSize ) ), m_Background( Qt::white )
+{
+}
+
+void TiledImageRenderer::addLayer( const QPicture &picture, const QPoint &offset, const QRect &clip ) {
+    Layer layer;
+    layer.picture = picture;
+    layer.offset = offset;
+    layer.clip = clip;
+    m_Layers.append( layer );
+}
+
+QList<QRect> TiledImageRenderer::tiles() const {
+    const QRect image( QPoint(), m_Size );
+    QList<QRect> tiles;
+    for ( int y = 0; y < m_Size.height(); y += m_TileSize )
+        for ( int x = 0; x < m_Size.width(); x += m_TileSize )
+            tiles.append( QRect( x, y, m_TileSize, m_TileSize ).intersected( image ) );
+    return tiles;
+}
+
+QImage TiledImageRenderer::renderTile( const QRect &rect ) const {
+    QImage tile( rect.size(), QImage::Format_ARGB32_Premultiplied );
+    tile.fill( m_Background );
+
+    const QRect image( QPoint(), m_Size );
+    foreach ( const Layer &layer, m_Layers ) {
+        // A clipped layer is drawn on its own, as the clip set by the picture replaces the clip of the painter.
+        // Whether it is clipped depends on the image only, so that the tiles and the single pass blend alike.
+        const bool isClipped = ! layer.clip.isEmpty() && ! layer.clip.contains( image );
+        QRect clip = isClipped ? layer.clip.intersected( rect ) : rect;
+        if ( clip.isEmpty() )
+            continue;
+
+        // QPicture::play() reads from the buffer of the picture, which the copies share until they detach
+        QPicture picture( layer.picture );
+        picture.detach();
+
+        QImage clipped;
+        if ( isClipped ) {
+            clipped = QImage( rect.size(), QImage::Format_ARGB32_Premultiplied );
+            clipped.fill( Qt::transparent );
+        }
+
+        QPainter p( isClipped ? &clipped : &tile );
+        p.translate( layer.offset - rect.topLeft() );
+        picture.play( &p );
+        p.end();
+
+        if ( isClipped ) {
+            clip.translate( -rect.topLeft() );
+            QPainter tp( &tile );
+            tp.drawImage( clip.topLeft(), clipped, clip );
+        }
+    }
+
+    return tile;
+}
+
+QImage TiledImageRenderer::render() const {
+    return renderTile( QRect( QPoint(), m_Size ) );
+}
+
+bool TiledImageRenderer::renderBands( const BandSink &sink ) const {
+    const QList<QRect> all = tiles();
+    const int perBand = ( m_Size.width() + m_TileSize - 1 ) / m_TileSize;
+    const bool concurrent = rendersConcurrently();
+
+    for ( int first = 0; first < all.size(); first += perBand ) {
+        const QList<QRect> band = all.mid( first, perBand );
+        QList<QImage> images;
+        if ( concurrent ) {
+            images = QtConcurrent::blockingMapped( band, TileFunctor( this ) );
+        } else {
+            foreach ( const QRect &rect, band )
+                images.append( renderTile( rect ) );
+        }
+
+        QImage bandImage( m_Size.width(), band.first().height(), QImage::Format_ARGB32_Premultiplied );
+        for ( int i = 0; i < band.size(); ++i )
+            copyTile( images[i], bandImage, band[i].x() );
+
+        if ( ! sink( bandImage, band.first().y() ) )
+            return false;
+    }
+    return true;
+}
+
+bool TiledImageRenderer::save( const QString &fileName, const char *format ) const {
+    if ( qstrcmp( format, "PNM" ) == 0 ) {
+        QFile file( fileName );
+        if ( ! file.open( QIODevice::WriteOnly ) )
+            return false;
+
+        // Binary PPM, as QImage::save() writes the color images
+        file.write( QString( "P6\n%1 %2\n255\n" ).arg( m_Size.width() ).arg( m_Size.height() ).toLatin1() );
+        QByteArray row( 3 * m_Size.width(), 0 );
+        return renderBands( [&file, &row]( const QImage &band, int ) -> bool {
+            for ( int j = 0; j < band.height(); ++j ) {
+                const QRgb *pixels = reinterpret_cast<const QRgb *>( band.constScanLine( j ) );
+                char *out = row.data();
+                for ( int i = 0; i < band.width(); ++i ) {
+                    const QRgb pixel = qUnpremultiply( pixels[i] );
+                    *out++ = qRed( pixel );
+                    *out++ = qGreen( pixel );
+                    *out++ = qBlue( pixel );
+                }
+                if ( file.write( row ) != row.size() )
+                    return false;
+            }
+            return true;
+        } );
+    }
+
+    // The other encoders need the whole image
+    QImage image( m_Size, QImage::Format_ARGB32_Premultiplied );
+    renderBands( [&image]( const QImage &band, int y ) -> bool {
+        for ( int j = 0; j < band.height(); ++j )
+            memcpy( image.scanLine( y + j ), band.constScanLine( j ), band.bytesPerLine() );
+        return true;
+    } );
+    return image.save( fileName, format );
+}
@@ -0,0 +1,104 @@
+/*  Tiled Image Renderer
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef TILEDIMAGERENDERER_H
+#define TILEDIMAGERENDERER_H
+
+#include <QColor>
+#include <QImage>
+#include <QList>
+#include <QPicture>
+#include <QPoint>
+#include <QRect>
+#include <QSize>
+
+#include <functional>
+
+/**
+ *@class TiledImageRenderer
+ *@short Rasterizes recorded drawings into a large image, tile by tile.
+ *
+ * The drawings are recorded once into QPictures, so that whatever depends on the whole image, as the placement of
+ * the labels by SkyLabeler, is resolved before the image is split. The image is then rendered one band of tiles at a
+ * time: the tiles of a band render concurrently, each with its own QPainter on a private QImage, and the band is
+ * handed over to the output before the next one starts. Only one band of the image is held in memory while PNM files
+ * are written. Where the platform cannot render fonts outside of the GUI thread, the tiles render one after the other
+ * in the calling thread.
+ *@version 1.0
+ */
+class TiledImageRenderer
+{
+public:
+    /** Receives a band of the image, whose first row is row @p y of the image. Returns false to stop the rendering. */
+    typedef std::function<bool ( const QImage &band, int y )> BandSink;
+
+    /**
+     * @short Constructor
+     * @param size size of the image
+     * @param tileSize width and height of the tiles
+     */
+    explicit TiledImageRenderer( const QSize &size, int tileSize = 512 );
+
+    /** @return true if the tiles of a band render concurrently, false if one after the other */
+    static bool rendersConcurrently();
+
+    /** @return the size of the image */
+    inline QSize size() const { return m_Size; }
+
+    /** @return the width and height of the tiles */
+    inline int tileSize() const { return m_TileSize; }
+
+    /** Set the color of the image where no layer is drawn. White by default. */
+    inline void setBackground( const QColor &color ) { m_Background = color; }
+
+    /**
+     * @short Add a layer, drawn over the previous ones.
+     * @param picture the recorded drawing
+     * @param offset position in the image of the origin of @p picture
+     * @param clip the part of the image where @p picture is drawn. If it is empty, the whole image.
+     */
+    void addLayer( const QPicture &picture, const QPoint &offset = QPoint(), const QRect &clip = QRect() );
+
+    /** @return the tiles of the image, band by band from the top, each band from the left */
+    QList<QRect> tiles() const;
+
+    /** @return the part @p rect of the image */
+    QImage renderTile( const QRect &rect ) const;
+
+    /** @return the whole image, rendered in a single pass */
+    QImage render() const;
+
+    /**
+     * @short Render the image band by band, the tiles of each band concurrently if rendersConcurrently().
+     * @param sink receives each band once all its tiles are rendered
+     * @return false if @p sink stopped the rendering
+     */
+    bool renderBands( const BandSink &sink ) const;
+
+    /**
+     * @short Save the image in @p fileName.
+     * PNM images are written row by row as the bands are rendered. Other formats are encoded once all the bands are.
+     * @return true on success
+     */
+    bool save( const QString &fileName, const char *format ) const;
+
+private:
+    struct Layer {
+        QPicture picture;
+        QPoint offset;
+        QRect clip;
+    };
+
+    QSize m_Size;
+    int m_TileSize;
+    QColor m_Background;
+    QList<Layer> m_Layers;
+};
+
+#endif // TILEDIMAGERENDERER_H
@@ -49,6 +49,7 @@
 #include "skyobjects/kscomet.h"
 #include "skyobjects/ksasteroid.h"
 #include "skyobjects/supernova.h"
+#include "skyobjects/satellite.h"
 #include "skycomponents/catalogcomponent.h"
 #include "thumbnailpicker.h"
 #include "Options.h"
@@ -84,6 +85,10 @@ DetailDialog::DetailDialog(SkyObject *o, const KStarsDateTime &ut, GeoLocation *
     titlePalette.setColor( backgroundRole(), palette().color( QPalette::Active, QPalette::Highlight ) );
     titlePalette.setColor( foregroundRole(), palette().color( QPalette::Active, QPalette::HighlightedText ) );
 
+    // Satellites below the horizon may not have been computed with the last update
+    if ( o->type() == SkyObject::SATELLITE )
+        static_cast<Satellite *>( o )->updatePosIfOutdated();
+
     //Create thumbnail image
     Thumbnail = new QPixmap( 200, 200 );
 
@@ -27,13 +27,15 @@
 #include "skycomponents/skymapcomposite.h"
 #include "tools/nameresolver.h"
 #include "skyobjectlistmodel.h"
+#include "skyobjectsearchindex.h"
 
 #include <KMessageBox>
 
-#include <QSortFilterProxyModel>
 #include <QStringListModel>
 #include <QTimer>
 
+#include <algorithm>
+
 FindDialogUI::FindDialogUI( QWidget *parent ) : QFrame( parent ) {
     setupUi( this );
 
@@ -58,6 +60,8 @@ FindDialogUI::FindDialogUI( QWidget *parent ) : QFrame( parent ) {
 FindDialog::FindDialog( QWidget* parent ) :
     QDialog( parent ),
     timer(0),
+    m_SearchIndexesRevision( 0 ),
+    m_LastIndex( 0 ),
     m_targetObject( 0 )
 {
 #ifdef Q_OS_OSX
@@ -88,16 +92,9 @@ FindDialog::FindDialog( QWidget* parent ) :
 
     ui->FilterType->setCurrentIndex(0);  // show all types of objects
 
+    // The search index keeps the objects sorted, the model only shows its results
     fModel = new SkyObjectListModel( this );
-    sortModel = new QSortFilterProxyModel(ui->SearchList);
-    sortModel->setFilterCaseSensitivity( Qt::CaseInsensitive );
-    sortModel->setSourceModel( fModel );
-    sortModel->setSortRole(Qt::DisplayRole);
-    sortModel->setFilterRole(Qt::DisplayRole);
-    sortModel->setDynamicSortFilter(true);
-    sortModel->sort( 0 );
-
-    ui->SearchList->setModel( sortModel );
+    ui->SearchList->setModel( fModel );
 
     // Connect signals to slots
     connect( ui->SearchBox, SIGNAL( textChanged( const QString & ) ), SLOT( enqueueSearch() ) );
@@ -114,18 +111,18 @@ FindDialog::FindDialog( QWidget* parent ) :
     listFiltered = false;
 }
 
-FindDialog::~FindDialog() { }
+FindDialog::~FindDialog() {
+    qDeleteAll( m_SearchIndexes );
+}
 
 void FindDialog::init() {
     ui->SearchBox->clear();
-    filterByType();
-    sortModel->sort( 0 );
-    initSelection();
+    filterList();
     m_targetObject = 0;
 }
 
 void FindDialog::initSelection() {
-    if ( sortModel->rowCount() <= 0 )
+    if ( fModel->rowCount( QModelIndex() ) <= 0 )
     {
         okB->setEnabled( false );
         return;
@@ -133,34 +130,28 @@ void FindDialog::initSelection() {
 
     if ( ui->SearchBox->text().isEmpty() ) {
         //Pre-select the first item
-        QModelIndex selectItem = sortModel->index( 0, sortModel->filterKeyColumn(), QModelIndex() );
+        QModelIndex selectItem = fModel->index( 0 );
+        QString defaultItem;
         switch ( ui->FilterType->currentIndex() ) {
         case 0: //All objects, choose Andromeda galaxy
-            {
-                QModelIndex qmi = fModel->index( fModel->indexOf( i18n("Andromeda Galaxy") ) );
-                selectItem = sortModel->mapFromSource( qmi );
-                break;
-            }
+            defaultItem = i18n("Andromeda Galaxy");
+            break;
         case 1: //Stars, choose Aldebaran
-            {
-                QModelIndex qmi = fModel->index( fModel->indexOf( i18n("Aldebaran") ) );
-                selectItem = sortModel->mapFromSource( qmi );
-                break;
-            }
+            defaultItem = i18n("Aldebaran");
+            break;
         case 2: //Solar system or Asteroids, choose Aaltje
         case 9:
-            {
-                QModelIndex qmi = fModel->index( fModel->indexOf( i18n("Aaltje") ) );
-                selectItem = sortModel->mapFromSource( qmi );
-                break;
-            }
+            defaultItem = i18n("Aaltje");
+            break;
         case 8: //Comets, choose 'Aarseth-Brewington (1989 W1)'
-            {
-                QModelIndex qmi = fModel->index( fModel->indexOf( i18n("Aarseth-Brewington (1989 W1)") ) );
-                selectItem = sortModel->mapFromSource( qmi );
-                break;
-            }
+            defaultItem = i18n("Aarseth-Brewington (1989 W1)");
+            break;
+        }
 
+        if ( ! defaultItem.isEmpty() ) {
+            int row = fModel->indexOf( defaultItem );
+            fModel->fetchUpTo( row );
+            selectItem = fModel->index( row );
         }
 
         if ( selectItem.isValid() ) {
@@ -175,86 +166,115 @@ void FindDialog::initSelection() {
     listFiltered = true;
 }
 
-void FindDialog::filterByType() {
-    KStarsData *data = KStarsData::Instance();
+QList<int> FindDialog::typesOfFilter( int filterType ) const {
+    QList<int> types;
 
-    switch ( ui->FilterType->currentIndex() ) {
+    switch ( filterType ) {
     case 0: // All object types
-    {
-        QVector<QPair<QString, const SkyObject *>> allObjects;
-        foreach( int type, data->skyComposite()->objectLists().keys() ) {
-            allObjects.append(data->skyComposite()->objectLists(SkyObject::TYPE(type)));
-        }
-        fModel->setSkyObjectsList( allObjects );
+        types = KStarsData::Instance()->skyComposite()->objectLists().keys();
         break;
-    }
     case 1: //Stars
-    {
-        QVector<QPair<QString, const SkyObject *>> starObjects;
-        starObjects.append(data->skyComposite()->objectLists(SkyObject::STAR));
-        starObjects.append(data->skyComposite()->objectLists(SkyObject::CATALOG_STAR));
-        fModel->setSkyObjectsList( starObjects );
+        types << SkyObject::STAR << SkyObject::CATALOG_STAR;
         break;
-    }
     case 2: //Solar system
-    {
-        QVector<QPair<QString, const SkyObject *>> ssObjects;
-        ssObjects.append(data->skyComposite()->objectLists(SkyObject::PLANET));
-        ssObjects.append(data->skyComposite()->objectLists(SkyObject::COMET));
-        ssObjects.append(data->skyComposite()->objectLists(SkyObject::ASTEROID));
-        ssObjects.append(data->skyComposite()->objectLists(SkyObject::MOON));
-
-        fModel->setSkyObjectsList(ssObjects);
+        types << SkyObject::PLANET << SkyObject::COMET << SkyObject::ASTEROID << SkyObject::MOON;
         break;
-    }
     case 3: //Open Clusters
-        fModel->setSkyObjectsList( data->skyComposite()->objectLists( SkyObject::OPEN_CLUSTER ) );
+        types << SkyObject::OPEN_CLUSTER;
         break;
     case 4: //Globular Clusters
-        fModel->setSkyObjectsList( data->skyComposite()->objectLists( SkyObject::GLOBULAR_CLUSTER ) );
+        types << SkyObject::GLOBULAR_CLUSTER;
         break;
     case 5: //Gaseous nebulae
-        fModel->setSkyObjectsList( data->skyComposite()->objectLists( SkyObject::GASEOUS_NEBULA ) );
+        types << SkyObject::GASEOUS_NEBULA;
         break;
     case 6: //Planetary nebula
-        fModel->setSkyObjectsList( data->skyComposite()->objectLists( SkyObject::PLANETARY_NEBULA ) );
+        types << SkyObject::PLANETARY_NEBULA;
         break;
     case 7: //Galaxies
-        fModel->setSkyObjectsList( data->skyComposite()->objectLists( SkyObject::GALAXY ) );
+        types << SkyObject::GALAXY;
         break;
     case 8: //Comets
-        fModel->setSkyObjectsList( data->skyComposite()->objectLists( SkyObject::COMET ) );
+        types << SkyObject::COMET;
         break;
     case 9: //Asteroids
-        fModel->setSkyObjectsList( data->skyComposite()->objectLists( SkyObject::ASTEROID ) );
+        types << SkyObject::ASTEROID;
         break;
     case 10: //Constellations
-        fModel->setSkyObjectsList( data->skyComposite()->objectLists( SkyObject::CONSTELLATION ) );
+        types << SkyObject::CONSTELLATION;
         break;
     case 11: //Supernovae
-        fModel->setSkyObjectsList( data->skyComposite()->objectLists( SkyObject::SUPERNOVA ) );
+        types << SkyObject::SUPERNOVA;
         break;
     case 12: //Satellites
-        fModel->setSkyObjectsList( data->skyComposite()->objectLists( SkyObject::SATELLITE ) );
+        types << SkyObject::SATELLITE;
         break;
     }
+
+    return types;
+}
+
+SkyObjectSearchIndex *FindDialog::searchIndex() {
+    SkyMapComposite *composite = KStarsData::Instance()->skyComposite();
+    int filterType = ui->FilterType->currentIndex();
+    QList<int> types = typesOfFilter( filterType );
+
+    // Objects are added by resolving names on the internet, and satellites, comets, asteroids and supernovae are
+    // deleted and loaded again when their data is updated. The dialog is kept between uses, so drop the indexes then.
+    if ( composite->objectListsRevision() != m_SearchIndexesRevision ) {
+        // The model and the last results refer to the old indexes
+        fModel->setSkyObjectsList( QVector<QPair<QString, const SkyObject *>>() );
+        m_LastIndex = 0;
+        qDeleteAll( m_SearchIndexes );
+        m_SearchIndexes.clear();
+        m_SearchIndexesRevision = composite->objectListsRevision();
+    }
+
+    SkyObjectSearchIndex *index = m_SearchIndexes.value( filterType );
+    if ( index )
+        return index;
+
+    int count = 0;
+    foreach( int type, types )
+        count += composite->objectLists( type ).size();
+
+    QVector<QPair<QString, const SkyObject *>> objects;
+    objects.reserve( count );
+    foreach( int type, types )
+        objects += composite->objectLists( type );
+
+    index = new SkyObjectSearchIndex( objects );
+    m_SearchIndexes.insert( filterType, index );
+    return index;
 }
 
 void FindDialog::filterList() {
     QString SearchText = processSearchText();
-    sortModel->setFilterFixedString( SearchText );
     ui->InternetSearchButton->setText( i18n( "or search the internet for %1", SearchText ) );
-    filterByType();
+
+    SkyObjectSearchIndex *index = searchIndex();
+
+    // Appending characters to the search text can only remove objects from the list
+    if ( index == m_LastIndex && ! m_LastSearch.isEmpty() && SkyObjectSearchIndex::narrows( SearchText, m_LastSearch ) )
+        m_LastResults = index->search( SearchText, &m_LastResults );
+    else
+        m_LastResults = index->search( SearchText );
+
+    m_LastIndex = index;
+    m_LastSearch = SearchText;
+
+    fModel->setSearchResults( index, m_LastResults );
     initSelection();
 
     //Select the first item in the list that begins with the filter string
     if ( !SearchText.isEmpty() ) {
-        QStringList mItems = fModel->filter( QRegExp( '^'+SearchText, Qt::CaseInsensitive ) );
-        mItems.sort();
+        int first = index->firstPrefixMatch( SearchText );
 
-        if ( mItems.size() ) {
-            QModelIndex qmi = fModel->index( fModel->indexOf( mItems[0] ) );
-            QModelIndex selectItem = sortModel->mapFromSource( qmi );
+        if ( first >= 0 ) {
+            // Results are sorted like the index, so the prefix match is found by bisection
+            int row = std::lower_bound( m_LastResults.constBegin(), m_LastResults.constEnd(), first ) - m_LastResults.constBegin();
+            fModel->fetchUpTo( row );
+            QModelIndex selectItem = fModel->index( row );
 
             if ( selectItem.isValid() ) {
                 ui->SearchList->selectionModel()->select( selectItem, QItemSelectionModel::ClearAndSelect );
@@ -264,7 +284,7 @@ void FindDialog::filterList() {
                 okB->setEnabled(true);
             }
         }
-        ui->InternetSearchButton->setEnabled( ! mItems.contains( SearchText ) ); // Disable searching the internet when an exact match for SearchText exists in KStars
+        ui->InternetSearchButton->setEnabled( ! index->containsName( SearchText ) ); // Disable searching the internet when an exact match for SearchText exists in KStars
     }
     else
         ui->InternetSearchButton->setEnabled( false );
@@ -274,7 +294,7 @@ void FindDialog::filterList() {
 
 SkyObject* FindDialog::selectedObject() const {
     QModelIndex i = ui->SearchList->currentIndex();
-    QVariant sObj = sortModel->data(sortModel->index(i.row(), 0), SkyObjectListModel::SkyObjectRole);
+    QVariant sObj = fModel->data(fModel->index(i.row()), SkyObjectListModel::SkyObjectRole);
     return (SkyObject *) sObj.value<void *>();
 }
 
@@ -287,7 +307,8 @@ void FindDialog::enqueueSearch() {
         timer->setSingleShot( true );
         connect( timer, SIGNAL( timeout() ), this, SLOT( filterList() ) );
     }
-    timer->start( 500 );
+    // Searching is fast, only coalesce keystrokes typed in quick succession
+    timer->start( 50 );
 }
 
 // Process the search box text to replace equivalent names like "m93" with "m 93"
@@ -359,7 +380,7 @@ void FindDialog::keyPressEvent( QKeyEvent *e ) {
     {
         int currentRow = ui->SearchList->currentIndex().row();
         if ( currentRow > 0 ) {
-            QModelIndex selectItem = sortModel->index( currentRow-1, sortModel->filterKeyColumn(), QModelIndex() );
+            QModelIndex selectItem = fModel->index( currentRow-1 );
             ui->SearchList->selectionModel()->setCurrentIndex( selectItem, QItemSelectionModel::SelectCurrent );
         }
         break;
@@ -367,8 +388,9 @@ void FindDialog::keyPressEvent( QKeyEvent *e ) {
     case Qt::Key_Down :
     {
         int currentRow = ui->SearchList->currentIndex().row();
-        if ( currentRow < sortModel->rowCount()-1 ) {
-            QModelIndex selectItem = sortModel->index( currentRow+1, sortModel->filterKeyColumn(), QModelIndex() );
+        fModel->fetchUpTo( currentRow+1 );
+        if ( currentRow < fModel->rowCount( QModelIndex() )-1 ) {
+            QModelIndex selectItem = fModel->index( currentRow+1 );
             ui->SearchList->selectionModel()->setCurrentIndex( selectItem, QItemSelectionModel::SelectCurrent );
         }
         break;
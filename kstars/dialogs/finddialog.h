@@ -20,13 +20,15 @@
 
 #include <QKeyEvent>
 #include <QDialog>
+#include <QHash>
+#include <QVector>
 
 #include "ui_finddialog.h"
 
 class QTimer;
 class QStringListModel;
-class QSortFilterProxyModel;
 class SkyObjectListModel;
+class SkyObjectSearchIndex;
 class SkyObject;
 
 class FindDialogUI : public QFrame, public Ui::FindDialog {
@@ -64,7 +66,8 @@ public:
 
 public slots:
     /**When Text is entered in the QLineEdit, filter the List of objects
-     * so that only objects which start with the filter text are shown.
+     * so that only objects which contain the filter text are shown, and
+     * select the first object which starts with it.
      */
     void filterList();
 
@@ -116,14 +119,23 @@ private:
       */
      void finishProcessing( SkyObject *selObj = 0, bool resolve = true );
 
-    /** @short pre-filter the list of objects according to the
-     * selected object type.
+    /** @return the object types listed for a filter type of the type combo box */
+    QList<int> typesOfFilter( int filterType ) const;
+
+    /** @short search index of the objects of the selected type.
+     * The index is built when the type is first searched. All indexes are dropped when the object lists change.
      */
-    void filterByType();
+    SkyObjectSearchIndex *searchIndex();
 
     FindDialogUI* ui;
     SkyObjectListModel *fModel;
-    QSortFilterProxyModel* sortModel;
+    QHash<int, SkyObjectSearchIndex *> m_SearchIndexes;
+    // SkyMapComposite::objectListsRevision() the indexes were built at
+    int m_SearchIndexesRevision;
+    // Last search, extended search texts only check its results
+    const SkyObjectSearchIndex *m_LastIndex;
+    QString m_LastSearch;
+    QVector<int> m_LastResults;
     QTimer* timer;
     bool listFiltered;
     QPushButton *okB;
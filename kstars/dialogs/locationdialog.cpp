@@ -24,6 +24,7 @@
 #include <QFile>
 #include <QTextStream>
 #include <QListWidget>
+#include <QScrollBar>
 
 #include <KMessageBox>
 
@@ -33,13 +34,16 @@
 #include "kstarsdata.h"
 #include "kspaths.h"
 
+// Number of cities added to the list at a time
+#define CITY_PAGE_SIZE  250
+
 LocationDialogUI::LocationDialogUI( QWidget *parent ) : QFrame( parent )
 {
     setupUi(this);
 }
 
 LocationDialog::LocationDialog( QWidget* parent ) :
-    QDialog( parent ), timer( 0 )
+    QDialog( parent ), matchingCityCount( 0 ), timer( 0 )
 {
 #ifdef Q_OS_OSX
         setWindowFlags(Qt::Tool| Qt::WindowStaysOnTopHint);
@@ -86,6 +90,7 @@ LocationDialog::LocationDialog( QWidget* parent ) :
     connect( ld->TZBox, SIGNAL( activated(int) ), this, SLOT( dataChanged() ) );
     connect( ld->DSTRuleBox, SIGNAL( activated(int) ), this, SLOT( dataChanged() ) );
     connect( ld->GeoBox, SIGNAL( itemSelectionChanged () ), this, SLOT( changeCity() ) );
+    connect( ld->GeoBox->verticalScrollBar(), SIGNAL( valueChanged(int) ), this, SLOT( slotCityListScrolled(int) ) );
     connect( ld->AddCityButton, SIGNAL( clicked() ), this, SLOT( addCity() ) );
     connect( ld->ClearFieldsButton, SIGNAL( clicked() ), this, SLOT( clearFields() ) );
     connect( ld->RemoveButton, SIGNAL(clicked()), this, SLOT(removeCity()));
@@ -106,35 +111,19 @@ LocationDialog::LocationDialog( QWidget* parent ) :
 
 void LocationDialog::initCityList() {
     KStarsData* data = KStarsData::Instance();
-    foreach ( GeoLocation *loc, data->getGeoList() )
-    {
-        ld->GeoBox->addItem( loc->fullName() );
-        filteredCityList.append( loc );
 
-        //If TZ is not an even integer value, add it to listbox
-        if ( loc->TZ0() - int( loc->TZ0() ) && ld->TZBox->findText( QLocale().toString( loc->TZ0() ) ) != -1 ) {
-            for ( int i=0; i < ld->TZBox->count(); ++i ) {
-                if ( ld->TZBox->itemText( i ).toDouble() > loc->TZ0() ) {
-                    ld->TZBox->addItem( QLocale().toString( loc->TZ0() ), i-1 );
-                    break;
-                }
-            }
-        }
-    }
+    filterCity();
 
-    //Sort the list of Cities alphabetically...note that filteredCityList may now have a different ordering!
-    ld->GeoBox->sortItems();
+    // attempt to highlight the current kstars location in the GeoBox
+    int row = data->cityDB()->position( data->geo()->fullName() );
+    if ( row < 0 )
+        return;
 
-    ld->CountLabel->setText( i18np("One city matches search criteria","%1 cities match search criteria", ld->GeoBox->count()) );
+    while ( ld->GeoBox->count() <= row && fetchMoreCities() )
+        ;
 
-    // attempt to highlight the current kstars location in the GeoBox
-    ld->GeoBox->setCurrentItem( 0 );
-    for( int i=0; i < ld->GeoBox->count(); i++ ) {
-        if ( ld->GeoBox->item(i)->text() == data->geo()->fullName() ) {
-            ld->GeoBox->setCurrentRow( i );
-            break;
-        }
-    }
+    if ( row < ld->GeoBox->count() && ld->GeoBox->item( row )->text() == data->geo()->fullName() )
+        ld->GeoBox->setCurrentRow( row );
 }
 
 void LocationDialog::enqueueFilterCity() {
@@ -149,36 +138,20 @@ void LocationDialog::enqueueFilterCity() {
 }
 
 void LocationDialog::filterCity() {
-    KStarsData* data = KStarsData::Instance();
     ld->GeoBox->clear();
     //Do NOT delete members of filteredCityList!
-    while( !filteredCityList.isEmpty() )
-        filteredCityList.takeFirst();
+    filteredCityList.clear();
 
     nameModified = false;
     dataModified = false;
     ld->AddCityButton->setEnabled( false );
     ld->UpdateButton->setEnabled( false );
 
-    foreach ( GeoLocation *loc, data->getGeoList() ) {
-        QString sc( loc->translatedName() );
-        QString ss( loc->translatedCountry() );
-        QString sp = "";
-        if ( !loc->province().isEmpty() )
-            sp = loc->translatedProvince();
-
-        if ( sc.toLower().startsWith( ld->CityFilter->text().toLower() ) &&
-                sp.toLower().startsWith( ld->ProvinceFilter->text().toLower() ) &&
-                ss.toLower().startsWith( ld->CountryFilter->text().toLower() ) ) {
-
-            ld->GeoBox->addItem( loc->fullName() );
-            filteredCityList.append( loc );
-        }
-    }
+    // The database lists the matching cities sorted, a page at a time
+    matchingCityCount = KStarsData::Instance()->cityDB()->count( ld->CityFilter->text(), ld->ProvinceFilter->text(), ld->CountryFilter->text() );
+    fetchMoreCities();
 
-    ld->GeoBox->sortItems();
-
-    ld->CountLabel->setText( i18np("One city matches search criteria","%1 cities match search criteria", ld->GeoBox->count()) );
+    ld->CountLabel->setText( i18np("One city matches search criteria","%1 cities match search criteria", matchingCityCount) );
 
     if ( ld->GeoBox->count() > 0 )		// set first item in list as selected
         ld->GeoBox->setCurrentItem( ld->GeoBox->item(0) );
@@ -186,6 +159,25 @@ void LocationDialog::filterCity() {
     ld->MapView->repaint();
 }
 
+bool LocationDialog::fetchMoreCities() {
+    if ( filteredCityList.size() >= matchingCityCount )
+        return false;
+
+    QList<GeoLocation*> page = KStarsData::Instance()->cityDB()->find( ld->CityFilter->text(), ld->ProvinceFilter->text(), ld->CountryFilter->text(),
+                                                                      filteredCityList.size(), CITY_PAGE_SIZE );
+    foreach ( GeoLocation *loc, page ) {
+        ld->GeoBox->addItem( loc->fullName() );
+        filteredCityList.append( loc );
+    }
+
+    return page.isEmpty() == false;
+}
+
+void LocationDialog::slotCityListScrolled( int value ) {
+    if ( value == ld->GeoBox->verticalScrollBar()->maximum() && fetchMoreCities() )
+        ld->MapView->repaint();
+}
+
 void LocationDialog::changeCity() {
     KStarsData* data = KStarsData::Instance();
     //when the selected city changes, set newCity, and redraw map
@@ -362,9 +354,8 @@ bool LocationDialog::updateCity(CityOperation operation)
                     return false;
                 }
 
-                //Add city to geoList...don't need to insert it alphabetically, since we always sort GeoList
-                g = new GeoLocation( lng, lat, name, province, country, TZ, & KStarsData::Instance()->Rulebook[ TZrule ] );
-                KStarsData::Instance()->getGeoList().append(g);
+                //Add city to the city database...don't need to insert it alphabetically, since it is always queried sorted
+                g = KStarsData::Instance()->cityDB()->addCity( GeoLocation( lng, lat, name, province, country, TZ, & KStarsData::Instance()->Rulebook[ TZrule ] ), TZrule );
             }
             break;
 
@@ -399,6 +390,7 @@ bool LocationDialog::updateCity(CityOperation operation)
                 g->setLong(lng);
                 g->setTZ(TZ);
                 g->setTZRule(& KStarsData::Instance()->Rulebook[ TZrule ]);
+                KStarsData::Instance()->cityDB()->updateCity( g, TZrule );
 
             }
             break;
@@ -418,8 +410,7 @@ bool LocationDialog::updateCity(CityOperation operation)
                 }
 
                 filteredCityList.removeOne(g);
-                KStarsData::Instance()->getGeoList().removeOne(g);
-                delete(g);
+                KStarsData::Instance()->cityDB()->removeCity(g);
                 g=NULL;
             }
             break;
@@ -453,18 +444,15 @@ void LocationDialog::findCitiesNear( int lng, int lat ) {
     //find all cities within 3 degrees of (lng, lat); list them in GeoBox
     ld->GeoBox->clear();
     //Remember, do NOT delete members of filteredCityList
-    while ( ! filteredCityList.isEmpty() ) filteredCityList.takeFirst();
+    filteredCityList.clear();
 
-    foreach ( GeoLocation *loc, data->getGeoList() ) {
-        if ( ( abs(	lng - int( loc->lng()->Degrees() ) ) < 3 ) &&
-                ( abs( lat - int( loc->lat()->Degrees() ) ) < 3 ) ) {
-
-            ld->GeoBox->addItem( loc->fullName() );
-            filteredCityList.append( loc );
-        }
+    foreach ( GeoLocation *loc, data->cityDB()->findNear( lng, lat, 3.0 ) ) {
+        ld->GeoBox->addItem( loc->fullName() );
+        filteredCityList.append( loc );
     }
 
-    ld->GeoBox->sortItems();
+    // All cities near the point are listed at once
+    matchingCityCount = filteredCityList.size();
     ld->CountLabel->setText( i18np("One city matches search criteria","%1 cities match search criteria", ld->GeoBox->count()) );
 
     if ( ld->GeoBox->count() > 0 )		// set first item in list as selected
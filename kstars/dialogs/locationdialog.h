@@ -72,15 +72,15 @@ public:
     explicit LocationDialog( QWidget* parent );
 
     /**Initialize list of cities.  Note that the database is not read in here,
-     * that is done in the KStars constructor.  This simply loads the local QListBox
-     * with the names of the cities from the kstarsData object.
+     * it is queried through the kstarsData object.  This simply loads the local
+     * QListBox with the first page of city names and highlights the current city.
      */
     void initCityList( void );
 
     /** @return pointer to the highlighted city in the List. */
     GeoLocation* selectedCity() const { return SelectedCity; }
 
-    /** @return pointer to the List of filtered city pointers. */
+    /** @return pointer to the List of filtered city pointers that are listed so far. */
     QList<GeoLocation*> filteredList() { return filteredCityList; }
 
     /**
@@ -153,7 +153,16 @@ public slots:
     void dataChanged();
     void slotOk();
 
+private slots:
+    /** Load more cities into the list when it is scrolled to the end. */
+    void slotCityListScrolled( int value );
+
 private:
+    /** Append the next page of cities matching the filter to the list.
+     * @return false if all matching cities are listed already
+     */
+    bool fetchMoreCities();
+
     /** Make sure Longitude and Latitude values are valid. */
     bool checkLongLat( void );
 
@@ -162,6 +171,8 @@ private:
     LocationDialogUI *ld;
     GeoLocation *SelectedCity;
     QList<GeoLocation*> filteredCityList;
+    // Number of cities matching the filter, including those not listed yet
+    int matchingCityCount;
     QTimer *timer;
 };
 
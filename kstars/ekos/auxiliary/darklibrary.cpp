@@ -8,6 +8,13 @@
  */
 
 #include <QVariantMap>
+#include <QMutexLocker>
+
+#include <limits>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "darklibrary.h"
 #include "Options.h"
@@ -17,6 +24,7 @@
 #include "kstarsdata.h"
 #include "fitsviewer/fitsview.h"
 #include "fitsviewer/fitsdata.h"
+#include "fitsviewer/fitsbufferpool.h"
 #include "auxiliary/ksuserdb.h"
 
 namespace Ekos
@@ -32,7 +40,7 @@ DarkLibrary * DarkLibrary::Instance()
     return _DarkLibrary;
 }
 
-DarkLibrary::DarkLibrary(QObject *parent) : QObject(parent)
+DarkLibrary::DarkLibrary(QObject *parent) : QObject(parent), cacheMutex(QMutex::Recursive)
 {
     KStarsData::Instance()->userdb()->GetAllDarkFrames(darkFrames);
 
@@ -42,6 +50,8 @@ DarkLibrary::DarkLibrary(QObject *parent) : QObject(parent)
     subtractParams.offsetY=0;
     subtractParams.targetChip=0;
     subtractParams.targetImage=0;
+    subtractParams.masterFrames=1;
+    subtractParams.capturedFrames=0;
 
     QDir writableDir;
     writableDir.mkdir(KSPaths::writableLocation(QStandardPaths::GenericDataLocation) + "darks");
@@ -49,11 +59,33 @@ DarkLibrary::DarkLibrary(QObject *parent) : QObject(parent)
 
 DarkLibrary::~DarkLibrary()
 {
+    QMutexLocker locker(&cacheMutex);
+
+    clearCroppedDarks(NULL);
     qDeleteAll(darkFiles);
 }
 
 FITSData * DarkLibrary::getDarkFrame(ISD::CCDChip *targetChip, double duration)
 {
+    QMutexLocker locker(&cacheMutex);
+
+    return findDarkFrame(targetChip, duration);
+}
+
+QString DarkLibrary::getDarkFrameKey(ISD::CCDChip *targetChip, double duration)
+{
+    QMutexLocker locker(&cacheMutex);
+
+    FITSData *darkData = findDarkFrame(targetChip, duration);
+
+    return darkData ? darkFiles.key(darkData) : QString();
+}
+
+FITSData * DarkLibrary::findDarkFrame(ISD::CCDChip *targetChip, double duration)
+{
+    QString scaledFilename, biasFilename;
+    double scaledDuration=0;
+
     foreach(QVariantMap map, darkFrames)
     {
         // First check CCD name matches
@@ -78,20 +110,36 @@ FITSData * DarkLibrary::getDarkFrame(ISD::CCDChip *targetChip, double duration)
                             continue;
                     }
 
+                    // Check if the duration is acceptable
+                    QDateTime frameTime = QDateTime::fromString(map["timestamp"].toString(), Qt::ISODate);
+                    if (frameTime.daysTo(QDateTime::currentDateTime()) > Options::darkLibraryDuration())
+                        continue;
+
                     // Then check for duration
                     // TODO make this value configurable
                     if (fabs(map["duration"].toDouble() - duration) > 0.05)
+                    {
+                        // Keep the dark frame closest in duration in case we can scale it
+                        double darkDuration = map["duration"].toDouble();
+                        // A zero second dark is a bias frame, the pedestal of the scaled dark
+                        if (darkDuration <= 0.05)
+                            biasFilename = map["filename"].toString();
+                        if (Options::darkLibraryScaling() && darkDuration > 0.05 &&
+                                (scaledFilename.isEmpty() || fabs(darkDuration - duration) < fabs(scaledDuration - duration)))
+                        {
+                            scaledFilename = map["filename"].toString();
+                            scaledDuration = darkDuration;
+                        }
                         continue;
-
-                    // Finaly check if the duration is acceptable
-                    QDateTime frameTime = QDateTime::fromString(map["timestamp"].toString(), Qt::ISODate);
-                    if (frameTime.daysTo(QDateTime::currentDateTime()) > Options::darkLibraryDuration())
-                        continue;
+                    }
 
                     QString filename = map["filename"].toString();
 
                     if (darkFiles.contains(filename))
+                    {
+                        touchDarkFile(filename);
                         return darkFiles[filename];
+                    }
 
                     // Finally we made it, let's put it in the hash
                     bool rc = loadDarkFile(filename);
@@ -104,9 +152,133 @@ FITSData * DarkLibrary::getDarkFrame(ISD::CCDChip *targetChip, double duration)
         }
     }
 
+    if (scaledFilename.isEmpty() == false)
+        return getScaledDarkFrame(scaledFilename, scaledDuration, duration, biasFilename);
+
     return NULL;
 }
 
+FITSData * DarkLibrary::getScaledDarkFrame(const QString &filename, double darkDuration, double duration, const QString &biasFilename)
+{
+    QString key = QString("%1@%2").arg(filename).arg(duration, 0, 'f', 3);
+
+    if (darkFiles.contains(key))
+    {
+        touchDarkFile(key);
+        return darkFiles[key];
+    }
+
+    FITSData *darkData = new FITSData();
+
+    if (darkData->loadFITS(filename) == false)
+    {
+        emit newLog(i18n("Failed to load dark frame file %1", filename));
+        delete (darkData);
+        return NULL;
+    }
+
+    // Only the dark current grows with the exposure, the bias is kept as is
+    FITSData *biasData = NULL;
+    if (biasFilename.isEmpty() == false)
+    {
+        biasData = new FITSData();
+        if (biasData->loadFITS(biasFilename) == false || biasData->getWidth() != darkData->getWidth() ||
+                biasData->getHeight() != darkData->getHeight() || biasData->getNumOfChannels() != darkData->getNumOfChannels() ||
+                biasData->getDataType() != darkData->getDataType())
+        {
+            delete (biasData);
+            biasData = NULL;
+        }
+    }
+
+    double factor = duration / darkDuration;
+    bool rc = true;
+
+    switch (darkData->getDataType())
+    {
+        case TBYTE:
+            scaleDark<uint8_t>(darkData, biasData, factor);
+            break;
+
+        case TSHORT:
+            scaleDark<int16_t>(darkData, biasData, factor);
+            break;
+
+        case TUSHORT:
+            scaleDark<uint16_t>(darkData, biasData, factor);
+            break;
+
+        case TLONG:
+            scaleDark<int32_t>(darkData, biasData, factor);
+            break;
+
+        case TULONG:
+            scaleDark<uint32_t>(darkData, biasData, factor);
+            break;
+
+        case TFLOAT:
+            scaleDark<float>(darkData, biasData, factor);
+            break;
+
+        case TLONGLONG:
+            scaleDark<int64_t>(darkData, biasData, factor);
+            break;
+
+        case TDOUBLE:
+            scaleDark<double>(darkData, biasData, factor);
+        break;
+
+        default:
+            rc = false;
+            break;
+    }
+
+    delete (biasData);
+
+    if (rc == false)
+    {
+        delete (darkData);
+        return NULL;
+    }
+
+    emit newLog(i18n("Scaling %1 seconds dark frame to %2 seconds.", darkDuration, duration));
+
+    cacheDarkFile(key, darkData);
+
+    return darkData;
+}
+
+template<typename T> void DarkLibrary::scaleDark(FITSData *darkData, FITSData *biasData, double factor)
+{
+    T *buffer = reinterpret_cast<T*>(darkData->getImageBuffer());
+    const T *biasBuffer = biasData ? reinterpret_cast<T*>(biasData->getImageBuffer()) : NULL;
+    uint32_t size = darkData->getSize();
+
+    const double minValue = static_cast<double>(std::numeric_limits<T>::lowest());
+    const double maxValue = static_cast<double>(std::numeric_limits<T>::max());
+
+    for (int channel=0; channel < darkData->getNumOfChannels(); channel++)
+    {
+        T *channelBuffer = buffer + channel * size;
+
+        if (biasBuffer)
+        {
+            const T *channelBias = biasBuffer + channel * size;
+            for (uint32_t i=0; i < size; i++)
+                channelBuffer[i] = static_cast<T>(qBound(minValue, channelBias[i] + (static_cast<double>(channelBuffer[i]) - channelBias[i]) * factor, maxValue));
+        }
+        else
+        {
+            // Without a bias frame, the darkest pixel of the channel holds the least dark current above the bias
+            const double pedestal = darkData->getMin(channel);
+            for (uint32_t i=0; i < size; i++)
+                channelBuffer[i] = static_cast<T>(qBound(minValue, pedestal + (channelBuffer[i] - pedestal) * factor, maxValue));
+        }
+    }
+
+    darkData->calculateStats(true);
+}
+
 bool DarkLibrary::loadDarkFile(const QString &filename)
 {
     FITSData *darkData = new FITSData();
@@ -114,7 +286,7 @@ bool DarkLibrary::loadDarkFile(const QString &filename)
     bool rc = darkData->loadFITS(filename);
 
     if (rc)
-        darkFiles[filename] = darkData;
+        cacheDarkFile(filename, darkData);
     else
     {
         emit newLog(i18n("Failed to load dark frame file %1", filename));
@@ -133,7 +305,9 @@ bool DarkLibrary::saveDarkFile(FITSData *darkData)
     if (darkData->saveFITS(path) != 0)
         return false;
 
-    darkFiles[path] = darkData;
+    QMutexLocker locker(&cacheMutex);
+
+    cacheDarkFile(path, darkData);
 
     QVariantMap map;
     int binX, binY;
@@ -159,43 +333,228 @@ bool DarkLibrary::saveDarkFile(FITSData *darkData)
     return true;
 }
 
+void DarkLibrary::cacheDarkFile(const QString &key, FITSData *darkData)
+{
+    if (darkFiles.contains(key) && darkFiles[key] != darkData)
+    {
+        clearCroppedDarks(darkFiles[key]);
+        delete (darkFiles[key]);
+    }
+
+    darkFiles[key] = darkData;
+    touchDarkFile(key);
+    trimCache(key);
+}
+
+void DarkLibrary::touchDarkFile(const QString &key)
+{
+    darkFilesUsage.removeOne(key);
+    darkFilesUsage.append(key);
+}
+
+void DarkLibrary::trimCache(const QString &keep)
+{
+    quint64 budget = static_cast<quint64>(Options::darkLibraryCacheSize()) * 1024 * 1024;
+
+    int i=0;
+    while (cacheSize() > budget && i < darkFilesUsage.count())
+    {
+        QString key = darkFilesUsage.at(i);
+
+        // Never drop the frame we are about to use
+        if (key == keep)
+        {
+            i++;
+            continue;
+        }
+
+        darkFilesUsage.removeAt(i);
+        FITSData *darkData = darkFiles.take(key);
+        clearCroppedDarks(darkData);
+        delete (darkData);
+    }
+}
+
+void DarkLibrary::clearCroppedDarks(FITSData *darkData)
+{
+    for (int i=croppedDarks.count()-1; i >= 0; i--)
+    {
+        if (darkData == NULL || croppedDarks[i].darkData == darkData)
+        {
+            if (croppedDarks[i].size > 0)
+                FITSBufferPool::Instance()->release(croppedDarks[i].buffer);
+            croppedDarks.removeAt(i);
+        }
+    }
+}
+
+quint64 DarkLibrary::frameSize(FITSData *data)
+{
+    return static_cast<quint64>(data->getSize()) * data->getNumOfChannels() * data->getBytesPerPixel();
+}
+
+quint64 DarkLibrary::cacheSize() const
+{
+    quint64 total=0;
+
+    foreach(FITSData *darkData, darkFiles)
+        total += frameSize(darkData);
+
+    foreach(const CroppedDark &oneCrop, croppedDarks)
+        total += oneCrop.size;
+
+    return total;
+}
+
+DarkLibrary::CroppedDark * DarkLibrary::getCroppedDark(FITSData *darkData, uint16_t offsetX, uint16_t offsetY, uint16_t width, uint16_t height)
+{
+    for (int i=0; i < croppedDarks.count(); i++)
+    {
+        CroppedDark &oneCrop = croppedDarks[i];
+        if (oneCrop.darkData == darkData && oneCrop.offsetX == offsetX && oneCrop.offsetY == offsetY && oneCrop.width == width && oneCrop.height == height)
+            return &oneCrop;
+    }
+
+    if (offsetX + width > darkData->getWidth() || offsetY + height > darkData->getHeight())
+    {
+        emit newLog(i18n("Dark frame is smaller than the light frame."));
+        return NULL;
+    }
+
+    int BBP = darkData->getBytesPerPixel();
+
+    CroppedDark oneCrop;
+    oneCrop.darkData = darkData;
+    oneCrop.offsetX  = offsetX;
+    oneCrop.offsetY  = offsetY;
+    oneCrop.width    = width;
+    oneCrop.height   = height;
+
+    // The light frame covers the whole dark frame, subtract the dark frame buffer itself
+    if (offsetX == 0 && offsetY == 0 && width == darkData->getWidth() && height == darkData->getHeight())
+    {
+        oneCrop.buffer = darkData->getImageBuffer();
+        oneCrop.size   = 0;
+        croppedDarks.append(oneCrop);
+        return &croppedDarks.last();
+    }
+
+    oneCrop.size     = static_cast<size_t>(width) * height * BBP;
+    oneCrop.buffer   = FITSBufferPool::Instance()->acquire(oneCrop.size);
+
+    if (oneCrop.buffer == NULL)
+        return NULL;
+
+    uint8_t *darkBuffer = darkData->getImageBuffer();
+    uint32_t darkW      = darkData->getWidth();
+
+    // Copy data line by line
+    for (int i=0; i < height; i++)
+        memcpy(oneCrop.buffer + i * width * BBP, darkBuffer + ((offsetY + i) * darkW + offsetX) * BBP, width * BBP);
+
+    croppedDarks.append(oneCrop);
+
+    QString key = darkFiles.key(darkData);
+    if (key.isEmpty() == false)
+    {
+        trimCache(key);
+
+        // Cropping may have pushed us over the budget, in which case the crop was dropped again
+        for (int i=0; i < croppedDarks.count(); i++)
+        {
+            if (croppedDarks[i].buffer == oneCrop.buffer)
+                return &croppedDarks[i];
+        }
+    }
+    else
+        return &croppedDarks.last();
+
+    return NULL;
+}
+
 bool DarkLibrary::subtract(FITSData *darkData, FITSView *lightImage, FITSScale filter, uint16_t offsetX, uint16_t offsetY)
 {
    Q_ASSERT(darkData);
    Q_ASSERT(lightImage);
 
+    FITSData *lightData = lightImage->getImageData();
+
+    cacheMutex.lock();
+    // Dark frame might have been dropped from the cache since it was requested
+    bool rc = darkFiles.key(darkData).isEmpty() == false && subtractData(darkData, lightData, offsetX, offsetY);
+    cacheMutex.unlock();
+
+    if (rc == false)
+    {
+        emit darkFrameCompleted(false);
+        return false;
+    }
+
+    lightData->applyFilter(filter);
+    if (filter == FITS_NONE)
+        lightData->calculateStats(true);
+    lightImage->rescale(ZOOM_KEEP_LEVEL);
+    lightImage->updateFrame();
+
+    emit darkFrameCompleted(true);
+
+    return true;
+}
+
+bool DarkLibrary::subtract(const QString &darkKey, FITSData *lightData, uint16_t offsetX, uint16_t offsetY)
+{
+    Q_ASSERT(lightData);
+
+    QMutexLocker locker(&cacheMutex);
+
+    // Dark frame might have been dropped from the cache since it was requested
+    FITSData *darkData = darkFiles.value(darkKey);
+    if (darkData == NULL)
+        return false;
+
+    return subtractData(darkData, lightData, offsetX, offsetY);
+}
+
+bool DarkLibrary::subtractData(FITSData *darkData, FITSData *lightData, uint16_t offsetX, uint16_t offsetY)
+{
+    if (darkData->getDataType() != lightData->getDataType())
+    {
+        emit newLog(i18n("Dark frame data type does not match the light frame."));
+        return false;
+    }
+
     switch (darkData->getDataType())
     {
         case TBYTE:
-            return subtract<uint8_t>(darkData, lightImage, filter, offsetX, offsetY);
+            return subtract<uint8_t>(darkData, lightData, offsetX, offsetY);
             break;
 
         case TSHORT:
-            return subtract<int16_t>(darkData, lightImage, filter, offsetX, offsetY);
+            return subtract<int16_t>(darkData, lightData, offsetX, offsetY);
             break;
 
         case TUSHORT:
-            return subtract<uint16_t>(darkData, lightImage, filter, offsetX, offsetY);
+            return subtract<uint16_t>(darkData, lightData, offsetX, offsetY);
             break;
 
         case TLONG:
-            return subtract<int32_t>(darkData, lightImage, filter, offsetX, offsetY);
+            return subtract<int32_t>(darkData, lightData, offsetX, offsetY);
             break;
 
         case TULONG:
-            return subtract<uint32_t>(darkData, lightImage, filter, offsetX, offsetY);
+            return subtract<uint32_t>(darkData, lightData, offsetX, offsetY);
             break;
 
         case TFLOAT:
-            return subtract<float>(darkData, lightImage, filter, offsetX, offsetY);
+            return subtract<float>(darkData, lightData, offsetX, offsetY);
             break;
 
         case TLONGLONG:
-            return subtract<int64_t>(darkData, lightImage, filter, offsetX, offsetY);
+            return subtract<int64_t>(darkData, lightData, offsetX, offsetY);
             break;
 
         case TDOUBLE:
-            return subtract<double>(darkData, lightImage, filter, offsetX, offsetY);
+            return subtract<double>(darkData, lightData, offsetX, offsetY);
         break;
 
         default:
@@ -205,44 +564,108 @@ bool DarkLibrary::subtract(FITSData *darkData, FITSView *lightImage, FITSScale f
     return false;
 }
 
-template<typename T> bool DarkLibrary::subtract(FITSData *darkData, FITSView *lightImage, FITSScale filter, uint16_t offsetX, uint16_t offsetY)
+namespace
 {
-    FITSData *lightData = lightImage->getImageData();
+// Subtract dark from light, clamping negative results to zero
+template<typename T> void subtractSaturated(T *lightBuffer, const T *darkBuffer, uint32_t count)
+{
+    for (uint32_t i=0; i < count; i++)
+        lightBuffer[i] = (lightBuffer[i] > darkBuffer[i]) ? lightBuffer[i] - darkBuffer[i] : 0;
+}
 
-    T *darkBuffer     = reinterpret_cast<T*>(darkData->getImageBuffer());
-    T *lightBuffer    = reinterpret_cast<T*>(lightData->getImageBuffer());
+#ifdef __SSE2__
+template<> void subtractSaturated<uint8_t>(uint8_t *lightBuffer, const uint8_t *darkBuffer, uint32_t count)
+{
+    uint32_t i=0;
 
-    int darkoffset   = offsetX + offsetY * darkData->getWidth();
-    int darkW        = darkData->getWidth();
+    for (; i + 16 <= count; i += 16)
+    {
+        __m128i light = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lightBuffer + i));
+        __m128i dark  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(darkBuffer + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lightBuffer + i), _mm_subs_epu8(light, dark));
+    }
+
+    for (; i < count; i++)
+        lightBuffer[i] = (lightBuffer[i] > darkBuffer[i]) ? lightBuffer[i] - darkBuffer[i] : 0;
+}
 
-    int lightOffset  = 0;
-    int lightW       = lightData->getWidth();
-    int lightH       = lightData->getHeight();
+template<> void subtractSaturated<uint16_t>(uint16_t *lightBuffer, const uint16_t *darkBuffer, uint32_t count)
+{
+    uint32_t i=0;
 
-    for (int i=0; i < lightH; i++)
+    for (; i + 8 <= count; i += 8)
     {
-        for (int j=0; j < lightW; j++)
-        {
-            if (lightBuffer[j+lightOffset] > darkBuffer[j+darkoffset])
-                lightBuffer[j+lightOffset] -= darkBuffer[j+darkoffset];
-            else
-                lightBuffer[j+lightOffset] = 0;
-        }
+        __m128i light = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lightBuffer + i));
+        __m128i dark  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(darkBuffer + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lightBuffer + i), _mm_subs_epu16(light, dark));
+    }
+
+    for (; i < count; i++)
+        lightBuffer[i] = (lightBuffer[i] > darkBuffer[i]) ? lightBuffer[i] - darkBuffer[i] : 0;
+}
+
+template<> void subtractSaturated<int16_t>(int16_t *lightBuffer, const int16_t *darkBuffer, uint32_t count)
+{
+    uint32_t i=0;
+    const __m128i zero = _mm_setzero_si128();
 
-        lightOffset += lightW;
-        darkoffset  += darkW;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i light = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lightBuffer + i));
+        __m128i dark  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(darkBuffer + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lightBuffer + i), _mm_max_epi16(_mm_subs_epi16(light, dark), zero));
     }
 
-    lightData->applyFilter(filter);
-    if (filter == FITS_NONE)
-        lightData->calculateStats(true);
-    lightImage->rescale(ZOOM_KEEP_LEVEL);
-    lightImage->updateFrame();
+    for (; i < count; i++)
+        lightBuffer[i] = (lightBuffer[i] > darkBuffer[i]) ? lightBuffer[i] - darkBuffer[i] : 0;
+}
+#endif
+}
 
-    emit darkFrameCompleted(true);
+template<typename T> bool DarkLibrary::subtract(FITSData *darkData, FITSData *lightData, uint16_t offsetX, uint16_t offsetY)
+{
+    uint16_t lightW  = lightData->getWidth();
+    uint16_t lightH  = lightData->getHeight();
+
+    CroppedDark *croppedDark = getCroppedDark(darkData, offsetX, offsetY, lightW, lightH);
+
+    if (croppedDark == NULL)
+        return false;
+
+    T *darkBuffer     = reinterpret_cast<T*>(croppedDark->buffer);
+    T *lightBuffer    = reinterpret_cast<T*>(lightData->getImageBuffer());
+
+    subtractSaturated<T>(lightBuffer, darkBuffer, static_cast<uint32_t>(lightW) * lightH);
 
     return true;
+}
+
+template<typename T> void DarkLibrary::accumulateMaster(FITSData *darkData)
+{
+    T *buffer = reinterpret_cast<T*>(darkData->getImageBuffer());
+    int size  = darkData->getSize() * darkData->getNumOfChannels();
 
+    if (masterAccumulator.size() != size)
+        masterAccumulator.fill(0, size);
+
+    double *sum = masterAccumulator.data();
+
+    for (int i=0; i < size; i++)
+        sum[i] += buffer[i];
+}
+
+template<typename T> void DarkLibrary::averageMaster(FITSData *darkData)
+{
+    T *buffer = reinterpret_cast<T*>(darkData->getImageBuffer());
+    int size  = qMin(static_cast<int>(darkData->getSize() * darkData->getNumOfChannels()), masterAccumulator.size());
+    const double *sum = masterAccumulator.constData();
+    const double frames = subtractParams.capturedFrames;
+    const double rounding = std::numeric_limits<T>::is_integer ? 0.5 : 0;
+
+    for (int i=0; i < size; i++)
+        buffer[i] = static_cast<T>(sum[i] / frames + rounding);
+
+    darkData->calculateStats(true);
 }
 
 bool DarkLibrary::captureAndSubtract(ISD::CCDChip *targetChip, FITSView*targetImage, double duration, uint16_t offsetX, uint16_t offsetY)
@@ -294,6 +717,10 @@ bool DarkLibrary::captureAndSubtract(ISD::CCDChip *targetChip, FITSView*targetIm
     subtractParams.duration   = duration;
     subtractParams.offsetX    = offsetX;
     subtractParams.offsetY    = offsetY;
+    subtractParams.masterFrames   = qMax(1u, Options::darkLibraryMasterFrames());
+    subtractParams.capturedFrames = 0;
+
+    masterAccumulator.clear();
 
     connect(targetChip->getCCD(), SIGNAL(BLOBUpdated(IBLOB*)), this, SLOT(newFITS(IBLOB*)));
 
@@ -319,20 +746,121 @@ void DarkLibrary::newFITS(IBLOB *bp)
     FITSData *calibrationData = new FITSData();
 
     // Deep copy of the data
-    if (calibrationData->loadFITS(calibrationView->getImageData()->getFilename()))
-    {
-        saveDarkFile(calibrationData);
-        subtract(calibrationData, subtractParams.targetImage, subtractParams.targetChip->getCaptureFilter(), subtractParams.offsetX, subtractParams.offsetY);
-    }
-    else
+    if (calibrationData->loadFITS(calibrationView->getImageData()->getFilename()) == false)
     {
+        delete (calibrationData);
+        masterAccumulator.clear();
         emit darkFrameCompleted(false);
         emit newLog(i18n("Warning: Cannot load calibration file %1", calibrationView->getImageData()->getFilename()));
+        return;
     }
-}
 
-}
+    if (subtractParams.masterFrames > 1)
+    {
+        subtractParams.capturedFrames++;
+
+        switch (calibrationData->getDataType())
+        {
+            case TBYTE:
+                accumulateMaster<uint8_t>(calibrationData);
+                break;
+
+            case TSHORT:
+                accumulateMaster<int16_t>(calibrationData);
+                break;
 
+            case TUSHORT:
+                accumulateMaster<uint16_t>(calibrationData);
+                break;
 
+            case TLONG:
+                accumulateMaster<int32_t>(calibrationData);
+                break;
 
+            case TULONG:
+                accumulateMaster<uint32_t>(calibrationData);
+                break;
 
+            case TFLOAT:
+                accumulateMaster<float>(calibrationData);
+                break;
+
+            case TLONGLONG:
+                accumulateMaster<int64_t>(calibrationData);
+                break;
+
+            case TDOUBLE:
+                accumulateMaster<double>(calibrationData);
+            break;
+
+            default:
+            break;
+        }
+
+        if (subtractParams.capturedFrames < subtractParams.masterFrames)
+        {
+            delete (calibrationData);
+
+            connect(subtractParams.targetChip->getCCD(), SIGNAL(BLOBUpdated(IBLOB*)), this, SLOT(newFITS(IBLOB*)));
+
+            emit newLog(i18n("Capturing dark frame %1 of %2...", subtractParams.capturedFrames+1, subtractParams.masterFrames));
+
+            subtractParams.targetChip->capture(subtractParams.duration);
+            return;
+        }
+
+        switch (calibrationData->getDataType())
+        {
+            case TBYTE:
+                averageMaster<uint8_t>(calibrationData);
+                break;
+
+            case TSHORT:
+                averageMaster<int16_t>(calibrationData);
+                break;
+
+            case TUSHORT:
+                averageMaster<uint16_t>(calibrationData);
+                break;
+
+            case TLONG:
+                averageMaster<int32_t>(calibrationData);
+                break;
+
+            case TULONG:
+                averageMaster<uint32_t>(calibrationData);
+                break;
+
+            case TFLOAT:
+                averageMaster<float>(calibrationData);
+                break;
+
+            case TLONGLONG:
+                averageMaster<int64_t>(calibrationData);
+                break;
+
+            case TDOUBLE:
+                averageMaster<double>(calibrationData);
+            break;
+
+            default:
+            break;
+        }
+
+        masterAccumulator.clear();
+
+        emit newLog(i18n("Master dark frame averaged from %1 frames.", subtractParams.capturedFrames));
+    }
+
+    // Keep the frame in the cache even if it could not be saved, so it can be subtracted
+    if (saveDarkFile(calibrationData) == false)
+    {
+        emit newLog(i18n("Warning: Failed to save dark frame."));
+        QMutexLocker locker(&cacheMutex);
+        cacheDarkFile(calibrationData->getFilename(), calibrationData);
+    }
+
+    subtract(calibrationData, subtractParams.targetImage, subtractParams.targetChip->getCaptureFilter(), subtractParams.offsetX, subtractParams.offsetY);
+}
+
+}
@@ -11,6 +11,8 @@
 #define DARKLIBRARY_H
 
 #include <QObject>
+#include <QVector>
+#include <QMutex>
 #include "indi/indiccd.h"
 
 namespace Ekos
@@ -20,8 +22,17 @@ namespace Ekos
  *@class DarkLibrary
  *@short Handles aquisition & loading of dark frames for cameras. If a suitable dark frame exists, it is loaded from disk, otherwise it gets captured and saved
  * for later use.
+ *
+ * Loaded dark frames are kept in memory within the DarkLibraryCacheSize budget, least recently used frames are dropped first.
+ * For each light frame geometry (sub-frame offset and size) the matching region of the dark frame is cropped once and cached, so
+ * consecutive guide and focus frames subtract a contiguous buffer. Master darks may be averaged from several captures and,
+ * if DarkLibraryScaling is enabled, scaled to exposure durations that have no dark frame of their own. Only the dark current is
+ * scaled: the bias, taken from a zero second dark frame if the library has one, is subtracted before and added back after.
+ *
+ * Subtraction at the data level may be called from a worker thread (e.g. the Ekos image pipeline). Access to the cache is
+ * serialized so a dark frame cannot be evicted while it is being subtracted.
  *@author Jasem Mutlaq
- *@version 1.0
+ *@version 1.1
  */
 class DarkLibrary : public QObject
 {
@@ -33,7 +44,19 @@ public:
     static DarkLibrary *Instance();
 
     FITSData * getDarkFrame(ISD::CCDChip *targetChip, double duration);
+    /**
+     * @brief getDarkFrameKey Find the dark frame as getDarkFrame() does.
+     * @return key of the dark frame in the cache, for subtracting it later from another thread, or an empty string if there is none.
+     */
+    QString getDarkFrameKey(ISD::CCDChip *targetChip, double duration);
     bool subtract(FITSData *darkData, FITSView *lightImage, FITSScale filter, uint16_t offsetX, uint16_t offsetY);
+    /**
+     * @brief subtract Subtract dark frame from light data without updating any view. Thread safe.
+     * @param darkKey dark frame as returned by getDarkFrameKey(). Fails if the dark frame is no longer in the cache.
+     * @param lightData light frame data. Filters and statistics are left to the caller.
+     * @return true if successful, false otherwise.
+     */
+    bool subtract(const QString &darkKey, FITSData *lightData, uint16_t offsetX, uint16_t offsetY);
     // Return false if canceled. True if dark capture proceeds
     bool captureAndSubtract(ISD::CCDChip *targetChip, FITSView*targetImage, double duration, uint16_t offsetX, uint16_t offsetY);
 
@@ -53,13 +76,53 @@ private:
   ~DarkLibrary();
   static DarkLibrary * _DarkLibrary;
 
+  // Cropped region of a dark frame matching the geometry of a light frame
+  typedef struct
+  {
+      FITSData *darkData;
+      uint16_t offsetX;
+      uint16_t offsetY;
+      uint16_t width;
+      uint16_t height;
+      // Either a copy, or the buffer of the dark frame itself if the light frame covers it entirely
+      uint8_t *buffer;
+      // Size of the copy, 0 if the buffer belongs to the dark frame
+      size_t size;
+  } CroppedDark;
+
   bool loadDarkFile(const QString &filename);
   bool saveDarkFile(FITSData *darkData);
-
-  template<typename T> bool subtract(FITSData *darkData, FITSView *lightImage, FITSScale filter, uint16_t offsetX, uint16_t offsetY);
+  // The cache must be locked by the caller of these
+  FITSData *findDarkFrame(ISD::CCDChip *targetChip, double duration);
+  bool subtractData(FITSData *darkData, FITSData *lightData, uint16_t offsetX, uint16_t offsetY);
+  FITSData *getScaledDarkFrame(const QString &filename, double darkDuration, double duration, const QString &biasFilename);
+
+  // Memory budget
+  void cacheDarkFile(const QString &key, FITSData *darkData);
+  void touchDarkFile(const QString &key);
+  void trimCache(const QString &keep);
+  void clearCroppedDarks(FITSData *darkData);
+  quint64 cacheSize() const;
+  static quint64 frameSize(FITSData *data);
+
+  CroppedDark *getCroppedDark(FITSData *darkData, uint16_t offsetX, uint16_t offsetY, uint16_t width, uint16_t height);
+
+  template<typename T> bool subtract(FITSData *darkData, FITSData *lightData, uint16_t offsetX, uint16_t offsetY);
+  template<typename T> void scaleDark(FITSData *darkData, FITSData *biasData, double factor);
+  template<typename T> void accumulateMaster(FITSData *darkData);
+  template<typename T> void averageMaster(FITSData *darkData);
 
   QList<QVariantMap> darkFrames;
   QHash<QString, FITSData *> darkFiles;
+  // Least recently used dark files first
+  QStringList darkFilesUsage;
+  QList<CroppedDark> croppedDarks;
+
+  // Guards darkFiles, darkFilesUsage and croppedDarks
+  QMutex cacheMutex;
+
+  // Running sum of the dark frames averaged into a master dark
+  QVector<double> masterAccumulator;
 
   struct
   {
@@ -69,6 +132,8 @@ private:
       uint16_t offsetY;
       FITSView *targetImage;
       FITSScale filter;
+      uint32_t masterFrames;
+      uint32_t capturedFrames;
   } subtractParams;
 
 
@@ -0,0 +1,178 @@
+/*  Ekos Image Processing Pipeline
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#include "imagepipeline.h"
+
+#include <QtConcurrent>
+#include <QDebug>
+
+#include <KLocalizedString>
+
+#include "darklibrary.h"
+#include "fitsviewer/fitsdata.h"
+#include "Options.h"
+
+namespace Ekos
+{
+
+ImagePipeline::Parameters ImagePipeline::defaultParameters(FITSMode mode)
+{
+    Parameters params;
+
+    params.mode        = mode;
+    params.filter      = FITS_NONE;
+    params.offsetX     = 0;
+    params.offsetY     = 0;
+    params.detectStars = false;
+    params.algorithm   = ALGORITHM_CENTROID;
+    params.HFR         = HFR_AVERAGE;
+
+    return params;
+}
+
+ImagePipeline::ImagePipeline(QObject *parent) : QObject(parent)
+{
+    workerPool.setMaxThreadCount(1);
+    latestSequenceID = 0;
+    abortedSequenceID = 0;
+}
+
+ImagePipeline::~ImagePipeline()
+{
+    abort();
+    workerPool.waitForDone();
+
+    // Release any data that finished after we aborted
+    foreach(QFutureWatcher<Result> *watcher, watchers)
+    {
+        delete (watcher->result().data);
+        delete (watcher);
+    }
+}
+
+quint32 ImagePipeline::process(const QString &filename, const Parameters &params)
+{
+    quint32 sequenceID = static_cast<quint32>(latestSequenceID.fetchAndAddOrdered(1)) + 1;
+
+    QFutureWatcher<Result> *watcher = new QFutureWatcher<Result>(this);
+    connect(watcher, SIGNAL(finished()), this, SLOT(processResult()));
+    watchers.append(watcher);
+
+    watcher->setFuture(QtConcurrent::run(&workerPool, &ImagePipeline::processFrame, sequenceID, filename, params, &latestSequenceID));
+
+    return sequenceID;
+}
+
+void ImagePipeline::abort()
+{
+    abortedSequenceID = lastSequenceID();
+}
+
+void ImagePipeline::processResult()
+{
+    QFutureWatcher<Result> *watcher = static_cast<QFutureWatcher<Result> *>(sender());
+
+    watchers.removeOne(watcher);
+    Result result = watcher->result();
+    watcher->deleteLater();
+
+    if (result.dropped || result.sequenceID <= abortedSequenceID)
+    {
+        if (Options::fITSLogging())
+            qDebug() << "ImagePipeline: dropping stale frame #" << result.sequenceID;
+
+        delete (result.data);
+        emit frameDropped(result.sequenceID);
+        return;
+    }
+
+    if (result.data == NULL)
+    {
+        emit frameFailed(result.sequenceID, result.message);
+        return;
+    }
+
+    emit frameProcessed(result.sequenceID, result.data, result.HFR);
+}
+
+ImagePipeline::Result ImagePipeline::processFrame(quint32 sequenceID, const QString &filename, const Parameters &params, QAtomicInt *latestSequenceID)
+{
+    Result result;
+    result.sequenceID = sequenceID;
+    result.data       = NULL;
+    result.HFR        = -1;
+    result.dropped    = false;
+
+    // A newer frame is already waiting, no need to process this one
+    if (static_cast<quint32>(latestSequenceID->load()) > sequenceID)
+    {
+        result.dropped = true;
+        return result;
+    }
+
+    // #1 Load. Statistics are calculated as part of loading.
+    // Loading is silent, errors are reported to the GUI thread through frameFailed() instead of dialogs.
+    FITSData *data = new FITSData(params.mode);
+    data->setNotifyErrors(false);
+    bool loaded = data->loadFITS(filename, true);
+    if (loaded == false || data->getLastError().isEmpty() == false)
+    {
+        if (data->getLastError().isEmpty())
+            result.message = i18n("Failed to load image %1", filename);
+        else
+            result.message = i18n("Failed to load image %1: %2", filename, data->getLastError());
+        delete (data);
+        return result;
+    }
+
+    // #2 Calibrate
+    if (params.darkFrame.isEmpty() == false)
+    {
+        if (DarkLibrary::Instance()->subtract(params.darkFrame, data, params.offsetX, params.offsetY))
+        {
+            data->applyFilter(params.filter);
+            if (params.filter == FITS_NONE)
+                data->calculateStats(true);
+        }
+        else
+            result.message = i18n("Dark frame subtraction failed.");
+    }
+
+    // #3 Detect
+    if (params.detectStars)
+    {
+        if (params.boundary.isNull() == false)
+        {
+            switch (params.algorithm)
+            {
+                case ALGORITHM_GRADIENT:
+                    FITSData::findCannyStar(data, params.boundary);
+                    break;
+
+                case ALGORITHM_CENTROID:
+                    data->findStars(params.boundary);
+                    break;
+
+                case ALGORITHM_THRESHOLD:
+                    data->findOneStar(params.boundary);
+                    break;
+            }
+        }
+        else
+            data->findStars();
+
+        result.HFR = data->getHFR(params.HFR);
+    }
+
+    result.data = data;
+
+    return result;
+}
+
+}
@@ -0,0 +1,122 @@
+/*  Ekos Image Processing Pipeline
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef IMAGEPIPELINE_H
+#define IMAGEPIPELINE_H
+
+#include <QObject>
+#include <QRect>
+#include <QString>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <QFutureWatcher>
+
+#include "fitsviewer/fitscommon.h"
+
+class FITSData;
+
+namespace Ekos
+{
+
+/**
+ *@class ImagePipeline
+ *@short Loads, calibrates and analyses received images on a worker thread.
+ *
+ * Each received image is assigned a sequence ID and goes through load -> dark subtraction -> statistics -> star detection
+ * on a dedicated worker thread, so the GUI thread stays responsive while the image is being processed. Frames are processed
+ * one at a time in the order they were received. If a newer frame is submitted while an older one is still waiting, the
+ * older one is skipped. Results that arrive after abort() are dropped. Listeners can use the sequence ID to match results
+ * to the frames they requested.
+ *@version 1.0
+ */
+class ImagePipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    typedef struct
+    {
+        FITSMode mode;              // FITS mode of the resulting data
+        FITSScale filter;           // Filter to apply after dark subtraction
+        QString darkFrame;          // Key of the dark frame in the DarkLibrary, or empty to skip calibration
+        uint16_t offsetX;           // Sub-frame offset of the light frame within the dark frame
+        uint16_t offsetY;
+        bool detectStars;           // Run star detection?
+        QRect boundary;             // Star detection boundary, null for the whole frame
+        StarAlgorithm algorithm;    // Star detection algorithm
+        HFRType HFR;                // How to combine the HFR of detected stars
+    } Parameters;
+
+    /** Parameters with no calibration and no star detection */
+    static Parameters defaultParameters(FITSMode mode);
+
+    explicit ImagePipeline(QObject *parent=0);
+    ~ImagePipeline();
+
+    /**
+     * @brief process Queue an image file for processing.
+     * @param filename FITS file written by the CCD driver.
+     * @param params processing parameters.
+     * @return sequence ID of the frame.
+     */
+    quint32 process(const QString &filename, const Parameters &params);
+
+    /** Drop all frames still in process. No further signals are emitted for them. */
+    void abort();
+
+    /** @return true if no frame is being processed. */
+    bool isIdle() const { return watchers.isEmpty(); }
+
+    /** Sequence ID of the last submitted frame */
+    quint32 lastSequenceID() const { return static_cast<quint32>(latestSequenceID.load()); }
+
+signals:
+    /**
+     * @brief frameProcessed Emitted in the GUI thread once a frame is processed.
+     * @param sequenceID sequence ID returned by process()
+     * @param data loaded, calibrated and analysed data. The receiver takes ownership.
+     * @param HFR half flux radius of detected stars, or -1 if no stars were detected or detection was not requested.
+     */
+    void frameProcessed(quint32 sequenceID, FITSData *data, double HFR);
+    /**
+     * @brief frameFailed Emitted in the GUI thread if a frame could not be loaded or debayered.
+     * @param message translated error, for the receiver to show since the worker thread cannot.
+     */
+    void frameFailed(quint32 sequenceID, const QString &message);
+    void frameDropped(quint32 sequenceID);
+
+private slots:
+    void processResult();
+
+private:
+
+    typedef struct
+    {
+        quint32 sequenceID;
+        FITSData *data;
+        double HFR;
+        bool dropped;
+        QString message;
+    } Result;
+
+    static Result processFrame(quint32 sequenceID, const QString &filename, const Parameters &params, QAtomicInt *latestSequenceID);
+
+    // Single worker thread so frames are processed in order
+    QThreadPool workerPool;
+    QList<QFutureWatcher<Result> *> watchers;
+
+    QAtomicInt latestSequenceID;
+    // Results with a sequence ID up to and including this one are dropped
+    quint32 abortedSequenceID;
+};
+
+}
+
+#endif // IMAGEPIPELINE_H
@@ -30,6 +30,7 @@
 #include "fitsviewer/fitsview.h"
 #include "ekos/ekosmanager.h"
 #include "ekos/auxiliary/darklibrary.h"
+#include "ekos/auxiliary/imagepipeline.h"
 
 #include "kstars.h"
 #include "focusadaptor.h"
@@ -65,6 +66,10 @@ Focus::Focus()
     inAutoFocus       = false;
     inFocusLoop       = false;
     captureInProgress = false;
+    frameAnalyzed     = false;
+    pendingFrameID    = 0;
+    pipelineHFR       = -1;
+    frameFailureCount = 0;
     inSequenceFocus   = false;
     starSelected      = false;
     //frameModified     = false;
@@ -245,6 +250,10 @@ Focus::Focus()
 
     focusView->setStarsEnabled(true);
 
+    pipeline = new ImagePipeline(this);
+    connect(pipeline, SIGNAL(frameProcessed(quint32,FITSData*,double)), this, SLOT(processFrame(quint32,FITSData*,double)));
+    connect(pipeline, SIGNAL(frameFailed(quint32,QString)), this, SLOT(processFrameFailure(quint32,QString)));
+
     // Reset star center on auto star check toggle
     connect(autoStarCheck, &QCheckBox::toggled, this, [&](bool enabled){if (enabled) { starCenter = QVector3D(); starSelected=false; focusView->setTrackingBox(QRect());}});
 }
@@ -781,6 +790,12 @@ void Focus::stop(bool aborted)
 
     disconnect(currentCCD, SIGNAL(BLOBUpdated(IBLOB*)), this, SLOT(newFITS(IBLOB*)));
 
+    // Drop any frame still being processed, and let the chip load frames itself again
+    pipeline->abort();
+    frameAnalyzed = false;
+    frameFailureCount = 0;
+    targetChip->setAsyncLoad(false);
+
     if (rememberUploadMode != currentCCD->getUploadMode())
         currentCCD->setUploadMode(rememberUploadMode);
 
@@ -849,6 +864,8 @@ void Focus::capture()
     targetChip->setBinning(activeBin, activeBin);
 
     targetChip->setCaptureMode(FITS_FOCUS);
+    // Frames are loaded by the image pipeline
+    targetChip->setAsyncLoad(true);
 
     // Always disable filtering if using a dark frame and then re-apply after subtraction. TODO: Implement this in capture and guide and align
     if (darkFrameCheck->isChecked())
@@ -985,34 +1002,129 @@ void Focus::newFITS(IBLOB *bp)
     ISD::CCDChip *targetChip = currentCCD->getChip(ISD::CCDChip::PRIMARY_CCD);
     disconnect(currentCCD, SIGNAL(BLOBUpdated(IBLOB*)), this, SLOT(newFITS(IBLOB*)));
 
+    // The frame is received, capture() sets asynchronous loading again for the next one
+    targetChip->setAsyncLoad(false);
+
+    QString filename = QString(static_cast<char *>(bp->aux2));
+
+    QString darkFrame;
+    uint16_t offsetX=0, offsetY=0;
+
     if (darkFrameCheck->isChecked())
     {        
-        FITSData *darkData       = NULL;
         QVariantMap settings = frameSettings[targetChip];
-        uint16_t offsetX = settings["x"].toInt() / settings["binx"].toInt();
-        uint16_t offsetY = settings["y"].toInt() / settings["biny"].toInt();
+        offsetX = settings["x"].toInt() / settings["binx"].toInt();
+        offsetY = settings["y"].toInt() / settings["biny"].toInt();
 
-        darkData = DarkLibrary::Instance()->getDarkFrame(targetChip, exposureIN->value());
+        // The dark frame is subtracted in the image pipeline, by then it may have been dropped from the cache
+        darkFrame = DarkLibrary::Instance()->getDarkFrameKey(targetChip, exposureIN->value());
 
-        connect(DarkLibrary::Instance(), SIGNAL(darkFrameCompleted(bool)), this, SLOT(setCaptureComplete()));
-        connect(DarkLibrary::Instance(), SIGNAL(newLog(QString)), this, SLOT(appendLogText(QString)));
+        connect(DarkLibrary::Instance(), SIGNAL(newLog(QString)), this, SLOT(appendLogText(QString)), Qt::UniqueConnection);
 
         targetChip->setCaptureFilter(defaultScale);
 
-        if (darkData)
-            DarkLibrary::Instance()->subtract(darkData, focusView, defaultScale, offsetX, offsetY);
-        else
+        // No dark frame available yet. Load the light frame and let the dark library capture and subtract one.
+        if (darkFrame.isEmpty())
         {
+            focusView->setFilter(FITS_NONE);
+            if (focusView->loadFITS(filename, true) == false)
+            {
+                processFrameFailure(pendingFrameID, i18n("Failed to load image %1", filename));
+                return;
+            }
+            focusView->updateFrame();
+            emit currentCCD->newImage(focusView->getDisplayImage(), targetChip);
+            frameAnalyzed = false;
+
+            connect(DarkLibrary::Instance(), SIGNAL(darkFrameCompleted(bool)), this, SLOT(setCaptureComplete()));
+
             bool rc = DarkLibrary::Instance()->captureAndSubtract(targetChip, focusView, exposureIN->value(), offsetX, offsetY);
             darkFrameCheck->setChecked(rc);
+            return;
         }
+    }
+
+    syncTrackingBoxPosition();
+
+    ImagePipeline::Parameters params = ImagePipeline::defaultParameters(FITS_FOCUS);
+    params.darkFrame = darkFrame;
+    params.offsetX   = offsetX;
+    params.offsetY   = offsetY;
+    params.filter    = darkFrame.isEmpty() ? FITS_NONE : defaultScale;
+
+    // If we're not framing, let's try to detect stars
+    params.detectStars = (inFocusLoop == false || focusView->isTrackingBoxEnabled());
+    if (focusView->isTrackingBoxEnabled())
+        params.boundary = focusView->getTrackingBox();
+    // A selected star is the only one measured. Full field, the brightest star alone may be saturated or lie where the
+    // field is tilted or curved, so use the median of all detected stars which is robust against outliers.
+    params.algorithm = starSelected ? focusAlgorithm : ALGORITHM_CENTROID;
+    params.HFR       = starSelected ? HFR_MAX : HFR_MEDIAN;
+
+    pendingFrameID = pipeline->process(filename, params);
+    frameAnalyzed  = params.detectStars;
+}
+
+void Focus::processFrame(quint32 sequenceID, FITSData *data, double HFR)
+{
+    if (sequenceID != pendingFrameID)
+    {
+        delete (data);
+        return;
+    }
 
+    ISD::CCDChip *targetChip = currentCCD->getChip(ISD::CCDChip::PRIMARY_CCD);
+
+    focusView->setFilter(targetChip->getCaptureFilter());
+
+    if (focusView->loadData(data) == false)
+    {
+        processFrameFailure(sequenceID, i18n("Failed to display image."));
         return;
     }
 
+    focusView->updateFrame();
+
+    // The chip left loading and announcing the frame to us
+    emit currentCCD->newImage(focusView->getDisplayImage(), targetChip);
+
+    pipelineHFR = HFR;
+    frameFailureCount = 0;
+
     setCaptureComplete();
 }
 
+void Focus::processFrameFailure(quint32 sequenceID, const QString &message)
+{
+    if (sequenceID != pendingFrameID)
+        return;
+
+    frameAnalyzed = false;
+
+    appendLogText(message);
+
+    // Treat it the same as an exposure failure and capture again if possible, unless frames keep failing
+    if (inFocusLoop || inAutoFocus)
+    {
+        if (frameFailureCount++ < MAX_RECAPTURE_RETRIES)
+        {
+            capture();
+            return;
+        }
+
+        appendLogText(i18n("Failed to load %1 frames in a row. Aborting...", frameFailureCount));
+        bool autoFocus = inAutoFocus;
+        abort();
+        if (autoFocus)
+            setAutoFocusResult(false);
+        return;
+    }
+
+    captureInProgress = false;
+    captureB->setEnabled(true);
+    stopFocusB->setEnabled(false);
+}
+
 void Focus::setCaptureComplete()
 {
     DarkLibrary::Instance()->disconnect(this);
@@ -1049,7 +1161,13 @@ void Focus::setCaptureComplete()
     // If we're not framing, let's try to detect stars
     if (inFocusLoop == false || (inFocusLoop && focusView->isTrackingBoxEnabled()))
     {
-        if (image_data->areStarsSearched() == false)
+        // Stars were already detected by the image pipeline
+        if (frameAnalyzed)
+        {
+            currentHFR    = pipelineHFR;
+            frameAnalyzed = false;
+        }
+        else if (image_data->areStarsSearched() == false)
         {
             //if (starSelected == false && autoStarCheck->isChecked() && subFramed == false)
             //if (autoStarCheck->isChecked() && subFramed == false)
@@ -1065,9 +1183,10 @@ void Focus::setCaptureComplete()
             }
             else
             {
+                // Full field, use the median of all detected stars as with the image pipeline
                 focusView->findStars(ALGORITHM_CENTROID);
                 focusView->updateFrame();
-                currentHFR= image_data->getHFR(HFR_MAX);
+                currentHFR= image_data->getHFR(HFR_MEDIAN);
             }
             /*
             if (subFramed && focusView->isTrackingBoxEnabled())
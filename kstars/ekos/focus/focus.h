@@ -22,9 +22,13 @@
 #include "indi/indifocuser.h"
 #include "indi/indiccd.h"
 
+class FITSData;
+
 namespace Ekos
 {
 
+class ImagePipeline;
+
 struct HFRPoint
 {
     int pos;
@@ -317,6 +321,12 @@ private slots:
 
     void setCaptureComplete();
 
+    /**
+     * @brief processFrame Display a frame loaded and analyzed by the image pipeline, then complete the capture.
+     */
+    void processFrame(quint32 sequenceID, FITSData *data, double HFR);
+    void processFrameFailure(quint32 sequenceID, const QString &message);
+
     void showFITSViewer();
 
 signals:
@@ -414,6 +424,15 @@ private:
 
     // Are we in the process of capturing an image?
     bool captureInProgress;
+    // Loads and analyzes received frames in the background
+    ImagePipeline *pipeline;
+    // Sequence ID of the frame we are waiting for from the pipeline
+    quint32 pendingFrameID;
+    // Were stars already detected by the pipeline? If so, pipelineHFR holds the result.
+    bool frameAnalyzed;
+    double pipelineHFR;
+    // How many frames in a row the pipeline failed to load
+    int frameFailureCount;
     // Was the frame modified by us? Better keep track since we need to return it to its previous state once we are done with the focus operation.
     //bool frameModified;
     // Was the modified frame subFramed?
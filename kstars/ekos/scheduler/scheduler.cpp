@@ -28,6 +28,7 @@
 #include "kstars.h"
 #include "scheduler.h"
 #include "skymapcomposite.h"
+#include "artificialhorizoncomponent.h"
 #include "kstarsdata.h"
 #include "ksmoon.h"
 #include "ksalmanac.h"
@@ -1474,7 +1475,7 @@ void Scheduler::wakeUpScheduler()
 
 }
 
-double Scheduler::findAltitude(const SkyPoint & target, const QDateTime when)
+double Scheduler::findAltitude(const SkyPoint & target, const QDateTime when, double *azimuth)
 {
     // Make a copy
     SkyPoint p = target;
@@ -1486,9 +1487,17 @@ double Scheduler::findAltitude(const SkyPoint & target, const QDateTime when)
     CachingDms LST = KStarsData::Instance()->geo()->GSTtoLST( myUT.gst() );
     p.EquatorialToHorizontal( &LST, KStarsData::Instance()->geo()->lat() );
 
+    if (azimuth)
+        *azimuth = p.az().Degrees();
+
     return p.alt().Degrees();
 }
 
+bool Scheduler::isAboveArtificialHorizon(double azimuth, double altitude)
+{
+    return KStarsData::Instance()->skyComposite()->artificialHorizon()->isVisible(azimuth, altitude);
+}
+
 bool Scheduler::calculateAltitudeTime(SchedulerJob *job, double minAltitude, double minMoonAngle)
 {
     // We wouldn't stat observation 30 mins (default) before dawn.
@@ -1515,7 +1524,8 @@ bool Scheduler::calculateAltitudeTime(SchedulerJob *job, double minAltitude, dou
             target.EquatorialToHorizontal( &LST, geo->lat() );
             altitude =  target.alt().Degrees();
 
-            if (altitude > minAltitude)
+            // An altitude constraint also keeps the target clear of the artificial horizon
+            if (altitude > minAltitude && (job->getMinAltitude() <= 0 || isAboveArtificialHorizon(target.az().Degrees(), altitude)))
             {
                 QDateTime startTime = geo->UTtoLT(myUT);
 
@@ -1733,7 +1743,8 @@ int16_t Scheduler::calculateJobScore(SchedulerJob *job, QDateTime when)
 int16_t Scheduler::getAltitudeScore(SchedulerJob *job, QDateTime when)
 {
     int16_t score=0;
-    double currentAlt  = findAltitude(job->getTargetCoords(), when);
+    double currentAz   = 0;
+    double currentAlt  = findAltitude(job->getTargetCoords(), when, &currentAz);
 
     if (currentAlt < 0)
         score = BAD_SCORE;
@@ -1743,6 +1754,12 @@ int16_t Scheduler::getAltitudeScore(SchedulerJob *job, QDateTime when)
         // if current altitude is lower that's not good
         if (currentAlt < job->getMinAltitude())
             score = BAD_SCORE;
+        // neither is being hidden by the artificial horizon
+        else if (isAboveArtificialHorizon(currentAz, currentAlt) == false)
+        {
+            appendLogText(i18n("%1 is blocked by the artificial horizon at %2.", job->getName(), when.toString()));
+            score = BAD_SCORE;
+        }
         else
         {
             double HA=0;
@@ -2524,13 +2541,19 @@ void Scheduler::checkJobStage()
 
         p.EquatorialToHorizontal(KStarsData::Instance()->lst(), geo->lat());
 
-        if (p.alt().Degrees() < currentJob->getMinAltitude())
+        bool belowHorizon = isAboveArtificialHorizon(p.az().Degrees(), p.alt().Degrees()) == false;
+
+        if (p.alt().Degrees() < currentJob->getMinAltitude() || belowHorizon)
         {
             // Only terminate job due to altitude limitation if mount is NOT parked.
             if (isMountParked() == false)
             {
-                appendLogText(i18n("%1 current altitude (%2 degrees) crossed minimum constraint altitude (%3 degrees), aborting job...", currentJob->getName(),
-                                   p.alt().Degrees(), currentJob->getMinAltitude()));
+                if (belowHorizon)
+                    appendLogText(i18n("%1 is now blocked by the artificial horizon (altitude %2 degrees), aborting job...", currentJob->getName(),
+                                       p.alt().Degrees()));
+                else
+                    appendLogText(i18n("%1 current altitude (%2 degrees) crossed minimum constraint altitude (%3 degrees), aborting job...", currentJob->getName(),
+                                       p.alt().Degrees(), currentJob->getMinAltitude()));
 
                 currentJob->setState(SchedulerJob::JOB_ABORTED);
                 stopCurrentJobAction();
@@ -110,9 +110,18 @@ public:
       * @brief findAltitude Find altitude given a specific time
       * @param target Target
       * @param when date time to find altitude
+      * @param azimuth if not NULL, set to the azimuth of the target at the specific date and time given.
       * @return Altitude of the target at the specific date and time given.
       */
-     static double findAltitude(const SkyPoint & target, const QDateTime when);
+     static double findAltitude(const SkyPoint & target, const QDateTime when, double *azimuth=NULL);
+
+     /**
+      * @brief isAboveArtificialHorizon Check a position against the enabled regions of the artificial horizon.
+      * @param azimuth azimuth in degrees
+      * @param altitude altitude in degrees
+      * @return true if the position is not blocked by the artificial horizon.
+      */
+     static bool isAboveArtificialHorizon(double azimuth, double altitude);
 
      /** @defgroup SchedulerDBusInterface Ekos DBus Interface - Scheduler Module
       * Ekos::Align interface provides primary functions to run and stop the scheduler.
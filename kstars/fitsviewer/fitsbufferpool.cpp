@@ -0,0 +1,211 @@
+/*  FITS Frame Buffer Pool
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#include "fitsbufferpool.h"
+
+#include <new>
+
+#include <QDebug>
+#include <QMutexLocker>
+
+#include "Options.h"
+
+// Never keep more than this many idle buffers around, regardless of their size
+#define MAX_IDLE_BUFFERS    16
+
+FITSBufferPool * FITSBufferPool::Instance()
+{
+    // The pool is first used by whichever thread loads a frame first, e.g. the image pipeline worker.
+    // Initialization of a local static is thread-safe.
+    static FITSBufferPool *pool = new FITSBufferPool();
+
+    return pool;
+}
+
+FITSBufferPool::FITSBufferPool()
+{
+    maxPooledBytes = static_cast<quint64>(Options::fITSBufferPoolSize()) * 1024 * 1024;
+    resetStatistics();
+}
+
+FITSBufferPool::~FITSBufferPool()
+{
+    clear();
+
+    QHashIterator<uint8_t*, size_t> it(activeBuffers);
+    while (it.hasNext())
+    {
+        it.next();
+        delete [] it.key();
+    }
+}
+
+uint8_t * FITSBufferPool::acquire(uint32_t width, uint32_t height, uint32_t channels, uint32_t bytesPerPixel)
+{
+    return acquire(static_cast<size_t>(width) * height * channels * bytesPerPixel);
+}
+
+uint8_t * FITSBufferPool::acquire(size_t size)
+{
+    if (size == 0)
+        return NULL;
+
+    QMutexLocker locker(&poolMutex);
+
+    // Most recently released buffers are at the end, they are the most likely to be hot in cache
+    for (int i=idleBuffers.count()-1; i >= 0; i--)
+    {
+        if (idleBuffers[i].first == size)
+        {
+            uint8_t *buffer = idleBuffers[i].second;
+            idleBuffers.removeAt(i);
+
+            activeBuffers[buffer] = size;
+            stats.bytesPooled -= size;
+            stats.bytesInUse  += size;
+            stats.reuses++;
+
+            return buffer;
+        }
+    }
+
+    uint8_t *buffer = new (std::nothrow) uint8_t[size];
+
+    // If we run out of memory, give back idle buffers and try once more
+    if (buffer == NULL && idleBuffers.isEmpty() == false)
+    {
+        while (idleBuffers.isEmpty() == false)
+        {
+            QPair<size_t, uint8_t*> oneBuffer = idleBuffers.takeFirst();
+            delete [] oneBuffer.second;
+            stats.bytesPooled -= oneBuffer.first;
+            stats.evictions++;
+        }
+
+        buffer = new (std::nothrow) uint8_t[size];
+    }
+
+    if (buffer == NULL)
+    {
+        qWarning() << "FITSBufferPool: Not enough memory to allocate" << size << "bytes.";
+        return NULL;
+    }
+
+    activeBuffers[buffer] = size;
+    stats.bytesInUse += size;
+    stats.allocations++;
+
+    if (Options::fITSLogging())
+        qDebug() << "FITSBufferPool: allocated" << size << "bytes. Total allocations" << stats.allocations << "reuses" << stats.reuses;
+
+    return buffer;
+}
+
+void FITSBufferPool::release(uint8_t *buffer)
+{
+    if (buffer == NULL)
+        return;
+
+    QMutexLocker locker(&poolMutex);
+
+    QHash<uint8_t*, size_t>::iterator it = activeBuffers.find(buffer);
+
+    if (it == activeBuffers.end())
+    {
+        qWarning() << "FITSBufferPool: releasing a buffer that was not acquired from the pool.";
+        delete [] buffer;
+        return;
+    }
+
+    size_t size = it.value();
+    activeBuffers.erase(it);
+
+    stats.bytesInUse  -= size;
+    stats.bytesPooled += size;
+    stats.releases++;
+
+    idleBuffers.append(qMakePair(size, buffer));
+
+    trim();
+}
+
+size_t FITSBufferPool::size(uint8_t *buffer) const
+{
+    QMutexLocker locker(&poolMutex);
+
+    return activeBuffers.value(buffer, 0);
+}
+
+void FITSBufferPool::clear()
+{
+    QMutexLocker locker(&poolMutex);
+
+    while (idleBuffers.isEmpty() == false)
+    {
+        QPair<size_t, uint8_t*> oneBuffer = idleBuffers.takeFirst();
+        delete [] oneBuffer.second;
+        stats.evictions++;
+    }
+
+    stats.bytesPooled = 0;
+}
+
+void FITSBufferPool::setMaximumPooledBytes(quint64 value)
+{
+    QMutexLocker locker(&poolMutex);
+
+    maxPooledBytes = value;
+    trim();
+}
+
+quint64 FITSBufferPool::maximumPooledBytes() const
+{
+    QMutexLocker locker(&poolMutex);
+
+    return maxPooledBytes;
+}
+
+FITSBufferPool::Statistics FITSBufferPool::statistics() const
+{
+    QMutexLocker locker(&poolMutex);
+
+    return stats;
+}
+
+void FITSBufferPool::resetStatistics()
+{
+    QMutexLocker locker(&poolMutex);
+
+    quint64 inUse = 0, pooled = 0;
+
+    foreach(size_t size, activeBuffers)
+        inUse += size;
+
+    for (int i=0; i < idleBuffers.count(); i++)
+        pooled += idleBuffers[i].first;
+
+    stats.allocations = 0;
+    stats.reuses      = 0;
+    stats.releases    = 0;
+    stats.evictions   = 0;
+    stats.bytesInUse  = inUse;
+    stats.bytesPooled = pooled;
+}
+
+void FITSBufferPool::trim()
+{
+    // Oldest buffers are evicted first. Caller must hold poolMutex.
+    while (idleBuffers.isEmpty() == false && (stats.bytesPooled > maxPooledBytes || idleBuffers.count() > MAX_IDLE_BUFFERS))
+    {
+        QPair<size_t, uint8_t*> oneBuffer = idleBuffers.takeFirst();
+        delete [] oneBuffer.second;
+        stats.bytesPooled -= oneBuffer.first;
+        stats.evictions++;
+    }
+}
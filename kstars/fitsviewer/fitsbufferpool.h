@@ -0,0 +1,100 @@
+/*  FITS Frame Buffer Pool
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef FITSBUFFERPOOL_H
+#define FITSBUFFERPOOL_H
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ *@class FITSBufferPool
+ *@short Recycles raw image buffers between consecutive frames.
+ *
+ * Guiding and focusing loops receive frames of identical geometry over and over. Instead of
+ * releasing and reallocating the image buffer for every frame, FITSData, FITSView and the dark
+ * library acquire their buffers from this pool and hand them back once done. Released buffers are kept
+ * in a small ring ordered by release time, so in steady state every acquire is served by the buffer
+ * released by the previous frame and no heap allocation takes place.
+ *
+ * The pool is thread safe. Buffers are keyed by their size in bytes, which is derived from the frame
+ * dimensions, number of channels and bytes per pixel.
+ *@version 1.0
+ */
+class FITSBufferPool
+{
+public:
+
+    /** Counters to verify pool efficiency. allocations should stop increasing once a loop is running. */
+    typedef struct
+    {
+        quint64 allocations;    // Buffers allocated from the heap
+        quint64 reuses;         // Acquire requests served from the pool
+        quint64 releases;       // Buffers returned to the pool
+        quint64 evictions;      // Buffers freed to honor the pool limits
+        quint64 bytesInUse;     // Bytes currently held by clients
+        quint64 bytesPooled;    // Bytes currently held by the pool, ready for reuse
+    } Statistics;
+
+    static FITSBufferPool *Instance();
+
+    /**
+     * @brief acquire Get a buffer suitable for a frame of the given geometry.
+     * @return pointer to uninitialized buffer, or NULL if memory is exhausted.
+     */
+    uint8_t *acquire(uint32_t width, uint32_t height, uint32_t channels, uint32_t bytesPerPixel);
+
+    /**
+     * @brief acquire Get a buffer of at least size bytes.
+     * @return pointer to uninitialized buffer, or NULL if memory is exhausted.
+     */
+    uint8_t *acquire(size_t size);
+
+    /**
+     * @brief release Return a buffer obtained from acquire() back to the pool. NULL is ignored.
+     */
+    void release(uint8_t *buffer);
+
+    /**
+     * @brief size Size in bytes of a buffer obtained from acquire(), or 0 if the buffer is not managed by the pool.
+     */
+    size_t size(uint8_t *buffer) const;
+
+    /** Free all idle buffers. Buffers currently in use are not affected. */
+    void clear();
+
+    /** Set the maximum number of bytes kept idle in the pool. */
+    void setMaximumPooledBytes(quint64 value);
+    quint64 maximumPooledBytes() const;
+
+    Statistics statistics() const;
+    void resetStatistics();
+
+private:
+    FITSBufferPool();
+    ~FITSBufferPool();
+
+    void trim();
+
+    // Idle buffers, oldest first
+    QList<QPair<size_t, uint8_t *> > idleBuffers;
+    // Buffers currently handed out to clients
+    QHash<uint8_t *, size_t> activeBuffers;
+
+    quint64 maxPooledBytes;
+    Statistics stats;
+
+    mutable QMutex poolMutex;
+};
+
+#endif // FITSBUFFERPOOL_H
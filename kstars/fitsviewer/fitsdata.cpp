@@ -18,12 +18,14 @@
  ***************************************************************************/
 
 #include "fitsdata.h"
+#include "fitsbufferpool.h"
 #include "skymapcomposite.h"
 #include "kstarsdata.h"
 
 #include <cmath>
 #include <cstdlib>
 #include <climits>
+#include <algorithm>
 #include <float.h>
 
 #include <QApplication>
@@ -32,6 +34,8 @@
 #include <QFile>
 #include <QTime>
 #include <QProgressDialog>
+#include <QThread>
+#include <QtConcurrent>
 
 #ifndef KSTARS_LITE
 #ifdef HAVE_WCSLIB
@@ -68,6 +72,14 @@ bool greaterThan(Edge *s1, Edge *s2)
     return s1->sum > s2->sum;
 }
 
+// Band of image rows scanned for edges by one thread
+typedef struct
+{
+    int start;
+    int end;
+    QList<Edge*> edges;
+} EdgeBand;
+
 FITSData::FITSData(FITSMode fitsMode)
 {
     channels = 0;
@@ -78,6 +90,7 @@ FITSData::FITSData(FITSMode fitsMode)
     starsSearched = false;
     HasWCS = false;
     HasDebayer=false;
+    notifyErrors = true;
     mode = fitsMode;
     channels=1;
 
@@ -123,6 +136,7 @@ bool FITSData::loadFITS (const QString &inFilename, bool silent)
 
     qDeleteAll(starCenters);
     starCenters.clear();
+    lastError.clear();
 
     if (fptr)
     {
@@ -144,6 +158,7 @@ bool FITSData::loadFITS (const QString &inFilename, bool silent)
         fits_report_error(stderr, status);
         fits_get_errstatus(status, error_status);
         errMessage = i18n("Could not open file %1. Error %2", filename, QString::fromUtf8(error_status));
+        lastError = errMessage;
         if (silent == false)
             KSNotification::error(errMessage, i18n("FITS Open"));
         if (Options::fITSLogging())
@@ -156,6 +171,7 @@ bool FITSData::loadFITS (const QString &inFilename, bool silent)
         fits_report_error(stderr, status);
         fits_get_errstatus(status, error_status);
         errMessage = i18n("FITS file open error (fits_get_img_param): %1", QString::fromUtf8(error_status));
+        lastError = errMessage;
         if (silent == false)
             KSNotification::error(errMessage, i18n("FITS Open"));
         if (Options::fITSLogging())
@@ -166,6 +182,7 @@ bool FITSData::loadFITS (const QString &inFilename, bool silent)
     if (stats.ndim < 2)
     {
         errMessage = i18n("1D FITS images are not supported in KStars.");
+        lastError = errMessage;
         if (silent == false)
             KSNotification::error(errMessage, i18n("FITS Open"));
         if (Options::fITSLogging())
@@ -210,6 +227,7 @@ bool FITSData::loadFITS (const QString &inFilename, bool silent)
         stats.bytesPerPixel = sizeof(double);
     default:
         errMessage = i18n("Bit depth %1 is not supported.", stats.bitpix);
+        lastError = errMessage;
         if (silent == false)
             KSNotification::error(errMessage, i18n("FITS Open"));
         if (Options::fITSLogging())
@@ -224,6 +242,7 @@ bool FITSData::loadFITS (const QString &inFilename, bool silent)
     if (naxes[0] == 0 || naxes[1] == 0)
     {
         errMessage = i18n("Image has invalid dimensions %1x%2", naxes[0], naxes[1]);
+        lastError = errMessage;
         if (silent == false)
             KSNotification::error(errMessage, i18n("FITS Open"));
         if (Options::fITSLogging())
@@ -243,12 +262,13 @@ bool FITSData::loadFITS (const QString &inFilename, bool silent)
     if (Options::auto3DCube() == false)
         channels = 1;
 
-    //image_buffer = new float[stats.samples_per_channel * channels];
-    imageBuffer = new uint8_t[stats.samples_per_channel * channels * stats.bytesPerPixel];
+    // Looping guide & focus frames share the same geometry, so the pool hands back the buffer we just released.
+    imageBuffer = FITSBufferPool::Instance()->acquire(stats.width, stats.height, channels, stats.bytesPerPixel);
     //if (image_buffer == NULL)
     if (imageBuffer == NULL)
     {
         qDebug() << "FITSData: Not enough memory for image_buffer channel. Requested: " << stats.samples_per_channel * channels * stats.bytesPerPixel << " bytes.";
+        lastError = i18n("Not enough memory to load image %1", filename);
         clearImageBuffers();
         return false;
     }
@@ -263,6 +283,7 @@ bool FITSData::loadFITS (const QString &inFilename, bool silent)
         char errmsg[512];
         fits_get_errstatus(status, errmsg);
         errMessage = i18n("Error reading image: %1", QString(errmsg));
+        lastError = errMessage;
         if (silent == false)
             KSNotification::error(errMessage, i18n("FITS Open"));
         fits_report_error(stderr, status);
@@ -437,7 +458,7 @@ int FITSData::saveFITS( const QString &newFilename )
 
 void FITSData::clearImageBuffers()
 {
-    delete[] imageBuffer;
+    FITSBufferPool::Instance()->release(imageBuffer);
     imageBuffer=NULL;
     bayerBuffer=NULL;
 }
@@ -727,7 +748,9 @@ template<typename T> int FITSData::findCannyStar(FITSData *data, const QRect &bo
     uint32_t offset = subX + subY * dataWidth;
 
     // #2 Create new buffer
-    uint8_t *buffer = new uint8_t[size*BBP];
+    uint8_t *buffer = FITSBufferPool::Instance()->acquire(size*BBP);
+    if (buffer == NULL)
+        return 0;
     // If there is no offset, copy whole buffer in one go
     if (offset == 0)
         memcpy(buffer, data->getImageBuffer(), size*BBP);
@@ -1181,9 +1204,7 @@ void FITSData::findCentroid(const QRectF &boundary, int initStdDev, int minEdgeW
 
 template<typename T> void FITSData::findCentroid(const QRectF &boundary, int initStdDev, int minEdgeWidth)
 {    
-    double threshold=0,sum=0,avg=0,min=0;
-    int starDiameter=0;
-    int pixVal=0;
+    double threshold=0,sum=0,min=0;
     int minimumEdgeCount = MINIMUM_EDGE_LIMIT;
 
     T *buffer = reinterpret_cast<T*>(imageBuffer);
@@ -1274,65 +1295,83 @@ template<typename T> void FITSData::findCentroid(const QRectF &boundary, int ini
             subH = subY + boundary.height();
         }
 
-        // Detect "edges" that are above threshold
-        for (int i=subY; i < subH; i++)
+        // Detect "edges" that are above threshold. Rows are independent, so we scan bands of rows concurrently
+        // and join the edges in row order afterwards.
+        QVector<EdgeBand> bands;
+        int bandHeight = qMax(1, (subH - subY) / (QThread::idealThreadCount() * 4));
+        for (int i=subY; i < subH; i += bandHeight)
         {
-            starDiameter = 0;
+            EdgeBand oneBand;
+            oneBand.start = i;
+            oneBand.end   = qMin(i + bandHeight, subH);
+            bands.append(oneBand);
+        }
 
-            for(int j=subX; j < subW; j++)
+        QtConcurrent::blockingMap(bands, [&](EdgeBand &band)
+        {
+            for (int i=band.start; i < band.end; i++)
             {
-                pixVal = buffer[j+(i*stats.width)] - min;
+                double avg=0, sum=0;
+                int starDiameter = 0;
 
-                // If pixel value > threshold, let's get its weighted average
-                if ( pixVal >= threshold )
+                for(int j=subX; j < subW; j++)
                 {
-                    avg += j * pixVal;
-                    sum += pixVal;
-                    starDiameter++;
-                }
-                // Value < threshold but avg exists
-                else if (sum > 0)
-                {
-                    // We found a potential centroid edge
-                    if (starDiameter >= minEdgeWidth)
+                    int pixVal = buffer[j+(i*stats.width)] - min;
+
+                    // If pixel value > threshold, let's get its weighted average
+                    if ( pixVal >= threshold )
+                    {
+                        avg += j * pixVal;
+                        sum += pixVal;
+                        starDiameter++;
+                    }
+                    // Value < threshold but avg exists
+                    else if (sum > 0)
                     {
-                        float center = avg/sum + 0.5;
-                        if (center > 0)
+                        // We found a potential centroid edge
+                        if (starDiameter >= minEdgeWidth)
                         {
-                            int i_center = floor(center);
-
-                            // Check if center is 10% or more brighter than edge, if not skip
-                            if ( ((buffer[i_center+(i*stats.width)]-min) / (buffer[i_center+(i*stats.width)-starDiameter/2]-min) >= dispersion_ratio) &&
-                                 ((buffer[i_center+(i*stats.width)]-min) / (buffer[i_center+(i*stats.width)+starDiameter/2]-min) >= dispersion_ratio))
+                            float center = avg/sum + 0.5;
+                            if (center > 0)
                             {
-                                if (Options::fITSLogging())
+                                int i_center = floor(center);
+
+                                // Check if center is 10% or more brighter than edge, if not skip
+                                if ( ((buffer[i_center+(i*stats.width)]-min) / (buffer[i_center+(i*stats.width)-starDiameter/2]-min) >= dispersion_ratio) &&
+                                     ((buffer[i_center+(i*stats.width)]-min) / (buffer[i_center+(i*stats.width)+starDiameter/2]-min) >= dispersion_ratio))
                                 {
-                                    qDebug() << "Edge center is " << buffer[i_center+(i*stats.width)]-min << " Edge is " << buffer[i_center+(i*stats.width)-starDiameter/2]-min
-                                             << " and ratio is " << ((buffer[i_center+(i*stats.width)]-min) / (buffer[i_center+(i*stats.width)-starDiameter/2]-min))
-                                            << " located at X: " << center << " Y: " << i+0.5;
-                                }
+                                    if (Options::fITSLogging())
+                                    {
+                                        qDebug() << "Edge center is " << buffer[i_center+(i*stats.width)]-min << " Edge is " << buffer[i_center+(i*stats.width)-starDiameter/2]-min
+                                                 << " and ratio is " << ((buffer[i_center+(i*stats.width)]-min) / (buffer[i_center+(i*stats.width)-starDiameter/2]-min))
+                                                << " located at X: " << center << " Y: " << i+0.5;
+                                    }
 
-                                Edge *newEdge = new Edge();
+                                    Edge *newEdge = new Edge();
 
-                                newEdge->x          = center;
-                                newEdge->y          = i + 0.5;
-                                newEdge->scanned    = 0;
-                                newEdge->val        = buffer[i_center+(i*stats.width)] - min;
-                                newEdge->width      = starDiameter;
-                                newEdge->HFR        = 0;
-                                newEdge->sum        = sum;
+                                    newEdge->x          = center;
+                                    newEdge->y          = i + 0.5;
+                                    newEdge->scanned    = 0;
+                                    newEdge->val        = buffer[i_center+(i*stats.width)] - min;
+                                    newEdge->width      = starDiameter;
+                                    newEdge->HFR        = 0;
+                                    newEdge->sum        = sum;
 
-                                edges.append(newEdge);
+                                    band.edges.append(newEdge);
 
+                                }
                             }
                         }
-                    }
 
-                    // Reset
-                    avg= sum = starDiameter=0;
+                        // Reset
+                        avg= sum = starDiameter=0;
+                    }
                 }
             }
-        }
+        });
+
+        foreach(const EdgeBand &oneBand, bands)
+            edges.append(oneBand.edges);
 
         if (Options::fITSLogging())
             qDebug() << "Total number of edges found is: " << edges.count();
@@ -1368,6 +1407,8 @@ template<typename T> void FITSData::findCentroid(const QRectF &boundary, int ini
     int cen_w=0;
     int width_sum=0;
 
+    QList<Edge*> centers;
+
     // Let's sort edges, starting with widest
     qSort(edges.begin(), edges.end(), greaterThan);
 
@@ -1449,72 +1490,76 @@ template<typename T> void FITSData::findCentroid(const QRectF &boundary, int ini
         //if (cen_limit >= 2 && cen_count >= cen_limit)
         if (cen_count >= cen_limit)
         {
+            float center_x = avg_x/sum;
+            float center_y = avg_y/sum;
+
+            if (floor(center_x) < 0 || floor(center_x) > stats.width || floor(center_y) < 0 || floor(center_y) > stats.height)
+                continue;
+
             // We detected a centroid, let's init it
             Edge *rCenter = new Edge();
 
-            rCenter->x = avg_x/sum;
-            rCenter->y = avg_y/sum;
+            rCenter->x = center_x;
+            rCenter->y = center_y;
             width_sum += rCenter->width;
             rCenter->width = cen_w;
 
             if (Options::fITSLogging())
                 qDebug() << "Found a real center with number with (" << rCenter->x << "," << rCenter->y << ")";
 
-            // Calculate Total Flux From Center, Half Flux, Full Summation
-            double TF=0;
-            double HF=0;
-            double FSum=0;
+            centers.append(rCenter);
+        }
+    }
 
-            cen_x = (int) floor(rCenter->x);
-            cen_y = (int) floor(rCenter->y);
+    // Measuring each star is independent of the others, so measure them all concurrently
+    QtConcurrent::blockingMap(centers, [&](Edge *rCenter)
+    {
+        // Calculate Total Flux From Center, Half Flux, Full Summation
+        double TF=0;
+        double HF=0;
+        double FSum=0;
 
-            if (cen_x < 0 || cen_x > stats.width || cen_y < 0 || cen_y > stats.height)
-                continue;
+        int cen_x = (int) floor(rCenter->x);
+        int cen_y = (int) floor(rCenter->y);
 
+        // Complete sum along the radius
+        for (int k=rCenter->width/2; k >= -(rCenter->width/2) ; k--)
+            FSum += buffer[cen_x-k+(cen_y*stats.width)] - min;
 
-            // Complete sum along the radius
-            //for (int k=0; k < rCenter->width; k++)
-            for (int k=rCenter->width/2; k >= -(rCenter->width/2) ; k--)
-            {
-                FSum += buffer[cen_x-k+(cen_y*stats.width)] - min;
-                //qDebug() << image_buffer[cen_x-k+(cen_y*stats.width)] - min;
-            }
-
-            // Half flux
-            HF = FSum / 2.0;
+        // Half flux
+        HF = FSum / 2.0;
 
-            // Total flux starting from center
-            TF = buffer[cen_y * stats.width + cen_x] - min;
+        // Total flux starting from center
+        TF = buffer[cen_y * stats.width + cen_x] - min;
 
-            int pixelCounter = 1;
+        int pixelCounter = 1;
 
-            // Integrate flux along radius axis until we reach half flux
-            for (int k=1; k < rCenter->width/2; k++)
+        // Integrate flux along radius axis until we reach half flux
+        for (int k=1; k < rCenter->width/2; k++)
+        {
+            if (TF >= HF)
             {
-                if (TF >= HF)
-                {
-                    if (Options::fITSLogging())
-                        qDebug() << "Stopping at TF " << TF << " after #" << k << " pixels.";
-                    break;
-                }
+                if (Options::fITSLogging())
+                    qDebug() << "Stopping at TF " << TF << " after #" << k << " pixels.";
+                break;
+            }
 
-                TF += buffer[cen_y * stats.width + cen_x + k] - min;
-                TF += buffer[cen_y * stats.width + cen_x - k] - min;
+            TF += buffer[cen_y * stats.width + cen_x + k] - min;
+            TF += buffer[cen_y * stats.width + cen_x - k] - min;
 
-                pixelCounter++;
-            }
+            pixelCounter++;
+        }
 
-            // Calculate weighted Half Flux Radius
-            rCenter->HFR = pixelCounter * (HF / TF);
-            // Store full flux
-            rCenter->val = FSum;
+        // Calculate weighted Half Flux Radius
+        rCenter->HFR = pixelCounter * (HF / TF);
+        // Store full flux
+        rCenter->val = FSum;
 
-            if (Options::fITSLogging())
-                qDebug() << "HFR for this center is " << rCenter->HFR << " pixels and the total flux is " << FSum;
+        if (Options::fITSLogging())
+            qDebug() << "HFR for this center is " << rCenter->HFR << " pixels and the total flux is " << FSum;
+    });
 
-            starCenters.append(rCenter);
-        }
-    }
+    starCenters.append(centers);
 
     if (starCenters.count() > 1 && mode != FITS_FOCUS)
     {
@@ -1552,7 +1597,7 @@ double FITSData::getHFR(HFRType type)
     if (starCenters.size() == 0)
         return -1;
 
-    if (type == HFR_MAX)
+    if (type == HFR_MAX || type == HFR_MEDIAN)
     {
         maxHFRStar = NULL;
         int maxVal=0;
@@ -1568,7 +1613,17 @@ double FITSData::getHFR(HFRType type)
         }
 
         maxHFRStar = starCenters[maxIndex];
-        return starCenters[maxIndex]->HFR;
+
+        if (type == HFR_MAX)
+            return starCenters[maxIndex]->HFR;
+
+        // Median of all stars, rejecting outliers such as hot pixels and blended stars
+        QVector<double> HFRs;
+        HFRs.reserve(starCenters.count());
+        foreach(Edge *center, starCenters)
+            HFRs.append(center->HFR);
+
+        return sigmaClippedMedian(HFRs);
     }
 
     double FSum=0;
@@ -1591,6 +1646,82 @@ double FITSData::getHFR(HFRType type)
 
 }
 
+QVector<double> FITSData::getHFRMap(int columns, int rows)
+{
+    // Bin the stars we already measured into regions, no need to scan the image again
+    return getHFRMap(starCenters, stats.width, stats.height, columns, rows);
+}
+
+QVector<double> FITSData::getHFRMap(const QList<Edge*> &stars, int width, int height, int columns, int rows)
+{
+    if (columns <= 0 || rows <= 0)
+        return QVector<double>();
+
+    QVector<double> HFRMap(columns * rows, -1);
+
+    if (width <= 0 || height <= 0)
+        return HFRMap;
+
+    QVector< QVector<double> > regions(columns * rows);
+
+    foreach(Edge *center, stars)
+    {
+        int column = qBound(0, static_cast<int>(center->x * columns / width), columns-1);
+        int row    = qBound(0, static_cast<int>(center->y * rows / height), rows-1);
+
+        regions[row * columns + column].append(center->HFR);
+    }
+
+    for (int i=0; i < regions.count(); i++)
+    {
+        if (regions[i].isEmpty() == false)
+            HFRMap[i] = sigmaClippedMedian(regions[i]);
+    }
+
+    return HFRMap;
+}
+
+double FITSData::sigmaClippedMedian(QVector<double> values, double sigma, int iterations)
+{
+    if (values.isEmpty())
+        return -1;
+
+    double median=0;
+
+    for (int i=0; i < iterations; i++)
+    {
+        std::sort(values.begin(), values.end());
+
+        int count = values.count();
+        median = (count % 2) ? values[count/2] : (values[count/2-1] + values[count/2]) / 2.0;
+
+        if (count < 3)
+            break;
+
+        double variance=0;
+        foreach(double oneValue, values)
+            variance += (oneValue - median) * (oneValue - median);
+
+        double limit = sigma * sqrt(variance / (count - 1));
+
+        QVector<double> clipped;
+        clipped.reserve(count);
+        foreach(double oneValue, values)
+        {
+            if (fabs(oneValue - median) <= limit)
+                clipped.append(oneValue);
+        }
+
+        // Nothing rejected, we converged
+        if (clipped.count() == count || clipped.isEmpty())
+            break;
+
+        values = clipped;
+    }
+
+    return median;
+}
+
 double FITSData::getHFR(int x, int y)
 {
     if (starCenters.size() == 0)
@@ -2308,7 +2439,7 @@ template<typename T>  bool FITSData::rotFITS (int rotate, int mirror)
     int BBP = stats.bytesPerPixel;
 
     /* Allocate buffer for rotated image */
-    rotimage = new uint8_t[stats.samples_per_channel*channels*BBP];
+    rotimage = FITSBufferPool::Instance()->acquire(stats.width, stats.height, channels, BBP);
 
     if (rotimage == NULL)
     {
@@ -2533,7 +2664,7 @@ template<typename T>  bool FITSData::rotFITS (int rotate, int mirror)
         }
     }
 
-    delete[] imageBuffer;
+    FITSBufferPool::Instance()->release(imageBuffer);
     imageBuffer = rotimage;
 
     return true;
@@ -2840,10 +2971,19 @@ uint8_t *FITSData::getImageBuffer()
 
 void FITSData::setImageBuffer(uint8_t *buffer)
 {
-    delete[] imageBuffer;
+    FITSBufferPool::Instance()->release(imageBuffer);
     imageBuffer = buffer;
 }
 
+void FITSData::reportError(const QString &message, const QString &title)
+{
+    lastError = message;
+    if (notifyErrors)
+        KSNotification::error(message, title);
+    if (Options::fITSLogging())
+        qDebug() << message;
+}
+
 bool FITSData::checkDebayer()
 {
     int status=0;
@@ -2855,7 +2995,7 @@ bool FITSData::checkDebayer()
 
     if (stats.bitpix != 16 && stats.bitpix != 8)
     {
-        KSNotification::error(i18n("Only 8 and 16 bits bayered images supported."), i18n("Debayer error"));
+        reportError(i18n("Only 8 and 16 bits bayered images supported."), i18n("Debayer error"));
         return false;
     }
     QString pattern(bayerPattern);
@@ -2872,7 +3012,7 @@ bool FITSData::checkDebayer()
     // We return unless we find a valid pattern
     else
     {
-        KSNotification::error(i18n("Unsupported bayer pattern %1.", pattern), i18n("Debayer error"));
+        reportError(i18n("Unsupported bayer pattern %1.", pattern), i18n("Debayer error"));
         return false;
     }
 
@@ -2912,7 +3052,7 @@ bool FITSData::debayer()
         {
             char errmsg[512];
             fits_get_errstatus(status, errmsg);
-            KSNotification::error(i18n("Error reading image: %1", QString(errmsg)), i18n("Debayer error"));
+            reportError(i18n("Error reading image: %1", QString(errmsg)), i18n("Debayer error"));
             return false;
         }
     }
@@ -2937,11 +3077,11 @@ bool FITSData::debayer_8bit()
     dc1394error_t error_code;
 
     int rgb_size = stats.samples_per_channel*3*stats.bytesPerPixel;
-    uint8_t * destinationBuffer = new uint8_t[rgb_size];
+    uint8_t * destinationBuffer = FITSBufferPool::Instance()->acquire(rgb_size);
 
     if (destinationBuffer == NULL)
     {
-        KSNotification::error(i18n("Unable to allocate memory for temporary bayer buffer."), i18n("Debayer error"));
+        reportError(i18n("Unable to allocate memory for temporary bayer buffer."), i18n("Debayer error"));
         return false;
     }
 
@@ -2963,21 +3103,21 @@ bool FITSData::debayer_8bit()
 
     if ( error_code != DC1394_SUCCESS)
     {
-        KSNotification::error(i18n("Debayer failed (%1)", error_code), i18n("Debayer error"));
+        reportError(i18n("Debayer failed (%1)", error_code), i18n("Debayer error"));
         channels=1;
-        delete[] destinationBuffer;
+        FITSBufferPool::Instance()->release(destinationBuffer);
         return false;
     }
 
     if (channels == 1)
     {
-        delete[] imageBuffer;
-        imageBuffer = new uint8_t[rgb_size];
+        FITSBufferPool::Instance()->release(imageBuffer);
+        imageBuffer = FITSBufferPool::Instance()->acquire(rgb_size);
 
         if (imageBuffer == NULL)
         {
-            delete[] destinationBuffer;
-            KSNotification::error(i18n("Unable to allocate memory for temporary bayer buffer."), i18n("Debayer error"));
+            FITSBufferPool::Instance()->release(destinationBuffer);
+            reportError(i18n("Unable to allocate memory for temporary bayer buffer."), i18n("Debayer error"));
             return false;
         }
     }
@@ -2997,7 +3137,7 @@ bool FITSData::debayer_8bit()
     }
 
     channels=3;
-    delete[] destinationBuffer;
+    FITSBufferPool::Instance()->release(destinationBuffer);
     bayerBuffer = NULL;
     return true;
 }
@@ -3007,14 +3147,14 @@ bool FITSData::debayer_16bit()
     dc1394error_t error_code;
 
     int rgb_size = stats.samples_per_channel*3*stats.bytesPerPixel;
-    uint8_t * destinationBuffer = new uint8_t[rgb_size];
+    uint8_t * destinationBuffer = FITSBufferPool::Instance()->acquire(rgb_size);
 
     uint16_t * buffer    = reinterpret_cast<uint16_t*>(bayerBuffer);
     uint16_t * dstBuffer = reinterpret_cast<uint16_t*>(destinationBuffer);
 
     if (destinationBuffer == NULL)
     {
-        KSNotification::error(i18n("Unable to allocate memory for temporary bayer buffer."), i18n("Debayer error"));
+        reportError(i18n("Unable to allocate memory for temporary bayer buffer."), i18n("Debayer error"));
         return false;
     }
 
@@ -3036,21 +3176,21 @@ bool FITSData::debayer_16bit()
 
     if ( error_code != DC1394_SUCCESS)
     {
-        KSNotification::error(i18n("Debayer failed (%1)", error_code), i18n("Debayer error"));
+        reportError(i18n("Debayer failed (%1)", error_code), i18n("Debayer error"));
         channels=1;
-        delete[] destinationBuffer;
+        FITSBufferPool::Instance()->release(destinationBuffer);
         return false;
     }
 
     if (channels == 1)
     {
-        delete[] imageBuffer;
-        imageBuffer = new uint8_t[rgb_size];
+        FITSBufferPool::Instance()->release(imageBuffer);
+        imageBuffer = FITSBufferPool::Instance()->acquire(rgb_size);
 
         if (imageBuffer == NULL)
         {
-            delete[] destinationBuffer;
-            KSNotification::error(i18n("Unable to allocate memory for temporary bayer buffer."), i18n("Debayer error"));
+            FITSBufferPool::Instance()->release(destinationBuffer);
+            reportError(i18n("Unable to allocate memory for temporary bayer buffer."), i18n("Debayer error"));
             return false;
         }
     }
@@ -3072,7 +3212,7 @@ bool FITSData::debayer_16bit()
     }
 
     channels=3;
-    delete[] destinationBuffer;
+    FITSBufferPool::Instance()->release(destinationBuffer);
     bayerBuffer = NULL;
     return true;
 }
@@ -31,6 +31,7 @@
 #include <QScrollArea>
 #include <QLabel>
 #include <QStringList>
+#include <QVector>
 
 #include "skyobject.h"
 
@@ -107,6 +108,10 @@ public:
 
     /* Loads FITS image, scales it, and displays it in the GUI */
     bool  loadFITS(const QString &filename, bool silent=true);
+    /* Error of the last loadFITS(), including its automatic debayering. Empty if there was none. */
+    const QString & getLastError() const { return lastError; }
+    /* Show debayering errors to the user? True by default, false when the image is not loaded on the GUI thread. */
+    void setNotifyErrors(bool enable) { notifyErrors = enable; }
     /* Save FITS */
     int saveFITS(const QString &filename);
     /* Rescale image lineary from image_buffer, fit to window if desired */
@@ -116,6 +121,7 @@ public:
 
     // Access functions
     void clearImageBuffers();
+    // Takes ownership of buffer, which must be acquired from FITSBufferPool.
     void setImageBuffer(uint8_t *buffer);
     uint8_t * getImageBuffer();
 
@@ -168,6 +174,16 @@ public:
     Edge * getMaxHFRStar() { return maxHFRStar;}
     double getHFR(HFRType type=HFR_AVERAGE);
     double getHFR(int x, int y);
+    /**
+     * @brief getHFRMap Divide the image into columns x rows regions and calculate the sigma-clipped median HFR of the stars
+     * detected within each region. Useful to analyse tilt and field curvature. Requires findStars() to be called first.
+     * @return HFR per region in row-major order, or -1 for regions with no stars.
+     */
+    QVector<double> getHFRMap(int columns, int rows);
+    // HFR map of stars detected in an image of width x height pixels
+    static QVector<double> getHFRMap(const QList<Edge*> &stars, int width, int height, int columns, int rows);
+    // Median of values after iteratively rejecting values beyond sigma standard deviations
+    static double sigmaClippedMedian(QVector<double> values, double sigma=3, int iterations=3);
 
     // FITS Mode (Normal, Guide, Focus..etc).
     FITSMode getMode() { return mode;}
@@ -231,6 +247,8 @@ private:
     int calculateMinMax(bool refresh=false);    
     bool checkDebayer();
     void readWCSKeys();
+    /* Keep the error for getLastError(), and notify the user unless loading silently */
+    void reportError(const QString &message, const QString &title);
 
     // Templated functions
 
@@ -278,6 +296,8 @@ private:
     bool HasWCS;                        // Do we have WCS keywords in this FITS data?
     bool markStars;                     // Do we need to mark stars for the user?
     bool HasDebayer;                    // Is the image debayarable?
+    bool notifyErrors;                  // Show debayering errors to the user? Not when loading on a worker thread.
+    QString lastError;                  // Error of the last load, if any
 
     QString filename;                   // Our very own file name
     FITSMode mode;                      // FITS Mode (Normal, WCS, Guide, Focus..etc)
@@ -13,6 +13,7 @@
 #include "fitstab.h"
 #include "fitsview.h"
 #include "fitsdata.h"
+#include "fitsbufferpool.h"
 
 #include <cmath>
 #include <cstdlib>
@@ -454,7 +455,7 @@ bool FITSHistogramCommand::reverseDelta()
     int totalPixels = size * channels;
     unsigned long totalBytes = totalPixels * image_data->getBytesPerPixel();
 
-    uint8_t *output_image = new uint8_t[totalBytes];
+    uint8_t *output_image = FITSBufferPool::Instance()->acquire(totalBytes);
     if (output_image == NULL)
     {
         qWarning() << "Error! not enough memory to create output image" << endl;
@@ -464,7 +465,7 @@ bool FITSHistogramCommand::reverseDelta()
     uint8_t *raw_delta = new uint8_t[totalBytes];
     if (raw_delta == NULL)
     {
-        delete(output_image);
+        FITSBufferPool::Instance()->release(output_image);
         qWarning() << "Error! not enough memory to create image delta" << endl;
         return false;
     }
@@ -473,6 +474,7 @@ bool FITSHistogramCommand::reverseDelta()
     if (r != Z_OK)
     {
         qDebug() << "FITSHistogram compression error in reverseDelta()" << endl;
+        FITSBufferPool::Instance()->release(output_image);
         delete [] raw_delta;
         return false;
     }
@@ -526,7 +528,7 @@ void FITSHistogramCommand::redo()
         }
         else
         {
-            uint8_t *buffer = new uint8_t[size * channels * BBP];
+            uint8_t *buffer = FITSBufferPool::Instance()->acquire(static_cast<size_t>(size) * channels * BBP);
             if (buffer == NULL)
             {
                 qWarning() << "Error! not enough memory to create image buffer in redo()" << endl;
@@ -558,7 +560,7 @@ void FITSHistogramCommand::redo()
             }
 
             calculateDelta(buffer);
-            delete [] buffer;
+            FITSBufferPool::Instance()->release(buffer);
         }
     }
 
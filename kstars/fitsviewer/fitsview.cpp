@@ -19,6 +19,7 @@
 
 #include <config-kstars.h>
 #include "fitsview.h"
+#include "fitsbufferpool.h"
 #include "kspopupmenu.h"
 #include "skymap.h"
 
@@ -616,6 +617,61 @@ bool FITSView::loadFITS (const QString &inFilename , bool silent)
     return true;
 }
 
+bool FITSView::loadData(FITSData *data)
+{
+    Q_ASSERT(data);
+
+    if (data != image_data)
+    {
+        delete (image_data);
+        image_data = data;
+    }
+
+    filterStack.clear();
+    filterStack.push(FITS_NONE);
+    if (filter != FITS_NONE)
+        filterStack.push(filter);
+
+    emit debayerToggled(image_data->hasDebayer());
+
+    image_data->getDimensions(&currentWidth, &currentHeight);
+
+    image_width  = currentWidth;
+    image_height = currentHeight;
+
+    image_frame->setSize(image_width, image_height);
+
+    maxPixel = image_data->getMax();
+    minPixel = image_data->getMin();
+
+    initDisplayImage();
+
+    if (firstLoad)
+    {
+        currentZoom   = 100;
+
+        if (rescale(ZOOM_FIT_WINDOW))
+            return false;
+
+        firstLoad = false;
+    }
+    else
+    {
+        if (rescale(ZOOM_KEEP_LEVEL))
+            return false;
+    }
+
+    // Stars may have been detected already while the data was loaded
+    starsSearched = image_data->areStarsSearched();
+
+    setAlignment(Qt::AlignCenter);
+
+    if (isVisible())
+        emit newStatus(QString("%1x%2").arg(image_width).arg(image_height), FITS_RESOLUTION);
+
+    return true;
+}
+
 int FITSView::saveFITS( const QString &newFilename )
 {
     return image_data->saveFITS(newFilename);
@@ -681,7 +737,9 @@ template<typename T>  int FITSView::rescale(FITSZoom type)
 
     if (Options::autoStretch() && (filter == FITS_NONE || (filter >= FITS_ROTATE_CW && filter <= FITS_FLIP_V )))
     {
-        image_buffer = new uint8_t[image_data->getSize() * image_data->getNumOfChannels() * BBP];
+        image_buffer = FITSBufferPool::Instance()->acquire(image_data->getSize() * image_data->getNumOfChannels() * BBP);
+        if (image_buffer == NULL)
+            return -1;
         memcpy(image_buffer, image_data->getImageBuffer(), image_data->getSize() * image_data->getNumOfChannels() * BBP);
 
         displayBuffer = true;
@@ -762,7 +820,7 @@ template<typename T>  int FITSView::rescale(FITSZoom type)
     }
 
     if (displayBuffer)
-        delete [] image_buffer;
+        FITSBufferPool::Instance()->release(image_buffer);
 
     switch (type)
     {
@@ -98,6 +98,8 @@ public:
 
     /* Loads FITS image, scales it, and displays it in the GUI */
     bool  loadFITS(const QString &filename, bool silent=true);
+    /* Displays data already loaded elsewhere, e.g. on a worker thread. The view takes ownership of data. */
+    bool  loadData(FITSData *data);
     /* Save FITS */
     int saveFITS(const QString &filename);
     /* Rescale image lineary from image_buffer, fit to window if desired */
@@ -26,6 +26,7 @@
 #include "deviceinfo.h"
 #include "indilistener.h"
 #include "guimanager.h"
+#include "indiupdatequeue.h"
 
 #include "Options.h"
 
@@ -34,6 +35,9 @@ ClientManager::ClientManager()
 
 sManager = NULL;
 
+updateQueue = new INDIUpdateQueue(this);
+updateQueue->setDefaultInterval(Options::indiUpdateInterval());
+
 }
 
 ClientManager::~ClientManager()
@@ -117,6 +121,7 @@ void ClientManager::newProperty(INDI::Property *prop)
 
 void ClientManager::removeProperty(INDI::Property *prop)
 {
+    updateQueue->removeProperty(prop->getProperty());
     emit removeINDIProperty(prop);
 }
 
@@ -128,6 +133,8 @@ void ClientManager::removeDevice(INDI::BaseDevice *dp)
         {
             if (deviceInfo->getBaseDevice() == dp)
             {
+                updateQueue->removeDevice(dp->getDeviceName());
+
                 //GUIManager::Instance()->removeDevice(deviceInfo);
                 //INDIListener::Instance()->removeDevice(deviceInfo);
 
@@ -147,26 +154,31 @@ void ClientManager::removeDevice(INDI::BaseDevice *dp)
 void ClientManager::newBLOB(IBLOB *bp)
 {
    emit newINDIBLOB(bp);
+   updateQueue->queueBLOB(bp);
 }
 
 void ClientManager::newSwitch(ISwitchVectorProperty *svp)
 {
     emit newINDISwitch(svp);
+    updateQueue->queueSwitch(svp);
 }
 
 void ClientManager::newNumber(INumberVectorProperty * nvp)
 {
     emit newINDINumber(nvp);
+    updateQueue->queueNumber(nvp);
 }
 
 void ClientManager::newText(ITextVectorProperty * tvp)
 {
     emit newINDIText(tvp);
+    updateQueue->queueText(tvp);
 }
 
 void ClientManager::newLight(ILightVectorProperty * lvp)
 {
     emit newINDILight(lvp);
+    updateQueue->queueLight(lvp);
 }
 
 void ClientManager::newMessage(INDI::BaseDevice *dp, int messageID)
@@ -224,6 +236,8 @@ void ClientManager::serverConnected()
 
 void ClientManager::serverDisconnected(int exit_code)
 {
+    updateQueue->clear();
+
     foreach (DriverInfo *device, managedDrivers)
     {
         device->setClientState(false);
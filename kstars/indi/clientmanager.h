@@ -23,6 +23,7 @@
 class DeviceInfo;
 class DriverInfo;
 class ServerManager;
+class INDIUpdateQueue;
 
 /**
  * @class ClientManager
@@ -64,6 +65,12 @@ public:
 
     ServerManager* getServerManager() { return sManager;}
 
+    /**
+     * @brief getUpdateQueue Property updates coalesced for the INDI Control Panel.
+     * @return the update queue, whose signals the control panel connects to instead of newINDISwitch/Number/Text/Light/BLOB.
+     */
+    INDIUpdateQueue* getUpdateQueue() { return updateQueue; }
+
     DriverInfo * findDriverInfoByName(const QString &name);
     DriverInfo * findDriverInfoByLabel(const QString &label);
 
@@ -90,6 +97,7 @@ private:
 
     QList<DriverInfo *> managedDrivers;
     ServerManager *sManager;
+    INDIUpdateQueue *updateQueue;
 
 signals:
     void connectionSuccessful();
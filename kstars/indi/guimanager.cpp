@@ -38,6 +38,7 @@
 #include "guimanager.h"
 #include "driverinfo.h"
 #include "deviceinfo.h"
+#include "indiupdatequeue.h"
 
 #include "Options.h"
 
@@ -282,11 +283,13 @@ void GUIManager::buildDevice(DeviceInfo *di)
     connect(cm, SIGNAL(newINDIProperty(INDI::Property*)), gdm, SLOT(buildProperty(INDI::Property*)), type);
     connect(cm, SIGNAL(removeINDIProperty(INDI::Property*)), gdm, SLOT(removeProperty(INDI::Property*)), type);
 
-    connect(cm, SIGNAL(newINDISwitch(ISwitchVectorProperty*)), gdm, SLOT(updateSwitchGUI(ISwitchVectorProperty*)));
-    connect(cm, SIGNAL(newINDIText(ITextVectorProperty*)), gdm, SLOT(updateTextGUI(ITextVectorProperty*)));
-    connect(cm, SIGNAL(newINDINumber(INumberVectorProperty*)), gdm, SLOT(updateNumberGUI(INumberVectorProperty*)));
-    connect(cm, SIGNAL(newINDILight(ILightVectorProperty*)), gdm, SLOT(updateLightGUI(ILightVectorProperty*)));
-    connect(cm, SIGNAL(newINDIBLOB(IBLOB*)), gdm, SLOT(updateBLOBGUI(IBLOB*)));
+    // Fast drivers would flood the panel, it is updated at most once per frame interval for each property
+    INDIUpdateQueue *queue = cm->getUpdateQueue();
+    connect(queue, SIGNAL(newSwitch(ISwitchVectorProperty*)), gdm, SLOT(updateSwitchGUI(ISwitchVectorProperty*)));
+    connect(queue, SIGNAL(newText(ITextVectorProperty*)), gdm, SLOT(updateTextGUI(ITextVectorProperty*)));
+    connect(queue, SIGNAL(newNumber(INumberVectorProperty*)), gdm, SLOT(updateNumberGUI(INumberVectorProperty*)));
+    connect(queue, SIGNAL(newLight(ILightVectorProperty*)), gdm, SLOT(updateLightGUI(ILightVectorProperty*)));
+    connect(queue, SIGNAL(newBLOB(IBLOB*)), gdm, SLOT(updateBLOBGUI(IBLOB*)));
 
     connect(cm, SIGNAL(newINDIMessage(INDI::BaseDevice*, int)), gdm, SLOT(updateMessageLog(INDI::BaseDevice*, int)));
 
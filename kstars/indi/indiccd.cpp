@@ -56,6 +56,7 @@ CCDChip::CCDChip(ISD::CCD *ccd, ChipType cType)
     parentCCD     = ccd;
     type          = cType;
     batchMode     = false;
+    asyncLoad     = false;
     displayFITS   = true;
     CanBin        = false;
     CanSubframe   = false;
@@ -1379,7 +1380,8 @@ void CCD::processBLOB(IBLOB* bp)
 
         {
             FITSView *focusView = targetChip->getImageView(FITS_FOCUS);
-            if (focusView)
+            // Asynchronous receivers load the image themselves on a worker thread
+            if (focusView && targetChip->isAsyncLoad() == false)
             {
                 focusView->setFilter(captureFilter);
                 bool imageLoad = focusView->loadFITS(filename, true);
@@ -79,6 +79,9 @@ public:
     FITSScale getCaptureFilter() const { return captureFilter; }
     bool isBatchMode() const { return batchMode; }
     void setBatchMode(bool enable) { batchMode = enable; }
+    // If enabled, focus frames are not loaded into the focus view when received. The receiver loads them asynchronously.
+    bool isAsyncLoad() const { return asyncLoad; }
+    void setAsyncLoad(bool enable) { asyncLoad = enable; }
     QStringList getFrameTypes() const { return frameTypes; }
     void addFrameLabel(const QString & label) { frameTypes << label; }
     void clearFrameTypes() { frameTypes.clear();}
@@ -109,6 +112,7 @@ private:
     ClientManager *clientManager;
     ChipType type;
     bool batchMode;
+    bool asyncLoad;
     bool displayFITS;
     QStringList frameTypes;
     bool CanBin;
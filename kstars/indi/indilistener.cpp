@@ -121,6 +121,7 @@ void INDIListener::removeClient(ClientManager *cm)
 
         if (dv && cm->isDriverManaged(dv))
         {
+            propertyIndex.removeDevice(*it);
             it = devices.erase(it);
 
             cm->removeManagedDriver(dv);
@@ -156,6 +157,7 @@ void INDIListener::removeDevice(DeviceInfo *dv)
         if (gd->getDeviceInfo() == dv)
         {
             emit deviceRemoved(gd);
+            propertyIndex.removeDevice(gd);
             devices.removeOne(gd);
             delete(gd);
         }
@@ -188,6 +190,8 @@ void INDIListener::registerProperty(INDI::Property *prop)
     {
         if (!strcmp(gd->getDeviceName(), prop->getDeviceName() ))
         {
+            ISD::GDInterface *undecorated = gd;
+
             if ( gd->getType() == KSTARS_UNKNOWN && (!strcmp(prop->getName(), "EQUATORIAL_EOD_COORD") || !strcmp(prop->getName(), "HORIZONTAL_COORD")) )
             {
                 devices.removeOne(gd);
@@ -291,6 +295,11 @@ void INDIListener::registerProperty(INDI::Property *prop)
                 emit newST4(st4Driver);
             }
 
+            // Updates of the property are dispatched to the device by the address of its vector
+            if (gd != undecorated)
+                propertyIndex.replaceDevice(undecorated, gd);
+            propertyIndex.insert(prop->getProperty(), gd);
+
             gd->registerProperty(prop);
             break;
         }
@@ -302,6 +311,8 @@ void INDIListener::removeProperty(INDI::Property *prop)
     if (prop == NULL)
         return;
 
+    propertyIndex.remove(prop->getProperty());
+
     foreach(ISD::GDInterface *gd, devices)
     {
         if (!strcmp(gd->getDeviceName(), prop->getDeviceName() ))
@@ -312,67 +323,54 @@ void INDIListener::removeProperty(INDI::Property *prop)
     }
 }
 
-void INDIListener::processSwitch(ISwitchVectorProperty * svp)
+ISD::GDInterface * INDIListener::findDevice(const void *property, const char *deviceName)
 {
+    ISD::GDInterface *gd = propertyIndex.device(property);
+    if (gd)
+        return gd;
 
-    foreach(ISD::GDInterface *gd, devices)
+    foreach(ISD::GDInterface *gi, devices)
     {
-        if (!strcmp(gd->getDeviceName(), svp->device))
-        {
-            gd->processSwitch(svp);
-            break;
-        }
+        if (!strcmp(gi->getDeviceName(), deviceName))
+            return gi;
     }
 
+    return NULL;
+}
+
+void INDIListener::processSwitch(ISwitchVectorProperty * svp)
+{
+    ISD::GDInterface *gd = findDevice(svp, svp->device);
+    if (gd)
+        gd->processSwitch(svp);
 }
 
 void INDIListener::processNumber(INumberVectorProperty * nvp)
 {
-    foreach(ISD::GDInterface *gd, devices)
-    {
-        if (!strcmp(gd->getDeviceName(), nvp->device))
-        {
-            gd->processNumber(nvp);
-            break;
-        }
-    }
+    ISD::GDInterface *gd = findDevice(nvp, nvp->device);
+    if (gd)
+        gd->processNumber(nvp);
 }
 
 void INDIListener::processText(ITextVectorProperty * tvp)
 {
-    foreach(ISD::GDInterface *gd, devices)
-    {
-        if (!strcmp(gd->getDeviceName(), tvp->device))
-        {
-            gd->processText(tvp);
-            break;
-        }
-    }
+    ISD::GDInterface *gd = findDevice(tvp, tvp->device);
+    if (gd)
+        gd->processText(tvp);
 }
 
 void INDIListener::processLight(ILightVectorProperty * lvp)
 {
-
-    foreach(ISD::GDInterface *gd, devices)
-    {
-        if (!strcmp(gd->getDeviceName(), lvp->device))
-        {
-            gd->processLight(lvp);
-            break;
-        }
-    }
+    ISD::GDInterface *gd = findDevice(lvp, lvp->device);
+    if (gd)
+        gd->processLight(lvp);
 }
 
 void INDIListener::processBLOB(IBLOB* bp)
 {
-    foreach(ISD::GDInterface *gd, devices)
-    {
-        if (!strcmp(gd->getDeviceName(), bp->bvp->device))
-        {
-            gd->processBLOB(bp);
-            break;
-        }
-    }
+    ISD::GDInterface *gd = findDevice(bp->bvp, bp->bvp->device);
+    if (gd)
+        gd->processBLOB(bp);
 }
 
 void INDIListener::processMessage(INDI::BaseDevice *dp, int messageID)
@@ -16,6 +16,7 @@
 #include <QObject>
 
 #include "indi/indistd.h"
+#include "indi/indipropertyindex.h"
 
 class ClientManager;
 class FITSViewer;
@@ -34,6 +35,11 @@ class DeviceInfo;
 class INDIListener : public QObject
 {
     Q_OBJECT
+
+#ifdef UNIT_TEST
+    friend class TestINDIListener;
+#endif
+
 public:
 
     static INDIListener *Instance();
@@ -55,6 +61,10 @@ public:
     QList<ClientManager *> clients;
     QList<ISD::GDInterface *> devices;
     QList<ISD::ST4*> st4Devices;
+    INDIPropertyIndex propertyIndex;
+
+    /** @return the device of @p property, looked up by @p deviceName if the property was not registered */
+    ISD::GDInterface * findDevice(const void *property, const char *deviceName);
 
 public slots:
 
@@ -0,0 +1,43 @@
+/*  INDI Property Index
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#include "indipropertyindex.h"
+
+void INDIPropertyIndex::insert(const void *property, ISD::GDInterface *device)
+{
+    if (property)
+        index.insert(property, device);
+}
+
+void INDIPropertyIndex::remove(const void *property)
+{
+    index.remove(property);
+}
+
+void INDIPropertyIndex::replaceDevice(ISD::GDInterface *oldDevice, ISD::GDInterface *newDevice)
+{
+    QHash<const void *, ISD::GDInterface *>::iterator it;
+    for (it = index.begin(); it != index.end(); ++it)
+    {
+        if (it.value() == oldDevice)
+            it.value() = newDevice;
+    }
+}
+
+void INDIPropertyIndex::removeDevice(ISD::GDInterface *device)
+{
+    QHash<const void *, ISD::GDInterface *>::iterator it = index.begin();
+    while (it != index.end())
+    {
+        if (it.value() == device)
+            it = index.erase(it);
+        else
+            ++it;
+    }
+}
@@ -0,0 +1,54 @@
+/*  INDI Property Index
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef INDIPROPERTYINDEX_H
+#define INDIPROPERTYINDEX_H
+
+#include <QHash>
+
+namespace ISD
+{
+class GDInterface;
+}
+
+/**
+ * @class INDIPropertyIndex
+ * INDIPropertyIndex finds the device of an INDI property without comparing names.
+ *
+ * The property vectors (INumberVectorProperty, ISwitchVectorProperty...) are created by INDI::BaseDevice when a property
+ * is defined, and each update is delivered with the same vector until the property is deleted. The address of the vector
+ * is therefore used as the handle of the property, recorded with its device when INDIListener registers the property.
+ */
+class INDIPropertyIndex
+{
+public:
+    /** Record @p device as the owner of the property vector @p property, as returned by INDI::Property::getProperty() */
+    void insert(const void *property, ISD::GDInterface *device);
+
+    /** Forget @p property, for instance when it is deleted */
+    void remove(const void *property);
+
+    /** @return the device of @p property, or NULL if the property was not recorded */
+    ISD::GDInterface * device(const void *property) const { return index.value(property, NULL); }
+
+    /** Move the properties of @p oldDevice to @p newDevice, when INDIListener decorates a device */
+    void replaceDevice(ISD::GDInterface *oldDevice, ISD::GDInterface *newDevice);
+
+    /** Forget all the properties of @p device */
+    void removeDevice(ISD::GDInterface *device);
+
+    int size() const { return index.size(); }
+
+    void clear() { index.clear(); }
+
+private:
+    QHash<const void *, ISD::GDInterface *> index;
+};
+
+#endif // INDIPROPERTYINDEX_H
@@ -0,0 +1,288 @@
+/*  INDI Update Queue
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#include <QList>
+#include <QMutexLocker>
+#include <QPair>
+#include <QTimer>
+
+#include "indiupdatequeue.h"
+
+// Milliseconds between two dispatches of a property, about the refresh rate of the INDI Control Panel
+#define DEFAULT_INTERVAL    100
+
+INDIUpdateQueue::INDIUpdateQueue(QObject *parent) : QObject(parent), defaultMsecs(DEFAULT_INTERVAL), pending(0)
+{
+    clock.start();
+
+    timer = new QTimer(this);
+    timer->setSingleShot(true);
+    connect(timer, SIGNAL(timeout()), this, SLOT(dispatchDue()));
+}
+
+void INDIUpdateQueue::setDefaultInterval(int msecs)
+{
+    QMutexLocker locker(&mutex);
+
+    defaultMsecs = qMax(0, msecs);
+
+    QHash<void *, Entry>::iterator it;
+    for (it = entries.begin(); it != entries.end(); ++it)
+    {
+        if (!intervals.contains(it->name))
+            it->interval = defaultMsecs;
+    }
+}
+
+int INDIUpdateQueue::defaultInterval() const
+{
+    QMutexLocker locker(&mutex);
+    return defaultMsecs;
+}
+
+void INDIUpdateQueue::setInterval(const QString &propertyName, int msecs)
+{
+    QMutexLocker locker(&mutex);
+
+    QByteArray name = propertyName.toLatin1();
+    intervals[name] = qMax(0, msecs);
+
+    QHash<void *, Entry>::iterator it;
+    for (it = entries.begin(); it != entries.end(); ++it)
+    {
+        if (it->name == name)
+            it->interval = intervals[name];
+    }
+}
+
+void INDIUpdateQueue::queueSwitch(ISwitchVectorProperty *svp)
+{
+    enqueue(svp, SWITCH_VECTOR, svp->device, svp->name, svp->s);
+}
+
+void INDIUpdateQueue::queueNumber(INumberVectorProperty *nvp)
+{
+    enqueue(nvp, NUMBER_VECTOR, nvp->device, nvp->name, nvp->s);
+}
+
+void INDIUpdateQueue::queueText(ITextVectorProperty *tvp)
+{
+    enqueue(tvp, TEXT_VECTOR, tvp->device, tvp->name, tvp->s);
+}
+
+void INDIUpdateQueue::queueLight(ILightVectorProperty *lvp)
+{
+    enqueue(lvp, LIGHT_VECTOR, lvp->device, lvp->name, lvp->s);
+}
+
+void INDIUpdateQueue::queueBLOB(IBLOB *bp)
+{
+    // Each BLOB is new data, not the new state of a property
+    emit newBLOB(bp);
+}
+
+void INDIUpdateQueue::enqueue(void *vp, VectorType type, const char *device, const char *name, IPState state)
+{
+    QMutexLocker locker(&mutex);
+
+    const qint64 now = clock.elapsed();
+    bool dispatchNow = false;
+
+    QHash<void *, Entry>::iterator it = entries.find(vp);
+    if (it == entries.end())
+    {
+        Entry entry;
+        entry.type = type;
+        entry.device = device;
+        entry.name = name;
+        entry.interval = intervals.value(entry.name, defaultMsecs);
+        entry.lastDispatch = now;
+        entry.lastState = state;
+        entry.pending = false;
+        it = entries.insert(vp, entry);
+
+        dispatchNow = true;
+    }
+
+    Entry &entry = it.value();
+
+    if (dispatchNow || state != entry.lastState || now - entry.lastDispatch >= entry.interval)
+    {
+        if (entry.pending)
+        {
+            entry.pending = false;
+            pending--;
+        }
+        entry.lastDispatch = now;
+        entry.lastState = state;
+
+        locker.unlock();
+        dispatch(vp, type);
+        return;
+    }
+
+    // Held back, the vector will hold the latest state when it is dispatched
+    if (entry.pending == false)
+    {
+        entry.pending = true;
+        if (++pending == 1)
+            QMetaObject::invokeMethod(this, "scheduleDispatch", Qt::QueuedConnection);
+    }
+}
+
+qint64 INDIUpdateQueue::nextDue(qint64 now) const
+{
+    qint64 delay = -1;
+
+    foreach(const Entry &entry, entries)
+    {
+        if (entry.pending)
+        {
+            qint64 due = qMax<qint64>(0, entry.lastDispatch + entry.interval - now);
+            if (delay < 0 || due < delay)
+                delay = due;
+        }
+    }
+
+    return delay;
+}
+
+void INDIUpdateQueue::scheduleDispatch()
+{
+    QMutexLocker locker(&mutex);
+
+    qint64 delay = nextDue(clock.elapsed());
+    if (delay >= 0)
+        timer->start(int(delay));
+}
+
+void INDIUpdateQueue::dispatchDue()
+{
+    QList<QPair<void *, VectorType> > due;
+
+    {
+        QMutexLocker locker(&mutex);
+
+        const qint64 now = clock.elapsed();
+
+        QHash<void *, Entry>::iterator it;
+        for (it = entries.begin(); it != entries.end(); ++it)
+        {
+            if (it->pending && now - it->lastDispatch >= it->interval)
+            {
+                it->pending = false;
+                it->lastDispatch = now;
+                pending--;
+                due.append(qMakePair(it.key(), it->type));
+            }
+        }
+
+        qint64 delay = nextDue(now);
+        if (delay >= 0)
+            timer->start(int(delay));
+    }
+
+    for (int i=0; i < due.size(); i++)
+        dispatch(due[i].first, due[i].second);
+}
+
+void INDIUpdateQueue::flush()
+{
+    QList<QPair<void *, VectorType> > due;
+
+    {
+        QMutexLocker locker(&mutex);
+
+        const qint64 now = clock.elapsed();
+
+        QHash<void *, Entry>::iterator it;
+        for (it = entries.begin(); it != entries.end(); ++it)
+        {
+            if (it->pending)
+            {
+                it->pending = false;
+                it->lastDispatch = now;
+                due.append(qMakePair(it.key(), it->type));
+            }
+        }
+
+        pending = 0;
+        timer->stop();
+    }
+
+    for (int i=0; i < due.size(); i++)
+        dispatch(due[i].first, due[i].second);
+}
+
+void INDIUpdateQueue::dispatch(void *vp, VectorType type)
+{
+    switch (type)
+    {
+        case SWITCH_VECTOR:
+            emit newSwitch(static_cast<ISwitchVectorProperty *>(vp));
+            break;
+
+        case NUMBER_VECTOR:
+            emit newNumber(static_cast<INumberVectorProperty *>(vp));
+            break;
+
+        case TEXT_VECTOR:
+            emit newText(static_cast<ITextVectorProperty *>(vp));
+            break;
+
+        case LIGHT_VECTOR:
+            emit newLight(static_cast<ILightVectorProperty *>(vp));
+            break;
+    }
+}
+
+void INDIUpdateQueue::removeProperty(const void *property)
+{
+    QMutexLocker locker(&mutex);
+
+    QHash<void *, Entry>::iterator it = entries.find(const_cast<void *>(property));
+    if (it == entries.end())
+        return;
+
+    if (it->pending)
+        pending--;
+    entries.erase(it);
+}
+
+void INDIUpdateQueue::removeDevice(const char *deviceName)
+{
+    QMutexLocker locker(&mutex);
+
+    QHash<void *, Entry>::iterator it = entries.begin();
+    while (it != entries.end())
+    {
+        if (it->device == deviceName)
+        {
+            if (it->pending)
+                pending--;
+            it = entries.erase(it);
+        }
+        else
+            ++it;
+    }
+}
+
+void INDIUpdateQueue::clear()
+{
+    QMutexLocker locker(&mutex);
+
+    entries.clear();
+    pending = 0;
+}
+
+int INDIUpdateQueue::pendingCount() const
+{
+    QMutexLocker locker(&mutex);
+    return pending;
+}
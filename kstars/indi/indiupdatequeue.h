@@ -0,0 +1,114 @@
+/*  INDI Update Queue
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef INDIUPDATEQUEUE_H
+#define INDIUPDATEQUEUE_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+
+#include <indiapi.h>
+
+class QTimer;
+
+/**
+ * @class INDIUpdateQueue
+ * INDIUpdateQueue coalesces the property updates shown in the INDI Control Panel.
+ *
+ * A driver polling fast, like a mount or a weather station, sends many more updates than the panel can show. Each
+ * property is dispatched at most once per frame interval: an update arriving sooner is held back, and only the
+ * latest state of the property is dispatched when the interval is over. Properties are identified by their vector,
+ * which INDI::BaseDevice reuses for every update of the same device and property.
+ *
+ * Updates changing the state of a property (Busy to Ok or Alert, for instance) are dispatched immediately, and
+ * BLOBs are never held back.
+ *
+ * The queue functions may be called from the INDI client thread, the signals are emitted in the thread of the queue
+ * when an update is held back, and in the calling thread otherwise.
+ */
+class INDIUpdateQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit INDIUpdateQueue(QObject *parent = NULL);
+
+    /** Set the minimum time between two dispatches of the same property, 0 to dispatch all the updates */
+    void setDefaultInterval(int msecs);
+    int defaultInterval() const;
+
+    /** Set the frame interval of the properties named @p propertyName, overriding the default interval */
+    void setInterval(const QString &propertyName, int msecs);
+
+    void queueSwitch(ISwitchVectorProperty *svp);
+    void queueNumber(INumberVectorProperty *nvp);
+    void queueText(ITextVectorProperty *tvp);
+    void queueLight(ILightVectorProperty *lvp);
+    void queueBLOB(IBLOB *bp);
+
+    /** Drop the updates of @p property, before its vector is deleted */
+    void removeProperty(const void *property);
+
+    /** Drop the updates of all the properties of @p deviceName */
+    void removeDevice(const char *deviceName);
+
+    /** Drop all the updates */
+    void clear();
+
+    /** @return the number of properties held back */
+    int pendingCount() const;
+
+public slots:
+    /** Dispatch all the updates held back */
+    void flush();
+
+private slots:
+    void scheduleDispatch();
+    void dispatchDue();
+
+signals:
+    void newSwitch(ISwitchVectorProperty *svp);
+    void newNumber(INumberVectorProperty *nvp);
+    void newText(ITextVectorProperty *tvp);
+    void newLight(ILightVectorProperty *lvp);
+    void newBLOB(IBLOB *bp);
+
+private:
+    typedef enum { SWITCH_VECTOR, NUMBER_VECTOR, TEXT_VECTOR, LIGHT_VECTOR } VectorType;
+
+    struct Entry
+    {
+        VectorType type;
+        QByteArray device;
+        QByteArray name;
+        int interval;
+        qint64 lastDispatch;
+        IPState lastState;
+        bool pending;
+    };
+
+    void enqueue(void *vp, VectorType type, const char *device, const char *name, IPState state);
+    void dispatch(void *vp, VectorType type);
+
+    /** @return the time until the next pending property is due, or -1 if none is pending. Called with the mutex locked. */
+    qint64 nextDue(qint64 now) const;
+
+    QHash<void *, Entry> entries;
+    QHash<QByteArray, int> intervals;
+    int defaultMsecs;
+    int pending;
+    QElapsedTimer clock;
+    QTimer *timer;
+    mutable QMutex mutex;
+};
+
+#endif // INDIUPDATEQUEUE_H
@@ -0,0 +1,151 @@
+/*  SER Video Recorder
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#include "serrecorder.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QtEndian>
+
+#include <cstring>
+
+#define SER_HEADER_SIZE     178
+#define SER_STRING_SIZE     40
+
+// .NET ticks at the Unix epoch
+#define SER_EPOCH_TICKS     Q_INT64_C(621355968000000000)
+
+namespace
+{
+void putInt32(uint8_t *header, int offset, int32_t value)
+{
+    qToLittleEndian<qint32>(value, header + offset);
+}
+
+void putInt64(uint8_t *header, int offset, int64_t value)
+{
+    qToLittleEndian<qint64>(value, header + offset);
+}
+}
+
+SERRecorder::SERRecorder()
+{
+    frames = frameWidth = frameHeight = pixelDepth = 0;
+    frameColorID = SER_MONO;
+    startTicks = 0;
+}
+
+SERRecorder::~SERRecorder()
+{
+    close();
+}
+
+bool SERRecorder::open(const QString &filename, const QString &instrument)
+{
+    close();
+
+    file.setFileName(filename);
+
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate) == false)
+    {
+        qWarning() << "SERRecorder: Cannot open" << filename << file.errorString();
+        return false;
+    }
+
+    instrumentName = instrument;
+    frames = frameWidth = frameHeight = pixelDepth = 0;
+    frameColorID = SER_MONO;
+    startTicks = currentTicks();
+    timestamps.clear();
+
+    // Geometry is unknown until the first frame arrives, reserve space for the header
+    return writeHeader();
+}
+
+bool SERRecorder::writeFrame(const uint8_t *buffer, uint32_t width, uint32_t height, ColorID colorID, uint32_t bitDepth)
+{
+    if (file.isOpen() == false || buffer == NULL)
+        return false;
+
+    if (frames == 0)
+    {
+        frameWidth   = width;
+        frameHeight  = height;
+        frameColorID = colorID;
+        pixelDepth   = bitDepth;
+    }
+    else if (width != frameWidth || height != frameHeight || colorID != frameColorID || bitDepth != pixelDepth)
+        return false;
+
+    qint64 planes = (colorID == SER_MONO) ? 1 : 3;
+    qint64 size   = static_cast<qint64>(width) * height * planes * (bitDepth > 8 ? 2 : 1);
+
+    if (file.write(reinterpret_cast<const char *>(buffer), size) != size)
+    {
+        qWarning() << "SERRecorder: Failed to write frame" << frames << file.errorString();
+        return false;
+    }
+
+    timestamps.append(currentTicks());
+    frames++;
+
+    return true;
+}
+
+void SERRecorder::close()
+{
+    if (file.isOpen() == false)
+        return;
+
+    // Trailer holds one UTC timestamp per frame
+    for (int i=0; i < timestamps.count(); i++)
+    {
+        uint8_t ticks[8];
+        qToLittleEndian<qint64>(timestamps[i], ticks);
+        file.write(reinterpret_cast<const char *>(ticks), sizeof(ticks));
+    }
+
+    if (file.seek(0))
+        writeHeader();
+
+    file.close();
+    timestamps.clear();
+}
+
+bool SERRecorder::writeHeader()
+{
+    uint8_t header[SER_HEADER_SIZE];
+    memset(header, 0, sizeof(header));
+
+    memcpy(header, "LUCAM-RECORDER", 14);
+    putInt32(header, 14, 0);
+    putInt32(header, 18, frameColorID);
+    // 16 bit data is written in host order, which we assume to be little endian
+    putInt32(header, 22, 1);
+    putInt32(header, 26, frameWidth);
+    putInt32(header, 30, frameHeight);
+    putInt32(header, 34, pixelDepth);
+    putInt32(header, 38, frames);
+
+    QByteArray observer("KStars");
+    memcpy(header + 42, observer.constData(), qMin(observer.size(), SER_STRING_SIZE));
+    QByteArray instrument = instrumentName.toLatin1();
+    memcpy(header + 82, instrument.constData(), qMin(instrument.size(), SER_STRING_SIZE));
+
+    int64_t localTicks = startTicks + static_cast<int64_t>(QDateTime::currentDateTime().offsetFromUtc()) * 10000000;
+    putInt64(header, 162, localTicks);
+    putInt64(header, 170, startTicks);
+
+    return (file.write(reinterpret_cast<const char *>(header), SER_HEADER_SIZE) == SER_HEADER_SIZE);
+}
+
+int64_t SERRecorder::currentTicks()
+{
+    return QDateTime::currentDateTimeUtc().toMSecsSinceEpoch() * 10000 + SER_EPOCH_TICKS;
+}
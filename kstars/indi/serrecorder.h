@@ -0,0 +1,82 @@
+/*  SER Video Recorder
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef SERRECORDER_H
+#define SERRECORDER_H
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+#include <cstdint>
+
+/**
+ *@class SERRecorder
+ *@short Writes raw video frames sequentially to a SER file.
+ *
+ * SER is the de-facto standard container for planetary video. It consists of a 178 bytes header, the raw frames one after
+ * another and a trailer of UTC timestamps, one per frame. The frame geometry is taken from the first frame written, frames
+ * with a different geometry are rejected. The frame count in the header and the timestamp trailer are written by close().
+ *@version 1.0
+ */
+class SERRecorder
+{
+public:
+
+    typedef enum
+    {
+        SER_MONO  = 0,
+        SER_RGB   = 100,
+        SER_BGR   = 101
+    } ColorID;
+
+    SERRecorder();
+    ~SERRecorder();
+
+    /**
+     * @brief open Create a new SER file. Any existing file is overwritten.
+     * @return true if the file was created, false otherwise.
+     */
+    bool open(const QString &filename, const QString &instrument=QString());
+
+    /**
+     * @brief writeFrame Append a frame to the file.
+     * @param buffer raw pixels, tightly packed.
+     * @param width width in pixels
+     * @param height height in pixels
+     * @param colorID pixel layout
+     * @param bitDepth bits per plane, 8 or 16.
+     * @return true if the frame was written, false otherwise.
+     */
+    bool writeFrame(const uint8_t *buffer, uint32_t width, uint32_t height, ColorID colorID, uint32_t bitDepth=8);
+
+    /** Finalize header and timestamps and close the file. */
+    void close();
+
+    bool isOpen() const { return file.isOpen(); }
+    uint32_t frameCount() const { return frames; }
+    QString fileName() const { return file.fileName(); }
+
+private:
+    bool writeHeader();
+
+    // Current UTC time in .NET ticks (100 ns since 0001-01-01), as required by SER
+    static int64_t currentTicks();
+
+    QFile file;
+    QString instrumentName;
+
+    uint32_t frames;
+    uint32_t frameWidth, frameHeight, pixelDepth;
+    ColorID  frameColorID;
+    int64_t  startTicks;
+    QVector<int64_t> timestamps;
+};
+
+#endif // SERRECORDER_H
@@ -10,6 +10,7 @@
  */
 
 #include "streamwg.h"
+#include "streamworker.h"
 #include "indistd.h"
 #include "kstars.h"
 #include "Options.h"
@@ -36,6 +37,7 @@
 #include <QImageReader>
 #include <QIcon>
 #include <QTemporaryFile>
+#include <QStatusBar>
 
 #include <stdlib.h>
 #include <fcntl.h>
@@ -49,28 +51,52 @@ StreamWG::StreamWG(QWidget * parent) : QWidget(parent)
 
     streamFrame      = new VideoWG(videoFrame);
 
+    lastReceived = lastDisplayed = 0;
+
+    worker = new StreamWorker();
+    worker->moveToThread(&workerThread);
+    connect(&workerThread, SIGNAL(finished()), worker, SLOT(deleteLater()));
+    connect(worker, SIGNAL(frameReady(QImage,QImage)), this, SLOT(showFrame(QImage,QImage)));
+    connect(worker, SIGNAL(decodeFailed()), this, SLOT(handleDecodeFailure()));
+    workerThread.start();
+
+    statsTimer.setInterval(1000);
+    connect(&statsTimer, SIGNAL(timeout()), this, SLOT(updateStatistics()));
+
     playPix    = QIcon::fromTheme( "media-playback-start", QIcon(":/icons/breeze/default/media-playback-start.svg"));
     pausePix   = QIcon::fromTheme( "media-playback-pause", QIcon(":/icons/breeze/default/media-playback-pause.svg"));
     capturePix = QIcon::fromTheme( "media-record", QIcon(":/icons/breeze/default/media-record.svg"));
+    recordPix  = QIcon::fromTheme( "media-record", QIcon(":/icons/breeze/default/media-record.svg"));
+    stopPix    = QIcon::fromTheme( "media-playback-stop", QIcon(":/icons/breeze/default/media-playback-stop.svg"));
 
     foreach (const QByteArray &format, QImageWriter::supportedImageFormats())
     imgFormatCombo->addItem(QString(format));
 
     playB->setIcon(pausePix);
     captureB->setIcon(capturePix);
+    recordB->setIcon(recordPix);
 
     connect(playB, SIGNAL(clicked()), this, SLOT(playPressed()));
     connect(captureB, SIGNAL(clicked()), this, SLOT(captureImage()));
+    connect(recordB, SIGNAL(clicked()), this, SLOT(toggleRecording()));
 }
 
 StreamWG::~StreamWG()
 {
+   worker->stopRecording();
+   workerThread.quit();
+   workerThread.wait();
+
    delete streamFrame;
 }
 
 void StreamWG::closeEvent ( QCloseEvent * e )
 {
     processStream = false;
+    statsTimer.stop();
+    if (worker->isRecording())
+        toggleRecording();
+    worker->clear();
     emit hidden();
     e->accept();
 }
@@ -85,11 +111,17 @@ void StreamWG::enableStream(bool enable)
     if (enable)
     {
         processStream = true;
+        statsElapsed.start();
+        statsTimer.start();
         show();
     }
     else
     {
         processStream = false;
+        statsTimer.stop();
+        if (worker->isRecording())
+            toggleRecording();
+        worker->clear();
         playB->setIcon(pausePix);
         hide();
     }
@@ -102,16 +134,16 @@ void StreamWG::setSize(int wd, int ht)
     streamWidth  = wd;
     streamHeight = ht;
 
-    streamFrame->totalBaseCount = wd * ht;
-
-    resize(wd + layout()->margin() * 2 , ht + playB->height() + layout()->margin() * 4 + layout()->spacing());
+    resize(wd + layout()->margin() * 2 , ht + playB->height() + statusLabel->height() + layout()->margin() * 4 + layout()->spacing() * 2);
     streamFrame->resize(wd, ht);
 }
 
 void StreamWG::resizeEvent(QResizeEvent *ev)
 {
-    streamFrame->resize(ev->size().width() - layout()->margin() * 2, ev->size().height() - playB->height() - layout()->margin() * 4 - layout()->spacing());
+    streamFrame->resize(ev->size().width() - layout()->margin() * 2, ev->size().height() - playB->height() - statusLabel->height() - layout()->margin() * 4 - layout()->spacing() * 2);
 
+    // Let the worker scale frames so painting is a plain copy
+    worker->setTargetSize(streamFrame->size());
 }
 
 void StreamWG::playPressed()
@@ -132,15 +164,87 @@ void StreamWG::playPressed()
 
 void StreamWG::newFrame(IBLOB *bp)
 {
-    bool rc = streamFrame->newFrame(bp);
+    int w = *((int *) bp->aux0);
+    int h = *((int *) bp->aux1);
 
-    if (rc && streamWidth == -1)
+    worker->submit(bp, w, h);
+}
+
+void StreamWG::showFrame(const QImage &display, const QImage &native)
+{
+    // Stream was paused or closed while the frame was being decoded
+    if (processStream == false)
+        return;
+
+    streamFrame->newFrame(display, native);
+
+    if (streamWidth == -1)
         setSize(streamFrame->imageWidth(), streamFrame->imageHeight());
-    else if (rc == false)
+}
+
+void StreamWG::handleDecodeFailure()
+{
+    if (processStream == false)
+        return;
+
+    close();
+    KMessageBox::error(0, i18n("Unable to load video stream."));
+}
+
+void StreamWG::updateStatistics()
+{
+    StreamWorker::Statistics stats = worker->statistics();
+
+    double elapsed = statsElapsed.restart() / 1000.0;
+    if (elapsed <= 0)
+        return;
+
+    double receivedFPS  = (stats.received - lastReceived) / elapsed;
+    double displayedFPS = (stats.displayed - lastDisplayed) / elapsed;
+
+    lastReceived  = stats.received;
+    lastDisplayed = stats.displayed;
+
+    QString status = i18n("%1 fps (%2 displayed), %3 dropped", QString::number(receivedFPS, 'f', 1), QString::number(displayedFPS, 'f', 1),
+                          stats.dropped);
+
+    if (worker->isRecording())
+        status += i18n(", %1 recorded", stats.recorded);
+    if (stats.recordDropped > 0)
+        status += i18n(", %1 not recorded", stats.recordDropped);
+
+    statusLabel->setText(status);
+}
+
+void StreamWG::toggleRecording()
+{
+    if (worker->isRecording())
     {
-        close();
-        KMessageBox::error(0, i18n("Unable to load video stream."));
+        QString filename = worker->recordingFileName();
+        worker->stopRecording();
+        recordB->setIcon(recordPix);
+        recordB->setToolTip(i18n("Record Video"));
+        KStars::Instance()->statusBar()->showMessage(i18n("Video saved to %1", filename));
+        return;
     }
+
+    QUrl currentDir = QUrl::fromLocalFile(Options::fitsDir());
+    QString filename = QFileDialog::getSaveFileName(KStars::Instance(), i18n("Record Video"), currentDir.toLocalFile(), i18n("SER Video (*.ser)"));
+
+    if (filename.isEmpty())
+        return;
+
+    if (filename.endsWith(".ser", Qt::CaseInsensitive) == false)
+        filename += ".ser";
+
+    if (worker->startRecording(filename, windowTitle()) == false)
+    {
+        KMessageBox::sorry(0, i18n("Unable to create video file %1", filename));
+        return;
+    }
+
+    recordB->setIcon(stopPix);
+    recordB->setToolTip(i18n("Stop Recording"));
 }
 
 void StreamWG::captureImage()
@@ -159,7 +263,7 @@ void StreamWG::captureImage()
 
     if ( currentFileURL.isValid() )
     {
-        streamFrame->kPix.save(currentFileURL.toLocalFile(), fmt.toLatin1());
+        streamFrame->nativeImage.save(currentFileURL.toLocalFile(), fmt.toLatin1());
     }
     else
     {
@@ -173,72 +277,44 @@ void StreamWG::captureImage()
 VideoWG::VideoWG(QWidget * parent) : QFrame(parent)
 {
     setAttribute(Qt::WA_OpaquePaintEvent);
-    streamImage    = new QImage();
-    //grayTable=new QRgb[256];
-    grayTable.resize(256);
-    for (int i=0;i<256;i++)
-        grayTable[i]=qRgb(i,i,i);
 }
 
 VideoWG::~VideoWG()
 {
-    delete (streamImage);
-    //delete [] (grayTable);
 }
 
-bool VideoWG::newFrame(IBLOB *bp)
+void VideoWG::newFrame(const QImage &display, const QImage &native)
 {
-    QString format(bp->format);
-
-    format.remove(".");
-    format.remove("stream_");
-    bool rc = false;
-
-    int w = *((int *) bp->aux0);
-    int h = *((int *) bp->aux1);
+    displayImage = display;
+    nativeImage  = native;
 
-    if (QImageReader::supportedImageFormats().contains(format.toLatin1()))
-           rc = streamImage->loadFromData(static_cast<uchar *>(bp->blob), bp->size);
-    else if (bp->size > totalBaseCount)
-    {
-        delete(streamImage);
-        streamImage = new QImage(static_cast<uchar *>(bp->blob), w, h, QImage::Format_RGB32);
-        rc = !streamImage->isNull();
-    }
-    else
-    {
-        delete(streamImage);
-        streamImage = new QImage(static_cast<uchar *>(bp->blob), w, h, QImage::Format_Indexed8);
-        streamImage->setColorTable(grayTable);
-        rc = !streamImage->isNull();
-    }
-
-    if (rc)
-        update();
-
-    return rc;
+    update();
 }
 
 void VideoWG::paintEvent(QPaintEvent * /*ev*/)
 {
-    if (streamImage && !streamImage->isNull())
-    {
-        kPix = QPixmap::fromImage(streamImage->scaled(width(), height()));
+    if (displayImage.isNull())
+        return;
 
-        QPainter p(this);
-        p.drawPixmap(0, 0, kPix);
-        p.end();
-    }
+    QPainter p(this);
+
+    // Frame was scaled by the worker already unless the widget was just resized
+    if (displayImage.size() == size())
+        p.drawImage(0, 0, displayImage);
+    else
+        p.drawImage(rect(), displayImage);
+
+    p.end();
 }
 
 int VideoWG::imageWidth()
 {
-    return streamImage->width();
+    return nativeImage.width();
 }
 
 int VideoWG::imageHeight()
 {
-    return streamImage->height();
+    return nativeImage.height();
 }
 
 
@@ -19,6 +19,9 @@
 #include <QCloseEvent>
 #include <QVector>
 #include <QColor>
+#include <QThread>
+#include <QTimer>
+#include <QElapsedTimer>
 
 #include <QIcon>
 
@@ -29,6 +32,7 @@
 class QImage;
 class VideoWG;
 class QVBoxLayout;
+class StreamWorker;
 
 class StreamWG : public QWidget, public Ui::streamForm
 {
@@ -44,6 +48,7 @@ public:
     void setSize(int wd, int ht);
     void enableStream(bool enable);
     bool isStreamEnabled() { return processStream; }
+    /* Queue the frame for decoding on the stream worker thread. Returns immediately. */
     void newFrame(IBLOB *bp);
     int getWidth() { return streamWidth; }
     int getHeight() { return streamHeight; }
@@ -54,7 +59,16 @@ private:
     int     streamWidth, streamHeight;
     VideoWG	*streamFrame;
     bool	colorFrame;
-    QIcon   playPix, pausePix, capturePix;
+    QIcon   playPix, pausePix, capturePix, recordPix, stopPix;
+
+    // Decoding and recording happen on the worker thread
+    StreamWorker *worker;
+    QThread  workerThread;
+
+    // Frame rate and drop statistics
+    QTimer   statsTimer;
+    QElapsedTimer statsElapsed;
+    quint64  lastReceived, lastDisplayed;
 
 protected:
     void closeEvent ( QCloseEvent * e );
@@ -64,6 +78,12 @@ protected:
 public slots:
     void playPressed();
     void captureImage();
+    void toggleRecording();
+
+private slots:
+    void showFrame(const QImage &display, const QImage &native);
+    void handleDecodeFailure();
+    void updateStatistics();
 
 signals:
     void hidden();
@@ -81,15 +101,14 @@ public:
 
     friend class StreamWG;
 
-   bool newFrame(IBLOB *bp);
+   /* Display a decoded frame. display is already scaled to the widget size, native is kept for saving. */
+   void newFrame(const QImage &display, const QImage &native);
    int imageWidth();
    int imageHeight();
 
 private:
-    int		totalBaseCount;
-    QVector<QRgb>     grayTable;
-    QImage		*streamImage;
-    QPixmap		 kPix;
+    QImage		displayImage;
+    QImage		nativeImage;
 
 protected:
     void paintEvent(QPaintEvent *ev);
@@ -0,0 +1,315 @@
+/*  Stream Worker
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#include "streamworker.h"
+
+#include <QImageReader>
+#include <QMutexLocker>
+#include <QPainter>
+#include <QDebug>
+
+#include <cstring>
+
+// Maximum number of frames waiting to be written while recording. When not recording only the newest frame is kept.
+#define MAX_RECORD_QUEUE    64
+// Number of image buffers in rotation. The GUI holds on to one while the worker fills the next.
+#define IMAGE_BUFFERS       3
+
+StreamWorker::StreamWorker(QObject *parent) : QObject(parent)
+{
+    grayTable.resize(256);
+    for (int i=0;i<256;i++)
+        grayTable[i]=qRgb(i,i,i);
+
+    nativeBuffers.resize(IMAGE_BUFFERS);
+    displayBuffers.resize(IMAGE_BUFFERS);
+
+    memset(&stats, 0, sizeof(stats));
+}
+
+StreamWorker::~StreamWorker()
+{
+    stopRecording();
+}
+
+void StreamWorker::submit(IBLOB *bp, int width, int height)
+{
+    Frame frame;
+    // The BLOB buffer is reused by the INDI client once we return, so take a deep copy
+    frame.data   = QByteArray(static_cast<const char *>(bp->blob), bp->size);
+    frame.format = QByteArray(bp->format).replace(".", "").replace("stream_", "");
+    frame.width  = width;
+    frame.height = height;
+
+    quint64 dropped=0, recordDropped=0;
+
+    {
+        QMutexLocker locker(&queueMutex);
+
+        if (recording.load())
+        {
+            while (queue.count() >= MAX_RECORD_QUEUE)
+            {
+                queue.dequeue();
+                recordDropped++;
+            }
+        }
+        else
+        {
+            // Anything still waiting is stale now
+            dropped = queue.count();
+            queue.clear();
+        }
+
+        queue.enqueue(frame);
+    }
+
+    {
+        QMutexLocker locker(&statsMutex);
+        stats.received++;
+        stats.dropped += dropped;
+        stats.recordDropped += recordDropped;
+    }
+
+    if (processPending.testAndSetOrdered(0, 1))
+        QMetaObject::invokeMethod(this, "processQueue", Qt::QueuedConnection);
+}
+
+void StreamWorker::setTargetSize(const QSize &size)
+{
+    QMutexLocker locker(&targetMutex);
+    targetSize = size;
+}
+
+bool StreamWorker::startRecording(const QString &filename, const QString &instrument)
+{
+    QMutexLocker locker(&recorderMutex);
+
+    if (recorder.open(filename, instrument) == false)
+        return false;
+
+    recording.store(1);
+
+    return true;
+}
+
+void StreamWorker::stopRecording()
+{
+    recording.store(0);
+
+    QMutexLocker locker(&recorderMutex);
+    recorder.close();
+}
+
+QString StreamWorker::recordingFileName()
+{
+    QMutexLocker locker(&recorderMutex);
+    return recorder.fileName();
+}
+
+StreamWorker::Statistics StreamWorker::statistics()
+{
+    QMutexLocker locker(&statsMutex);
+    return stats;
+}
+
+void StreamWorker::clear()
+{
+    QMutexLocker locker(&queueMutex);
+    queue.clear();
+}
+
+void StreamWorker::processQueue()
+{
+    // Frames submitted from now on schedule another run
+    processPending.store(0);
+
+    QList<Frame> frames;
+
+    {
+        QMutexLocker locker(&queueMutex);
+        while (queue.isEmpty() == false)
+            frames.append(queue.dequeue());
+    }
+
+    if (frames.isEmpty())
+        return;
+
+    // Every frame is recorded...
+    if (recording.load())
+    {
+        foreach(const Frame &oneFrame, frames)
+            record(oneFrame);
+    }
+
+    // ...but only the newest one is displayed
+    {
+        QMutexLocker locker(&statsMutex);
+        stats.dropped += frames.count() - 1;
+    }
+
+    if (decode(frames.last()))
+    {
+        QMutexLocker locker(&statsMutex);
+        stats.displayed++;
+    }
+    else
+        emit decodeFailed();
+}
+
+void StreamWorker::record(const Frame &frame)
+{
+    QMutexLocker locker(&recorderMutex);
+
+    if (recorder.isOpen() == false)
+        return;
+
+    const uint8_t *buffer = reinterpret_cast<const uint8_t *>(frame.data.constData());
+    int pixels = frame.width * frame.height;
+    bool rc = false;
+
+    if (QImageReader::supportedImageFormats().contains(frame.format))
+    {
+        // Compressed streams have to be decoded to be stored in SER
+        QImage image;
+        if (image.loadFromData(frame.data, frame.format.constData()))
+        {
+            image = image.convertToFormat(QImage::Format_RGB888);
+            QByteArray packed(image.width() * image.height() * 3, 0);
+            for (int i=0; i < image.height(); i++)
+                memcpy(packed.data() + i * image.width() * 3, image.constScanLine(i), image.width() * 3);
+
+            rc = recorder.writeFrame(reinterpret_cast<const uint8_t *>(packed.constData()), image.width(), image.height(), SERRecorder::SER_RGB);
+        }
+    }
+    else if (frame.data.size() >= pixels * 4)
+    {
+        // 32 bit RGB is stored as B, G, R, X in memory. Strip the padding byte.
+        QByteArray packed(pixels * 3, 0);
+        uint8_t *out = reinterpret_cast<uint8_t *>(packed.data());
+        for (int i=0; i < pixels; i++)
+        {
+            out[i*3]   = buffer[i*4];
+            out[i*3+1] = buffer[i*4+1];
+            out[i*3+2] = buffer[i*4+2];
+        }
+
+        rc = recorder.writeFrame(out, frame.width, frame.height, SERRecorder::SER_BGR);
+    }
+    else if (frame.data.size() >= pixels * 3)
+        rc = recorder.writeFrame(buffer, frame.width, frame.height, SERRecorder::SER_RGB);
+    else if (frame.data.size() >= pixels)
+        rc = recorder.writeFrame(buffer, frame.width, frame.height, SERRecorder::SER_MONO);
+
+    QMutexLocker statsLocker(&statsMutex);
+    if (rc)
+        stats.recorded++;
+    else
+        stats.recordDropped++;
+}
+
+bool StreamWorker::decode(const Frame &frame)
+{
+    QImage *nativeImage = NULL;
+
+    if (QImageReader::supportedImageFormats().contains(frame.format))
+    {
+        nativeImage = &nextBuffer(nativeBuffers, QSize(), QImage::Format_Invalid);
+        if (nativeImage->loadFromData(frame.data, frame.format.constData()) == false)
+            return false;
+    }
+    else
+    {
+        if (frame.width <= 0 || frame.height <= 0)
+            return false;
+
+        int pixels = frame.width * frame.height;
+        int bytesPerPixel = 0;
+        QImage::Format format;
+
+        if (frame.data.size() >= pixels * 4)
+        {
+            format = QImage::Format_RGB32;
+            bytesPerPixel = 4;
+        }
+        else if (frame.data.size() >= pixels * 3)
+        {
+            format = QImage::Format_RGB888;
+            bytesPerPixel = 3;
+        }
+        else if (frame.data.size() >= pixels)
+        {
+            format = QImage::Format_Indexed8;
+            bytesPerPixel = 1;
+        }
+        else
+            return false;
+
+        nativeImage = &nextBuffer(nativeBuffers, QSize(frame.width, frame.height), format);
+        if (nativeImage->isNull())
+            return false;
+
+        if (format == QImage::Format_Indexed8)
+            nativeImage->setColorTable(grayTable);
+
+        // Scan lines may be padded, copy line by line
+        int lineSize = frame.width * bytesPerPixel;
+        for (int i=0; i < frame.height; i++)
+            memcpy(nativeImage->scanLine(i), frame.data.constData() + i * lineSize, lineSize);
+    }
+
+    QSize displaySize;
+    {
+        QMutexLocker locker(&targetMutex);
+        displaySize = targetSize;
+    }
+
+    if (displaySize.isEmpty())
+        displaySize = nativeImage->size();
+
+    QImage &displayImage = nextBuffer(displayBuffers, displaySize, QImage::Format_RGB32);
+    if (displayImage.isNull())
+        return false;
+
+    QPainter p(&displayImage);
+    p.drawImage(QRect(QPoint(0,0), displaySize), *nativeImage);
+    p.end();
+
+    emit frameReady(displayImage, *nativeImage);
+
+    return true;
+}
+
+QImage & StreamWorker::nextBuffer(QVector<QImage> &buffers, const QSize &size, QImage::Format format)
+{
+    // Pick a buffer of matching geometry that nobody else holds a reference to
+    for (int i=0; i < buffers.count(); i++)
+    {
+        if (buffers[i].isDetached() && (format == QImage::Format_Invalid || (buffers[i].size() == size && buffers[i].format() == format)))
+            return buffers[i];
+    }
+
+    // Otherwise replace the first buffer not in use by the GUI
+    int index = 0;
+    for (int i=0; i < buffers.count(); i++)
+    {
+        if (buffers[i].isNull() || buffers[i].isDetached())
+        {
+            index = i;
+            break;
+        }
+    }
+
+    if (format == QImage::Format_Invalid)
+        buffers[index] = QImage();
+    else
+        buffers[index] = QImage(size, format);
+
+    return buffers[index];
+}
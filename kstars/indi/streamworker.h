@@ -0,0 +1,117 @@
+/*  Stream Worker
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef STREAMWORKER_H
+#define STREAMWORKER_H
+
+#include <QObject>
+#include <QImage>
+#include <QQueue>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QSize>
+#include <QVector>
+
+#include <indidevapi.h>
+
+#include "serrecorder.h"
+
+/**
+ *@class StreamWorker
+ *@short Decodes and records video stream frames away from the GUI thread.
+ *
+ * submit() copies the incoming stream BLOB into a bounded queue and returns immediately. The worker, which lives in its own
+ * thread, writes every queued frame to the SER file if recording is active, but only decodes the newest one for display: older
+ * frames are stale by the time they would be painted, so they are dropped and counted. The decoded frame is scaled to the
+ * display size and converted to a paintable format on the worker as well, reusing a small ring of QImage buffers, so the GUI
+ * thread only needs to draw the finished image.
+ *@version 1.0
+ */
+class StreamWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    typedef struct
+    {
+        quint64 received;       // Frames submitted
+        quint64 displayed;      // Frames decoded and handed to the display
+        quint64 dropped;        // Frames skipped because a newer one was already waiting
+        quint64 recorded;       // Frames written to the SER file
+        quint64 recordDropped;  // Frames lost because the recording could not keep up
+    } Statistics;
+
+    explicit StreamWorker(QObject *parent=0);
+    ~StreamWorker();
+
+    /** Queue a stream frame. May be called from any thread. The BLOB data is copied. */
+    void submit(IBLOB *bp, int width, int height);
+
+    /** Size to scale decoded frames to. */
+    void setTargetSize(const QSize &size);
+
+    /**
+     * @brief startRecording Record all subsequent raw frames to a SER file.
+     * @return true if the file could be created.
+     */
+    bool startRecording(const QString &filename, const QString &instrument);
+    void stopRecording();
+    bool isRecording() const { return recording.load() != 0; }
+    QString recordingFileName();
+
+    Statistics statistics();
+
+    /** Drop all queued frames. */
+    void clear();
+
+signals:
+    /** Emitted for every decoded frame. native is the decoded frame at full resolution, display is scaled for painting. */
+    void frameReady(const QImage &display, const QImage &native);
+    void decodeFailed();
+
+private slots:
+    void processQueue();
+
+private:
+
+    typedef struct
+    {
+        QByteArray data;
+        QByteArray format;
+        int width;
+        int height;
+    } Frame;
+
+    void record(const Frame &frame);
+    bool decode(const Frame &frame);
+    static QImage & nextBuffer(QVector<QImage> &buffers, const QSize &size, QImage::Format format);
+
+    QMutex queueMutex;
+    QQueue<Frame> queue;
+    QAtomicInt processPending;
+    QAtomicInt recording;
+
+    QMutex recorderMutex;
+    SERRecorder recorder;
+
+    QMutex statsMutex;
+    Statistics stats;
+
+    QSize targetSize;
+    QMutex targetMutex;
+
+    // Reused image buffers
+    QVector<QImage> nativeBuffers;
+    QVector<QImage> displayBuffers;
+    QVector<QRgb> grayTable;
+};
+
+#endif // STREAMWORKER_H
@@ -45,6 +45,7 @@ class WIEquipSettings;
 class ObsConditions;
 class AstroCalc;
 class SkyCalendar;
+class SatellitePassesDialog;
 class ScriptBuilder;
 class PlanetViewer;
 class JMoonTool;
@@ -380,6 +381,14 @@ public Q_SLOTS:
      */
     Q_SCRIPTABLE QString getObjectPositionInfo( const QString &objectName );
 
+    /** DBUS interface function.  Return XML listing the satellite passes above the current location
+     * @param start beginning of the time window in UT, as a date and time string. If empty, the current simulation time is used.
+     * @param hours duration of the time window in hours
+     * @param selectedOnly if true, only the satellites selected for display are considered
+     * @note Passes are sorted by rise time. Asking again for the same window and location is fast.
+     */
+    Q_SCRIPTABLE QString getSatellitePasses( const QString &start, double hours, bool selectedOnly = true );
+
     /** DBUS interface function. Render eyepiece view and save it in the file(s) specified
      * @note See EyepieceField::renderEyepieceView() for more info. This is a DBus proxy that calls that method, and then writes the resulting image(s) to file(s).
      * @note Important: If imagePath is empty, but overlay is true, or destPathImage is supplied, this method will make a blocking DSS download.
@@ -517,6 +526,9 @@ private slots:
     /** action slot: open Sky Calendar tool */
     void slotCalendar();
 
+    /** action slot: open Satellite Passes tool */
+    void slotSatellitePasses();
+
     /** action slot: open the glossary */
     void slotGlossary();
 
@@ -671,6 +683,7 @@ private:
     AstroCalc *m_AstroCalc;
     AltVsTime *m_AltVsTime;
     SkyCalendar *m_SkyCalendar;
+    SatellitePassesDialog *m_SatellitePasses;
     ScriptBuilder *m_ScriptBuilder;
     PlanetViewer *m_PlanetViewer;
     WUTDialog *m_WUTDialog;
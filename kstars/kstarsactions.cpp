@@ -89,6 +89,7 @@
 #endif
 
 #include "tools/skycalendar.h"
+#include "tools/satellitepassesdialog.h"
 #include "tools/scriptbuilder.h"
 #include "tools/planetviewer.h"
 #include "tools/jmoontool.h"
@@ -489,6 +490,11 @@ void KStars::slotCalendar() {
     m_SkyCalendar->show();
 }
 
+void KStars::slotSatellitePasses() {
+    if ( ! m_SatellitePasses ) m_SatellitePasses = new SatellitePassesDialog(this);
+    m_SatellitePasses->show();
+}
+
 void KStars::slotGlossary(){
     // 	GlossaryDialog *dlg = new GlossaryDialog( this, true );
     // 	QString glossaryfile =data()->stdDirs->findResource( "data", "kstars/glossary.xml" );
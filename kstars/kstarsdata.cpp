@@ -36,6 +36,7 @@
 #include "ksfilereader.h"
 #include "ksnumbers.h"
 #include "auxiliary/kspaths.h"
+#include "auxiliary/startuploader.h"
 #include "skyobjects/skyobject.h"
 #include "skycomponents/supernovaecomponent.h"
 #include "skycomponents/skymapcomposite.h"
@@ -124,6 +125,7 @@ KStarsData::KStarsData() :
     #endif
     temporaryTrail( false ),
     //locale( new KLocale( "kstars" ) ),
+    m_CityDB( &Rulebook ),
     m_preUpdateID(0),        m_updateID(0),
     m_preUpdateNumID(0),     m_updateNumID(0),
     m_preUpdateNum( J2000 ), m_updateNum( J2000 )
@@ -146,7 +148,6 @@ KStarsData::~KStarsData() {
     delete m_ObservingList;
     delete m_ImageExporter;
 #endif
-    qDeleteAll( geoList );
     qDeleteAll( ADVtreeList );
 
     pinstance = 0;
@@ -156,27 +157,44 @@ bool KStarsData::initialize() {
     //Initialize CatalogDB//
     catalogdb()->Initialize();
 
+    // Location data and sky components are independent. Load them concurrently and report which one failed.
+    StartupLoader loader;
+    connect( &loader, SIGNAL( progressText( const QString & ) ), this, SIGNAL( progressText( const QString & ) ) );
+
+    bool tzRulesLoaded = false, citiesLoaded = false;
+
     //Load Time Zone Rules//
-    emit progressText( i18n("Reading time zone rules") );
-    if( !readTimeZoneRulebook( ) ) {
+    loader.addTask( "TimeZoneRules", i18n("Reading time zone rules"),
+                    [this, &tzRulesLoaded]() { tzRulesLoaded = readTimeZoneRulebook(); },
+                    QStringList(), StartupLoader::MainThread );
+
+    //Load Cities//
+    // Cities refer to time zone rules. The database connections belong to the main thread.
+    loader.addTask( "Cities", i18n("Loading city data"),
+                    [this, &tzRulesLoaded, &citiesLoaded]() { if ( tzRulesLoaded ) citiesLoaded = readCityData(); },
+                    QStringList() << "TimeZoneRules", StartupLoader::MainThread );
+
+    //Initialize User Database//
+    loader.addTask( "UserDB", i18n("Loading User Information" ),
+                    [this]() { m_ksuserdb.Initialize(); },
+                    QStringList(), StartupLoader::MainThread );
+
+    //Initialize SkyMapComposite//
+    emit progressText(i18n("Loading sky objects" ) );
+    m_SkyComposite = new SkyMapComposite(0, &loader);
+
+    loader.run();
+
+    if( !tzRulesLoaded ) {
         fatalErrorMessage( "TZrules.dat" );
         return false;
     }
 
-    //Load Cities//
-    emit progressText( i18n("Loading city data") );
-    if ( !readCityData( ) ) {
+    if ( !citiesLoaded ) {
         fatalErrorMessage( "citydb.sqlite" );
         return false;
     }
 
-    //Initialize User Database//
-    emit progressText( i18n("Loading User Information" ) );
-    m_ksuserdb.Initialize();
-
-    //Initialize SkyMapComposite//
-    emit progressText(i18n("Loading sky objects" ) );
-    m_SkyComposite = new SkyMapComposite(0);
     //Load Image URLs//
     //#ifndef Q_OS_ANDROID
     //On Android these 2 calls produce segfault. WARNING
@@ -320,14 +338,7 @@ void KStarsData::setTimeDirection( float scale ) {
 }
 
 GeoLocation* KStarsData::locationNamed( const QString &city, const QString &province, const QString &country ) {
-    foreach ( GeoLocation *loc, geoList ) {
-        if ( loc->translatedName() == city &&
-                ( province.isEmpty() || loc->translatedProvince() == province ) &&
-                ( country.isEmpty() || loc->translatedCountry() == country ) ) {
-            return loc;
-        }
-    }
-    return 0;
+    return m_CityDB.locationNamed( city, province, country );
 }
 
 void KStarsData::setLocationFromOptions() {
@@ -366,77 +377,8 @@ SkyObject* KStarsData::objectNamed( const QString &name ) {
 
 bool KStarsData::readCityData()
 {
-    QSqlDatabase citydb = QSqlDatabase::addDatabase("QSQLITE", "citydb");
-    QString dbfile = KSPaths::locate(QStandardPaths::GenericDataLocation, "citydb.sqlite");
-    citydb.setDatabaseName(dbfile);
-    if (citydb.open() == false)
-    {
-        qWarning() << "Unable to open city database file " << dbfile << citydb.lastError().text() << endl;
-        return false;
-    }
-
-     QSqlQuery get_query(citydb);
-
-     //get_query.prepare("SELECT * FROM city");
-     if (!get_query.exec("SELECT * FROM city"))
-     {
-         qDebug() << get_query.lastError();
-         return false;
-     }
-
-     bool citiesFound = false;
-     // get_query.size() always returns -1 so we set citiesFound if at least one city is found
-     while (get_query.next())
-     {
-         citiesFound          = true;
-         QString name         = get_query.value(1).toString();
-         QString province     = get_query.value(2).toString();
-         QString country      = get_query.value(3).toString();
-         dms lat              = dms(get_query.value(4).toString());
-         dms lng              = dms(get_query.value(5).toString());
-         double TZ            = get_query.value(6).toDouble();
-         TimeZoneRule *TZrule = &( Rulebook[ get_query.value(7).toString() ] );
-
-         // appends city names to list
-         geoList.append ( new GeoLocation( lng, lat, name, province, country, TZ, TZrule, true));
-     }
-    citydb.close();
-
-    // Reading local database
-    QSqlDatabase mycitydb = QSqlDatabase::addDatabase("QSQLITE", "mycitydb");
-    dbfile = KSPaths::writableLocation(QStandardPaths::GenericDataLocation) + QDir::separator()  +  "mycitydb.sqlite";
-
-    if (QFile::exists(dbfile))
-    {
-        mycitydb.setDatabaseName(dbfile);
-        if (mycitydb.open())
-        {
-            QSqlQuery get_query(mycitydb);
-
-            if (!get_query.exec("SELECT * FROM city"))
-            {
-                qDebug() << get_query.lastError();
-                return false;
-            }
-            while (get_query.next())
-            {
-                QString name         = get_query.value(1).toString();
-                QString province     = get_query.value(2).toString();
-                QString country      = get_query.value(3).toString();
-                dms lat              = dms(get_query.value(4).toString());
-                dms lng              = dms(get_query.value(5).toString());
-                double TZ            = get_query.value(6).toDouble();
-                TimeZoneRule *TZrule = &( Rulebook[ get_query.value(7).toString() ] );
-
-                // appends city names to list
-                geoList.append ( new GeoLocation( lng, lat, name, province, country, TZ, TZrule, false));
-            }
-           mycitydb.close();
-
-        }
-    }
-
-    return citiesFound;
+    // Only the index is checked here, cities are read when they are looked up
+    return m_CityDB.open();
 }
 
 bool KStarsData::readTimeZoneRulebook() {
@@ -1032,20 +974,12 @@ bool KStarsData::executeScript( const QString &scriptname, SkyMap *map ) {
                     country = fn[3];
                 }
 
-                bool cityFound( false );
-                foreach ( GeoLocation *loc, geoList ) {
-                    if ( loc->translatedName() == city &&
-                            ( province.isEmpty() || loc->translatedProvince() == province ) &&
-                            loc->translatedCountry() == country ) {
-
-                        cityFound = true;
-                        setLocation( *loc );
-                        cmdCount++;
-                        break;
-                    }
+                GeoLocation *loc = locationNamed( city, province, country );
+                if ( loc ) {
+                    setLocation( *loc );
+                    cmdCount++;
                 }
-
-                if ( !cityFound )
+                else
                     qWarning() << i18n( "Could not set location named %1, %2, %3" , city, province, country) ;
             }
         }
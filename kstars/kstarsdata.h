@@ -22,6 +22,7 @@
 
 #include "ksnumbers.h"
 #include "ksuserdb.h"
+#include "citydatabase.h"
 #include "catalogdb.h"
 
 #include <QList>
@@ -90,7 +91,7 @@ public:
     friend class KStars;
     // FIXME: it uses temporary trail and resumeKey
     friend class SkyMap;
-    // FIXME: uses geoList and changes it.
+    // FIXME: uses Rulebook and changes it.
     friend class LocationDialog;
     friend class LocationDialogLite;
 
@@ -173,8 +174,13 @@ public:
     /** @return pointer to the GeoLocation object*/
     GeoLocation *geo() { return &m_Geo; }
 
-    /** @return list of all geographic locations */
-    QList<GeoLocation*> & getGeoList() { return geoList; }
+    /** @return list of all geographic locations
+     * @note all cities are loaded on the first call, prefer querying cityDB()
+     */
+    QList<GeoLocation*> & getGeoList() { return m_CityDB.allCities(); }
+
+    /** @return pointer to the database of geographic locations */
+    CityDatabase *cityDB() { return &m_CityDB; }
 
     GeoLocation *locationNamed( const QString &city, const QString &province=QString(), const QString &country= QString() );
 
@@ -279,12 +285,12 @@ public slots:
     void setTimeDirection( float scale );
 
 private:
-    /**Populate list of geographic locations from "citydb.sqlite" database. Also check for custom
-     * locations file "mycitydb.sqlite" database, but don't require it.  Each line in the file
-     * provides the information required to create one GeoLocation object.
-     * @short Fill list of geographic locations from file(s)
-     * @return true if at least one city read successfully.
-     * @see KStarsData::processCity()
+    /**Open the database of geographic locations from "citydb.sqlite" database. Also check for custom
+     * locations file "mycitydb.sqlite" database, but don't require it.  Cities are only read when
+     * they are queried.
+     * @short Open database of geographic locations
+     * @return true if at least one city is available.
+     * @see CityDatabase
      */
     bool readCityData();
 
@@ -382,8 +388,8 @@ private:
     // FIXME: Used in kstarsdcop.cpp only
     KStarsDateTime StoredDate;
 
-    QList<GeoLocation*> geoList;
     QMap<QString, TimeZoneRule> Rulebook;
+    CityDatabase m_CityDB;
 
     quint32   m_preUpdateID,    m_updateID;
     quint32   m_preUpdateNumID, m_updateNumID;
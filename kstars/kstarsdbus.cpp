@@ -46,6 +46,7 @@
 #include "Options.h"
 #include "imageexporter.h"
 #include "skycomponents/constellationboundarylines.h"
+#include "skycomponents/satellitescomponent.h"
 #include "observinglist.h"
 #include "eyepiecefield.h"
 
@@ -193,39 +194,33 @@ bool KStars::setGeoLocation( const QString &city, const QString &province, const
     //Set the geographic location
     bool cityFound( false );
 
-    foreach ( GeoLocation *loc, data()->geoList ) {
-        if ( loc->translatedName() == city &&
-                ( province.isEmpty() || loc->translatedProvince() == province ) &&
-                loc->translatedCountry() == country ) {
+    // The country must be given, the province is optional
+    GeoLocation *loc = country.isEmpty() ? 0 : data()->locationNamed( city, province, country );
+    if ( loc ) {
+        cityFound = true;
 
-            cityFound = true;
+        data()->setLocation( *loc );
 
-            data()->setLocation( *loc );
+        //configure time zone rule
+        KStarsDateTime ltime = loc->UTtoLT( data()->ut() );
+        loc->tzrule()->reset_with_ltime( ltime, loc->TZ0(), data()->isTimeRunningForward() );
+        data()->setNextDSTChange( loc->tzrule()->nextDSTChange() );
 
-            //configure time zone rule
-            KStarsDateTime ltime = loc->UTtoLT( data()->ut() );
-            loc->tzrule()->reset_with_ltime( ltime, loc->TZ0(), data()->isTimeRunningForward() );
-            data()->setNextDSTChange( loc->tzrule()->nextDSTChange() );
+        //reset LST
+        data()->syncLST();
 
-            //reset LST
-            data()->syncLST();
+        //make sure planets, etc. are updated immediately
+        data()->setFullTimeUpdate();
 
-            //make sure planets, etc. are updated immediately
-            data()->setFullTimeUpdate();
-
-            // If the sky is in Horizontal mode and not tracking, reset focus such that
-            // Alt/Az remain constant.
-            if ( ! Options::isTracking() && Options::useAltAz() ) {
-                map()->focus()->HorizontalToEquatorial( data()->lst(), data()->geo()->lat() );
-            }
-
-            // recalculate new times and objects
-            data()->setSnapNextFocus();
-            updateTime();
-
-            //no need to keep looking, we're done.
-            break;
+        // If the sky is in Horizontal mode and not tracking, reset focus such that
+        // Alt/Az remain constant.
+        if ( ! Options::isTracking() && Options::useAltAz() ) {
+            map()->focus()->HorizontalToEquatorial( data()->lst(), data()->geo()->lat() );
         }
+
+        // recalculate new times and objects
+        data()->setSnapNextFocus();
+        updateTime();
     }
 
     if ( !cityFound ) {
@@ -618,6 +613,39 @@ QString KStars::getObjectPositionInfo( const QString &objectName ) {
     return output;
 }
 
+QString KStars::getSatellitePasses( const QString &start, double hours, bool selectedOnly ) {
+    KStarsDateTime startUT = start.isEmpty() ? data()->ut() : KStarsDateTime::fromString( start );
+    if ( ! startUT.isValid() || hours <= 0 ) {
+        return QString( "<xml></xml>" );
+    }
+    KStarsDateTime endUT = startUT.addSecs( hours * 3600.0 );
+
+    QList<SatellitePass> passes = data()->skyComposite()->satellites()->passes( startUT, endUT, data()->geo(), selectedOnly );
+
+    QString output;
+    QXmlStreamWriter stream( &output );
+    stream.setAutoFormatting( true );
+    stream.writeStartDocument();
+    stream.writeStartElement( "passes" );
+    foreach ( const SatellitePass &pass, passes ) {
+        stream.writeStartElement( "pass" );
+        stream.writeTextElement( "Name", pass.satellite );
+        stream.writeTextElement( "Rise_UT", pass.rise.toString( Qt::ISODate ) );
+        stream.writeTextElement( "Rise_Azimuth", QString::number( pass.riseAzimuth, 'f', 1 ) );
+        stream.writeTextElement( "Culmination_UT", pass.culmination.toString( Qt::ISODate ) );
+        stream.writeTextElement( "Culmination_Azimuth", QString::number( pass.culminationAzimuth, 'f', 1 ) );
+        stream.writeTextElement( "Max_Altitude", QString::number( pass.maxAltitude, 'f', 1 ) );
+        stream.writeTextElement( "Set_UT", pass.set.toString( Qt::ISODate ) );
+        stream.writeTextElement( "Set_Azimuth", QString::number( pass.setAzimuth, 'f', 1 ) );
+        stream.writeTextElement( "Sunlit", pass.sunlit ? "true" : "false" );
+        stream.writeTextElement( "Visible", pass.visible ? "true" : "false" );
+        stream.writeEndElement(); // pass
+    }
+    stream.writeEndElement(); // passes
+    stream.writeEndDocument();
+    return output;
+}
+
 void KStars::renderEyepieceView( const QString &objectName, const QString &destPathChart, const double fovWidth, const double fovHeight, const double rotation, const double scale,
                                 const bool flip, const bool invert, QString imagePath, const QString &destPathImage, const bool overlay, const bool invertColors ) {
     const SkyObject *obj = data()->objectNamed( objectName );
@@ -425,6 +425,9 @@ void KStars::initActions() {
     actionCollection()->addAction("skycalendar", this, SLOT( slotCalendar() ) )
         << i18n("Sky Calendar");
 
+    actionCollection()->addAction("satellite_passes", this, SLOT( slotSatellitePasses() ) )
+        << i18n("Satellite Passes...");
+
 #ifdef HAVE_INDI
         actionCollection()->addAction("ekos", this, SLOT( slotEkos() ) )
             << i18n("Ekos")
@@ -195,9 +195,8 @@ bool LocationDialogLite::addCity(QString city, QString province, QString country
             return false;
         }
 
-        //Add city to geoList
-        g = new GeoLocation( lng, lat, city, province, country, TZ, & KStarsData::Instance()->Rulebook[ TZRule ] );
-        KStarsData::Instance()->getGeoList().append(g);
+        //Add city to the city database
+        g = KStarsData::Instance()->cityDB()->addCity( GeoLocation( lng, lat, city, province, country, TZ, & KStarsData::Instance()->Rulebook[ TZRule ] ), TZRule );
 
         mycitydb.commit();
         mycitydb.close();
@@ -224,8 +223,7 @@ bool LocationDialogLite::deleteCity(QString fullName) {
         }
 
         filteredCityList.remove(geo->fullName());
-        KStarsData::Instance()->getGeoList().removeOne(geo);
-        delete(geo);
+        KStarsData::Instance()->cityDB()->removeCity(geo);
         mycitydb.commit();
         mycitydb.close();
         return true;
@@ -269,6 +267,7 @@ bool LocationDialogLite::editCity(QString fullName, QString city, QString provin
         geo->setLong(lng);
         geo->setTZ(TZ);
         geo->setTZRule(& KStarsData::Instance()->Rulebook[ TZRule ]);
+        KStarsData::Instance()->cityDB()->updateCity(geo, TZRule);
 
         //If we are changing current location update it
         if(m_currentLocation == fullName) {
@@ -45,7 +45,7 @@ void SatellitesItem::update() {
     while(n != 0) {
         SatelliteNode *satNode = static_cast<SatelliteNode *>(n);
         Satellite *sat = satNode->sat();
-        if ( sat->selected() ) {
+        if ( sat->selected() && !sat->isOutdated() ) {
             if ( Options::showVisibleSatellites() ) {
                 if ( sat->isVisible() ) {
                     satNode->update();
@@ -46,7 +46,7 @@ SkyPoint Projector::pointAt(double az)
     return p;
 }
 
-Projector::Projector(const ViewParams& p)
+Projector::Projector(const ViewParams& p) : m_revision(0)
 {
     m_data = KStarsData::Instance();
     setViewParams(p);
@@ -61,6 +61,20 @@ Projector::~Projector()
 
 void Projector::setViewParams(const ViewParams& p)
 {
+    // The view is set again for every frame, only count it as a change if the projection differs
+    static quint64 lastRevision = 0;
+    if ( m_revision == 0 || p.width != m_vp.width || p.height != m_vp.height || p.zoomFactor != m_vp.zoomFactor ||
+         p.useRefraction != m_vp.useRefraction || p.useAltAz != m_vp.useAltAz ||
+         p.focus->ra().Degrees() != m_focusRA || p.focus->dec().Degrees() != m_focusDec ||
+         p.focus->alt().Degrees() != m_focusAlt || p.focus->az().Degrees() != m_focusAz )
+    {
+        m_revision = ++lastRevision;
+        m_focusRA  = p.focus->ra().Degrees();
+        m_focusDec = p.focus->dec().Degrees();
+        m_focusAlt = p.focus->alt().Degrees();
+        m_focusAz  = p.focus->az().Degrees();
+    }
+
     m_vp = p;
 
     /** Precompute cached values */
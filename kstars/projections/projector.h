@@ -68,6 +68,10 @@ public:
     /** Update cached values for projector */
     void setViewParams( const ViewParams& p );
 
+    /** @return a number that changes whenever the view changes, so that screen positions can be cached.
+        Two projectors never have the same revision. */
+    quint64 revision() const { return m_revision; }
+
     enum Projection { Lambert,
                       AzimuthalEquidistant,
                       Orthographic,
@@ -271,6 +275,10 @@ private:
     //Used by CheckVisibility
     double m_xrange;
     bool m_isPoleVisible;
+
+    //Used by revision()
+    quint64 m_revision;
+    double m_focusRA, m_focusDec, m_focusAlt, m_focusAz;
 };
 
 #endif // PROJECTOR_H
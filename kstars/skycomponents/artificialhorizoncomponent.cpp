@@ -27,6 +27,11 @@
 
 #include "projections/projector.h"
 
+#include <cmath>
+
+// Azimuth steps of the altitude profile
+#define PROFILE_STEPS   3600
+
 ArtificialHorizonEntity::ArtificialHorizonEntity()
 {
     m_List = NULL;
@@ -83,6 +88,7 @@ ArtificialHorizonComponent::ArtificialHorizonComponent(SkyComposite *parent ) :
         NoPrecessIndex( parent, i18n("Artificial Horizon") )
 {
     livePreview=NULL;
+    m_ProfileValid=false;
     load();
 }
 
@@ -93,6 +99,8 @@ bool ArtificialHorizonComponent::load()
     foreach(ArtificialHorizonEntity *horizon, m_HorizonList)
         appendLine(horizon->list());
 
+    m_ProfileValid = false;
+
     return true;
 }
 
@@ -176,6 +184,8 @@ void ArtificialHorizonComponent::removeRegion(const QString &regionName, bool li
         m_HorizonList.removeOne(regionHorizon);
         delete (regionHorizon);
     }
+
+    m_ProfileValid = false;
 }
 
 void ArtificialHorizonComponent::addRegion(const QString &regionName, bool enabled, LineList *list)
@@ -189,5 +199,86 @@ void ArtificialHorizonComponent::addRegion(const QString &regionName, bool enabl
     m_HorizonList.append(horizon);
 
     appendLine(list);
+
+    m_ProfileValid = false;
+}
+
+void ArtificialHorizonComponent::buildProfile()
+{
+    m_Profile.clear();
+    m_ProfileValid = true;
+
+    foreach(ArtificialHorizonEntity *horizon, m_HorizonList)
+    {
+        if (horizon->enabled() == false || horizon->list() == NULL || horizon->list()->points()->size() < 2)
+            continue;
+
+        if (m_Profile.isEmpty())
+            m_Profile.fill(-90, PROFILE_STEPS);
+
+        const SkyList *points = horizon->list()->points();
+
+        // Regions are closed polygons, sample the altitude of each edge at every azimuth step it spans
+        for (int i=0; i < points->size(); i++)
+        {
+            const SkyPoint *p1 = points->at(i);
+            const SkyPoint *p2 = points->at((i+1) % points->size());
+
+            double az1 = p1->az().Degrees(), alt1 = p1->alt().Degrees();
+            double az2 = p2->az().Degrees(), alt2 = p2->alt().Degrees();
+
+            // Edges crossing north go the short way
+            if (az2 - az1 > 180)
+                az1 += 360;
+            else if (az1 - az2 > 180)
+                az2 += 360;
+
+            double from = qMin(az1, az2), to = qMax(az1, az2);
+            int first = static_cast<int>(floor(from * PROFILE_STEPS / 360.0));
+            int last  = static_cast<int>(ceil(to * PROFILE_STEPS / 360.0));
+
+            for (int step=first; step <= last; step++)
+            {
+                double az = qBound(from, step * 360.0 / PROFILE_STEPS, to);
+                double alt = (az1 == az2) ? qMax(alt1, alt2) : alt1 + (alt2 - alt1) * (az - az1) / (az2 - az1);
+
+                float &top = m_Profile[((step % PROFILE_STEPS) + PROFILE_STEPS) % PROFILE_STEPS];
+                top = qMax(top, static_cast<float>(alt));
+            }
+        }
+    }
+}
+
+double ArtificialHorizonComponent::altitudeConstraint(double azimuth)
+{
+    if (m_ProfileValid == false)
+        buildProfile();
+
+    if (m_Profile.isEmpty())
+        return -90;
+
+    double steps = azimuth * PROFILE_STEPS / 360.0;
+    int step = static_cast<int>(floor(steps)) % PROFILE_STEPS;
+    if (step < 0)
+        step += PROFILE_STEPS;
+
+    // The higher of the two steps around azimuth
+    return qMax(m_Profile[step], m_Profile[(step + 1) % PROFILE_STEPS]);
+}
+
+QVector<bool> ArtificialHorizonComponent::isVisible(const QVector<double> &azimuths, const QVector<double> &altitudes)
+{
+    QVector<bool> visible(azimuths.size(), true);
+
+    if (m_ProfileValid == false)
+        buildProfile();
+
+    if (m_Profile.isEmpty())
+        return visible;
+
+    for (int i=0; i < azimuths.size() && i < altitudes.size(); i++)
+        visible[i] = altitudes[i] > altitudeConstraint(azimuths[i]);
+
+    return visible;
 }
 
@@ -12,6 +12,8 @@
 
 #include "noprecessindex.h"
 
+#include <QVector>
+
 class ArtificialHorizonEntity
 {
 public:
@@ -65,12 +67,45 @@ public:
     bool load();
     void save();
 
+    /**
+     * @brief regionsChanged Rebuild the altitude profile on its next use. Call it after enabling, disabling or editing a region
+     * directly through horizonList().
+     */
+    void regionsChanged() { m_ProfileValid = false; }
+
+    /**
+     * @brief altitudeConstraint Get the altitude of the artificial horizon.
+     * @param azimuth azimuth in degrees
+     * @return highest altitude in degrees covered by an enabled region at this azimuth, or -90 if no region covers it.
+     * @note Everything below the top of a region is considered blocked. The profile has a resolution of 0.1 degree of azimuth
+     * and errs on the blocked side.
+     */
+    double altitudeConstraint(double azimuth);
+
+    /** @return true if a point at azimuth and altitude in degrees is above the artificial horizon */
+    bool isVisible(double azimuth, double altitude) { return altitude > altitudeConstraint(azimuth); }
+
+    /**
+     * @brief isVisible Check many points against the artificial horizon.
+     * @param azimuths azimuths in degrees
+     * @param altitudes altitudes in degrees, in the same order
+     * @return for each point, true if it is above the artificial horizon
+     */
+    QVector<bool> isVisible(const QVector<double> &azimuths, const QVector<double> &altitudes);
+
 protected:
     virtual void preDraw( SkyPainter *skyp );
 
 private:
+    /** Sample the tops of the enabled regions into m_Profile */
+    void buildProfile();
+
     QList<ArtificialHorizonEntity *> m_HorizonList;
     LineList *livePreview;
+
+    // Highest blocked altitude at each azimuth step, empty if no region is enabled
+    QVector<float> m_Profile;
+    bool m_ProfileValid;
 };
 
 #endif
@@ -40,8 +40,128 @@
 #include "skyobjects/ksasteroid.h"
 #include "kstarsdata.h"
 #include "ksfilereader.h"
+#include "ksrowparser.h"
 #include "auxiliary/kspaths.h"
 #include "auxiliary/ksnotification.h"
+#include "auxiliary/snapshotcache.h"
+
+// Bump whenever the layout of AsteroidRecord in the snapshot changes
+#define ASTEROID_SNAPSHOT_VERSION 1
+
+namespace
+{
+// Columns of asteroids.dat used to build the asteroids
+typedef struct
+{
+    qint32 catN;
+    QString name;
+    qint32 mJD;
+    double q, a, e, i, w, N, M, H, G, earth_moid;
+    QString orbit_id, orbit_class, dimensions;
+    float diameter, albedo, rot_period, period;
+    bool neo;
+} AsteroidRecord;
+
+// Columns of asteroids.dat, see AsteroidsComponent::loadData()
+enum AsteroidColumn
+{
+    COL_FULL_NAME, COL_EPOCH_MJD, COL_Q, COL_A, COL_E, COL_I, COL_W, COL_OM, COL_MA, COL_TP_CALC, COL_ORBIT_ID,
+    COL_H, COL_G, COL_NEO, COL_M1, COL_M2, COL_DIAMETER, COL_EXTENT, COL_ALBEDO, COL_ROT_PERIOD, COL_PER_Y,
+    COL_MOID, COL_CLASS, ASTEROID_COLUMNS
+};
+
+const KSRowParser::Column asteroidColumns[ASTEROID_COLUMNS] =
+{
+    { "full name", 0 }, { "epoch_mjd", 0 }, { "q", 0 }, { "a", 0 }, { "e", 0 }, { "i", 0 }, { "w", 0 }, { "om", 0 },
+    { "ma", 0 }, { "tp_calc", 0 }, { "orbit_id", 0 }, { "H", 0 }, { "G", 0 }, { "neo", 0 }, { "M1", 0 }, { "M2", 0 },
+    { "diameter", 0 }, { "extent", 0 }, { "albedo", 0 }, { "rot_period", 0 }, { "per_y", 0 }, { "moid", 0 },
+    { "class", 0 }
+};
+
+void parseFile(const QString &file_name, QVector<AsteroidRecord> &records)
+{
+    KSRowParser asteroid_parser(file_name, '#', asteroidColumns, ASTEROID_COLUMNS, ',');
+
+    while (asteroid_parser.ReadNextRow()){
+        const KSRowParser &row = asteroid_parser;
+
+        AsteroidRecord record;
+        QString full_name = row[COL_FULL_NAME].trimmed().toString();
+        record.catN = full_name.section(' ', 0, 0).toInt();
+        record.name = full_name.section(' ', 1, -1);
+
+        record.mJD  = row[COL_EPOCH_MJD].toInt();
+        record.q    = row[COL_Q].toDouble();
+        record.a    = row[COL_A].toDouble();
+        record.e    = row[COL_E].toDouble();
+        record.i    = row[COL_I].toDouble();
+        record.w    = row[COL_W].toDouble();
+        record.N    = row[COL_OM].toDouble();
+        record.M    = row[COL_MA].toDouble();
+        record.orbit_id = row[COL_ORBIT_ID].toString();
+        record.H    = row[COL_H].toDouble();
+        record.G    = row[COL_G].toDouble();
+        record.neo  = row[COL_NEO] == "Y";
+        record.diameter   = row[COL_DIAMETER].toFloat();
+        record.dimensions = row[COL_EXTENT].toString();
+        record.albedo     = row[COL_ALBEDO].toFloat();
+        record.rot_period = row[COL_ROT_PERIOD].toFloat();
+        record.period     = row[COL_PER_Y].toFloat();
+        record.earth_moid  = row[COL_MOID].toDouble();
+        record.orbit_class = row[COL_CLASS].toString();
+
+        records.append(record);
+    }
+}
+
+bool readSnapshot(SnapshotCache &snapshot, QVector<AsteroidRecord> &records)
+{
+    QDataStream *in = snapshot.open();
+    if (in == NULL)
+        return false;
+
+    quint32 count = 0;
+    *in >> count;
+
+    for (quint32 n = 0; n < count && in->status() == QDataStream::Ok; n++)
+    {
+        AsteroidRecord record;
+        *in >> record.catN >> record.name >> record.mJD >> record.q >> record.a >> record.e >> record.i >> record.w >> record.N
+            >> record.M >> record.H >> record.G >> record.earth_moid >> record.orbit_id >> record.orbit_class >> record.dimensions
+            >> record.diameter >> record.albedo >> record.rot_period >> record.period >> record.neo;
+        records.append(record);
+    }
+
+    if (in->status() != QDataStream::Ok)
+    {
+        qWarning() << "Asteroid snapshot is corrupt, reloading" << snapshot.fileName();
+        snapshot.remove();
+        records.clear();
+        return false;
+    }
+
+    snapshot.close();
+    return true;
+}
+
+void writeSnapshot(SnapshotCache &snapshot, const QVector<AsteroidRecord> &records)
+{
+    QDataStream *out = snapshot.create();
+    if (out == NULL)
+        return;
+
+    *out << static_cast<quint32>(records.count());
+
+    foreach (const AsteroidRecord &record, records)
+    {
+        *out << record.catN << record.name << record.mJD << record.q << record.a << record.e << record.i << record.w << record.N
+             << record.M << record.H << record.G << record.earth_moid << record.orbit_id << record.orbit_class << record.dimensions
+             << record.diameter << record.albedo << record.rot_period << record.period << record.neo;
+    }
+
+    snapshot.commit();
+}
+}
 
 AsteroidsComponent::AsteroidsComponent(SolarSystemComposite *parent) : SolarSystemListComponent(parent)
 {
@@ -86,86 +206,42 @@ bool AsteroidsComponent::selected() {
  */
 void AsteroidsComponent::loadData()
 {
-    QString name, full_name, orbit_id, orbit_class, dimensions;
-    int mJD;
-    double q, a, e, dble_i, dble_w, dble_N, dble_M, H, G, earth_moid;
-    long double JD;
-    float diameter, albedo, rot_period, period;
-    bool neo;    
-
     emitProgressText( i18n("Loading asteroids") );
 
     // Clear lists
+    clearIndex();
     qDeleteAll(m_ObjectList);
     m_ObjectList.clear();
+    m_Elements.clear();
+    m_Index.clear();
 
-    objectLists( SkyObject::ASTEROID ).clear();
-    objectNames( SkyObject::ASTEROID ).clear();
-
-
-    QList< QPair<QString, KSParser::DataTypes> > sequence;
-    sequence.append(qMakePair(QString("full name"), KSParser::D_QSTRING));
-    sequence.append(qMakePair(QString("epoch_mjd"), KSParser::D_INT));
-    sequence.append(qMakePair(QString("q"), KSParser::D_DOUBLE));
-    sequence.append(qMakePair(QString("a"), KSParser::D_DOUBLE));
-    sequence.append(qMakePair(QString("e"), KSParser::D_DOUBLE));
-    sequence.append(qMakePair(QString("i"), KSParser::D_DOUBLE));
-    sequence.append(qMakePair(QString("w"), KSParser::D_DOUBLE));
-    sequence.append(qMakePair(QString("om"), KSParser::D_DOUBLE));
-    sequence.append(qMakePair(QString("ma"), KSParser::D_DOUBLE));
-    sequence.append(qMakePair(QString("tp_calc"), KSParser::D_SKIP));
-    sequence.append(qMakePair(QString("orbit_id"), KSParser::D_QSTRING));
-    sequence.append(qMakePair(QString("H"), KSParser::D_DOUBLE));
-    sequence.append(qMakePair(QString("G"), KSParser::D_DOUBLE));
-    sequence.append(qMakePair(QString("neo"), KSParser::D_QSTRING));
-    sequence.append(qMakePair(QString("tp_calc"), KSParser::D_SKIP));
-    sequence.append(qMakePair(QString("M2"), KSParser::D_SKIP));
-    sequence.append(qMakePair(QString("diameter"), KSParser::D_FLOAT));
-    sequence.append(qMakePair(QString("extent"), KSParser::D_QSTRING));
-    sequence.append(qMakePair(QString("albedo"), KSParser::D_FLOAT));
-    sequence.append(qMakePair(QString("rot_period"), KSParser::D_FLOAT));
-    sequence.append(qMakePair(QString("per_y"), KSParser::D_FLOAT));
-    sequence.append(qMakePair(QString("moid"), KSParser::D_DOUBLE));
-    sequence.append(qMakePair(QString("class"), KSParser::D_QSTRING));
+    clearObjectNames( SkyObject::ASTEROID );
 
     //QString file_name = KSPaths::locate( QStandardPaths::DataLocation,  );
     QString file_name = KSPaths::locate(QStandardPaths::GenericDataLocation, QString("asteroids.dat"));
-    KSParser asteroid_parser(file_name, '#', sequence);
 
-    QHash<QString, QVariant> row_content;
-    while (asteroid_parser.HasNextRow()){
-        row_content = asteroid_parser.ReadNextRow();
-        full_name = row_content["full name"].toString();
-        full_name = full_name.trimmed();
-        int catN  = full_name.section(' ', 0, 0).toInt();
+    SnapshotCache snapshot("asteroids", ASTEROID_SNAPSHOT_VERSION);
+    snapshot.addSource(file_name);
 
-        name = full_name.section(' ', 1, -1);
+    QVector<AsteroidRecord> records;
+    if (readSnapshot(snapshot, records) == false)
+    {
+        parseFile(file_name, records);
+        writeSnapshot(snapshot, records);
+    }
+
+    m_Elements.reserve(records.size());
+
+    foreach (const AsteroidRecord &record, records)
+    {
+        QString name = record.name;
+        float diameter = record.diameter;
 
         //JM temporary hack to avoid Europa,Io, and Asterope duplication
         if (name == "Europa" || name == "Io" || name == "Asterope")
             name += i18n(" (Asteroid)");
 
-        mJD  = row_content["epoch_mjd"].toInt();
-        q    = row_content["q"].toDouble();
-        a    = row_content["a"].toDouble();
-        e    = row_content["e"].toDouble();
-        dble_i = row_content["i"].toDouble();
-        dble_w = row_content["w"].toDouble();
-        dble_N = row_content["om"].toDouble();
-        dble_M = row_content["ma"].toDouble();
-        orbit_id = row_content["orbit_id"].toString();
-        H   = row_content["H"].toDouble();
-        G   = row_content["G"].toDouble();
-        neo = row_content["neo"].toString() == "Y";
-        diameter = row_content["diameter"].toFloat();
-        dimensions = row_content["extent"].toString();
-        albedo  = row_content["albedo"].toFloat();
-        rot_period = row_content["rot_period"].toFloat();
-        period  = row_content["per_y"].toFloat();
-        earth_moid  = row_content["moid"].toDouble();
-        orbit_class = row_content["class"].toString();
-
-        JD = static_cast<double>(mJD) + 2400000.5;
+        long double JD = static_cast<double>(record.mJD) + 2400000.5;
 
         KSAsteroid *new_asteroid = NULL;
         // JM: Hack since asteroid file (Generated by JPL) is missing important Pluto data
@@ -173,28 +249,29 @@ void AsteroidsComponent::loadData()
         if (name == "Pluto")
         {
            diameter = 2368;
-           new_asteroid = new KSAsteroid( catN, name, "pluto", JD, a, e, dms(dble_i), dms(dble_w), dms(dble_N), dms(dble_M), H, G );
+           new_asteroid = new KSAsteroid( record.catN, name, "pluto", JD, record.a, record.e, dms(record.i), dms(record.w), dms(record.N), dms(record.M), record.H, record.G );
          }
          else
-           new_asteroid = new KSAsteroid( catN, name, QString(), JD, a, e, dms(dble_i), dms(dble_w), dms(dble_N), dms(dble_M), H, G );
+           new_asteroid = new KSAsteroid( record.catN, name, QString(), JD, record.a, record.e, dms(record.i), dms(record.w), dms(record.N), dms(record.M), record.H, record.G );
 
-        new_asteroid->setPerihelion(q);
-        new_asteroid->setOrbitID(orbit_id);
-        new_asteroid->setNEO(neo);
+        new_asteroid->setPerihelion(record.q);
+        new_asteroid->setOrbitID(record.orbit_id);
+        new_asteroid->setNEO(record.neo);
         new_asteroid->setDiameter(diameter);
-        new_asteroid->setDimensions(dimensions);
-        new_asteroid->setAlbedo(albedo);
-        new_asteroid->setRotationPeriod(rot_period);
-        new_asteroid->setPeriod(period);
-        new_asteroid->setEarthMOID(earth_moid);
-        new_asteroid->setOrbitClass(orbit_class);
+        new_asteroid->setDimensions(record.dimensions);
+        new_asteroid->setAlbedo(record.albedo);
+        new_asteroid->setRotationPeriod(record.rot_period);
+        new_asteroid->setPeriod(record.period);
+        new_asteroid->setEarthMOID(record.earth_moid);
+        new_asteroid->setOrbitClass(record.orbit_class);
         new_asteroid->setPhysicalSize(diameter);
         //new_asteroid->setAngularSize(0.005);
 
         m_ObjectList.append(new_asteroid);
+        m_Elements.append(new_asteroid);
+        addToIndex(new_asteroid);
         // Add name to the list of object names
-        objectNames(SkyObject::ASTEROID).append(name);
-        objectLists( SkyObject::ASTEROID ).append(QPair<QString, const SkyObject*>(name,new_asteroid));
+        appendObjectName( SkyObject::ASTEROID, name, new_asteroid );
     }
 }
 
@@ -218,43 +295,36 @@ void AsteroidsComponent::draw( SkyPainter *skyp )
 
     skyp->setBrush( QBrush( QColor( "gray" ) ) );
 
-    foreach ( SkyObject *so, m_ObjectList ) {
-        // FIXME: God help us!
-        KSAsteroid *ast = (KSAsteroid*) so;
+    // Only the asteroids in the trixels of the visible sky
+    const MovingObjectIndex &index = trixelIndex();
+    MeshIterator region( SkyMesh::Instance(), DRAW_BUF );
+    while ( region.hasNext() ) {
+        foreach ( SkyObject *so, index.objects( region.next() ) ) {
+            // FIXME: God help us!
+            KSAsteroid *ast = (KSAsteroid*) so;
 
-        if ( ast->mag() > Options::magLimitAsteroid() || std::isnan(ast->mag()) != 0)
-            continue;
+            if ( ast->mag() > Options::magLimitAsteroid() || std::isnan(ast->mag()) != 0)
+                continue;
 
-        bool drawn = false;
+            bool drawn = false;
 
-        if (ast->image().isNull() == false)
-            drawn = skyp->drawPlanet(ast);
-        else
-            drawn = skyp->drawPointSource(ast,ast->mag());
-
-        if ( drawn && !( hideLabels || ast->mag() >= labelMagLimit ) )
-            SkyLabeler::AddLabel( ast, SkyLabeler::ASTEROID_LABEL );
+            if (ast->image().isNull() == false)
+                drawn = skyp->drawPlanet(ast);
+            else
+                drawn = skyp->drawPointSource(ast,ast->mag());
 
+            if ( drawn && !( hideLabels || ast->mag() >= labelMagLimit ) )
+                SkyLabeler::AddLabel( ast, SkyLabeler::ASTEROID_LABEL );
+        }
     }
 #endif
 }
 
 SkyObject* AsteroidsComponent::objectNearest( SkyPoint *p, double &maxrad ) {
-    SkyObject *oBest = 0;
-
     if ( ! selected() ) return 0;
 
-    foreach ( SkyObject *o, m_ObjectList ) {
-        if ( o->mag() > Options::magLimitAsteroid() ) continue;
-
-        double r = o->angularDistanceTo( p ).Degrees();
-        if ( r < maxrad ) {
-            oBest = o;
-            maxrad = r;
-        }
-    }
-
-    return oBest;
+    // Only the asteroids in the trixels found by SkyMapComposite::objectNearest()
+    return trixelIndex().objectNearest( p, maxrad, Options::magLimitAsteroid() );
 }
 
 void AsteroidsComponent::updateDataFile()
@@ -25,6 +25,7 @@
 #include <KMessageBox>
 #endif
 #include <QDir>
+#include <QMutexLocker>
 #include <QFile>
 #include <QPixmap>
 #include <QTextStream>
@@ -91,6 +92,10 @@ void CatalogComponent::_loadData( bool includeCatalogDesignation ) {
                                                        names,
                                                        this,
                                                        includeCatalogDesignation);
+
+    // Other components may be loading at the same time
+    QMutexLocker locker( objectNamesMutex() );
+
     for (int iter = 0; iter < names.size(); ++iter) {
         if (names.at(iter).first <= SkyObject::TYPE_UNKNOWN) {
             //FIXME JM 2016-06-02: inefficient and costly check
@@ -120,6 +125,7 @@ void CatalogComponent::_loadData( bool includeCatalogDesignation ) {
     for(int iter = 0; iter < m_ObjectList.size(); ++iter) {
         SkyObject *obj = m_ObjectList[iter];
         Q_ASSERT( obj );
+        addToIndex( obj );
         if(obj->type() <= SkyObject::TYPE_UNKNOWN) {
             QVector<QPair<QString, const SkyObject *>>&objects = objectLists(obj->type());
             bool dupName = false;
@@ -155,9 +161,8 @@ void CatalogComponent::_loadData( bool includeCatalogDesignation ) {
         }
     }
 
-    // Remove Duplicates (see FIXME by AS above)
-    foreach(QStringList list, objectNames())
-        list.removeDuplicates();
+    objectListsChanged();
+    locker.unlock();
 
     CatalogData loaded_catalog_data;
     KStarsData::Instance()->catalogdb()->GetCatalogData(m_catName, loaded_catalog_data);
@@ -30,6 +30,7 @@
 #include "ksutils.h"
 #include "kstarsdata.h"
 #include "ksfilereader.h"
+#include "ksrowparser.h"
 #include "auxiliary/kspaths.h"
 #ifndef KSTARS_LITE
 #include "skymap.h"
@@ -40,8 +41,127 @@
 #include "skypainter.h"
 #include "projections/projector.h"
 #include "auxiliary/filedownloader.h"
+#include "auxiliary/snapshotcache.h"
 #include "kspaths.h"
 
+// Bump whenever the layout of CometRecord in the snapshot changes
+#define COMET_SNAPSHOT_VERSION 1
+
+namespace
+{
+// Columns of comets.dat used to build the comets
+typedef struct
+{
+    QString name;
+    qint32 mJD;
+    double q, e, i, w, N, Tp, earth_moid;
+    QString orbit_id, orbit_class, dimensions;
+    float M1, M2, K1, K2, diameter, albedo, rot_period, period;
+    bool neo;
+} CometRecord;
+
+// Columns of comets.dat, see CometsComponent::loadData()
+enum CometColumn
+{
+    COL_FULL_NAME, COL_EPOCH_MJD, COL_Q, COL_E, COL_I, COL_W, COL_OM, COL_TP_CALC, COL_ORBIT_ID, COL_NEO, COL_M1,
+    COL_M2, COL_DIAMETER, COL_EXTENT, COL_ALBEDO, COL_ROT_PERIOD, COL_PER_Y, COL_MOID, COL_CLASS, COL_H, COL_G,
+    COMET_COLUMNS
+};
+
+const KSRowParser::Column cometColumns[COMET_COLUMNS] =
+{
+    { "full name", 0 }, { "epoch_mjd", 0 }, { "q", 0 }, { "e", 0 }, { "i", 0 }, { "w", 0 }, { "om", 0 },
+    { "tp_calc", 0 }, { "orbit_id", 0 }, { "neo", 0 }, { "M1", 0 }, { "M2", 0 }, { "diameter", 0 }, { "extent", 0 },
+    { "albedo", 0 }, { "rot_period", 0 }, { "per_y", 0 }, { "moid", 0 }, { "class", 0 }, { "H", 0 }, { "G", 0 }
+};
+
+void parseFile(const QString &file_name, QVector<CometRecord> &records)
+{
+    KSRowParser cometParser(file_name, '#', cometColumns, COMET_COLUMNS, ',');
+
+    while (cometParser.ReadNextRow()){
+        const KSRowParser &row = cometParser;
+
+        CometRecord record;
+        record.name   = row[COL_FULL_NAME].trimmed().toString();
+        record.mJD    = row[COL_EPOCH_MJD].toInt();
+        record.q      = row[COL_Q].toDouble();
+        record.e      = row[COL_E].toDouble();
+        record.i      = row[COL_I].toDouble();
+        record.w      = row[COL_W].toDouble();
+        record.N      = row[COL_OM].toDouble();
+        record.Tp     = row[COL_TP_CALC].toDouble();
+        record.orbit_id = row[COL_ORBIT_ID].toString();
+        record.neo    = row[COL_NEO] == "Y";
+
+        record.M1 = row[COL_M1].toFloat();
+        if(record.M1==0.0)
+            record.M1 = 101.0;
+
+        record.M2 = row[COL_M2].toFloat();
+        if(record.M2==0.0)
+            record.M2 = 101.0;
+
+        record.diameter   = row[COL_DIAMETER].toFloat();
+        record.dimensions = row[COL_EXTENT].toString();
+        record.albedo     = row[COL_ALBEDO].toFloat();
+        record.rot_period = row[COL_ROT_PERIOD].toFloat();
+        record.period     = row[COL_PER_Y].toFloat();
+        record.earth_moid  = row[COL_MOID].toDouble();
+        record.orbit_class = row[COL_CLASS].toString();
+        record.K1 = row[COL_H].toFloat();
+        record.K2 = row[COL_G].toFloat();
+
+        records.append(record);
+    }
+}
+
+bool readSnapshot(SnapshotCache &snapshot, QVector<CometRecord> &records)
+{
+    QDataStream *in = snapshot.open();
+    if (in == NULL)
+        return false;
+
+    quint32 count = 0;
+    *in >> count;
+
+    for (quint32 n = 0; n < count && in->status() == QDataStream::Ok; n++) {
+        CometRecord record;
+        *in >> record.name >> record.mJD >> record.q >> record.e >> record.i >> record.w >> record.N >> record.Tp >> record.earth_moid
+            >> record.orbit_id >> record.orbit_class >> record.dimensions >> record.M1 >> record.M2 >> record.K1 >> record.K2
+            >> record.diameter >> record.albedo >> record.rot_period >> record.period >> record.neo;
+        records.append(record);
+    }
+
+    if (in->status() != QDataStream::Ok) {
+        qWarning() << "Comet snapshot is corrupt, reloading" << snapshot.fileName();
+        snapshot.remove();
+        records.clear();
+        return false;
+    }
+
+    snapshot.close();
+    return true;
+}
+
+void writeSnapshot(SnapshotCache &snapshot, const QVector<CometRecord> &records)
+{
+    QDataStream *out = snapshot.create();
+    if (out == NULL)
+        return;
+
+    *out << static_cast<quint32>(records.count());
+
+    foreach (const CometRecord &record, records) {
+        *out << record.name << record.mJD << record.q << record.e << record.i << record.w << record.N << record.Tp << record.earth_moid
+             << record.orbit_id << record.orbit_class << record.dimensions << record.M1 << record.M2 << record.K1 << record.K2
+             << record.diameter << record.albedo << record.rot_period << record.period << record.neo;
+    }
+
+    snapshot.commit();
+}
+}
+
 CometsComponent::CometsComponent( SolarSystemComposite *parent )
         : SolarSystemListComponent( parent ) {
     loadData();
@@ -84,104 +204,52 @@ bool CometsComponent::selected() {
  * @note See KSComet constructor for more details.
  */
 void CometsComponent::loadData() {
-    QString name, orbit_id, orbit_class, dimensions;
-    bool neo;
-    int mJD;
-    double q, e, dble_i, dble_w, dble_N, Tp, earth_moid;
-    long double JD;
-    float M1, M2, K1, K2, diameter, albedo, rot_period, period;
-
     emitProgressText(i18n("Loading comets"));
 
+    clearIndex();
     qDeleteAll(m_ObjectList);
     m_ObjectList.clear();
+    m_Elements.clear();
+    m_Index.clear();
 
-    objectNames(SkyObject::COMET).clear();
-    objectLists(SkyObject::COMET).clear();
-
-    QList< QPair<QString, KSParser::DataTypes> > sequence;
-    sequence.append(qMakePair(QString("full name"), KSParser::D_QSTRING));
-    sequence.append(qMakePair(QString("epoch_mjd"), KSParser::D_INT));
-    sequence.append(qMakePair(QString("q"), KSParser::D_DOUBLE));
-    sequence.append(qMakePair(QString("e"), KSParser::D_DOUBLE));
-    sequence.append(qMakePair(QString("i"), KSParser::D_DOUBLE));
-    sequence.append(qMakePair(QString("w"), KSParser::D_DOUBLE));
-    sequence.append(qMakePair(QString("om"), KSParser::D_DOUBLE));
-    sequence.append(qMakePair(QString("tp_calc"), KSParser::D_DOUBLE));
-    sequence.append(qMakePair(QString("orbit_id"), KSParser::D_QSTRING));
-    sequence.append(qMakePair(QString("neo"), KSParser::D_QSTRING));
-    sequence.append(qMakePair(QString("M1"), KSParser::D_FLOAT));
-    sequence.append(qMakePair(QString("M2"), KSParser::D_FLOAT));
-    sequence.append(qMakePair(QString("diameter"), KSParser::D_FLOAT));
-    sequence.append(qMakePair(QString("extent"), KSParser::D_QSTRING));
-    sequence.append(qMakePair(QString("albedo"), KSParser::D_FLOAT));
-    sequence.append(qMakePair(QString("rot_period"), KSParser::D_FLOAT));
-    sequence.append(qMakePair(QString("per_y"), KSParser::D_FLOAT));
-    sequence.append(qMakePair(QString("moid"), KSParser::D_DOUBLE));
-    sequence.append(qMakePair(QString("class"), KSParser::D_QSTRING));
-    sequence.append(qMakePair(QString("H"), KSParser::D_SKIP));
-    sequence.append(qMakePair(QString("G"), KSParser::D_SKIP));
+    clearObjectNames( SkyObject::COMET );
 
     QString file_name = KSPaths::locate(QStandardPaths::GenericDataLocation, QString("comets.dat") );
-    KSParser cometParser(file_name, '#', sequence);
-
-    QHash<QString, QVariant> row_content;
-    while (cometParser.HasNextRow()){
-        KSComet *com = 0;
-        row_content = cometParser.ReadNextRow();
-        name   = row_content["full name"].toString();
-        name   = name.trimmed();
-        mJD    = row_content["epoch_mjd"].toInt();
-        q    = row_content["q"].toDouble();
-        e    = row_content["e"].toDouble();
-        dble_i = row_content["i"].toDouble();
-        dble_w = row_content["w"].toDouble();
-        dble_N = row_content["om"].toDouble();
-        Tp     = row_content["tp_calc"].toDouble();
-        orbit_id = row_content["orbit_id"].toString();
-        neo = row_content["neo"] == "Y";
-
-        if(row_content["M1"].toFloat()==0.0)
-            M1 = 101.0;
-        else
-            M1 = row_content["M1"].toFloat();
-
-        if(row_content["M2"].toFloat()==0.0)
-            M2 = 101.0;
-        else
-            M2 = row_content["M2"].toFloat();
-
-        diameter = row_content["diameter"].toFloat();
-        dimensions = row_content["extent"].toString();
-        albedo  = row_content["albedo"].toFloat();
-        rot_period = row_content["rot_period"].toFloat();
-        period  = row_content["per_y"].toFloat();
-        earth_moid  = row_content["moid"].toDouble();
-        orbit_class = row_content["class"].toString();
-        K1 = row_content["H"].toFloat();
-        K2 = row_content["G"].toFloat();
-
-        JD = static_cast<double>( mJD ) + 2400000.5;
-
-        com = new KSComet( name, QString(), JD, q, e,
-                           dms( dble_i ), dms( dble_w ),
-                           dms( dble_N ), Tp, M1, M2,
-                           K1, K2 );
-        com->setOrbitID( orbit_id );
-        com->setNEO( neo );
-        com->setDiameter( diameter );
-        com->setDimensions( dimensions );
-        com->setAlbedo( albedo );
-        com->setRotationPeriod( rot_period );
-        com->setPeriod( period );
-        com->setEarthMOID( earth_moid );
-        com->setOrbitClass( orbit_class );
+
+    SnapshotCache snapshot("comets", COMET_SNAPSHOT_VERSION);
+    snapshot.addSource(file_name);
+
+    QVector<CometRecord> records;
+    if (readSnapshot(snapshot, records) == false) {
+        parseFile(file_name, records);
+        writeSnapshot(snapshot, records);
+    }
+
+    m_Elements.reserve( records.size() );
+
+    foreach (const CometRecord &record, records) {
+        long double JD = static_cast<double>( record.mJD ) + 2400000.5;
+
+        KSComet *com = new KSComet( record.name, QString(), JD, record.q, record.e,
+                                    dms( record.i ), dms( record.w ),
+                                    dms( record.N ), record.Tp, record.M1, record.M2,
+                                    record.K1, record.K2 );
+        com->setOrbitID( record.orbit_id );
+        com->setNEO( record.neo );
+        com->setDiameter( record.diameter );
+        com->setDimensions( record.dimensions );
+        com->setAlbedo( record.albedo );
+        com->setRotationPeriod( record.rot_period );
+        com->setPeriod( record.period );
+        com->setEarthMOID( record.earth_moid );
+        com->setOrbitClass( record.orbit_class );
         com->setAngularSize( 0.005 );
         m_ObjectList.append( com );
+        m_Elements.append( com );
+        addToIndex( com );
 
         // Add *short* name to the list of object names
-        objectNames( SkyObject::COMET ).append( com->name() );
-        objectLists( SkyObject::COMET ).append(QPair<QString, const SkyObject*>(com->name(),com));
+        appendObjectName( SkyObject::COMET, com->name(), com );
     }
 }
 
@@ -201,19 +269,31 @@ void CometsComponent::draw( SkyPainter *skyp )
     skyp->setPen( QPen( QColor( "darkcyan" ) ) );
     skyp->setBrush( QBrush( QColor( "darkcyan" ) ) );
 
-    foreach ( SkyObject *so, m_ObjectList ) {
-        KSComet *com = (KSComet*)so;
-        double mag= com->mag();
-        if (std::isnan(mag) == 0)
-        {
-            bool drawn = skyp->drawPointSource(com,mag);
-            if ( drawn && !(hideLabels || com->rsun() >= rsunLabelLimit) )
-                SkyLabeler::AddLabel( com, SkyLabeler::COMET_LABEL );
+    // Only the comets in the trixels of the visible sky
+    const MovingObjectIndex &index = trixelIndex();
+    MeshIterator region( SkyMesh::Instance(), DRAW_BUF );
+    while ( region.hasNext() ) {
+        foreach ( SkyObject *so, index.objects( region.next() ) ) {
+            KSComet *com = (KSComet*)so;
+            double mag= com->mag();
+            if (std::isnan(mag) == 0)
+            {
+                bool drawn = skyp->drawPointSource(com,mag);
+                if ( drawn && !(hideLabels || com->rsun() >= rsunLabelLimit) )
+                    SkyLabeler::AddLabel( com, SkyLabeler::COMET_LABEL );
+            }
         }
     }
 #endif
 }
 
+SkyObject* CometsComponent::objectNearest( SkyPoint *p, double &maxrad ) {
+    if ( ! selected() ) return 0;
+
+    // Only the comets in the trixels found by SkyMapComposite::objectNearest()
+    return trixelIndex().objectNearest( p, maxrad );
+}
+
 void CometsComponent::updateDataFile()
 {
     downloadJob = new FileDownloader();
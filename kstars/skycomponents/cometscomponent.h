@@ -45,6 +45,7 @@ public:
     virtual ~CometsComponent();
     virtual bool selected();
     virtual void draw( SkyPainter *skyp );
+    virtual SkyObject* objectNearest( SkyPoint *p, double &maxrad );
     void updateDataFile();
 
 protected slots:
@@ -18,6 +18,7 @@
 #include "constellationboundarylines.h"
 
 #include <cstdio>
+#include <cmath>
 
 #include <QPen>
 
@@ -45,6 +46,15 @@
 
 #include "skypainter.h"
 
+// The membership table has one cell per minute of RA and quarter degree of Dec
+#define LOOKUP_RA_CELLS     1440
+#define LOOKUP_DEC_CELLS    720
+#define LOOKUP_CELL_RA      (24.0 / LOOKUP_RA_CELLS)
+#define LOOKUP_CELL_DEC     (180.0 / LOOKUP_DEC_CELLS)
+// Cells crossed by a boundary, the boundaries are tested for each point
+#define LOOKUP_BOUNDARY     -1
+#define LOOKUP_UNKNOWN      -2
+
 ConstellationBoundaryLines::ConstellationBoundaryLines( SkyComposite *parent )
         : NoPrecessIndex( parent, i18n("Constellation Boundaries") )
 {
@@ -96,6 +106,7 @@ ConstellationBoundaryLines::ConstellationBoundaryLines( SkyComposite *parent )
                 appendPoly( polyList, idxFile, verbose );
             QString cName = line.mid(1);
             polyList = new PolyList( cName );
+            m_polyLists.append( polyList );
             if ( verbose == -1 ) printf(":\n");
             lastRa = lastDec = -1000.0;
             continue;
@@ -147,6 +158,8 @@ ConstellationBoundaryLines::ConstellationBoundaryLines( SkyComposite *parent )
         appendLine( lineList );
     if( polyList )
         appendPoly( polyList, idxFile, verbose );
+
+    buildLookupTable();
 }
 
 bool ConstellationBoundaryLines::selected()
@@ -198,9 +211,106 @@ void ConstellationBoundaryLines::appendPoly( PolyList* polyList, int debug)
         printf("PolyList: %3d: %d\n", ++m_polyIndexCnt, indexHash.size() );
 }
 
+void ConstellationBoundaryLines::markBoundaryCells( PolyList* polyList )
+{
+    const QPolygonF* poly = polyList->poly();
+    int size = poly->size();
+
+    // The polygon is closed, the last point connects back to the first
+    for ( int i = 0; i < size; i++ ) {
+        QPointF a = poly->at( i );
+        QPointF b = poly->at( ( i + 1 ) % size );
+
+        // Sample the edge at least twice per cell and mark the cells
+        // around each sample, so the marked cells always separate the
+        // cells on either side of the edge.
+        double dRa  = ( b.x() - a.x() ) / LOOKUP_CELL_RA;
+        double dDec = ( b.y() - a.y() ) / LOOKUP_CELL_DEC;
+        int steps = (int) ceil( 2.0 * qMax( fabs( dRa ), fabs( dDec ) ) ) + 1;
+
+        for ( int s = 0; s <= steps; s++ ) {
+            double t = (double) s / steps;
+            int col = (int) floor( ( a.x() + t * ( b.x() - a.x() ) ) / LOOKUP_CELL_RA );
+            int row = (int) floor( ( a.y() + t * ( b.y() - a.y() ) + 90.0 ) / LOOKUP_CELL_DEC );
+
+            for ( int r = row - 1; r <= row + 1; r++ ) {
+                if ( r < 0 || r >= LOOKUP_DEC_CELLS ) continue;
+                for ( int c = col - 1; c <= col + 1; c++ ) {
+                    // boundaries that wrap RA have negative RA points
+                    int wrapped = ( ( c % LOOKUP_RA_CELLS ) + LOOKUP_RA_CELLS ) % LOOKUP_RA_CELLS;
+                    m_lookup[ r * LOOKUP_RA_CELLS + wrapped ] = LOOKUP_BOUNDARY;
+                }
+            }
+        }
+    }
+}
+
+void ConstellationBoundaryLines::buildLookupTable()
+{
+    m_lookup.fill( LOOKUP_UNKNOWN, LOOKUP_RA_CELLS * LOOKUP_DEC_CELLS );
+
+    QHash<PolyList*, qint16> polyIds;
+    for ( int i = 0; i < m_polyLists.size(); i++ ) {
+        polyIds.insert( m_polyLists[ i ], i );
+        markBoundaryCells( m_polyLists[ i ] );
+    }
+
+    // Every cell of a region enclosed by boundary cells lies in the same
+    // constellation, so only one point per region has to be tested.
+    QVector<int> stack;
+
+    for ( int cell = 0; cell < m_lookup.size(); cell++ ) {
+        if ( m_lookup[ cell ] != LOOKUP_UNKNOWN ) continue;
+
+        SkyPoint seed( ( cell % LOOKUP_RA_CELLS + 0.5 ) * LOOKUP_CELL_RA,
+                       ( cell / LOOKUP_RA_CELLS + 0.5 ) * LOOKUP_CELL_DEC - 90.0 );
+        PolyList* polyList = SearchPoly( &seed );
+        qint16 id = polyList ? polyIds.value( polyList ) : LOOKUP_BOUNDARY;
+
+        m_lookup[ cell ] = id;
+        stack.append( cell );
+
+        while ( ! stack.isEmpty() ) {
+            int current = stack.takeLast();
+            int row = current / LOOKUP_RA_CELLS;
+            int col = current % LOOKUP_RA_CELLS;
+
+            int neighbors[4];
+            int count = 0;
+            neighbors[ count++ ] = row * LOOKUP_RA_CELLS + ( col + 1 ) % LOOKUP_RA_CELLS;
+            neighbors[ count++ ] = row * LOOKUP_RA_CELLS + ( col + LOOKUP_RA_CELLS - 1 ) % LOOKUP_RA_CELLS;
+            if ( row > 0 ) neighbors[ count++ ] = current - LOOKUP_RA_CELLS;
+            if ( row < LOOKUP_DEC_CELLS - 1 ) neighbors[ count++ ] = current + LOOKUP_RA_CELLS;
+
+            for ( int i = 0; i < count; i++ ) {
+                if ( m_lookup[ neighbors[ i ] ] != LOOKUP_UNKNOWN ) continue;
+                m_lookup[ neighbors[ i ] ] = id;
+                stack.append( neighbors[ i ] );
+            }
+        }
+    }
+}
+
 PolyList* ConstellationBoundaryLines::ContainingPoly( SkyPoint *p )
 {
-    //printf("called ContainingPoly(p)\n");
+    if ( ! m_lookup.isEmpty() ) {
+        double ra  = p->ra().Hours();
+        double dec = p->dec().Degrees();
+
+        int col = qBound( 0, (int) floor( ra / LOOKUP_CELL_RA ), LOOKUP_RA_CELLS - 1 );
+        int row = qBound( 0, (int) floor( ( dec + 90.0 ) / LOOKUP_CELL_DEC ), LOOKUP_DEC_CELLS - 1 );
+
+        qint16 id = m_lookup[ row * LOOKUP_RA_CELLS + col ];
+        if ( id >= 0 )
+            return m_polyLists[ id ];
+    }
+
+    return SearchPoly( p );
+}
+
+PolyList* ConstellationBoundaryLines::SearchPoly( SkyPoint *p )
+{
+    //printf("called SearchPoly(p)\n");
 
     // we save the pointers in a hash because most often there is only one
     // constellation and we can avoid doing the expensive boundary calculations
@@ -267,9 +377,8 @@ PolyList* ConstellationBoundaryLines::ContainingPoly( SkyPoint *p )
 // start here.  (Some of them may not be needed (or working)).
 //-------------------------------------------------------------------
 
-QString ConstellationBoundaryLines::constellationName( SkyPoint *p )
+QString ConstellationBoundaryLines::displayName( PolyList *polyList )
 {
-    PolyList *polyList = ContainingPoly( p );
     if ( polyList ) {
         return ( Options::useLocalConstellNames() ?
                  i18nc( "Constellation name (optional)", polyList->name().toUpper().toLocal8Bit().data() ) :
@@ -277,3 +386,26 @@ QString ConstellationBoundaryLines::constellationName( SkyPoint *p )
     }
     return i18n("Unknown");
 }
+
+QString ConstellationBoundaryLines::constellationName( SkyPoint *p )
+{
+    return displayName( ContainingPoly( p ) );
+}
+
+QStringList ConstellationBoundaryLines::constellationNames( const QVector<SkyPoint *> &points )
+{
+    // Catalogs have many objects per constellation, translate each name once
+    QHash<PolyList*, QString> names;
+    QStringList result;
+    result.reserve( points.size() );
+
+    foreach ( SkyPoint *p, points ) {
+        PolyList *polyList = ContainingPoly( p );
+        QHash<PolyList*, QString>::const_iterator it = names.constFind( polyList );
+        if ( it == names.constEnd() )
+            it = names.insert( polyList, displayName( polyList ) );
+        result.append( it.value() );
+    }
+
+    return result;
+}
@@ -22,6 +22,7 @@
 
 #include <QHash>
 #include <QPolygonF>
+#include <QStringList>
 
 class PolyList;
 class ConstellationBoundary;
@@ -56,6 +57,12 @@ public:
 
     QString constellationName( SkyPoint *p );
 
+    /** @short Find the constellations of many points at once.
+     * @return the name of the constellation of each point, in the
+     * same order as the points.
+     */
+    QStringList constellationNames( const QVector<SkyPoint *> &points );
+
     virtual bool selected();
 
     virtual void preDraw( SkyPainter *skyp );
@@ -68,11 +75,37 @@ private:
      */
     void appendPoly( PolyList* polyList, KSFileReader* file, int debug);
 
+    /** @short returns the boundary containing p, looked up in the
+     * membership table where possible.
+     */
     PolyList* ContainingPoly( SkyPoint *p );
 
+    /** @short tests p against the boundaries of the trixels around it.
+     */
+    PolyList* SearchPoly( SkyPoint *p );
+
+    /** @short returns the localized name of a boundary.
+     */
+    QString displayName( PolyList *polyList );
+
+    /** @short builds the membership table.  The sky is divided into a
+     * grid of RA and Dec cells.  Cells not crossed by a boundary
+     * store the boundary containing them, found by testing one seed
+     * point per region enclosed by the boundaries.
+     */
+    void buildLookupTable();
+
+    /** @short marks all cells crossed by the edges of polyList.
+     */
+    void markBoundaryCells( PolyList *polyList );
+
     SkyMesh*   m_skyMesh;
     PolyIndex  m_polyIndex;
     int        m_polyIndexCnt;
+
+    // All boundaries, cells of the membership table index them
+    QVector<PolyList*> m_polyLists;
+    QVector<qint16>    m_lookup;
 };
 
 
@@ -94,10 +94,10 @@ void ConstellationNamesComponent::loadData(CultureList* cultures)
             SkyObject *o = new SkyObject( SkyObject::CONSTELLATION, r, d, 0.0, name, abbrev );
             o->EquatorialToHorizontal(KStarsData::Instance()->lst(),KStarsData::Instance()->geo()->lat());
             m_ObjectList.append( o );
+            addToIndex( o );
 
             //Add name to the list of object names
-            objectNames(SkyObject::CONSTELLATION).append( name );
-            objectLists(SkyObject::CONSTELLATION).append(QPair<QString, const SkyObject*>(name, o));
+            appendObjectName( SkyObject::CONSTELLATION, name, o );
         }
     }
 }
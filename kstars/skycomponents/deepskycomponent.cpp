@@ -26,6 +26,7 @@
 #include "skyobjects/deepskyobject.h"
 #include "dms.h"
 #include "ksfilereader.h"
+#include "ksrowparser.h"
 #include "kstarsdata.h"
 #include "auxiliary/kspaths.h"
 #ifndef KSTARS_LITE
@@ -38,6 +39,30 @@
 #include "skypainter.h"
 #include "projections/projector.h"
 #include "kspaths.h"
+#include "auxiliary/snapshotcache.h"
+
+// Bump whenever the layout of DeepSkyRecord in the snapshot changes
+#define DEEPSKY_SNAPSHOT_VERSION 1
+
+namespace
+{
+// Columns of ngcic.dat
+enum DeepSkyColumn
+{
+    COL_FLAG, COL_ID, COL_SUFFIX, COL_RA_H, COL_RA_M, COL_RA_S, COL_D_SIGN, COL_DEC_D, COL_DEC_M, COL_DEC_S, COL_BMAG,
+    COL_TYPE, COL_A, COL_B, COL_PA, COL_PGC, COL_OTHER_CAT, COL_OTHER1, COL_OTHER2, COL_MESSR, COL_MESSR_NUM,
+    COL_LONGNAME, DEEPSKY_COLUMNS
+};
+
+// The last column extends to the end of the line
+const KSRowParser::Column deepSkyColumns[DEEPSKY_COLUMNS] =
+{
+    { "Flag", 1 }, { "ID", 4 }, { "suffix", 1 }, { "RA_H", 2 }, { "RA_M", 2 }, { "RA_S", 4 }, { "D_Sign", 2 },
+    { "Dec_d", 2 }, { "Dec_m", 2 }, { "Dec_s", 2 }, { "BMag", 6 }, { "type", 2 }, { "a", 6 }, { "b", 6 }, { "pa", 4 },
+    { "PGC", 7 }, { "other cat", 4 }, { "other1", 6 }, { "other2", 6 }, { "Messr", 2 }, { "MessrNum", 4 },
+    { "Longname", 0 }
+};
+}
 
 DeepSkyComponent::DeepSkyComponent( SkyComposite *parent ) :
     SkyComponent(parent)
@@ -64,93 +89,34 @@ void DeepSkyComponent::update( KSNumbers* )
 
 void DeepSkyComponent::loadData()
 {
-
-    KStarsData* data = KStarsData::Instance();
     //Check whether we need to concatenate a split NGC/IC catalog
     //(i.e., if user has downloaded the Steinicke catalog)
     mergeSplitFiles();
 
-    QList< QPair<QString,KSParser::DataTypes> > sequence;
-    QList<int> widths;
-    sequence.append(qMakePair(QString("Flag"), KSParser::D_QSTRING));
-    widths.append(1);
-
-    sequence.append(qMakePair(QString("ID"), KSParser::D_INT));
-    widths.append(4);
-
-    sequence.append(qMakePair(QString("suffix"), KSParser::D_QSTRING));
-    widths.append(1);
-
-    sequence.append(qMakePair(QString("RA_H"), KSParser::D_INT));
-    widths.append(2);
-
-    sequence.append(qMakePair(QString("RA_M"),KSParser::D_INT));
-    widths.append(2);
-
-    sequence.append(qMakePair(QString("RA_S"),KSParser::D_FLOAT));
-    widths.append(4);
-
-    sequence.append(qMakePair(QString("D_Sign"),KSParser::D_QSTRING));
-    widths.append(2);
-
-    sequence.append(qMakePair(QString("Dec_d"),KSParser::D_INT));
-    widths.append(2);
-
-    sequence.append(qMakePair(QString("Dec_m"),KSParser::D_INT));
-    widths.append(2);
-
-    sequence.append(qMakePair(QString("Dec_s"),KSParser::D_INT));
-    widths.append(2);
-
-    sequence.append(qMakePair(QString("BMag"),KSParser::D_QSTRING));
-    widths.append(6);
-
-    sequence.append(qMakePair(QString("type"),KSParser::D_INT));
-    widths.append(2);
-
-    sequence.append(qMakePair(QString("a"),KSParser::D_FLOAT));
-    widths.append(6);
-
-    sequence.append(qMakePair(QString("b"),KSParser::D_FLOAT));
-    widths.append(6);
-
-    sequence.append(qMakePair(QString("pa"),KSParser::D_QSTRING));
-    widths.append(4);
-
-    sequence.append(qMakePair(QString("PGC"),KSParser::D_INT));
-    widths.append(7);
-
-    sequence.append(qMakePair(QString("other cat"),KSParser::D_QSTRING));
-    widths.append(4);
-
-    sequence.append(qMakePair(QString("other1"),KSParser::D_QSTRING));
-    widths.append(6);
-
-    sequence.append(qMakePair(QString("other2"),KSParser::D_QSTRING));
-    widths.append(6);
-
-    sequence.append(qMakePair(QString("Messr"),KSParser::D_QSTRING));
-    widths.append(2);
+    QString file_name = KSPaths::locate(QStandardPaths::GenericDataLocation, QString("ngcic.dat") );
 
-    sequence.append(qMakePair(QString("MessrNum"),KSParser::D_INT));
-    widths.append(4);
+    // Trixels are only valid for the mesh they were computed with
+    SnapshotCache snapshot( "ngcic", DEEPSKY_SNAPSHOT_VERSION );
+    snapshot.addSource( file_name );
+    snapshot.addKey( QString::number( m_skyMesh->level() ) );
 
-    sequence.append(qMakePair(QString("Longname"),KSParser::D_QSTRING));
-    //No width to be appended for last sequence object
+    if ( loadSnapshot( snapshot ) )
+        return;
 
-    QString file_name = KSPaths::locate(QStandardPaths::GenericDataLocation, QString("ngcic.dat") );
-    KSParser deep_sky_parser(file_name, '#', sequence, widths);
+    KSRowParser deep_sky_parser(file_name, '#', deepSkyColumns, DEEPSKY_COLUMNS);
 
-    deep_sky_parser.SetProgress( i18n("Loading NGC/IC objects"), 13444, 10 );
+    emitProgressText( i18n("Loading NGC/IC objects") );
     qDebug() << "Loading NGC/IC objects";
 
-    QHash<QString,QVariant> row_content;
-    while (deep_sky_parser.HasNextRow()) {
-        row_content = deep_sky_parser.ReadNextRow();
+    QVector<DeepSkyRecord> records;
+    records.reserve( 13444 );
+
+    while (deep_sky_parser.ReadNextRow()) {
+        const KSRowParser &row = deep_sky_parser;
 
         QString iflag;
         QString cat;
-        iflag = row_content["Flag"].toString().mid( 0, 1 ); //check for NGC/IC catalog flag
+        iflag = row[COL_FLAG].toString().mid( 0, 1 ); //check for NGC/IC catalog flag
         /*
         Q_ASSERT(iflag == "I" || iflag == "N" || iflag == " ");
         // (spacetime): ^ Why an assert? Change in implementation of ksparser
@@ -161,28 +127,28 @@ void DeepSkyComponent::loadData()
         float mag(1000.0);
         int type, ingc, imess(-1), pa;
         int pgc, ugc;
-        QString ss, name, name2, longname;
+        QString name, name2, longname;
         QString cat2;
 
         // Designation
         if ( iflag == "I" ) cat = "IC";
         else if ( iflag == "N" ) cat = "NGC";
 
-        ingc = row_content["ID"].toInt();  // NGC/IC catalog number
+        ingc = row[COL_ID].toInt();  // NGC/IC catalog number
         if ( ingc==0 ) cat.clear(); //object is not in NGC or IC catalogs
 
-        QString suffix = row_content["suffix"].toString(); // multipliticity suffixes, eg: the 'A' in NGC 4945A
+        QString suffix = row[COL_SUFFIX].toString(); // multipliticity suffixes, eg: the 'A' in NGC 4945A
 
         Q_ASSERT( suffix.isEmpty() || ( suffix.at( 0 ) >= QChar( 'A' ) && suffix.at( 0 ) <= QChar( 'Z' ) ) || (suffix.at( 0 ) >= QChar( 'a' ) && suffix.at( 0 ) <= QChar( 'z' ) ) );
 
         //coordinates
-        int rah = row_content["RA_H"].toInt();
-        int ram = row_content["RA_M"].toInt();
-        float ras = row_content["RA_S"].toFloat();
-        QString sgn = row_content["D_Sign"].toString();
-        int dd = row_content["Dec_d"].toInt();
-        int dm = row_content["Dec_m"].toInt();
-        int ds = row_content["Dec_s"].toInt();
+        int rah = row[COL_RA_H].toInt();
+        int ram = row[COL_RA_M].toInt();
+        float ras = row[COL_RA_S].toFloat();
+        QString sgn = row[COL_D_SIGN].toString();
+        int dd = row[COL_DEC_D].toInt();
+        int dm = row[COL_DEC_M].toInt();
+        int ds = row[COL_DEC_S].toInt();
 
         if ( !( (0.0 <= rah && rah < 24.0) ||
              (0.0 <= ram && ram < 60.0) ||
@@ -200,41 +166,39 @@ void DeepSkyComponent::loadData()
             continue;
 
         //B magnitude
-        ss = row_content["BMag"].toString();
-        if (ss == "") { mag = 99.9f; } else { mag = ss.toFloat(); }
+        if (row[COL_BMAG].isEmpty()) { mag = 99.9f; } else { mag = row[COL_BMAG].toFloat(); }
 
         //object type
-        type = row_content["type"].toInt();
+        type = row[COL_TYPE].toInt();
 
         //major and minor axes
-        float a = row_content["a"].toFloat();
-        float b = row_content["b"].toFloat();
+        float a = row[COL_A].toFloat();
+        float b = row[COL_B].toFloat();
 
         //position angle.  The catalog PA is zero when the Major axis
         //is horizontal.  But we want the angle measured from North, so
         //we set PA = 90 - pa.
-        ss = row_content["pa"].toString();
-        if (ss == "" ) { pa = 90; } else { pa = 90 - ss.toInt(); }
+        if (row[COL_PA].isEmpty()) { pa = 90; } else { pa = 90 - row[COL_PA].toInt(); }
 
         //PGC number
-        pgc = row_content["PGC"].toInt();
+        pgc = row[COL_PGC].toInt();
 
         //UGC number
-        if (row_content["other cat"].toString().trimmed() == "UGC") {
-            ugc = row_content["other1"].toString().toInt();
+        if (row[COL_OTHER_CAT] == "UGC") {
+            ugc = row[COL_OTHER1].toInt();
         } else {
             ugc = 0;
         }
 
         //Messier number
-        if ( row_content["Messr"].toString().trimmed() == "M" ) {
+        if ( row[COL_MESSR] == "M" ) {
             cat2 = cat;
             if ( ingc == 0 ) cat2.clear();
             cat = 'M';
-            imess = row_content["MessrNum"].toInt();
+            imess = row[COL_MESSR_NUM].toInt();
         }
 
-        longname = row_content["Longname"].toString();
+        longname = row[COL_LONGNAME].toString();
 
         dms r;
         r.setH( rah, ram, int(ras) );
@@ -261,70 +225,149 @@ void DeepSkyComponent::loadData()
             if (!longname.isEmpty()) name = longname;
             else {
                 hasName = false;
-                name = i18n( "Unnamed Object" );
             }
         }
 
-        name = i18nc("object name (optional)", name.toLatin1().constData());
-        if (!longname.isEmpty())
-            longname = i18nc("object name (optional)", longname.toLatin1().constData());
-
-        // create new deepskyobject
-        DeepSkyObject *o = 0;
         if ( type==0 ) type = 1; //Make sure we use CATALOG_STAR, not STAR
-        o = new DeepSkyObject( type, r, d, mag, name, name2, longname, cat, a, b, pa, pgc, ugc );
-        o->EquatorialToHorizontal( data->lst(), data->geo()->lat() );
-
-        // Add the name(s) to the nameHash for fast lookup -jbb
-        if ( hasName ) {
-            nameHash[ name.toLower() ] = o;
-            if ( ! longname.isEmpty() ) nameHash[ longname.toLower() ] = o;
-            if ( ! name2.isEmpty() ) nameHash[ name2.toLower() ] = o;
-        }
 
-        Trixel trixel = m_skyMesh->index(o);
+        DeepSkyRecord record;
+        record.type     = type;
+        record.ra       = r.Degrees();
+        record.dec      = d.Degrees();
+        record.mag      = mag;
+        record.a        = a;
+        record.b        = b;
+        record.pa       = pa;
+        record.pgc      = pgc;
+        record.ugc      = ugc;
+        record.name     = hasName ? name : QString();
+        record.name2    = name2;
+        record.longname = longname;
+        record.cat      = cat;
+        record.trixel   = -1;
+
+        addObject( record );
+        records.append( record );
 
-        //Assign object to general DeepSkyObjects list,
-        //and a secondary list based on its catalog.
-        m_DeepSkyList.append( o );
-        appendIndex( o, &m_DeepSkyIndex, trixel );
+    }
 
-        if ( o->isCatalogM()) {
-            m_MessierList.append( o );
-            appendIndex( o, &m_MessierIndex, trixel );
-        }
-        else if (o->isCatalogNGC() ) {
-            m_NGCList.append( o );
-            appendIndex( o, &m_NGCIndex, trixel );
-        }
-        else if ( o->isCatalogIC() ) {
-            m_ICList.append( o );
-            appendIndex( o, &m_ICIndex, trixel );
-        }
-        else {
-            m_OtherList.append( o );
-            appendIndex( o, &m_OtherIndex, trixel );
-        }
+    saveSnapshot( snapshot, records );
+}
 
-        // JM: VERY INEFFICIENT. Disabling for now until we figure out how to deal with dups. QSet?
-        //if ( ! name.isEmpty() && !objectNames(type).contains(name))
-        if ( ! name.isEmpty() ) {
-            objectNames(type).append( name );
-            objectLists(type).append( QPair<QString, SkyObject *>(name, o));
-        }
+void DeepSkyComponent::addObject( DeepSkyRecord &record )
+{
+    KStarsData* data = KStarsData::Instance();
 
-        //Add long name to the list of object names
-        //if ( ! longname.isEmpty() && longname != name  && !objectNames(type).contains(longname))
-        if ( ! longname.isEmpty() && longname != name) {
-            objectNames(type).append( longname );
-            objectLists(type).append( QPair<QString, SkyObject *>(longname, o));
-        }
+    bool hasName = ! record.name.isEmpty();
+    QString name, longname;
+
+    if ( hasName )
+        name = i18nc("object name (optional)", record.name.toLatin1().constData());
+    else
+        name = i18n( "Unnamed Object" );
+    if (!record.longname.isEmpty())
+        longname = i18nc("object name (optional)", record.longname.toLatin1().constData());
+
+    const QString &name2 = record.name2;
+    int type = record.type;
+
+    // create new deepskyobject
+    DeepSkyObject *o = new DeepSkyObject( type, dms( record.ra ), dms( record.dec ), record.mag, name, name2, longname, record.cat,
+                                          record.a, record.b, record.pa, record.pgc, record.ugc );
+    o->EquatorialToHorizontal( data->lst(), data->geo()->lat() );
+
+    // Add the name(s) to the name index for fast lookup -jbb
+    if ( hasName )
+        addToIndex( o );
+
+    if ( record.trixel < 0 )
+        record.trixel = m_skyMesh->index(o);
+    Trixel trixel = record.trixel;
+
+    //Assign object to general DeepSkyObjects list,
+    //and a secondary list based on its catalog.
+    m_DeepSkyList.append( o );
+    appendIndex( o, &m_DeepSkyIndex, trixel );
+
+    if ( o->isCatalogM()) {
+        m_MessierList.append( o );
+        appendIndex( o, &m_MessierIndex, trixel );
+    }
+    else if (o->isCatalogNGC() ) {
+        m_NGCList.append( o );
+        appendIndex( o, &m_NGCIndex, trixel );
+    }
+    else if ( o->isCatalogIC() ) {
+        m_ICList.append( o );
+        appendIndex( o, &m_ICIndex, trixel );
+    }
+    else {
+        m_OtherList.append( o );
+        appendIndex( o, &m_OtherIndex, trixel );
+    }
+
+    // JM: VERY INEFFICIENT. Disabling for now until we figure out how to deal with dups. QSet?
+    //if ( ! name.isEmpty() && !objectNames(type).contains(name))
+    if ( ! name.isEmpty() ) {
+        appendObjectName( type, name, o );
+    }
+
+    //Add long name to the list of object names
+    //if ( ! longname.isEmpty() && longname != name  && !objectNames(type).contains(longname))
+    if ( ! longname.isEmpty() && longname != name) {
+        appendObjectName( type, longname, o );
+    }
+}
+
+bool DeepSkyComponent::loadSnapshot( SnapshotCache &snapshot )
+{
+    QDataStream *in = snapshot.open();
+    if ( in == 0 )
+        return false;
+
+    quint32 count = 0;
+    *in >> count;
+
+    // Read everything before creating any object, so a damaged snapshot leaves no half loaded catalog behind
+    QVector<DeepSkyRecord> records;
+    for ( quint32 i = 0; i < count && in->status() == QDataStream::Ok; ++i ) {
+        DeepSkyRecord record;
+        *in >> record.type >> record.ra >> record.dec >> record.mag >> record.a >> record.b >> record.pa
+            >> record.pgc >> record.ugc >> record.name >> record.name2 >> record.longname >> record.cat >> record.trixel;
+        records.append( record );
+    }
+
+    if ( in->status() != QDataStream::Ok ) {
+        qWarning() << "Deep sky snapshot is corrupt, reloading" << snapshot.fileName();
+        snapshot.remove();
+        return false;
+    }
+
+    snapshot.close();
+
+    emitProgressText( i18n("Loading NGC/IC objects") );
+    qDebug() << "Loading NGC/IC objects from snapshot";
+
+    for ( int i = 0; i < records.count(); ++i )
+        addObject( records[i] );
+
+    return true;
+}
+
+void DeepSkyComponent::saveSnapshot( SnapshotCache &snapshot, const QVector<DeepSkyRecord> &records )
+{
+    QDataStream *out = snapshot.create();
+    if ( out == 0 )
+        return;
+
+    *out << static_cast<quint32>( records.count() );
 
-        deep_sky_parser.ShowProgress();
+    foreach ( const DeepSkyRecord &record, records ) {
+        *out << record.type << record.ra << record.dec << record.mag << record.a << record.b << record.pa
+             << record.pgc << record.ugc << record.name << record.name2 << record.longname << record.cat << record.trixel;
     }
 
-    foreach(QStringList list, objectNames())
-        list.removeDuplicates();
+    snapshot.commit();
 }
 
 void DeepSkyComponent::mergeSplitFiles() {
@@ -524,7 +567,7 @@ void DeepSkyComponent::drawLabels()
 
 SkyObject* DeepSkyComponent::findByName( const QString &name ) {
 
-    return nameHash[ name.toLower() ];
+    return findInIndex( name );
 }
 
 void DeepSkyComponent::objectsInArea( QList<SkyObject*>& list, const SkyRegion& region )
@@ -667,6 +710,7 @@ void DeepSkyComponent::clearList(QList<DeepSkyObject*>& list) {
 }
 
 void DeepSkyComponent::clear() {
+    clearIndex();
     clearList( m_MessierList );
     clearList( m_NGCList );
     clearList( m_ICList );
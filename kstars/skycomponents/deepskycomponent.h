@@ -34,6 +34,7 @@ class DeepSkyObject;
 class SkyPoint;
 class SkyMesh;
 class SkyLabeler;
+class SnapshotCache;
 
 #ifdef KSTARS_LITE
 class DeepSkyItem;
@@ -118,6 +119,26 @@ public:
     bool selected();
 
 private:
+
+    /** Fields of one catalog object, as parsed from ngcic.dat or read back from the snapshot */
+    typedef struct
+    {
+        qint32 type;
+        double ra;          // degrees
+        double dec;         // degrees
+        float mag;
+        float a;
+        float b;
+        qint32 pa;
+        qint32 pgc;
+        qint32 ugc;
+        QString name;       // untranslated, empty if the object has no name
+        QString name2;
+        QString longname;   // untranslated
+        QString cat;
+        qint32 trixel;      // -1 until indexed
+    } DeepSkyRecord;
+
     /**
      * @short Read the ngcic.dat deep-sky database.
      * Parse all lines from the deep-sky object catalog files. Construct a DeepSkyObject
@@ -145,9 +166,19 @@ private:
      * @li 71-75    UGC Catalog number [int] can be blank
      * @li 77-END   Common name [string] can be blank
      * @return true if data file is successfully read.
+     *
+     * The parsed objects are saved to a snapshot, which replaces the parsing on the next start as long as ngcic.dat
+     * and the sky mesh are unchanged.
      */
     void loadData();
 
+    /** Create the object described by record and add it to the lists, indexes and name tables. */
+    void addObject( DeepSkyRecord &record );
+
+    /** @return true if all objects could be created from a valid snapshot */
+    bool loadSnapshot( SnapshotCache &snapshot );
+    void saveSnapshot( SnapshotCache &snapshot, const QVector<DeepSkyRecord> &records );
+
     void clearList(QList<DeepSkyObject*>& list);
 
     void mergeSplitFiles();
@@ -176,8 +207,6 @@ private:
 
     void appendIndex( DeepSkyObject *o, DeepSkyIndex* dsIndex, Trixel trixel );
 
-    QHash<QString, DeepSkyObject*> nameHash;
-
     /**
      *@short adds a label to the lists of labels to be drawn prioritized
      *by magnitude.
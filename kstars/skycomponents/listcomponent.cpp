@@ -34,6 +34,7 @@ ListComponent::~ListComponent() {
 }
 
 void ListComponent::clear() {
+    clearIndex();
     while ( ! m_ObjectList.isEmpty() ) {
         SkyObject *o = m_ObjectList.takeFirst();
         removeFromNames( o );
@@ -54,14 +55,7 @@ void ListComponent::update( KSNumbers *num )
 }
 
 SkyObject* ListComponent::findByName( const QString &name ) {
-    foreach( SkyObject *o, m_ObjectList ) {
-        if( QString::compare( o->name(),     name, Qt::CaseInsensitive ) == 0 ||
-            QString::compare( o->longname(), name, Qt::CaseInsensitive ) == 0 ||
-            QString::compare( o->name2(),    name, Qt::CaseInsensitive ) == 0 )
-            return o;
-    }
-    //No object found
-    return 0;
+    return findInIndex( name );
 }
 
 SkyObject* ListComponent::objectNearest( SkyPoint *p, double &maxrad ) {
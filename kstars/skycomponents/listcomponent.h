@@ -53,6 +53,7 @@ public:
      */
     virtual void update( KSNumbers *num=0 );
 
+    /** @short Look up an object this component added to the name index */
     virtual SkyObject* findByName( const QString &name );
     virtual SkyObject* objectNearest( SkyPoint *p, double &maxrad );
 
@@ -0,0 +1,82 @@
+/*  Moving Object Index
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#include "movingobjectindex.h"
+
+#include <cmath>
+
+#include "ksnumbers.h"
+#include "skyobjects/skyobject.h"
+
+MovingObjectIndex::MovingObjectIndex( SkyMesh *mesh ) : m_Mesh( mesh ), m_Trixels( mesh->size() ), m_Count( 0 )
+{
+}
+
+void MovingObjectIndex::update( const QList<SkyObject *> &objects, const KSNumbers *num )
+{
+    // resize() keeps the memory of each trixel for the next update
+    for ( int t=0; t<m_Trixels.size(); ++t )
+        m_Trixels[t].resize( 0 );
+
+    // From the equinox of the date to J2000.0, see SkyPoint::precessFromAnyEpoch()
+    const Eigen::Matrix3d &toJ2000 = num->p1();
+    Eigen::Vector3d s, v;
+
+    foreach ( SkyObject *o, objects )
+    {
+        double sinRA, cosRA, sinDec, cosDec;
+        o->ra().SinCos( sinRA, cosRA );
+        o->dec().SinCos( sinDec, cosDec );
+
+        s[0] = cosRA * cosDec;
+        s[1] = sinRA * cosDec;
+        s[2] = sinDec;
+        v.noalias() = toJ2000 * s;
+
+        double ra = atan2( v[1], v[0] ) / dms::DegToRad;
+        double dec = asin( qBound( -1.0, v[2], 1.0 ) ) / dms::DegToRad;
+        if ( ra < 0.0 )
+            ra += 360.0;
+
+        m_Trixels[ m_Mesh->HTMesh::index( ra, dec ) ].append( o );
+    }
+
+    m_Count = objects.size();
+}
+
+void MovingObjectIndex::clear()
+{
+    for ( int t=0; t<m_Trixels.size(); ++t )
+        m_Trixels[t].clear();
+    m_Count = 0;
+}
+
+SkyObject * MovingObjectIndex::objectNearest( SkyPoint *p, double &maxrad, double magLimit, MeshBufNum_t bufNum ) const
+{
+    SkyObject *oBest = 0;
+
+    MeshIterator region( m_Mesh, bufNum );
+    while ( region.hasNext() )
+    {
+        foreach ( SkyObject *o, m_Trixels[ region.next() ] )
+        {
+            if ( o->mag() > magLimit )
+                continue;
+
+            double r = o->angularDistanceTo( p ).Degrees();
+            if ( r < maxrad )
+            {
+                oBest = o;
+                maxrad = r;
+            }
+        }
+    }
+
+    return oBest;
+}
@@ -0,0 +1,67 @@
+/*  Moving Object Index
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef MOVINGOBJECTINDEX_H
+#define MOVINGOBJECTINDEX_H
+
+#include <QList>
+#include <QVector>
+
+#include "skymesh.h"
+
+class KSNumbers;
+class SkyObject;
+class SkyPoint;
+
+/**
+ *@class MovingObjectIndex
+ *@short Trixel index of sky objects whose positions change, like asteroids and comets.
+ *
+ * Each object is put in the trixel of its current position, precessed back to J2000.0 like the centers of
+ * SkyMesh::aperture(), so the trixels found by an aperture cover the objects in it. The index must be rebuilt
+ * with update() whenever the positions change.
+ */
+class MovingObjectIndex
+{
+public:
+    explicit MovingObjectIndex( SkyMesh *mesh );
+
+    /**
+     * @short Index the objects at their current positions, replacing the previous content.
+     * @param objects objects to index
+     * @param num the date of the current positions
+     */
+    void update( const QList<SkyObject *> &objects, const KSNumbers *num );
+
+    /** @short Empty the index, for instance before the indexed objects are deleted */
+    void clear();
+
+    /** @return the number of indexed objects */
+    int count() const { return m_Count; }
+
+    /** @return the objects in @p trixel */
+    const QVector<SkyObject *> & objects( Trixel trixel ) const { return m_Trixels[trixel]; }
+
+    /**
+     * @short Find the object nearest to @p p in the trixels of a buffer filled by SkyMesh::aperture().
+     * @param p the point to search around
+     * @param maxrad the largest distance to search (degrees), set to the distance of the object found
+     * @param magLimit objects fainter than this magnitude are skipped
+     * @param bufNum the SkyMesh buffer
+     * @return the nearest object, or NULL if none is closer than @p maxrad
+     */
+    SkyObject * objectNearest( SkyPoint *p, double &maxrad, double magLimit=100.0, MeshBufNum_t bufNum=OBJ_NEAREST_BUF ) const;
+
+private:
+    SkyMesh *m_Mesh;
+    QVector< QVector<SkyObject *> > m_Trixels;
+    int m_Count;
+};
+
+#endif // MOVINGOBJECTINDEX_H
@@ -0,0 +1,156 @@
+/*  Sky Object Name Index
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#include "nameindex.h"
+
+#include "skyobjects/skyobject.h"
+
+#include <QMutexLocker>
+
+NameIndex::NameIndex()
+{
+}
+
+QString NameIndex::normalize(const QString &name)
+{
+    QString key;
+    key.reserve(name.size());
+
+    const QChar *c = name.constData();
+    for (int i=0; i < name.size(); i++)
+    {
+        if (c[i].isSpace() == false)
+            key.append(c[i]);
+    }
+
+    return key.toCaseFolded();
+}
+
+void NameIndex::add(SkyObject *object, SkyComponent *owner)
+{
+    if (object == NULL)
+        return;
+
+    QMutexLocker locker(&m_Mutex);
+
+    insert(normalize(object->name()), object, owner);
+    insert(normalize(object->longname()), object, owner);
+    insert(normalize(object->name2()), object, owner);
+}
+
+void NameIndex::add(const QString &name, SkyObject *object, SkyComponent *owner)
+{
+    if (object == NULL)
+        return;
+
+    QMutexLocker locker(&m_Mutex);
+
+    insert(normalize(name), object, owner);
+}
+
+void NameIndex::insert(const QString &key, SkyObject *object, SkyComponent *owner)
+{
+    if (key.isEmpty())
+        return;
+
+    QVector<Entry> &entries = m_Index[key];
+
+    // Long name and name are often the same
+    for (int i=0; i < entries.count(); i++)
+    {
+        if (entries[i].object == object)
+            return;
+    }
+
+    Entry oneEntry;
+    oneEntry.object = object;
+    oneEntry.owner  = owner;
+    entries.append(oneEntry);
+
+    m_OwnerKeys[owner].insert(key);
+}
+
+void NameIndex::remove(SkyComponent *owner)
+{
+    QMutexLocker locker(&m_Mutex);
+
+    QSet<QString> keys = m_OwnerKeys.take(owner);
+
+    foreach(const QString &key, keys)
+    {
+        QHash<QString, QVector<Entry> >::iterator it = m_Index.find(key);
+        if (it == m_Index.end())
+            continue;
+
+        QVector<Entry> &entries = it.value();
+        for (int i=entries.count()-1; i >= 0; i--)
+        {
+            if (entries[i].owner == owner)
+                entries.remove(i);
+        }
+
+        if (entries.isEmpty())
+            m_Index.erase(it);
+    }
+}
+
+SkyObject * NameIndex::find(const QString &name, SkyComponent *owner)
+{
+    QString key = normalize(name);
+
+    QMutexLocker locker(&m_Mutex);
+
+    QHash<QString, QVector<Entry> >::const_iterator it = m_Index.constFind(key);
+    if (it == m_Index.constEnd())
+        return NULL;
+
+    const QVector<Entry> &entries = it.value();
+
+    if (owner)
+    {
+        foreach(const Entry &oneEntry, entries)
+        {
+            if (oneEntry.owner == owner)
+                return oneEntry.object;
+        }
+
+        return NULL;
+    }
+
+    if (entries.count() == 1 || !m_Rank)
+        return entries.first().object;
+
+    // Name collisions are rare, so ranking them on demand is cheap
+    const Entry *best = &entries.first();
+    int bestRank = m_Rank(best->owner);
+
+    for (int i=1; i < entries.count(); i++)
+    {
+        int rank = m_Rank(entries[i].owner);
+        if (rank < bestRank)
+        {
+            best = &entries[i];
+            bestRank = rank;
+        }
+    }
+
+    return best->object;
+}
+
+void NameIndex::setRankFunction(RankFunction function)
+{
+    QMutexLocker locker(&m_Mutex);
+    m_Rank = function;
+}
+
+int NameIndex::count()
+{
+    QMutexLocker locker(&m_Mutex);
+    return m_Index.count();
+}
@@ -0,0 +1,89 @@
+/*  Sky Object Name Index
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef NAMEINDEX_H
+#define NAMEINDEX_H
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QVector>
+#include <QMutex>
+
+#include <functional>
+
+class SkyObject;
+class SkyComponent;
+
+/**
+ *@class NameIndex
+ *@short Hash index from object names to sky objects.
+ *
+ * Names are normalized before they are stored or looked up: they are case folded and white space is removed, so "m31",
+ * "M 31" and "M31" all find the same object.
+ *
+ * Every entry belongs to the component that added it. A component removes its entries before deleting its objects, so the
+ * index never holds dangling pointers. When several objects share a name, the ranking function decides which one is found:
+ * the object whose owner has the lowest rank wins, and among objects of the same owner the one added first.
+ *
+ * All functions are thread safe, components may add entries while they are loaded concurrently.
+ *@version 1.0
+ */
+class NameIndex
+{
+public:
+
+    typedef std::function<int(SkyComponent *)> RankFunction;
+
+    NameIndex();
+
+    /** @return name as it is stored in the index */
+    static QString normalize(const QString &name);
+
+    /** Add object under its name, long name and alternate name. */
+    void add(SkyObject *object, SkyComponent *owner);
+
+    /** Add object under an additional name, e.g. a catalog designation. */
+    void add(const QString &name, SkyObject *object, SkyComponent *owner);
+
+    /** Remove all entries added by owner. */
+    void remove(SkyComponent *owner);
+
+    /**
+     * @brief find Look up an object by name.
+     * @param name name to look for, case and white space are ignored.
+     * @param owner if not NULL, only objects added by owner are considered.
+     * @return matching object, or NULL if there is none.
+     */
+    SkyObject * find(const QString &name, SkyComponent *owner=0);
+
+    /** Set the function ranking owners of objects sharing a name. Lower ranks are preferred. */
+    void setRankFunction(RankFunction function);
+
+    /** @return number of names in the index */
+    int count();
+
+private:
+
+    typedef struct
+    {
+        SkyObject *object;
+        SkyComponent *owner;
+    } Entry;
+
+    void insert(const QString &key, SkyObject *object, SkyComponent *owner);
+
+    QMutex m_Mutex;
+    // Entries of each name, in the order they were added
+    QHash<QString, QVector<Entry> > m_Index;
+    QHash<SkyComponent *, QSet<QString> > m_OwnerKeys;
+    RankFunction m_Rank;
+};
+
+#endif // NAMEINDEX_H
@@ -59,8 +59,8 @@ PlanetMoonsComponent::PlanetMoonsComponent( SkyComposite *p,
     pmoons = new JupiterMoons();
     int nmoons = pmoons->nMoons();
     for ( int i=0; i<nmoons; ++i ) {
-        objectNames(SkyObject::MOON).append( pmoons->name(i) );
-        objectLists(SkyObject::MOON).append( QPair<QString, const SkyObject*>(pmoons->name(i),pmoons->moon(i)) );
+        appendObjectName( SkyObject::MOON, pmoons->name(i), pmoons->moon(i) );
+        addToIndex( pmoons->moon(i) );
     }
 }
 
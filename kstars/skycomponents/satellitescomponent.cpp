@@ -37,6 +37,11 @@
 #include "skymap.h"
 #include "ksnotification.h"
 
+#include <algorithm>
+
+// Minutes between the epochs passes are searched from
+#define PASS_STEP   0.5
+
 SatellitesComponent::SatellitesComponent( SkyComposite *parent ) :
     SkyComponent( parent )
 {
@@ -66,8 +71,7 @@ void SatellitesComponent::loadData()
         m_groups.append( new SatelliteGroup( group_infos.at( 0 ), group_infos.at( 1 ), QUrl( group_infos.at( 2 ) ) ) );
     }
 
-    objectNames(SkyObject::SATELLITE).clear();
-    objectLists(SkyObject::SATELLITE).clear();
+    clearObjectNames( SkyObject::SATELLITE );
 
     foreach( SatelliteGroup *group, m_groups )
     {
@@ -76,8 +80,7 @@ void SatellitesComponent::loadData()
             Satellite *sat = group->at( i );
             if ( sat->selected() && nameHash.contains(sat->name().toLower()) == false)
             {
-                objectNames(SkyObject::SATELLITE).append(sat->name());
-                objectLists(SkyObject::SATELLITE).append(QPair<QString, const SkyObject*>(sat->name(), sat));
+                appendObjectName( SkyObject::SATELLITE, sat->name(), sat );
                 nameHash[sat->name().toLower()] = sat;
             }
         }
@@ -94,9 +97,25 @@ void SatellitesComponent::update( KSNumbers * )
     if( ! selected() )
         return;
     
+    // Observer and sun positions are the same for all satellites
+    SatelliteEpoch epoch;
+
+    // Satellites below the horizon are hidden by the ground, they are only computed again when they may have risen
+    bool skipBelowHorizon = Options::showGround();
+
     foreach( SatelliteGroup *group, m_groups ) {
-        group->updateSatellitesPos();
+        group->updateSatellitesPos( epoch, skipBelowHorizon );
     }
+
+#ifndef KSTARS_LITE
+    // A tracked satellite is followed below the horizon too
+    SkyObject *focus = SkyMap::Instance() ? SkyMap::Instance()->focusObject() : NULL;
+    if ( focus && focus->type() == SkyObject::SATELLITE ) {
+        Satellite *sat = static_cast<Satellite *>( focus );
+        if ( sat->isOutdated() )
+            sat->updatePos( epoch );
+    }
+#endif
 }
 
 void SatellitesComponent::draw( SkyPainter *skyp )
@@ -112,7 +131,7 @@ void SatellitesComponent::draw( SkyPainter *skyp )
         for ( int i=0; i<group->size(); i++ )
         {
             Satellite *sat = group->at( i );
-            if ( sat->selected() )
+            if ( sat->selected() && !sat->isOutdated() )
             {
                 bool drawn = false;
                 if ( Options::showVisibleSatellites() )
@@ -178,6 +197,7 @@ void SatellitesComponent::updateTLEs()
                 file.close();
                 group->readTLE();
                 group->updateSatellitesPos();
+                m_passes.clear();
                 progressDlg.setValue( ++i );
             }
             else
@@ -225,7 +245,7 @@ SkyObject* SatellitesComponent::objectNearest( SkyPoint* p, double& maxrad ) {
     foreach ( SatelliteGroup *group, m_groups ) {
         for ( int i=0; i<group->size(); i++ ) {
             Satellite *sat = group->at( i );
-            if ( ! sat->selected() )
+            if ( ! sat->selected() || sat->isOutdated() )
                 continue;
 
             r = sat->angularDistanceTo( p ).Degrees();
@@ -245,5 +265,58 @@ SkyObject* SatellitesComponent::objectNearest( SkyPoint* p, double& maxrad ) {
 
 SkyObject* SatellitesComponent::findByName( const QString &name )
 {
-     return nameHash[ name.toLower() ];
+     return nameHash.value( name.toLower() );
+}
+
+QList<SatellitePass> SatellitesComponent::passes( const KStarsDateTime &start, const KStarsDateTime &end, const GeoLocation *geo, bool selectedOnly )
+{
+    // Worker threads use their own copy of the location
+    GeoLocation location( *geo );
+
+    QString key = QString( "%1 %2 %3 %4 %5" ).arg( double( start.djd() ), 0, 'f', 8 ).arg( double( end.djd() ), 0, 'f', 8 )
+                  .arg( location.lng()->Degrees(), 0, 'f', 6 ).arg( location.lat()->Degrees(), 0, 'f', 6 ).arg( location.height() );
+    if ( key != m_passKey )
+    {
+        m_passes.clear();
+        m_passKey = key;
+    }
+
+    QList<Satellite *> sats;
+    QVector< QPair<Satellite *, QList<SatellitePass> > > missing;
+
+    foreach ( SatelliteGroup *group, m_groups )
+    {
+        foreach ( Satellite *sat, *group )
+        {
+            if ( selectedOnly && ! sat->selected() )
+                continue;
+
+            sats.append( sat );
+            if ( ! m_passes.contains( sat ) )
+                missing.append( qMakePair( sat, QList<SatellitePass>() ) );
+        }
+    }
+
+    if ( ! missing.isEmpty() )
+    {
+        // Observer and sun positions are computed once for all satellites
+        QVector<SatelliteEpoch> table = SatellitePass::epochTable( start.djd(), end.djd(), &location, PASS_STEP );
+
+        QtConcurrent::blockingMap( missing, [&table, &location]( QPair<Satellite *, QList<SatellitePass> > &sat ) {
+            sat.second = SatellitePass::predict( sat.first, table, &location );
+        } );
+
+        for ( int i=0; i<missing.size(); i++ )
+            m_passes.insert( missing[i].first, missing[i].second );
+    }
+
+    QList<SatellitePass> result;
+    foreach ( Satellite *sat, sats )
+        result.append( m_passes.value( sat ) );
+
+    std::sort( result.begin(), result.end(), []( const SatellitePass &a, const SatellitePass &b ) {
+        return a.rise < b.rise;
+    } );
+
+    return result;
 }
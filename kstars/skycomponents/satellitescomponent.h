@@ -24,7 +24,9 @@
 
 #include "skycomponent.h"
 #include "satellitegroup.h"
+#include "satellitepass.h"
 
+class GeoLocation;
 class Satellite;
 class FileDownloader;
 
@@ -103,6 +105,18 @@ public:
      */
     SkyObject* findByName( const QString &name );
 
+    /**
+     * @brief passes Predict the passes of satellites above the horizon.
+     * @param start beginning of the time window (UT)
+     * @param end end of the time window (UT)
+     * @param geo observer location
+     * @param selectedOnly if true, only the satellites selected for display are considered
+     * @return passes sorted by rise time
+     * @note Satellites are computed on worker threads. Their passes are kept until the TLEs, the time window or the
+     * location change, so asking again, or for more satellites, only computes the satellites that are missing.
+     */
+    QList<SatellitePass> passes( const KStarsDateTime &start, const KStarsDateTime &end, const GeoLocation *geo, bool selectedOnly=true );
+
     void loadData();
 
 protected:
@@ -112,6 +126,10 @@ protected:
 private:
     QList<SatelliteGroup*> m_groups;    // List of all groups
     QHash<QString, Satellite*> nameHash;
+
+    // Passes predicted for m_passKey, the time window and location
+    QString m_passKey;
+    QHash<const Satellite *, QList<SatellitePass> > m_passes;
 };
 
 #endif
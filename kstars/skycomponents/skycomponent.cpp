@@ -17,8 +17,10 @@
 
 #include "skycomponent.h"
 #include "skycomposite.h"
+#include "nameindex.h"
 
 #include <QList>
+#include <QMutexLocker>
 
 #include "Options.h"
 #include "ksnumbers.h"
@@ -29,7 +31,9 @@ SkyComponent::SkyComponent( SkyComposite *parent ) :
 {}
 
 SkyComponent::~SkyComponent()
-{}
+{
+    clearIndex();
+}
 
 //Hand the message up to SkyMapComposite
 void SkyComponent::emitProgressText( const QString &message ) {
@@ -59,7 +63,58 @@ QHash<int, QVector<QPair<QString, const SkyObject *>>>& SkyComponent::getObjectL
     return parent()->objectLists();
 }
 
+NameIndex* SkyComponent::getNameIndex() {
+    return parent() ? parent()->getNameIndex() : 0;
+}
+
+QMutex* SkyComponent::getObjectNamesMutex() {
+    return parent() ? parent()->getObjectNamesMutex() : 0;
+}
+
+void SkyComponent::objectListsChanged() {
+    if ( parent() )
+        parent()->objectListsChanged();
+}
+
+void SkyComponent::appendObjectName( int type, const QString &name, const SkyObject *obj ) {
+    QMutexLocker locker( getObjectNamesMutex() );
+    objectNames( type ).append( name );
+    objectLists( type ).append( QPair<QString, const SkyObject *>( name, obj ) );
+    objectListsChanged();
+}
+
+void SkyComponent::clearObjectNames( int type ) {
+    QMutexLocker locker( getObjectNamesMutex() );
+    objectNames( type ).clear();
+    objectLists( type ).clear();
+    objectListsChanged();
+}
+
+void SkyComponent::addToIndex(SkyObject *obj) {
+    NameIndex *index = getNameIndex();
+    if ( index )
+        index->add( obj, this );
+}
+
+void SkyComponent::addToIndex(const QString &name, SkyObject *obj) {
+    NameIndex *index = getNameIndex();
+    if ( index )
+        index->add( name, obj, this );
+}
+
+void SkyComponent::clearIndex() {
+    NameIndex *index = getNameIndex();
+    if ( index )
+        index->remove( this );
+}
+
+SkyObject* SkyComponent::findInIndex(const QString &name) {
+    NameIndex *index = getNameIndex();
+    return index ? index->find( name, this ) : 0;
+}
+
 void SkyComponent::removeFromNames(const SkyObject* obj) {
+    QMutexLocker locker( getObjectNamesMutex() );
     QStringList& names = getObjectNames()[obj->type()];
     int i;
     i = names.indexOf( obj->name() );
@@ -69,9 +124,11 @@ void SkyComponent::removeFromNames(const SkyObject* obj) {
     i = names.indexOf( obj->longname() );
     if ( i >= 0 )
         names.removeAt( i );
+    objectListsChanged();
 }
 
 void SkyComponent::removeFromLists(const SkyObject* obj) {
+    QMutexLocker locker( getObjectNamesMutex() );
     QVector<QPair<QString, const SkyObject*>>& names = getObjectLists()[obj->type()];
     int i;
     i = names.indexOf( QPair<QString, const SkyObject*>(obj->name(), obj) );
@@ -81,4 +138,5 @@ void SkyComponent::removeFromLists(const SkyObject* obj) {
     i = names.indexOf( QPair<QString, const SkyObject*>(obj->longname(),obj) );
     if ( i >= 0 )
         names.removeAt( i );
+    objectListsChanged();
 }
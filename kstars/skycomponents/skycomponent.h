@@ -20,6 +20,7 @@
 
 
 #include <QDebug>
+#include <QMutex>
 #include "typedef.h"
 
 class QString;
@@ -28,6 +29,7 @@ class KSNumbers;
 class SkyObject;
 class SkyPoint;
 class SkyComposite;
+class NameIndex;
 class SkyPainter;
 
 /**
@@ -211,14 +213,43 @@ public:
 
     inline QVector<QPair<QString, const SkyObject *>>& objectLists(int type) { return getObjectLists()[type]; }
 
+    /** @short Add @p name of @p obj to the names and the lists of the objects of @p type.
+     * Components load concurrently, so they add their names with this rather than through objectNames() and objectLists(). */
+    void appendObjectName( int type, const QString &name, const SkyObject *obj );
+
+    /** @short Remove all the names and the objects of @p type */
+    void clearObjectNames( int type );
+
 protected:
+    /** @return the lock of the object names and lists, or NULL while the sky map is being destroyed */
+    inline QMutex* objectNamesMutex() { return getObjectNamesMutex(); }
+
     void removeFromNames(const SkyObject* obj);
     void removeFromLists(const SkyObject* obj);
 
+    /** @short Make obj findable by its name, long name and alternate name in SkyMapComposite::findByName() */
+    void addToIndex(SkyObject *obj);
+
+    /** @short Make obj findable by an additional name, such as a catalog designation */
+    void addToIndex(const QString &name, SkyObject *obj);
+
+    /** @short Remove all objects this component added to the name index.
+     * Must be called before the objects are deleted. The destructor calls it too.
+     */
+    void clearIndex();
+
+    /** @return object with the given name that this component added to the name index, or NULL */
+    SkyObject* findInIndex(const QString &name);
+
 private:
     /** */
     virtual QHash<int, QStringList>& getObjectNames();
     virtual QHash<int, QVector<QPair<QString, const SkyObject *>>>& getObjectLists();
+    /** @return index shared by all components, or NULL while the sky map is being destroyed */
+    virtual NameIndex* getNameIndex();
+    virtual QMutex* getObjectNamesMutex();
+    /** @short Called whenever names or objects are added to or removed from the lists */
+    virtual void objectListsChanged();
 
     // Disallow copying and assignement
     SkyComponent(const SkyComponent&);
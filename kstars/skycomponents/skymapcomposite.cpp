@@ -19,6 +19,7 @@
 
 #include <QPolygonF>
 #include <QApplication>
+#include <QThread>
 
 #include "Options.h"
 #include "kstarsdata.h"
@@ -54,6 +55,8 @@
 #include "constellationartcomponent.h"
 #include "kscomet.h"
 #include "ksasteroid.h"
+#include "asteroidscomponent.h"
+#include "cometscomponent.h"
 
 #ifndef KSTARS_LITE
 #include "observinglist.h"
@@ -67,8 +70,13 @@
 #include "projections/projector.h"
 
 #include "typedef.h"
+#include "texturemanager.h"
+#include "auxiliary/startuploader.h"
+#ifndef KSTARS_LITE
+#include "skyqpainter.h"
+#endif
 
-SkyMapComposite::SkyMapComposite(SkyComposite *parent ) :
+SkyMapComposite::SkyMapComposite(SkyComposite *parent, StartupLoader *loader ) :
     SkyComposite(parent), m_reindexNum( J2000 )
 {
     m_skyLabeler = SkyLabeler::Instance();
@@ -80,98 +88,171 @@ SkyMapComposite::SkyMapComposite(SkyComposite *parent ) :
     // You can also set the debug level of individual
     // appendLine() and appendPoly() calls.
 
-    //Add all components
-    //Stars must come before constellation lines
-#ifdef KSTARS_LITE
-    addComponent( m_MilkyWay       = new MilkyWay( this ), 50);
-    addComponent( m_Stars          = StarComponent::Create( this ), 10);
-    addComponent( m_EquatorialCoordinateGrid = new EquatorialCoordinateGrid( this ));
-    addComponent( m_HorizontalCoordinateGrid = new HorizontalCoordinateGrid( this ));
-
-    // Do add to components.
-    addComponent( m_CBoundLines = new ConstellationBoundaryLines( this ), 80);
-    m_Cultures = new CultureList();
-    addComponent( m_CLines     = new ConstellationLines( this, m_Cultures ), 85);
-    addComponent( m_CNames     = new ConstellationNamesComponent( this, m_Cultures ), 90);
-    addComponent( m_Equator    = new Equator( this ), 95);
-    addComponent( m_Ecliptic   = new Ecliptic( this ), 95);
-    addComponent( m_Horizon    = new HorizonComponent( this ), 100);
-    addComponent( m_DeepSky    = new DeepSkyComponent( this ), 5);
-    addComponent(m_ConstellationArt    = new ConstellationArtComponent( this, m_Cultures ), 100);
+    connect( this, SIGNAL( progressText( const QString & ) ),
+             KStarsData::Instance(), SIGNAL( progressText( const QString & ) ) );
 
-    addComponent( m_ArtificialHorizon = new ArtificialHorizonComponent(this), 110);
+    // Planet textures are cached while loading the solar system, create the cache on the main thread
+    TextureManager::Create();
 
-    m_internetResolvedCat = "_Internet_Resolved";
-    m_manualAdditionsCat = "_Manual_Additions";
-    addComponent( m_internetResolvedComponent = new SyncedCatalogComponent( this, m_internetResolvedCat, true, 0 ), 6 );
-    addComponent( m_manualAdditionsComponent = new SyncedCatalogComponent( this, m_manualAdditionsCat, true, 0 ), 6 );
-    m_CustomCatalogs = new SkyComposite( this );
-    QStringList allcatalogs = Options::showCatalogNames();
-
-    if(!allcatalogs.contains(m_internetResolvedCat)) {
-        allcatalogs.append(m_internetResolvedCat);
-    }
-    if(!allcatalogs.contains(m_manualAdditionsCat)) {
-        allcatalogs.append(m_manualAdditionsCat);
+    // Components load concurrently and add their names under a lock. Create the lists of all types beforehand,
+    // so that reading the lists never inserts into the hashes.
+    for ( int i = 0; i < SkyObject::NUMBER_OF_KNOWN_TYPES; ++i ) {
+        m_ObjectNames[ i ];
+        m_ObjectLists[ i ];
     }
-    Options::setShowCatalogNames(allcatalogs);
 
-    for ( int i=0; i < allcatalogs.size(); ++ i ) {
-        if( allcatalogs.at(i) == m_internetResolvedCat || allcatalogs.at(i) == m_manualAdditionsCat ) // This is a special catalog
-            continue;
-        m_CustomCatalogs->addComponent(new CatalogComponent( this, allcatalogs.at(i), false, i ), 6 ); // FIXME: Should this be 6 or 5? See SkyMapComposite::reloadDeepSky()
-    }
+    // Components add their objects to the name index while they load
+    m_SolarSystem = 0;
+    m_DeepSky = 0;
+    m_CustomCatalogs = 0;
+    m_internetResolvedComponent = 0;
+    m_manualAdditionsComponent = 0;
+    m_CNames = 0;
+    m_Stars = 0;
+    m_Supernovae = 0;
+    m_Satellites = 0;
+    m_NameIndex.setRankFunction( [this]( SkyComponent *owner ) { return searchRank( owner ); } );
 
-    addComponent( m_SolarSystem = new SolarSystemComposite( this ), 2);
-
-    //addComponent( m_ObservingList = new TargetListComponent( this , 0, QPen(),
-    //                                                       &Options::obsListSymbol, &Options::obsListText ), 120 );
-    addComponent( m_StarHopRouteList = new TargetListComponent( this , 0, QPen() ), 130 );
-    addComponent( m_Satellites       = new SatellitesComponent( this ), 7 );
-    addComponent( m_Supernovae       = new SupernovaeComponent( this ), 7 );
-    SkyMapLite::Instance()->loadingFinished();
-#else
-    addComponent( m_MilkyWay       = new MilkyWay( this ), 50);
-    addComponent( m_Stars          = StarComponent::Create( this ), 10);
-    addComponent( m_EquatorialCoordinateGrid = new EquatorialCoordinateGrid( this ));
-    addComponent( m_HorizontalCoordinateGrid = new HorizontalCoordinateGrid( this ));
-
-    // Do add to components.
-    addComponent( m_CBoundLines = new ConstellationBoundaryLines( this ), 80);
     m_Cultures = new CultureList();
-    addComponent( m_CLines     = new ConstellationLines( this, m_Cultures ), 85);
-    addComponent( m_CNames     = new ConstellationNamesComponent( this, m_Cultures ), 90);
-    addComponent( m_Equator    = new Equator( this ), 95);
-    addComponent( m_Ecliptic   = new Ecliptic( this ), 95);
-    addComponent( m_Horizon    = new HorizonComponent( this ), 100);
-    addComponent( m_DeepSky    = new DeepSkyComponent( this ), 5);
-    addComponent(m_ConstellationArt    = new ConstellationArtComponent( this, m_Cultures ), 100);
-
-    addComponent( m_ArtificialHorizon = new ArtificialHorizonComponent(this), 110);
 
     m_internetResolvedCat = "_Internet_Resolved";
     m_manualAdditionsCat = "_Manual_Additions";
-    addComponent( m_internetResolvedComponent = new SyncedCatalogComponent( this, m_internetResolvedCat, true, 0 ), 6 );
-    addComponent( m_manualAdditionsComponent = new SyncedCatalogComponent( this, m_manualAdditionsCat, true, 0 ), 6 );
-    m_CustomCatalogs = new SkyComposite( this );
-    QStringList allcatalogs = Options::showCatalogNames();
-    for ( int i=0; i < allcatalogs.size(); ++ i ) {
-        if( allcatalogs.at(i) == m_internetResolvedCat || allcatalogs.at(i) == m_manualAdditionsCat ) // This is a special catalog
-            continue;
-        m_CustomCatalogs->addComponent(new CatalogComponent( this, allcatalogs.at(i), false, i ), 6 ); // FIXME: Should this be 6 or 5? See SkyMapComposite::reloadDeepSky()
-    }
-
-    addComponent( m_SolarSystem = new SolarSystemComposite( this ), 2);
-    addComponent( m_Flags       = new FlagComponent( this ), 4);
 
-    addComponent( m_ObservingList = new TargetListComponent( this , 0, QPen(),
-                                                             &Options::obsListSymbol, &Options::obsListText ), 120 );
-    addComponent( m_StarHopRouteList = new TargetListComponent( this , 0, QPen() ), 130 );
-    addComponent( m_Satellites       = new SatellitesComponent( this ), 7 );
-    addComponent( m_Supernovae       = new SupernovaeComponent( this ), 7 );
+    StartupLoader localLoader;
+    StartupLoader *taskLoader = loader ? loader : &localLoader;
+
+    // Tasks building line or object indexes write to the shared sky mesh and must not overlap.
+    // The stars also create the meshes of their catalogs, which the other tasks look up.
+    const QString mesh("SkyMesh");
+
+    taskLoader->addTask( "MilkyWay", i18n("Loading Milky Way"),
+                         [this]() { m_MilkyWay = new MilkyWay( this ); },
+                         QStringList(), StartupLoader::WorkerThread, mesh );
+    taskLoader->addTask( "Stars", i18n("Loading stars"),
+                         [this]() { m_Stars = StarComponent::Create( this ); },
+                         QStringList(), StartupLoader::WorkerThread, mesh );
+    taskLoader->addTask( "Guides", QString(),
+                         [this]() {
+                             m_EquatorialCoordinateGrid = new EquatorialCoordinateGrid( this );
+                             m_HorizontalCoordinateGrid = new HorizontalCoordinateGrid( this );
+                             m_Equator    = new Equator( this );
+                             m_Ecliptic   = new Ecliptic( this );
+                             m_Horizon    = new HorizonComponent( this );
+                         },
+                         QStringList(), StartupLoader::WorkerThread, mesh );
+    // The horizons are read from the user database, whose connection belongs to the main thread.
+    // Without a loader, the caller initialized the database beforehand.
+    taskLoader->addTask( "ArtificialHorizon", QString(),
+                         [this]() { m_ArtificialHorizon = new ArtificialHorizonComponent( this ); },
+                         loader ? QStringList() << "UserDB" : QStringList(), StartupLoader::MainThread, mesh );
+    taskLoader->addTask( "ConstellationBoundaries", i18n("Loading constellation boundaries"),
+                         [this]() { m_CBoundLines = new ConstellationBoundaryLines( this ); },
+                         QStringList(), StartupLoader::WorkerThread, mesh );
+    // Constellation lines are drawn between stars
+    taskLoader->addTask( "ConstellationLines", i18n("Loading constellation lines"),
+                         [this]() { m_CLines = new ConstellationLines( this, m_Cultures ); },
+                         QStringList() << "Stars", StartupLoader::WorkerThread, mesh );
+    taskLoader->addTask( "ConstellationNames", QString(),
+                         [this]() { m_CNames = new ConstellationNamesComponent( this, m_Cultures ); } );
+    // Uses its own database connection and loads images, keep it on the main thread
+    taskLoader->addTask( "ConstellationArt", i18n("Loading constellation art"),
+                         [this]() { m_ConstellationArt = new ConstellationArtComponent( this, m_Cultures ); },
+                         QStringList(), StartupLoader::MainThread );
+    taskLoader->addTask( "DeepSky", i18n("Loading deep sky objects"),
+                         [this]() { m_DeepSky = new DeepSkyComponent( this ); },
+                         QStringList(), StartupLoader::WorkerThread, mesh );
+    // Catalogs use the catalog database owned by the main thread, and share object types with the deep sky objects
+    taskLoader->addTask( "Catalogs", i18n("Loading custom catalogs"),
+                         [this]() {
+                             m_internetResolvedComponent = new SyncedCatalogComponent( this, m_internetResolvedCat, true, 0 );
+                             m_manualAdditionsComponent = new SyncedCatalogComponent( this, m_manualAdditionsCat, true, 0 );
+                             m_CustomCatalogs = new SkyComposite( this );
+                             QStringList allcatalogs = Options::showCatalogNames();
+#ifdef KSTARS_LITE
+                             if(!allcatalogs.contains(m_internetResolvedCat)) {
+                                 allcatalogs.append(m_internetResolvedCat);
+                             }
+                             if(!allcatalogs.contains(m_manualAdditionsCat)) {
+                                 allcatalogs.append(m_manualAdditionsCat);
+                             }
+                             Options::setShowCatalogNames(allcatalogs);
 #endif
-    connect( this, SIGNAL( progressText( const QString & ) ),
-             KStarsData::Instance(), SIGNAL( progressText( const QString & ) ) );
+                             for ( int i=0; i < allcatalogs.size(); ++ i ) {
+                                 if( allcatalogs.at(i) == m_internetResolvedCat || allcatalogs.at(i) == m_manualAdditionsCat ) // This is a special catalog
+                                     continue;
+                                 m_CustomCatalogs->addComponent(new CatalogComponent( this, allcatalogs.at(i), false, i ), 6 ); // FIXME: Should this be 6 or 5? See SkyMapComposite::reloadDeepSky()
+                             }
+                         },
+                         QStringList() << "DeepSky", StartupLoader::MainThread );
+    taskLoader->addTask( "SolarSystem", i18n("Loading solar system"),
+                         [this]() {
+                             m_SolarSystem = new SolarSystemComposite( this );
+                             // Updates of the orbital elements are downloaded later on, the replies must reach
+                             // the components in the main thread rather than in this worker without an event loop
+                             m_SolarSystem->asteroidsComponent()->moveToThread( qApp->thread() );
+                             m_SolarSystem->cometsComponent()->moveToThread( qApp->thread() );
+                         } );
+    // Satellites and supernovae load their data asynchronously on their own
+    taskLoader->addTask( "Transients", QString(),
+                         [this]() {
+#ifndef KSTARS_LITE
+                             m_Flags = new FlagComponent( this );
+                             m_ObservingList = new TargetListComponent( this , 0, QPen(),
+                                                                        &Options::obsListSymbol, &Options::obsListText );
+#endif
+                             m_StarHopRouteList = new TargetListComponent( this , 0, QPen() );
+                             m_Satellites       = new SatellitesComponent( this );
+                             m_Supernovae       = new SupernovaeComponent( this );
+                         },
+                         QStringList(), StartupLoader::MainThread );
+
+    // Add all components in a fixed order once everything is loaded, regardless of the order the tasks completed in.
+    taskLoader->addTask( "SkyComposite", QString(),
+                         [this]() {
+#ifndef KSTARS_LITE
+                             // Star images are pixmaps, they can only be created on the main thread
+                             SkyQPainter::initStarImages();
+#endif
+                             //Stars must come before constellation lines
+                             addComponent( m_MilkyWay, 50 );
+                             addComponent( m_Stars, 10 );
+                             addComponent( m_EquatorialCoordinateGrid );
+                             addComponent( m_HorizontalCoordinateGrid );
+
+                             // Do add to components.
+                             addComponent( m_CBoundLines, 80 );
+                             addComponent( m_CLines, 85 );
+                             addComponent( m_CNames, 90 );
+                             addComponent( m_Equator, 95 );
+                             addComponent( m_Ecliptic, 95 );
+                             addComponent( m_Horizon, 100 );
+                             addComponent( m_DeepSky, 5 );
+                             addComponent( m_ConstellationArt, 100 );
+
+                             addComponent( m_ArtificialHorizon, 110 );
+
+                             addComponent( m_internetResolvedComponent, 6 );
+                             addComponent( m_manualAdditionsComponent, 6 );
+
+                             addComponent( m_SolarSystem, 2 );
+#ifndef KSTARS_LITE
+                             addComponent( m_Flags, 4 );
+                             addComponent( m_ObservingList, 120 );
+#endif
+                             addComponent( m_StarHopRouteList, 130 );
+                             addComponent( m_Satellites, 7 );
+                             addComponent( m_Supernovae, 7 );
+#ifdef KSTARS_LITE
+                             SkyMapLite::Instance()->loadingFinished();
+#endif
+                         },
+                         QStringList() << "MilkyWay" << "Stars" << "Guides" << "ArtificialHorizon" << "ConstellationBoundaries" << "ConstellationLines"
+                                       << "ConstellationNames" << "ConstellationArt" << "DeepSky" << "Catalogs" << "SolarSystem"
+                                       << "Transients",
+                         StartupLoader::MainThread );
+
+    if ( loader == 0 )
+        localLoader.run();
 }
 
 SkyMapComposite::~SkyMapComposite()
@@ -294,7 +375,7 @@ void SkyMapComposite::draw( SkyPainter *skyp )
         if( Options::obsListText() )
             foreach( QSharedPointer<SkyObject> obj_clone, obsList ) {
                 // Find the "original" obj
-                SkyObject *o = findByName( obj_clone->name() ); // FIXME: This is sloww.... and can also fail!!!
+                SkyObject *o = findByName( obj_clone->name() ); // FIXME: This can fail if the object was reloaded
                 if ( !o )
                     continue;
                 SkyLabeler::AddLabel( o, SkyLabeler::RUDE_LABEL );
@@ -544,33 +625,49 @@ QList<SkyObject*> SkyMapComposite::findObjectsInArea( const SkyPoint& p1, const
 }
 
 SkyObject* SkyMapComposite::findByName( const QString &name ) {
-    //We search the children in an "intelligent" order (most-used
-    //object types first), in order to avoid wasting too much time
-    //looking for a match.  The most important part of this ordering
-    //is that stars should be last (because the stars list is so long)
-    SkyObject *o = 0;
-    o = m_SolarSystem->findByName( name );
-    if ( o ) return o;
-    o = m_DeepSky->findByName( name );
-    if ( o ) return o;
-    o = m_CustomCatalogs->findByName( name );
-    if ( o ) return o;
-    o = m_internetResolvedComponent->findByName( name );
-    if ( o ) return o;
-    o = m_manualAdditionsComponent->findByName( name );
-    if ( o ) return o;
-    o = m_CNames->findByName( name );
-    if ( o ) return o;
-    o = m_Stars->findByName( name );
-    if ( o ) return o;
-    o = m_Supernovae->findByName(name);
-    if ( o ) return o;
-    o = m_Satellites->findByName(name);
+    SkyObject *o = m_NameIndex.find( name );
     if ( o ) return o;
 
+    // Satellites keep their own hash, they are reloaded when their TLEs are updated
+    if ( m_Satellites )
+        return m_Satellites->findByName( name );
+
     return 0;
 }
 
+int SkyMapComposite::searchRank( SkyComponent *owner ) {
+    //We prefer the most used object types, in the order
+    //findByName() used to search the components. Stars come last.
+    if ( m_internetResolvedComponent && owner == m_internetResolvedComponent ) return 3;
+    if ( m_manualAdditionsComponent && owner == m_manualAdditionsComponent ) return 4;
+    if ( m_CustomCatalogs && m_CustomCatalogs->components().contains( owner ) ) return 2;
+
+    SkyComponent *top = owner;
+    while ( top && top->parent() && top->parent() != this )
+        top = top->parent();
+
+    if ( top == 0 ) return 9;
+    if ( top == m_SolarSystem ) return 0;
+    if ( top == m_DeepSky ) return 1;
+    if ( top == m_CNames ) return 5;
+    if ( top == m_Stars ) return 6;
+    if ( top == m_Supernovae ) return 7;
+
+    return 8;
+}
+
+NameIndex* SkyMapComposite::getNameIndex() {
+    return &m_NameIndex;
+}
+
+QMutex* SkyMapComposite::getObjectNamesMutex() {
+    return &m_ObjectNamesMutex;
+}
+
+void SkyMapComposite::objectListsChanged() {
+    m_ObjectListsRevision.ref();
+}
+
 
 SkyObject* SkyMapComposite::findStarByGenetiveName( const QString name ) {
     return m_Stars->findStarByGenetiveName( name );
@@ -606,6 +703,7 @@ void SkyMapComposite::removeCustomCatalog( const QString &name ) {
 
         if ( ccc->name() == name ) {
             m_CustomCatalogs->removeComponent( ccc );
+            m_NameIndex.remove( ccc );
             return;
         }
     }
@@ -632,7 +730,7 @@ void SkyMapComposite::reloadCNames( ) {
     //     m_CNames = 0;
     //     m_CNames = new ConstellationNamesComponent( this, m_Cultures );
     //     SkyMapDrawAbstract::setDrawLock( false );
-    objectNames(SkyObject::CONSTELLATION).clear();
+    clearObjectNames( SkyObject::CONSTELLATION );
     delete m_CNames;
     m_CNames = new ConstellationNamesComponent( this, m_Cultures );
 }
@@ -704,7 +802,9 @@ void SkyMapComposite::emitProgressText( const QString &message ) {
     emit progressText( message );
 #ifndef Q_OS_ANDROID
     //Can cause crashes on Android, investigate it
-    qApp->processEvents();         // -jbb: this seemed to make it work.
+    // Components may be loading on a worker thread, in which case the startup loader processes events for us
+    if ( QThread::currentThread() == qApp->thread() )
+        qApp->processEvents();         // -jbb: this seemed to make it work.
 #endif
     //qDebug() << QString("PROGRESS TEXT: %1\n").arg( message );
 }
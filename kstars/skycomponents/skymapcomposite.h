@@ -19,10 +19,12 @@
 #define SKYMAPCOMPOSITE_H
 
 #include <QList>
+#include <QAtomicInt>
 
 #include "skycomposite.h"
 #include "ksnumbers.h"
 #include "skyobject.h"
+#include "nameindex.h"
 
 class SkyMesh;
 class SkyLabeler;
@@ -57,6 +59,7 @@ class KSPlanetBase;
 class KSPlanet;
 class ConstellationsArt;
 class SyncedCatalogComponent;
+class StartupLoader;
 
 /** @class SkyMapComposite
 *SkyMapComposite is the root object in the object hierarchy of the sky map.
@@ -75,8 +78,10 @@ public:
     /**
     	*Constructor
     	*@p parent pointer to the parent SkyComponent
+    	*@p loader If set, the components are loaded as tasks of this loader and the composite is only complete once the
+    	*loader has run. Otherwise the components are loaded before the constructor returns.
     	*/
-    explicit SkyMapComposite(SkyComposite *parent);
+    explicit SkyMapComposite(SkyComposite *parent, StartupLoader *loader=0);
 
     ~SkyMapComposite();
 
@@ -142,9 +147,10 @@ public:
     	*a SkyObject whose name matches the argument.
     	*
     	*The objects' primary, secondary and long-form names will 
-    	*all be checked for a match.
-    	*@note Overloaded from SkyComposite.  In this version, we search 
-    	*the most likely object classes first to be more efficient.
+    	*all be checked for a match, ignoring case and white space.
+    	*@note Overloaded from SkyComposite.  In this version, the name is
+    	*looked up in the name index the components maintain. If several
+    	*objects share the name, the most likely object class wins.
     	*@p name the name to be matched
     	*@return a pointer to the SkyObject whose name matches
     	*the argument, or a NULL pointer if no match was found.
@@ -227,6 +233,10 @@ public:
 
     QList<SkyComponent*> customCatalogs();
 
+    /** @return a number that changes whenever names or objects are added to or removed from objectLists().
+     * Anything referring to the objects of the lists must be built again when it changes. */
+    inline int objectListsRevision() const { return m_ObjectListsRevision.load(); }
+
     inline TargetListComponent *getStarHopRouteList() { return m_StarHopRouteList; }
 signals:
     void progressText( const QString &message );
@@ -234,7 +244,13 @@ signals:
 private:
     virtual QHash<int, QStringList>& getObjectNames();
     virtual QHash<int, QVector<QPair<QString, const SkyObject*>>>& getObjectLists();
-    
+    virtual NameIndex* getNameIndex();
+    virtual QMutex* getObjectNamesMutex();
+    virtual void objectListsChanged();
+
+    /** @return search priority of objects added to the name index by owner, lower is preferred */
+    int searchRank( SkyComponent *owner );
+
     CultureList                 *m_Cultures;
     ConstellationBoundaryLines  *m_CBoundLines;
     ConstellationNamesComponent *m_CNames;
@@ -269,6 +285,10 @@ private:
     QList<SkyObject*>       m_LabeledObjects;
     QHash<int, QStringList> m_ObjectNames;
     QHash<int, QVector<QPair<QString, const SkyObject*>>> m_ObjectLists;
+    // Guards m_ObjectNames and m_ObjectLists while the components load
+    QMutex                  m_ObjectNamesMutex;
+    QAtomicInt              m_ObjectListsRevision;
+    NameIndex               m_NameIndex;
     QHash<QString, QString> m_ConstellationNames;
     QString m_internetResolvedCat; // Holds the name of the internet resolved catalog
     QString m_manualAdditionsCat;
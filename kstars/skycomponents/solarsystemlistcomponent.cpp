@@ -25,12 +25,14 @@
 #include "skyobjects/ksplanet.h"
 #include "skyobjects/ksplanetbase.h"
 #include "kstarsdata.h"
+#include "ksnumbers.h"
 #ifndef KSTARS_LITE
 #include "skymap.h"
 #endif
 
 SolarSystemListComponent::SolarSystemListComponent( SolarSystemComposite *p ) :
     ListComponent( p ),
+    m_Index( SkyMesh::Instance() ),
     m_Earth( p->earth() )
 {}
 
@@ -53,6 +55,22 @@ void SolarSystemListComponent::update(KSNumbers * ) {
 void SolarSystemListComponent::updateSolarSystemBodies(KSNumbers *num ) {
     if ( selected() ) {
         KStarsData *data = KStarsData::Instance(); 
+
+        if ( m_Elements.size() == m_ObjectList.size() ) {
+            // Solve the orbits in one batch, then find the coordinates of each object from its heliocentric position
+            const QVector<OrbitPosition> positions = m_Elements.solve( num->julianDay() );
+            for ( int i=0; i<m_ObjectList.size(); ++i ) {
+                KSPlanetBase *p = (KSPlanetBase*)m_ObjectList[i];
+                p->findPosition( num, data->geo()->lat(), data->lst(), m_Earth, positions[i] );
+                p->EquatorialToHorizontal( data->lst(), data->geo()->lat() );
+
+                if ( p->hasTrail() )
+                    p->updateTrail( data->lst(), data->geo()->lat() );
+            }
+            m_Index.update( m_ObjectList, num );
+            return;
+        }
+
         foreach ( SkyObject *o, m_ObjectList ) {
             KSPlanetBase *p = (KSPlanetBase*)o;
             p->findPosition( num, data->geo()->lat(), data->lst(), m_Earth );
@@ -61,14 +79,25 @@ void SolarSystemListComponent::updateSolarSystemBodies(KSNumbers *num ) {
             if ( p->hasTrail() )
                 p->updateTrail( data->lst(), data->geo()->lat() );
         }
+        m_Index.update( m_ObjectList, num );
     }
 }
 
+const MovingObjectIndex & SolarSystemListComponent::trixelIndex() {
+    if ( m_Index.count() != m_ObjectList.size() )
+        m_Index.update( m_ObjectList, KStarsData::Instance()->updateNum() );
+    return m_Index;
+}
+
 
 void SolarSystemListComponent::drawTrails( SkyPainter *skyp ) {
-    //FIXME: here for all objects trails are drawn this could be source of inefficiency
-    if( selected() )
-        foreach( SkyObject *obj, m_ObjectList )
-            // Will segfault if not TrailObject
-            dynamic_cast<TrailObject*>(obj)->drawTrail(skyp);
+    if( ! selected() )
+        return;
+
+    // Most objects have no trail, skip them without a cast
+    foreach( SkyObject *obj, m_ObjectList ) {
+        TrailObject *p = static_cast<KSPlanetBase*>(obj);
+        if( p->hasTrail() )
+            p->drawTrail(skyp);
+    }
 }
@@ -19,6 +19,8 @@
 #define SOLARSYSTEMLISTCOMPONENT_H
 
 #include "listcomponent.h"
+#include "movingobjectindex.h"
+#include "skyobjects/orbitalelements.h"
 
 class KSPlanet;
 class SolarSystemComposite;
@@ -49,6 +51,17 @@ public:
 protected:
     void drawTrails( SkyPainter* skyp );
 
+    /** @return the trixel index of the objects, rebuilt first if objects were added or removed since the last update */
+    const MovingObjectIndex & trixelIndex();
+
+    /** Orbital elements of the objects, in the order of m_ObjectList. Filled by the subclasses when they load their
+     * objects, it lets updateSolarSystemBodies() compute all the heliocentric positions in one batch. */
+    OrbitalElements m_Elements;
+
+    /** Objects of m_ObjectList by trixel of their current position, rebuilt each time the positions are updated.
+     * The subclasses must clear it before deleting the objects. */
+    MovingObjectIndex m_Index;
+
 private:
     KSPlanet *m_Earth;
 };
@@ -27,9 +27,6 @@
 #include "kstarsdata.h"
 #include "skymap.h"
 #include "skyobjects/starobject.h"
-#ifndef KSTARS_LITE
-#include "skyqpainter.h"
-#endif
 #include "skypainter.h"
 
 #include "skymesh.h"
@@ -82,10 +79,8 @@ StarComponent::StarComponent(SkyComposite *parent )
     // The following works but can cause crashes sometimes
     //QtConcurrent::run(this, &StarComponent::loadDeepStarCatalogs);
 
-    //In KStars Lite star images are initialized in SkyMapLite
-#ifndef KSTARS_LITE
-    SkyQPainter::initStarImages();
-#endif
+    // Star images are initialized by SkyMapComposite on the main thread since we may be loading on a worker thread.
+    // In KStars Lite star images are initialized in SkyMapLite
 }
 
 StarComponent::~StarComponent() {
@@ -509,19 +504,27 @@ bool StarComponent::loadStaticData()
             //if ( ! name.isEmpty() && name != i18n("star"))
             if (named)
             {
-                objectNames(SkyObject::STAR).append( name );
-                objectLists(SkyObject::STAR).append(QPair<QString, const SkyObject*>(name,star));
+                appendObjectName( SkyObject::STAR, name, star );
             }
 
             if ( ! visibleName.isEmpty() && gname != name )
             {
                 QString gName = star -> gname(false);
-                objectNames(SkyObject::STAR).append( gName );
-                objectLists(SkyObject::STAR).append(QPair<QString, const SkyObject*>(gName,star));
+                appendObjectName( SkyObject::STAR, gName, star );
             }
 
             m_ObjectList.append( star );
 
+            // Index the designations too, the long name of stars without one is just "star"
+            if ( named )
+                addToIndex( name, star );
+            if ( ! star->name2().isEmpty() )
+                addToIndex( star->name2(), star );
+            if ( gnamed )
+                addToIndex( star->gname(false), star );
+            if ( stardata.HD )
+                addToIndex( QString("HD %1").arg(stardata.HD), star );
+
             m_starIndex->at( trixel )->append( star );
             double pm = star->pmMagnitude();
             for (int z = 0; z < m_highPMStars.size(); z++ )
@@ -554,18 +557,6 @@ SkyObject* StarComponent::findStarByGenetiveName( const QString name ) {
     return m_genName.value( name );
 }
 
-// Overrides ListComponent::findByName() to include genetive name and HD index also in the search
-SkyObject* StarComponent::findByName( const QString &name ) {
-    foreach(SkyObject* o, m_ObjectList) {
-        if ( QString::compare( o->name(), name, Qt::CaseInsensitive ) == 0 ||
-             QString::compare( o->longname(), name, Qt::CaseInsensitive ) == 0 ||
-             QString::compare( o->name2(), name, Qt::CaseInsensitive ) == 0 ||
-             QString::compare( ((StarObject *)o)->gname(false), name, Qt::CaseInsensitive ) == 0)
-            return o;
-    }
-    return 0;
-}
-
 void StarComponent::objectsInArea( QList<SkyObject*>& list, const SkyRegion& region )
 {
     for( SkyRegion::const_iterator it = region.constBegin(); it != region.constEnd(); ++it )
@@ -99,18 +99,6 @@ public:
 
     virtual SkyObject* findStarByGenetiveName( const QString name );
 
-    /**
-     *@short Find stars by name (including genetive name)
-     *
-     * Overrides ListComponent::findByName() to include genetive names of stars
-     * as well.
-     *
-     *@param name  Name to search for. Could be trivial name or genetive name
-     *@return  Pointer to the star with the given name as a SkyObject, NULL if
-     *         no match was found
-     */
-    virtual SkyObject* findByName( const QString &name );
-
     /**
      * @short Searches the region(s) and appends the SkyObjects found to the list of sky objects
      *
@@ -62,11 +62,11 @@ bool SupernovaeComponent::selected()
 
 void SupernovaeComponent::loadData()
 {
+    clearIndex();
     qDeleteAll(m_ObjectList);
     m_ObjectList.clear();
 
-    objectNames(SkyObject::SUPERNOVA).clear();    
-    objectLists(SkyObject::SUPERNOVA).clear();
+    clearObjectNames( SkyObject::SUPERNOVA );
 
     QString name, type, host, date, ra, de;
     float z, mag;
@@ -126,22 +126,10 @@ void SupernovaeComponent::loadData()
 
         Supernova * sup = new Supernova(name, dms::fromString(ra, false), dms::fromString(de, true), type, host, date, z, mag);
 
-        objectNames(SkyObject::SUPERNOVA).append(name);
-
         m_ObjectList.append(sup);
-        objectLists( SkyObject::SUPERNOVA ).append(QPair<QString, const SkyObject*>(name,sup));
-    }
-}
-
-SkyObject* SupernovaeComponent::findByName(const QString& name)
-{
-    foreach (SkyObject* o, m_ObjectList)
-    {
-         if( QString::compare( o->name(),name, Qt::CaseInsensitive ) == 0 )
-             return o;
+        addToIndex(sup);
+        appendObjectName( SkyObject::SUPERNOVA, name, sup );
     }
-    //if no object is found then..
-    return NULL;
 }
 
 SkyObject* SupernovaeComponent::objectNearest(SkyPoint* p, double& maxrad)
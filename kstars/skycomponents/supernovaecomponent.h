@@ -39,7 +39,6 @@ public:
     virtual ~SupernovaeComponent();
     virtual bool selected();
     virtual void update(KSNumbers* num = 0);
-    virtual SkyObject* findByName(const QString& name);
     virtual SkyObject* objectNearest(SkyPoint* p, double& maxrad);
 
     /**
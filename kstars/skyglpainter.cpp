@@ -601,6 +601,16 @@ bool SkyGLPainter::drawConstellationArtImage(ConstellationsArt *obj)
 {
 }
 
+void SkyGLPainter::drawScreenPolyline(const QPointF *points, int count)
+{
+    glDisable( GL_TEXTURE_2D );
+    glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+    glBegin( GL_LINE_STRIP );
+    for( int i = 0; i < count; ++i )
+        glVertex2f( points[i].x(), points[i].y() );
+    glEnd();
+}
+
 void SkyGLPainter::drawSkyLine(SkyPoint* a, SkyPoint* b)
 {
     bool aVisible, bVisible;
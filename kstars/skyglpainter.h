@@ -40,6 +40,7 @@ public:
     virtual void drawSkyPolygon(LineList* list, bool forceClip=true);
     virtual void drawSkyPolyline(LineList* list, SkipList* skipList = 0, LineListLabel* label = 0);
     virtual void drawSkyLine(SkyPoint* a, SkyPoint* b);
+    virtual void drawScreenPolyline(const QPointF *points, int count);
     virtual void drawSkyBackground();
     virtual void drawObservingList(const QList<SkyObject*>& obs);
     virtual void drawFlags();
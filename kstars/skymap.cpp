@@ -57,6 +57,7 @@
 #include "skyobjects/skyobject.h"
 #include "skyobjects/deepskyobject.h"
 #include "skyobjects/ksplanetbase.h"
+#include "skyobjects/satellite.h"
 #include "skycomponents/skymapcomposite.h"
 #include "skycomponents/flagcomponent.h"
 #include "widgets/infoboxwidget.h"
@@ -322,10 +323,15 @@ void SkyMap::slotTransientLabel() {
 //Slots
 
 void SkyMap::setClickedObject( SkyObject *o ) {
-      ClickedObject = o;
+    // Satellites below the horizon may not have been computed with the last update
+    if ( o && o->type() == SkyObject::SATELLITE )
+        static_cast<Satellite *>( o )->updatePosIfOutdated();
+    ClickedObject = o;
 }
 
 void SkyMap::setFocusObject( SkyObject *o ) {
+    if ( o && o->type() == SkyObject::SATELLITE )
+        static_cast<Satellite *>( o )->updatePosIfOutdated();
     FocusObject = o;
     if ( FocusObject )
         Options::setFocusObject( FocusObject->name() );
@@ -71,7 +71,8 @@ bool KSAsteroid::findGeocentricPosition( const KSNumbers *num, const KSPlanetBas
 
     //v is the true anomaly; r is the distance from the Sun
     double v = atan2( yv, xv ) / dms::DegToRad;
-    double r = sqrt( xv*xv + yv*yv );
+    OrbitPosition helio;
+    helio.r = sqrt( xv*xv + yv*yv );
 
     //vw is the sum of the true anomaly and the argument of perihelion
     dms vw( v + w.Degrees() );
@@ -82,9 +83,15 @@ bool KSAsteroid::findGeocentricPosition( const KSNumbers *num, const KSPlanetBas
     i.SinCos( sini, cosi );
 
     //xh, yh, zh are the heliocentric cartesian coords with the ecliptic plane congruent with zh=0.
-    double xh = r * ( cosN * cosvw - sinN * sinvw * cosi );
-    double yh = r * ( sinN * cosvw + cosN * sinvw * cosi );
-    double zh = r * ( sinvw * sini );
+    helio.x = helio.r * ( cosN * cosvw - sinN * sinvw * cosi );
+    helio.y = helio.r * ( sinN * cosvw + cosN * sinvw * cosi );
+    helio.z = helio.r * ( sinvw * sini );
+
+    return findGeocentricPositionFrom( helio, num, Earth );
+}
+
+bool KSAsteroid::findGeocentricPositionFrom( const OrbitPosition &helio, const KSNumbers *num, const KSPlanetBase *Earth ) {
+    double xh = helio.x, yh = helio.y, zh = helio.z, r = helio.r;
 
     //the spherical ecliptic coordinates:
     double ELongRad = atan2( yh, xh );
@@ -22,6 +22,7 @@
 
 class KSNumbers;
 class dms;
+class OrbitalElements;
 
 /** @class KSAsteroid
 	*@short A subclass of KSPlanetBase that implements asteroids.
@@ -191,6 +192,11 @@ protected:
     	*/
     virtual bool findGeocentricPosition( const KSNumbers *num, const KSPlanetBase *Earth=NULL );
 
+    /** Calculate the geocentric RA, Dec coordinates of the Asteroid from its heliocentric position.
+        *@note reimplemented from KSPlanetBase
+        */
+    virtual bool findGeocentricPositionFrom( const OrbitPosition &helio, const KSNumbers *num, const KSPlanetBase *Earth );
+
     //these set functions are needed for the new KSPluto subclass
     void set_a( double newa ) { a = newa; }
     void set_e( double newe ) { e = newe; }
@@ -202,6 +208,7 @@ protected:
     void setJD( long double jd ) { JD = jd; }
 
 private:
+    friend class OrbitalElements;
     virtual void findMagnitude(const KSNumbers*);
     
     int catN;
@@ -221,9 +221,17 @@ bool KSComet::findGeocentricPosition( const KSNumbers *num, const KSPlanetBase *
     i.SinCos( sini, cosi );
 
     //xh, yh, zh are the heliocentric cartesian coords with the ecliptic plane congruent with zh=0.
-    double xh = r * ( cosN * cosvw - sinN * sinvw * cosi );
-    double yh = r * ( sinN * cosvw + cosN * sinvw * cosi );
-    double zh = r * ( sinvw * sini );
+    OrbitPosition helio;
+    helio.x = r * ( cosN * cosvw - sinN * sinvw * cosi );
+    helio.y = r * ( sinN * cosvw + cosN * sinvw * cosi );
+    helio.z = r * ( sinvw * sini );
+    helio.r = r;
+
+    return findGeocentricPositionFrom( helio, num, Earth );
+}
+
+bool KSComet::findGeocentricPositionFrom( const OrbitPosition &helio, const KSNumbers *num, const KSPlanetBase *Earth ) {
+    double xh = helio.x, yh = helio.y, zh = helio.z, r = helio.r;
 
     //the spherical ecliptic coordinates:
     double ELongRad = atan2( yh, xh );
@@ -46,6 +46,7 @@
 
 class KSNumbers;
 class dms;
+class OrbitalElements;
 
 class KSComet : public KSPlanetBase
 {
@@ -237,6 +238,11 @@ protected:
         */
     virtual bool findGeocentricPosition( const KSNumbers *num, const KSPlanetBase *Earth=NULL );
 
+    /** Calculate the geocentric RA, Dec coordinates of the Comet from its heliocentric position.
+        *@note reimplemented from KSPlanetBase
+        */
+    virtual bool findGeocentricPositionFrom( const OrbitPosition &helio, const KSNumbers *num, const KSPlanetBase *Earth );
+
     /**
      *@short Estimate physical parameters of the comet such as coma size, tail length and size of the nucleus
      *@note invoked from findGeocentricPosition in order
@@ -245,6 +251,7 @@ protected:
 
 
 private:
+    friend class OrbitalElements;
     virtual void findMagnitude(const KSNumbers*);
     
     long double JD, JDp;
@@ -70,7 +70,7 @@ bool KSPlanet::OrbitDataManager::loadData( KSPlanet::OrbitDataColl &odc, const Q
     QString nl = n.toLower();
 
     if ( hash.contains( nl ) ) {
-        odc = hash[nl];
+        odc = hash.value( nl );
         return true;  //orbit data already loaded
     }
 
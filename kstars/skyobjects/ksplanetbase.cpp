@@ -22,6 +22,7 @@
 #include <QFile>
 #include <QPoint>
 #include <QMatrix>
+#include <QtConcurrent>
 
 #include "nan.h"
 #include "kstarsdata.h"
@@ -113,7 +114,7 @@ void KSPlanetBase::updateCoords( const KSNumbers *num, bool includePlanets, cons
             findPosition( num, lat, LST, kd->skyComposite()->earth() );
             //Don't add to the trail this time
             if( hasTrail() )
-                Trail.takeLast();
+                Trail.removeLast();
         } else {
             findGeocentricPosition( num, kd->skyComposite()->earth() );
         }
@@ -123,6 +124,19 @@ void KSPlanetBase::updateCoords( const KSNumbers *num, bool includePlanets, cons
 void KSPlanetBase::findPosition( const KSNumbers *num, const CachingDms *lat, const CachingDms *LST, const KSPlanetBase *Earth ) {
     // DEBUG edit
     findGeocentricPosition( num, Earth );  //private function, reimplemented in each subclass
+    findDependentQuantities( num, lat, LST );
+}
+
+void KSPlanetBase::findPosition( const KSNumbers *num, const CachingDms *lat, const CachingDms *LST, const KSPlanetBase *Earth, const OrbitPosition &helio ) {
+    findGeocentricPositionFrom( helio, num, Earth );
+    findDependentQuantities( num, lat, LST );
+}
+
+bool KSPlanetBase::findGeocentricPositionFrom( const OrbitPosition &, const KSNumbers *num, const KSPlanetBase *Earth ) {
+    return findGeocentricPosition( num, Earth );
+}
+
+void KSPlanetBase::findDependentQuantities( const KSNumbers *num, const CachingDms *lat, const CachingDms *LST ) {
     findPhase();
     setAngularSize( asin(physicalSize()/Rearth/AU_KM)*60.*180./dms::PI ); //angular size in arcmin
 
@@ -149,6 +163,67 @@ void KSPlanetBase::findPosition( const KSNumbers *num, const CachingDms *lat, co
 
 }
 
+QVector< QVector<EphemerisPoint> > KSPlanetBase::ephemeris( const QList<const KSPlanetBase *> &bodies, const QVector<double> &jds, const GeoLocation *geo, const KSPlanetBase *Earth ) {
+    QVector< QVector<EphemerisPoint> > result( bodies.size() );
+    QVector<EphemerisPoint *> points( bodies.size() );
+    for ( int i=0; i<bodies.size(); ++i ) {
+        result[i].resize( jds.size() );
+        points[i] = result[i].data();
+    }
+
+    if ( bodies.isEmpty() || jds.isEmpty() )
+        return result;
+
+    const KSPlanetBase *earth = Earth ? Earth : KStarsData::Instance()->skyComposite()->earth();
+
+    // Each worker handles a range of times with its own copies of the bodies
+    const int chunkSize = 32;
+    QVector<int> chunks;
+    for ( int first=0; first<jds.size(); first+=chunkSize )
+        chunks.append( first );
+
+    QtConcurrent::blockingMap( chunks, [&]( int first ) {
+        QScopedPointer<KSPlanetBase> earthCopy( static_cast<KSPlanetBase *>( earth->clone() ) );
+        QList<KSPlanetBase *> copies;
+        foreach ( const KSPlanetBase *body, bodies )
+            copies.append( static_cast<KSPlanetBase *>( body->clone() ) );
+
+        int last = qMin( first + chunkSize, jds.size() );
+        for ( int j=first; j<last; ++j ) {
+            KSNumbers num( jds[j] );
+            earthCopy->findGeocentricPosition( &num );
+
+            CachingDms LST;
+            if ( geo )
+                LST = geo->GSTtoLST( KStarsDateTime( jds[j] ).gst() );
+
+            for ( int i=0; i<copies.size(); ++i ) {
+                KSPlanetBase *body = copies[i];
+                body->findGeocentricPosition( &num, earthCopy.data() );
+                if ( geo ) {
+                    body->localizeCoords( &num, geo->lat(), &LST );
+                    body->EquatorialToHorizontal( &LST, geo->lat() );
+                }
+
+                EphemerisPoint &point = points[i][j];
+                point.jd = jds[j];
+                point.ra = body->ra();
+                point.dec = body->dec();
+                point.rearth = body->rearth();
+                point.rsun = body->rsun();
+                if ( geo ) {
+                    point.alt = body->alt();
+                    point.az = body->az();
+                }
+            }
+        }
+
+        qDeleteAll( copies );
+    } );
+
+    return result;
+}
+
 bool KSPlanetBase::isMajorPlanet() const {
     if ( name() == i18n( "Mercury" ) || name() == i18n( "Venus" ) || name() == i18n( "Mars" ) ||
          name() == i18n( "Jupiter" ) || name() == i18n( "Saturn" ) || name() == i18n( "Uranus" ) ||
@@ -22,12 +22,14 @@
 #include <QList>
 #include <QImage>
 #include <QColor>
+#include <QVector>
 
 #include <QDebug>
 
 #include "trailobject.h"
 
 class KSNumbers;
+class GeoLocation;
 
 /**
  *@class EclipticPosition
@@ -47,6 +49,36 @@ public:
     {}
 };
 
+/**
+ *@class EphemerisPoint
+ *@short The position of a solar system body at one time, as computed by KSPlanetBase::ephemeris().
+ */
+class EphemerisPoint {
+public:
+    double jd;      // Julian day
+    dms ra;         // Apparent right ascension, topocentric if a location was given
+    dms dec;        // Apparent declination, topocentric if a location was given
+    double rearth;  // Distance from the Earth (AU)
+    double rsun;    // Distance from the Sun (AU)
+    dms alt;        // Altitude, if a location was given
+    dms az;         // Azimuth, if a location was given
+
+    EphemerisPoint() : jd(0.0), rearth(0.0), rsun(0.0) {}
+};
+
+/**
+ *@class OrbitPosition
+ *@short The heliocentric position of a body orbiting the Sun, as computed by OrbitalElements::solve().
+ *Cartesian ecliptic coordinates, the x axis pointing to the equinox.
+ */
+class OrbitPosition {
+public:
+    double x, y, z; // Cartesian coordinates (AU)
+    double r;       // Distance from the Sun (AU)
+
+    OrbitPosition() : x(0.0), y(0.0), z(0.0), r(0.0) {}
+};
+
 /**
   *@class KSPlanetBase
   *A subclass of TrailObject that provides additional information
@@ -158,6 +190,28 @@ public:
      */
     void findPosition( const KSNumbers *num, const CachingDms *lat=0, const CachingDms *LST=0, const KSPlanetBase *Earth = 0 );
 
+    /** @short Find position from a heliocentric position computed beforehand, see OrbitalElements.
+     * Bodies which are not computed from orbital elements ignore @p helio and find their position as usual.
+     * @param num KSNumbers pointer for the target date/time
+     * @param lat pointer to the geographic latitude; if NULL, we skip localizeCoords()
+     * @param LST pointer to the local sidereal time; if NULL, we skip localizeCoords()
+     * @param Earth pointer to the Earth
+     * @param helio heliocentric position of the body at the target date/time
+     */
+    void findPosition( const KSNumbers *num, const CachingDms *lat, const CachingDms *LST, const KSPlanetBase *Earth, const OrbitPosition &helio );
+
+    /**
+     *@short Compute the positions of solar system bodies at many times.
+     *The nutation, obliquity and Earth position of each time are computed once and shared by all bodies.
+     *Times are computed in parallel on copies of the bodies, the sky objects themselves are left untouched.
+     *@param bodies bodies to compute
+     *@param jds Julian days
+     *@param geo if not NULL, positions are topocentric for this location and include altitude and azimuth
+     *@param Earth the Earth whose positions are computed, the Earth of the sky map if NULL
+     *@return for each body, its positions in the order of jds
+     */
+    static QVector< QVector<EphemerisPoint> > ephemeris( const QList<const KSPlanetBase *> &bodies, const QVector<double> &jds, const GeoLocation *geo=0, const KSPlanetBase *Earth=0 );
+
     /** @return the Planet's position angle. */
     virtual double pa() const { return PositionAngle; }
 
@@ -198,6 +252,10 @@ public:
     virtual double labelOffset() const;
 
 protected:
+#ifdef UNIT_TEST
+    friend class TestOrbitalElements; // Test class
+#endif
+
     /** Big object. Planet, Moon, Sun. */
     static const UID UID_SOL_BIGOBJ;
     /** Asteroids */
@@ -218,6 +276,15 @@ protected:
      */
     virtual bool findGeocentricPosition( const KSNumbers *num, const KSPlanetBase *Earth=NULL ) = 0;
 
+    /** @short find the object's current geocentric equatorial coordinates from its heliocentric position
+     * This default implementation ignores @p helio and calls findGeocentricPosition().
+     * @param helio heliocentric position of the object at the date of @p num
+     * @param num pointer to current KSNumbers object
+     * @param Earth pointer to planet Earth (needed to calculate geocentric coords)
+     * @return true if position was successfully calculated.
+     */
+    virtual bool findGeocentricPositionFrom( const OrbitPosition &helio, const KSNumbers *num, const KSPlanetBase *Earth );
+
     /**
      * @short Computes the visual magnitude for the major planets.
      * @param num pointer to a ksnumbers object. Needed for the saturn rings contribution to 
@@ -255,6 +322,9 @@ private:
      */
     void localizeCoords( const KSNumbers *num, const CachingDms *lat, const CachingDms *LST );
 
+    /** Find the quantities which depend on the geocentric position (phase, size, magnitude...), see findPosition() */
+    void findDependentQuantities( const KSNumbers *num, const CachingDms *lat, const CachingDms *LST );
+
     double PositionAngle, AngularSize, PhysicalSize;
     QColor m_Color;
 };
@@ -0,0 +1,193 @@
+/*  Orbital Elements
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#include "orbitalelements.h"
+
+#include <cmath>
+
+#include <QtConcurrent>
+
+#include "dms.h"
+#include "kstarsdatetime.h"
+#include "ksasteroid.h"
+#include "kscomet.h"
+
+// Halley steps from Danby's starting value, enough for double precision up to an eccentricity of 0.995
+#define KEPLER_ITERATIONS   6
+// Bodies computed by each thread at a time
+#define SOLVE_CHUNK         4096
+// Precession of the ascending node of the comets, see KSComet::findGeocentricPosition()
+#define NODE_PRECESSION     3.82394E-5
+
+void OrbitalElements::clear()
+{
+    m_Epoch.clear();
+    m_M0.clear();
+    m_Motion.clear();
+    m_A.clear();
+    m_E.clear();
+    m_SinI.clear();
+    m_CosI.clear();
+    m_W.clear();
+    m_N.clear();
+    m_NodeRate.clear();
+    m_NearParabolic.clear();
+}
+
+void OrbitalElements::reserve( int count )
+{
+    m_Epoch.reserve( count );
+    m_M0.reserve( count );
+    m_Motion.reserve( count );
+    m_A.reserve( count );
+    m_E.reserve( count );
+    m_SinI.reserve( count );
+    m_CosI.reserve( count );
+    m_W.reserve( count );
+    m_N.reserve( count );
+    m_NodeRate.reserve( count );
+    m_NearParabolic.reserve( count );
+}
+
+void OrbitalElements::append( const KSAsteroid *asteroid )
+{
+    appendElliptic( asteroid->JD, asteroid->M.Degrees(), asteroid->P, asteroid->a, asteroid->e,
+                    asteroid->i.Degrees(), asteroid->w.Degrees(), asteroid->N.Degrees() );
+}
+
+void OrbitalElements::append( const KSComet *comet )
+{
+    if ( comet->e > 0.98 )
+        appendNearParabolic( comet->JDp, comet->q, comet->e, comet->i.Degrees(), comet->w.Degrees(), comet->N.Degrees(), NODE_PRECESSION );
+    else
+        appendElliptic( comet->JDp, 0.0, comet->P, comet->a, comet->e,
+                        comet->i.Degrees(), comet->w.Degrees(), comet->N.Degrees(), NODE_PRECESSION );
+}
+
+void OrbitalElements::appendElliptic( double epoch, double M, double P, double a, double e, double i, double w, double N, double nodeRate )
+{
+    m_Epoch.append( epoch );
+    m_M0.append( M * dms::DegToRad );
+    m_Motion.append( 2.0 * dms::PI / P );
+    m_A.append( a );
+    m_E.append( e );
+    m_SinI.append( sin( i * dms::DegToRad ) );
+    m_CosI.append( cos( i * dms::DegToRad ) );
+    m_W.append( w * dms::DegToRad );
+    m_N.append( N * dms::DegToRad );
+    m_NodeRate.append( nodeRate * dms::DegToRad );
+    m_NearParabolic.append( false );
+}
+
+void OrbitalElements::appendNearParabolic( double JDp, double q, double e, double i, double w, double N, double nodeRate )
+{
+    m_Epoch.append( JDp );
+    m_M0.append( 0.0 );
+    m_Motion.append( 0.0 );
+    m_A.append( q );
+    m_E.append( e );
+    m_SinI.append( sin( i * dms::DegToRad ) );
+    m_CosI.append( cos( i * dms::DegToRad ) );
+    m_W.append( w * dms::DegToRad );
+    m_N.append( N * dms::DegToRad );
+    m_NodeRate.append( nodeRate * dms::DegToRad );
+    m_NearParabolic.append( true );
+}
+
+QVector<OrbitPosition> OrbitalElements::solve( double jd ) const
+{
+    QVector<OrbitPosition> positions( size() );
+    OrbitPosition *out = positions.data();
+
+    QVector<int> chunks;
+    for ( int first=0; first<size(); first+=SOLVE_CHUNK )
+        chunks.append( first );
+
+    QtConcurrent::blockingMap( chunks, [this, jd, out]( int first ) {
+        solveRange( jd, first, qMin( first + SOLVE_CHUNK, size() ), out );
+    } );
+
+    return positions;
+}
+
+void OrbitalElements::solveRange( double jd, int first, int last, OrbitPosition *positions ) const
+{
+    const double twoPi = 2.0 * dms::PI;
+
+    const double *epoch = m_Epoch.constData();
+    const double *M0 = m_M0.constData();
+    const double *motion = m_Motion.constData();
+    const double *A = m_A.constData();
+    const double *eccentricity = m_E.constData();
+    const double *sinI = m_SinI.constData();
+    const double *cosI = m_CosI.constData();
+    const double *perihelion = m_W.constData();
+    const double *node0 = m_N.constData();
+    const double *nodeRate = m_NodeRate.constData();
+
+    for ( int k=first; k<last; ++k )
+    {
+        const double e = eccentricity[k];
+        double v, r;
+
+        if ( m_NearParabolic[k] )
+        {
+            const double q = A[k];
+            const double gauss = 0.01720209895; //Gauss gravitational constant
+            double a = 0.75 * ( jd - epoch[k] ) * gauss * sqrt( (1+e)/(q*q*q) );
+            double b = sqrt( 1.0 + a*a );
+            double W = pow((b+a),1.0/3.0) - pow((b-a),1.0/3.0);
+            double c = 1.0 + 1.0/(W*W);
+            double f = (1.0-e)/(1.0+e);
+            double g = f/(c*c);
+
+            double a1 = (2.0/3.0) + (2.0*W*W/5.0);
+            double a2 = (7.0/5.0) + (33.0*W*W/35.0) + (37.0*W*W*W*W/175.0);
+            double a3 = W*W*( (432.0/175.0) + (956.0*W*W/1125.0) + (84.0*W*W*W*W/1575.0) );
+            double w = W*(1.0 + g*c*( a1 + a2*g + a3*g*g ));
+
+            v = 2.0 * atan( w );
+            r = q*( 1.0 + w*w )/( 1.0 + w*w*f );
+        }
+        else
+        {
+            //Mean anomaly in [-pi, pi]
+            double M = M0[k] + motion[k] * ( jd - epoch[k] );
+            M -= twoPi * floor( M / twoPi + 0.5 );
+
+            //Eccentric anomaly
+            double E = M + 0.85 * e * ( M < 0.0 ? -1.0 : 1.0 );
+            for ( int n=0; n<KEPLER_ITERATIONS; ++n )
+            {
+                double esinE = e * sin( E );
+                double f = E - esinE - M;
+                double df = 1.0 - e * cos( E );
+                E -= f / ( df - 0.5 * f * esinE / df );
+            }
+
+            double xv = A[k] * ( cos( E ) - e );
+            double yv = A[k] * sqrt( 1.0 - e*e ) * sin( E );
+
+            v = atan2( yv, xv );
+            r = sqrt( xv*xv + yv*yv );
+        }
+
+        //vw is the sum of the true anomaly and the argument of perihelion
+        double vw = v + perihelion[k];
+        double node = node0[k] - nodeRate[k] * ( jd - J2000 );
+        double sinN = sin( node ), cosN = cos( node );
+        double sinvw = sin( vw ), cosvw = cos( vw );
+
+        OrbitPosition &p = positions[k];
+        p.x = r * ( cosN * cosvw - sinN * sinvw * cosI[k] );
+        p.y = r * ( sinN * cosvw + cosN * sinvw * cosI[k] );
+        p.z = r * ( sinvw * sinI[k] );
+        p.r = r;
+    }
+}
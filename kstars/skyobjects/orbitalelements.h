@@ -0,0 +1,101 @@
+/*  Orbital Elements
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef ORBITALELEMENTS_H
+#define ORBITALELEMENTS_H
+
+#include <QVector>
+
+#include "ksplanetbase.h"
+
+class KSAsteroid;
+class KSComet;
+
+/**
+ *@class OrbitalElements
+ *@short The orbital elements of many asteroids or comets, to compute their heliocentric positions in one batch.
+ *
+ * Each element is stored in its own array, in the order the bodies were appended. Positions are computed with the
+ * same formulas as KSAsteroid and KSComet, but in radians, and the Kepler equation is solved with a fixed number of
+ * Halley steps instead of iterating in degrees until the eccentric anomaly changes by less than 0.001 degree.
+ * The bodies are split in ranges computed in parallel.
+ *
+ * KSPlanetBase::findPosition() then finds the geocentric coordinates from each position.
+ *@version 1.0
+ */
+class OrbitalElements
+{
+public:
+
+    /** Remove all the bodies */
+    void clear();
+
+    /** Reserve room for @p count bodies */
+    void reserve( int count );
+
+    /** @return the number of bodies */
+    int size() const { return m_Epoch.size(); }
+
+    /** Append the elements of an asteroid */
+    void append( const KSAsteroid *asteroid );
+
+    /** Append the elements of a comet. Comets with an eccentricity above 0.98 use the near-parabolic approximation. */
+    void append( const KSComet *comet );
+
+    /**
+     * @short Append the elements of an elliptic orbit. Angles are in degrees.
+     * @param epoch Julian day of the mean anomaly @p M
+     * @param M mean anomaly at @p epoch
+     * @param P orbital period in days
+     * @param a semi-major axis (AU)
+     * @param e eccentricity
+     * @param i inclination
+     * @param w argument of perihelion
+     * @param N longitude of the ascending node at J2000.0
+     * @param nodeRate precession of @p N, degrees per day
+     */
+    void appendElliptic( double epoch, double M, double P, double a, double e, double i, double w, double N, double nodeRate=0.0 );
+
+    /**
+     * @short Append the elements of a near-parabolic orbit. Angles are in degrees.
+     * @param JDp Julian day of the perihelion passage
+     * @param q perihelion distance (AU)
+     * @param e eccentricity
+     * @param i inclination
+     * @param w argument of perihelion
+     * @param N longitude of the ascending node at J2000.0
+     * @param nodeRate precession of @p N, degrees per day
+     */
+    void appendNearParabolic( double JDp, double q, double e, double i, double w, double N, double nodeRate=0.0 );
+
+    /**
+     * @short Compute the heliocentric positions of all the bodies.
+     * @param jd Julian day
+     * @return the positions, in the order the bodies were appended
+     */
+    QVector<OrbitPosition> solve( double jd ) const;
+
+private:
+    /** Compute the positions of the bodies from @p first to @p last (excluded) */
+    void solveRange( double jd, int first, int last, OrbitPosition *positions ) const;
+
+    QVector<double> m_Epoch;        // Julian day of the mean anomaly at epoch; of the perihelion for near-parabolic orbits
+    QVector<double> m_M0;           // Mean anomaly at epoch [Radians]
+    QVector<double> m_Motion;       // Mean motion [Radians per day]
+    QVector<double> m_A;            // Semi-major axis; perihelion distance for near-parabolic orbits [AU]
+    QVector<double> m_E;            // Eccentricity
+    QVector<double> m_SinI;         // Sine of the inclination
+    QVector<double> m_CosI;         // Cosine of the inclination
+    QVector<double> m_W;            // Argument of perihelion [Radians]
+    QVector<double> m_N;            // Longitude of the ascending node at J2000.0 [Radians]
+    QVector<double> m_NodeRate;     // Precession of the ascending node [Radians per day]
+    QVector<bool> m_NearParabolic;  // True if the near-parabolic approximation is used
+};
+
+#endif // ORBITALELEMENTS_H
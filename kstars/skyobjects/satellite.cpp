@@ -63,6 +63,81 @@
 #define MFACTOR 7.292115e-5
 
 
+SatelliteEpoch::SatelliteEpoch()
+{
+    KStarsData *data = KStarsData::Instance();
+
+    jd = data->clock()->utc().djd();
+    init( data->geo() );
+    lst = *data->lst();
+
+    KSSun *sun = (KSSun*)data->skyComposite()->findByName( "Sun" );
+    sun_is_down = sun && sun->alt().Degrees() <= -12.0;
+}
+
+SatelliteEpoch::SatelliteEpoch( double jd, const GeoLocation *geo ) : jd( jd )
+{
+    double thetageo = init( geo );
+    lst = CachingDms( thetageo / DEG2RAD );
+
+    // Elevation of the sun above the observer's horizon
+    double range_posx = sun_posx - obs_posx;
+    double range_posy = sun_posy - obs_posy;
+    double range_posz = sun_posz - obs_posz;
+    double range = sqrt( range_posx*range_posx + range_posy*range_posy + range_posz*range_posz );
+    double top_z = coslat*costheta*range_posx + coslat*sintheta*range_posy + sinlat*range_posz;
+    sun_is_down = Satellite::arcSin( top_z / range ) <= -12.0 * DEG2RAD;
+}
+
+double SatelliteEpoch::init( const GeoLocation *geo )
+{
+    double c, sq, achcp, thetageo;
+
+    longitude = geo->lng()->radians();
+    latitude  = geo->lat()->radians();
+    lat       = *geo->lat();
+
+    // Observer ECI position
+    sinlat = sin( latitude );
+    coslat = cos( latitude );
+    thetageo = geo->LMST( jd );
+    sintheta = sin( thetageo );
+    costheta = cos( thetageo );
+    c = 1.0 / sqrt( 1.0 + F * ( F - 2.0 ) * sinlat * sinlat );
+    sq = ( 1.0 - F ) * ( 1.0 - F ) * c;
+    achcp = ( RADIUSEARTHKM * c + MEANALT) * coslat;
+    obs_posx = achcp * costheta;
+    obs_posy = achcp * sintheta;
+    obs_posz = ( RADIUSEARTHKM * sq + MEANALT ) * sinlat;
+    obs_posw = sqrt( obs_posx*obs_posx + obs_posy*obs_posy + obs_posz*obs_posz );
+
+    // ECI coordinates of the sun
+    double mjd, year, T, M, L, e, C, O, Lsa, nu, R, eps;
+
+    mjd  = jd - 2415020.0;
+    year = 1900.0 + mjd / 365.25;
+    T    = ( mjd + Satellite::deltaET( year ) / ( MINPD * 60.0 ) ) / 36525.0;
+    M    = DEG2RAD * ( Satellite::Modulus( 358.47583 + Satellite::Modulus( 35999.04975 * T, 360.0 ) - ( 0.000150 + 0.0000033 * T ) * T*T, 360.0 ) );
+    L    = DEG2RAD * ( Satellite::Modulus( 279.69668 + Satellite::Modulus( 36000.76892 * T, 360.0 ) + 0.0003025 * T*T, 360.0 ) );
+    e    = 0.01675104 - ( 0.0000418 + 0.000000126 * T ) * T;
+    C    = DEG2RAD * ( ( 1.919460 - ( 0.004789 + 0.000014 * T ) * T ) *
+           sin( M ) + ( 0.020094 - 0.000100 *  T) *
+           sin( 2 * M ) + 0.000293 * sin( 3 * M ) );
+    O    = DEG2RAD * ( Satellite::Modulus( 259.18 - 1934.142 * T, 360.0 ) );
+    Lsa  = Satellite::Modulus( L + C - DEG2RAD * ( 0.00569  -0.00479 * sin( O ) ), TWOPI );
+    nu   = Satellite::Modulus( M + C, TWOPI);
+    R    = 1.0000002 * ( 1.0 - e*e ) / ( 1.0 + e * cos( nu ) );
+    eps  = DEG2RAD * ( 23.452294 - ( 0.0130125 + ( 0.00000164 - 0.000000503 * T ) * T ) * T + 0.00256 * cos( O ) );
+    R    = AU * R;
+
+    sun_posx = R * cos( Lsa );
+    sun_posy = R * sin( Lsa ) * cos( eps );
+    sun_posz = R * sin( Lsa ) * sin( eps );
+    sun_posw = R;
+
+    return thetageo;
+}
+
 Satellite::Satellite( const QString name, const QString line1, const QString line2 )
 {
     //m_name          = name;
@@ -158,6 +233,11 @@ void Satellite::init()
     method = 'n';
 
     m_is_visible = false;
+    m_is_outdated = false;
+    m_computed_jd = 0.;
+    m_computed_lng = 0.;
+    m_computed_lat = 0.;
+    m_rise_minutes = 0.;
 
     // Divisor for divide by zero check on inclination
     const double temp4 =  1.5e-12;
@@ -187,6 +267,12 @@ void Satellite::init()
     rp    = ao * ( 1.0 - m_eccentricity );
     method = 'n';
 
+    // Bounds for the horizon prefilter, with a margin for perturbations: the satellite moves fastest at perigee,
+    // the earth rotation adds to the apparent motion
+    m_max_radius = 1.1 * ao * ( 1.0 + m_eccentricity ) * RADIUSEARTHKM;
+    m_max_rate   = 1.1 * m_mean_motion * ( 1.0 + m_eccentricity ) * ( 1.0 + m_eccentricity ) / ( omeosq * rteosq )
+                   + MFACTOR * 60.0;
+
     // Find sidereal time
     ts70  = m_tle_jd - 2433281.5 - 7305.0;
     ds70  = floor( ts70 + 1.0e-8 );
@@ -656,14 +742,25 @@ void Satellite::init()
 
 int Satellite::updatePos()
 {
-    KStarsData *data = KStarsData::Instance();
-    return sgp4( ( data->clock()->utc().djd() - m_tle_jd ) * MINPD );
+    return updatePos( SatelliteEpoch() );
 }
 
-int Satellite::sgp4( double tsince )
+int Satellite::updatePos( const SatelliteEpoch &epoch, bool skipBelowHorizon )
+{
+    if ( skipBelowHorizon && m_computed_jd != 0. &&
+         epoch.longitude == m_computed_lng && epoch.latitude == m_computed_lat &&
+         fabs( epoch.jd - m_computed_jd ) * MINPD < m_rise_minutes ) {
+        m_is_outdated = true;
+        m_is_visible = false;
+        return( 0 );
+    }
+
+    m_is_outdated = false;
+    return sgp4( ( epoch.jd - m_tle_jd ) * MINPD, epoch );
+}
+
+int Satellite::sgp4( double tsince, const SatelliteEpoch &epoch )
 {
-    KStarsData *data = KStarsData::Instance();
-    
     int ktr;
     double am   , axnl  , aynl , betal ,  cosim , cnod  ,
            cos2u, coseo1, cosi , cosip ,  cosisq, cossu , cosu,
@@ -677,15 +774,10 @@ int Satellite::sgp4( double tsince )
            nm   , nodem , xinc , xincp ,  xl    , xlm   , mp  ,
            xmdf , xmx   , xmy  , nodedf, xnode  , nodep , tc  ,
            sat_posx, sat_posy , sat_posz, sat_posw, sat_velx ,
-           sat_vely  , sat_velz , sinlat, obs_posx, obs_posy,
-           obs_posz, obs_posw, /*obs_velx, obs_vely, obs_velz,*/
-           coslat, thetageo, sintheta, costheta, c, sq, achcp,
-           vkmpersec;
+           sat_vely  , sat_velz , vkmpersec;
 
     const double temp4 =   1.5e-12;
 
-    double jul_utc = data->clock()->utc().djd();
-
     vkmpersec = RADIUSEARTHKM * XKE / 60.0;
 
     // Update for secular gravity and atmospheric drag
@@ -1071,22 +1163,11 @@ int Satellite::sgp4( double tsince )
         return( 6 );
     }
 
-    // Observer ECI position and velocity
-    sinlat = sin( data->geo()->lat()->radians() );
-    coslat = cos( data->geo()->lat()->radians() );
-    thetageo = data->geo()->LMST( jul_utc );
-    sintheta = sin( thetageo );
-    costheta = cos( thetageo );
-    c = 1.0 / sqrt( 1.0 + F * ( F - 2.0 ) * sinlat * sinlat );
-    sq = ( 1.0 - F ) * ( 1.0 - F ) * c;
-    achcp = ( RADIUSEARTHKM * c + MEANALT) * coslat;
-    obs_posx = achcp * costheta;
-    obs_posy = achcp * sintheta;
-    obs_posz = ( RADIUSEARTHKM * sq + MEANALT ) * sinlat;
-    obs_posw = sqrt( obs_posx*obs_posx + obs_posy*sat_posy + obs_posz*obs_posz );
-    /*obs_velx = -MFACTOR * obs_posy;
-    obs_vely = MFACTOR * obs_posx;
-    obs_velz = 0.;*/
+    // Observer ECI position is shared by all satellites
+    const double sinlat = epoch.sinlat, coslat = epoch.coslat;
+    const double sintheta = epoch.sintheta, costheta = epoch.costheta;
+    const double obs_posx = epoch.obs_posx, obs_posy = epoch.obs_posy, obs_posz = epoch.obs_posz;
+    const double obs_posw = epoch.obs_posw;
 
     m_altitude = sat_posw - obs_posw + MEANALT;
 
@@ -1115,32 +1196,23 @@ int Satellite::sgp4( double tsince )
 
     setAz( azimut / DEG2RAD );
     setAlt( elevation / DEG2RAD );
-    HorizontalToEquatorial( data->lst(), data->geo()->lat() );
+    HorizontalToEquatorial( &epoch.lst, &epoch.lat );
+
+    // Geocentric angle between the satellite and the observer, and the largest one from which the
+    // satellite is above the horizon. Until the satellite could have covered the difference, it stays
+    // below the horizon and need not be computed.
+    double cos_psi = ( sat_posx*obs_posx + sat_posy*obs_posy + sat_posz*obs_posz ) / ( sat_posw * obs_posw );
+    double psi = acos( qBound( -1.0, cos_psi, 1.0 ) );
+    double psi_rise = acos( qMin( 1.0, RADIUSEARTHKM * ( 1.0 - F ) / m_max_radius ) );
+    m_rise_minutes = psi > psi_rise ? ( psi - psi_rise ) / m_max_rate : 0.;
+    m_computed_jd = epoch.jd;
+    m_computed_lng = epoch.longitude;
+    m_computed_lat = epoch.latitude;
 
     // is the satellite visible ?
-    // Find ECI coordinates of the sun
-    double mjd, year, T, M, L, e, C, O, Lsa, nu, R, eps;
-
-    mjd  = jul_utc - 2415020.0;
-    year = 1900.0 + mjd / 365.25;
-    T    = ( mjd + deltaET( year ) / ( MINPD * 60.0 ) ) / 36525.0;
-    M    = DEG2RAD * ( Modulus( 358.47583 + Modulus( 35999.04975 * T, 360.0 ) - ( 0.000150 + 0.0000033 * T ) * T*T, 360.0 ) );
-    L    = DEG2RAD * ( Modulus( 279.69668 + Modulus( 36000.76892 * T, 360.0 ) + 0.0003025 * T*T, 360.0 ) );
-    e    = 0.01675104 - ( 0.0000418 + 0.000000126 * T ) * T;
-    C    = DEG2RAD * ( ( 1.919460 - ( 0.004789 + 0.000014 * T ) * T ) *
-           sin( M ) + ( 0.020094 - 0.000100 *  T) *
-           sin( 2 * M ) + 0.000293 * sin( 3 * M ) );
-    O    = DEG2RAD * ( Modulus( 259.18 - 1934.142 * T, 360.0 ) );
-    Lsa  = Modulus( L + C - DEG2RAD * ( 0.00569  -0.00479 * sin( O ) ), TWOPI );
-    nu   = Modulus( M + C, TWOPI);
-    R    = 1.0000002 * ( 1.0 - e*e ) / ( 1.0 + e * cos( nu ) );
-    eps  = DEG2RAD * ( 23.452294 - ( 0.0130125 + ( 0.00000164 - 0.000000503 * T ) * T ) * T + 0.00256 * cos( O ) );
-    R    = AU * R;
-
-    double sun_posx = R * cos( Lsa );
-    double sun_posy = R * sin( Lsa ) * cos( eps );
-    double sun_posz = R * sin( Lsa ) * sin( eps );
-    double sun_posw = R;
+    // ECI coordinates of the sun are shared by all satellites
+    const double sun_posx = epoch.sun_posx, sun_posy = epoch.sun_posy, sun_posz = epoch.sun_posz;
+    const double sun_posw = epoch.sun_posw;
 
     // Calculates satellite's eclipse status and depth
     double sd_sun, sd_earth, delta, depth;
@@ -1158,10 +1230,9 @@ int Satellite::sgp4( double tsince )
     double earth_w = sat_posw;
     delta = PIO2 - arcSin( ( sun_posx*earth_x + sun_posy*earth_y + sun_posz*earth_z )  / ( sun_posw*earth_w ) );
     depth = sd_earth - sd_sun - delta;
-    KSSun *sun = (KSSun*)data->skyComposite()->findByName( "Sun" );
 
     m_is_eclipsed = sd_earth >= sd_sun  &&  depth >= 0;
-    m_is_visible  = !m_is_eclipsed && sun->alt().Degrees() <= -12.0 && elevation >= 0.0;
+    m_is_visible  = !m_is_eclipsed && epoch.sun_is_down && elevation >= 0.0;
 
     return( 0 );
 }
@@ -1235,6 +1306,27 @@ bool Satellite::isVisible()
     return m_is_visible;
 }
 
+bool Satellite::isOutdated() const
+{
+    return m_is_outdated;
+}
+
+void Satellite::updatePosIfOutdated()
+{
+    if ( m_is_outdated )
+        updatePos();
+}
+
+bool Satellite::isEclipsed() const
+{
+    return m_is_eclipsed;
+}
+
+double Satellite::minutesBeforeRise() const
+{
+    return m_rise_minutes;
+}
+
 bool Satellite::selected()
 {
     return m_is_selected;
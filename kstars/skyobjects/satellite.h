@@ -24,8 +24,49 @@
 #include "skyobject.h"
 #include "skypoint.h"
 
+class GeoLocation;
 class KSPopupMenu;
 
+/**
+    *@class SatelliteEpoch
+    *Observer and sun positions shared by all satellites computed for the same time.
+    *They are computed once per update instead of once per satellite.
+    */
+class SatelliteEpoch
+{
+public:
+    /**
+     *@short Compute the observer and sun positions for the current time and location
+     */
+    SatelliteEpoch();
+
+    /**
+     *@short Compute the observer and sun positions for any time and location
+     *@param jd Julian date (UTC)
+     *@param geo observer location
+     *@note Unlike the default constructor, this one does not use KStarsData and may be used from any thread.
+     */
+    SatelliteEpoch( double jd, const GeoLocation *geo );
+
+    double jd;                  // Julian date (UTC)
+    double longitude;           // Observer longitude [Radians]
+    double latitude;            // Observer latitude [Radians]
+    double sinlat, coslat;      // Sine and cosine of the observer latitude
+    double sintheta, costheta;  // Sine and cosine of the local mean sidereal time
+    double obs_posx, obs_posy, obs_posz, obs_posw;  // Observer ECI position (km)
+    double sun_posx, sun_posy, sun_posz, sun_posw;  // Sun ECI position (km)
+    bool   sun_is_down;         // True if the sun is at least 12° under horizon
+    CachingDms lst;             // Local sidereal time
+    CachingDms lat;             // Observer latitude
+
+private:
+    /**
+     *@short Compute the observer and sun ECI positions from jd and the observer location
+     *@return Local mean sidereal time [Radians]
+     */
+    double init( const GeoLocation *geo );
+};
+
 /**
     *@class Satellite
     *Represents an artificial satellites.
@@ -56,6 +97,38 @@ public:
      */
     int updatePos();
 
+    /**
+     *@short Update satellite position for the time and location of epoch
+     *@param skipBelowHorizon if true, the position is left unchanged when the satellite cannot have risen
+     *above the horizon since it was last computed. isOutdated() then returns true.
+     *@return 0, or an error code for sgp4ErrorString()
+     *@note Satellites may be updated from several threads at once for the same epoch.
+     */
+    int updatePos( const SatelliteEpoch &epoch, bool skipBelowHorizon = false );
+
+    /**
+     *@return True if the last update was skipped because the satellite was below the horizon.
+     *Its coordinates are then out of date.
+     */
+    bool isOutdated() const;
+
+    /**
+     *@short Update the position if the last update was skipped, before the coordinates are read
+     *as when the satellite is found, centered or shown in details.
+     */
+    void updatePosIfOutdated();
+
+    /**
+     *@return True if the satellite was in the shadow of the earth when it was last computed
+     */
+    bool isEclipsed() const;
+
+    /**
+     *@return Minutes the satellite needs at least to rise above the horizon after it was last computed,
+     *0 if it is above or close to the horizon
+     */
+    double minutesBeforeRise() const;
+
     /**
      *@return True if the satellite is visible (above horizon, in the sunlight and sun at least 12° under horizon)
      */
@@ -109,12 +182,12 @@ private:
     /**
      *@short Compute satellite position
      */
-    int sgp4( double tsince );    
+    int sgp4( double tsince, const SatelliteEpoch &epoch );
 
     /**
      *@return Arcsine of the argument
      */
-    double arcSin( double arg );
+    static double arcSin( double arg );
 
     /**
      *Provides the difference between UT (approximately the same as UTC)
@@ -122,12 +195,14 @@ private:
      *This function is based on a least squares fit of data from 1950
      *to 1991 and will need to be updated periodically.
      */
-    double deltaET( double year );
+    static double deltaET( double year );
 
     /**
      *@return arg1 mod arg2
      */
-    double Modulus(double arg1, double arg2);
+    static double Modulus(double arg1, double arg2);
+
+    friend class SatelliteEpoch;
 
     
 
@@ -160,6 +235,15 @@ private:
     double m_altitude;          // Satellite altitude in km
     double m_range;             // Satellite range from observer in km
 
+    // Horizon prefilter
+    bool   m_is_outdated;       // True if the last update was skipped
+    double m_max_radius;        // Upper bound of the distance from the earth center (km)
+    double m_max_rate;          // Upper bound of the angular velocity seen from the earth center [Radians per minutes]
+    double m_computed_jd;       // Julian date of the last computed position
+    double m_computed_lng;      // Observer longitude of the last computed position [Radians]
+    double m_computed_lat;      // Observer latitude of the last computed position [Radians]
+    double m_rise_minutes;      // Minutes the satellite needs at least to rise after the last computed position
+
     // Near Earth
     bool isimp;
     double aycof  , con41  , cc1    , cc4      , cc5    , d2      , d3   , d4    ,
@@ -18,6 +18,8 @@
 #include <QFile>
 #include <QDir>
 #include <QStandardPaths>
+#include <QVector>
+#include <QtConcurrent>
 
 #include "satellitegroup.h"
 #include "ksutils.h"
@@ -64,18 +66,27 @@ void SatelliteGroup::readTLE()
 
 void SatelliteGroup::updateSatellitesPos()
 {
-    QMutableListIterator<Satellite *> sats(*this);
-    while (sats.hasNext())
-    {
-        Satellite *sat = sats.next();
+    updateSatellitesPos( SatelliteEpoch(), false );
+}
 
+void SatelliteGroup::updateSatellitesPos( const SatelliteEpoch &epoch, bool skipBelowHorizon )
+{
+    QVector< QPair<Satellite *, int> > sats;
+    sats.reserve( size() );
+    foreach ( Satellite *sat, *this ) {
         if ( sat->selected() )
-        {
-            int rc = sat->updatePos();
-            // If position cannot be calculated, remove it from list
-            if (rc != 0)
-                sats.remove();
-        }
+            sats.append( qMakePair( sat, 0 ) );
+    }
+
+    // Satellites only modify themselves, so they can be computed concurrently
+    QtConcurrent::blockingMap( sats, [&epoch, skipBelowHorizon]( QPair<Satellite *, int> &sat ) {
+        sat.second = sat.first->updatePos( epoch, skipBelowHorizon );
+    } );
+
+    // If position cannot be calculated, remove it from list
+    for ( int i=0; i<sats.size(); i++ ) {
+        if ( sats[i].second != 0 )
+            removeOne( sats[i].first );
     }
 }
 
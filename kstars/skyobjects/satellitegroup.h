@@ -55,6 +55,14 @@ public:
      */
     void updateSatellitesPos();
 
+    /**
+     *Compute the position of the selected satellites in the group for epoch.
+     *The satellites are computed in parallel. Those whose position cannot be computed are removed from the group.
+     *@param skipBelowHorizon if true, satellites that cannot have risen since their last update are not computed
+     *@see Satellite::updatePos()
+     */
+    void updateSatellitesPos( const SatelliteEpoch &epoch, bool skipBelowHorizon );
+
     /**
      *@return TLE filename
      */
@@ -0,0 +1,202 @@
+/*  Satellite Pass
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#include "satellitepass.h"
+
+#include <QScopedPointer>
+#include <QtMath>
+
+#include "satellite.h"
+
+// Refinement of rise, set and culmination times stops below this duration (days)
+#define PASS_PRECISION  ( 1.0 / 86400.0 )
+#define MINPD           1440.0
+
+namespace
+{
+
+/** Compute probe at jd. @return its altitude in degrees, or -90 if its position cannot be computed. */
+double altitudeAt( Satellite *probe, double jd, const GeoLocation *geo )
+{
+    if ( probe->updatePos( SatelliteEpoch( jd, geo ) ) != 0 )
+        return -90.0;
+
+    return probe->alt().Degrees();
+}
+
+/** @return time between below and above when probe crosses the horizon. probe is left computed at that time. */
+double horizonCrossing( Satellite *probe, double below, double above, const GeoLocation *geo )
+{
+    while ( fabs( above - below ) > PASS_PRECISION )
+    {
+        double middle = ( below + above ) / 2.0;
+        if ( altitudeAt( probe, middle, geo ) >= 0.0 )
+            above = middle;
+        else
+            below = middle;
+    }
+
+    altitudeAt( probe, above, geo );
+    return above;
+}
+
+/** @return time between a and b when probe is the highest. probe is left computed at that time. */
+double highestPoint( Satellite *probe, double a, double b, const GeoLocation *geo )
+{
+    const double ratio = 0.61803398874989485;
+
+    double c = b - ratio * ( b - a );
+    double d = a + ratio * ( b - a );
+    double altC = altitudeAt( probe, c, geo );
+    double altD = altitudeAt( probe, d, geo );
+
+    while ( b - a > PASS_PRECISION )
+    {
+        if ( altC > altD )
+        {
+            b = d;
+            d = c;
+            altD = altC;
+            c = b - ratio * ( b - a );
+            altC = altitudeAt( probe, c, geo );
+        }
+        else
+        {
+            a = c;
+            c = d;
+            altC = altD;
+            d = a + ratio * ( b - a );
+            altD = altitudeAt( probe, d, geo );
+        }
+    }
+
+    double jd = ( a + b ) / 2.0;
+    altitudeAt( probe, jd, geo );
+    return jd;
+}
+
+}
+
+SatellitePass::SatellitePass() : riseAzimuth( 0 ), culminationAzimuth( 0 ), setAzimuth( 0 ), maxAltitude( 0 ),
+                                 sunlit( false ), visible( false )
+{
+}
+
+QVector<SatelliteEpoch> SatellitePass::epochTable( double start, double end, const GeoLocation *geo, double step )
+{
+    QVector<SatelliteEpoch> table;
+
+    int count = qMax( 1, qCeil( ( end - start ) * MINPD / step ) );
+    table.reserve( count + 1 );
+
+    for ( int i=0; i <= count; i++ )
+        table.append( SatelliteEpoch( qMin( start + i * step / MINPD, end ), geo ) );
+
+    return table;
+}
+
+QList<SatellitePass> SatellitePass::predict( const Satellite *sat, const QVector<SatelliteEpoch> &table, const GeoLocation *geo )
+{
+    QList<SatellitePass> passes;
+
+    if ( table.size() < 2 )
+        return passes;
+
+    // Computing a position changes the satellite, work on a copy
+    QScopedPointer<Satellite> probe( sat->clone() );
+    double step = ( table[1].jd - table[0].jd ) * MINPD;
+
+    SatellitePass pass;
+    bool up = false;
+    int last = 0;           // Last step computed
+    int highest = 0;        // Highest step of the current pass
+    double highestAltitude = 0.;
+
+    for ( int i=0; i < table.size(); )
+    {
+        // The satellite has decayed
+        if ( probe->updatePos( table[i] ) != 0 )
+            return passes;
+
+        double altitude = probe->alt().Degrees();
+        bool visible = probe->isVisible();
+        double minutesBeforeRise = probe->minutesBeforeRise();
+
+        if ( altitude >= 0.0 )
+        {
+            if ( ! up )
+            {
+                pass = SatellitePass();
+                pass.satellite = sat->name();
+                if ( i == 0 )
+                    pass.rise = KStarsDateTime( table[0].jd );
+                else
+                    pass.rise = KStarsDateTime( horizonCrossing( probe.data(), table[last].jd, table[i].jd, geo ) );
+                pass.riseAzimuth = probe->az().Degrees();
+                pass.visible = probe->isVisible();
+                highest = i;
+                highestAltitude = altitude;
+                up = true;
+            }
+            else if ( altitude > highestAltitude )
+            {
+                highest = i;
+                highestAltitude = altitude;
+            }
+
+            pass.visible = pass.visible || visible;
+        }
+        else if ( up )
+        {
+            double setJD = horizonCrossing( probe.data(), table[i].jd, table[last].jd, geo );
+            pass.set = KStarsDateTime( setJD );
+            pass.setAzimuth = probe->az().Degrees();
+            pass.visible = pass.visible || probe->isVisible();
+
+            double from = qMax( highest > 0 ? table[highest-1].jd : table[0].jd, double( pass.rise.djd() ) );
+            double to   = qMin( table[highest+1].jd, setJD );
+            pass.culmination = KStarsDateTime( highestPoint( probe.data(), from, to, geo ) );
+            pass.culminationAzimuth = probe->az().Degrees();
+            pass.maxAltitude = probe->alt().Degrees();
+            pass.sunlit = ! probe->isEclipsed();
+            pass.visible = pass.visible || probe->isVisible();
+
+            passes.append( pass );
+            up = false;
+        }
+
+        last = i;
+
+        // The satellite cannot rise before minutesBeforeRise, skip the steps until then
+        if ( altitude < 0.0 && minutesBeforeRise > step )
+            i += int( minutesBeforeRise / step );
+        else
+            i++;
+    }
+
+    // The satellite is still up at the end of the time window
+    if ( up )
+    {
+        pass.set = KStarsDateTime( table.last().jd );
+        probe->updatePos( table.last() );
+        pass.setAzimuth = probe->az().Degrees();
+
+        double from = qMax( highest > 0 ? table[highest-1].jd : table[0].jd, double( pass.rise.djd() ) );
+        double to   = highest + 1 < table.size() ? table[highest+1].jd : table.last().jd;
+        pass.culmination = KStarsDateTime( highestPoint( probe.data(), from, to, geo ) );
+        pass.culminationAzimuth = probe->az().Degrees();
+        pass.maxAltitude = probe->alt().Degrees();
+        pass.sunlit = ! probe->isEclipsed();
+        pass.visible = pass.visible || probe->isVisible();
+
+        passes.append( pass );
+    }
+
+    return passes;
+}
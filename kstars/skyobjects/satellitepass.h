@@ -0,0 +1,70 @@
+/*  Satellite Pass
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef SATELLITEPASS_H
+#define SATELLITEPASS_H
+
+#include <QList>
+#include <QString>
+#include <QVector>
+
+#include "kstarsdatetime.h"
+
+class GeoLocation;
+class Satellite;
+class SatelliteEpoch;
+
+/**
+ *@class SatellitePass
+ *@short A pass of a satellite above the observer's horizon.
+ *
+ * Passes are found in a table of epochs at regular steps covering the time window. While the satellite is below the
+ * horizon, the table is walked in jumps as long as the satellite needs at least to rise. Each horizon crossing found
+ * between two steps is then refined by bisection, and the culmination by golden section search, to about one second.
+ * Passes shorter than one step may be missed.
+ *@version 1.0
+ */
+class SatellitePass
+{
+public:
+
+    SatellitePass();
+
+    /**
+     * @brief predict Find the passes of a satellite above the horizon.
+     * @param sat satellite, it is not modified
+     * @param table epochs from the beginning to the end of the time window, at regular steps
+     * @param geo observer location the table was computed for
+     * @return passes in time order
+     * @note This function does not use KStarsData and may be called from any thread.
+     */
+    static QList<SatellitePass> predict( const Satellite *sat, const QVector<SatelliteEpoch> &table, const GeoLocation *geo );
+
+    /**
+     * @brief epochTable Compute the epochs to predict passes from.
+     * @param start Julian date (UTC) of the beginning of the time window
+     * @param end Julian date (UTC) of the end of the time window
+     * @param geo observer location
+     * @param step minutes between two epochs. The last step may be shorter.
+     */
+    static QVector<SatelliteEpoch> epochTable( double start, double end, const GeoLocation *geo, double step );
+
+    QString satellite;              // Satellite name
+    KStarsDateTime rise;            // Rise time (UT), or beginning of the time window if the satellite was already up
+    KStarsDateTime culmination;     // Time of the highest altitude (UT)
+    KStarsDateTime set;             // Set time (UT), or end of the time window if the satellite was still up
+    double riseAzimuth;             // Azimuth at rise [Degrees]
+    double culminationAzimuth;      // Azimuth at culmination [Degrees]
+    double setAzimuth;              // Azimuth at set [Degrees]
+    double maxAltitude;             // Altitude at culmination [Degrees]
+    bool sunlit;                    // True if the satellite is in the sunlight at culmination
+    bool visible;                   // True if the satellite is visible at some point of the pass (see Satellite::isVisible())
+};
+
+#endif // SATELLITEPASS_H
@@ -262,6 +262,22 @@ public:
      */
     dms transitAltitude( const KStarsDateTime &dt, const GeoLocation *geo ) const;
 
+    /**
+     *Correct for the geometric altitude of the center of the body at the
+     *time of rising or setting. This is due to refraction at the horizon
+     *and to the size of the body. The moon correction has also to take into
+     *account parallax. The value we use here is a rough approximation
+     *suggeted by J. Meeus.
+     *
+     *Weather status (temperature and pressure basically) is not taken
+     *into account although change of conditions between summer and 
+     *winter could shift the times of sunrise and sunset by 20 seconds.
+     *
+     *This function is used by auxRiseSetTimeLST() and YearlyEphemeris.
+     *@return dms object with the correction.
+     */
+    dms elevationCorrection(void) const;
+
     /**
      *The equatorial coordinates for the object on date dt are computed and returned,
      *but the object's internal coordinates are not modified.
@@ -384,22 +400,6 @@ private:
      */
     double approxHourAngle( const dms *h, const dms *gLat, const dms *d ) const;
 
-    /**
-     *Correct for the geometric altitude of the center of the body at the
-     *time of rising or setting. This is due to refraction at the horizon
-     *and to the size of the body. The moon correction has also to take into
-     *account parallax. The value we use here is a rough approximation
-     *suggeted by J. Meeus.
-     *
-     *Weather status (temperature and pressure basically) is not taken
-     *into account although change of conditions between summer and 
-     *winter could shift the times of sunrise and sunset by 20 seconds.
-     *
-     *This function is only used by auxRiseSetTimeLST().
-     *@return dms object with the correction.
-     */
-    dms elevationCorrection(void) const;
-
     /**
      *@short Return a pointer to the AuxInfo object associated with this SkyObject.
      *@note  This method creates the AuxInfo object if it is non-existent
@@ -889,3 +889,33 @@ double SkyPoint::minAlt(const dms& lat) const {
     return retval;
 
 }
+
+void SkyPoint::altitudeRange( const dms &lat, const dms &startLST, double siderealHours, double &lowest, double &highest ) const {
+    double sinlat, coslat, sindec, cosdec;
+    lat.SinCos( sinlat, coslat );
+    dec().SinCos( sindec, cosdec );
+
+    auto altitude = [&]( double hourAngle ) {
+        double sinAlt = sindec*sinlat + cosdec*coslat*cos( hourAngle * 15. * dms::DegToRad );
+        return asin( qBound( -1.0, sinAlt, 1.0 ) ) / dms::DegToRad;
+    };
+
+    // Hour angles at both ends, the first one in [-12h, 12h)
+    double ha1 = dms( startLST.Degrees() - ra().Degrees() ).Hours();
+    if ( ha1 >= 12. )
+        ha1 -= 24.;
+    double ha2 = ha1 + siderealHours;
+
+    double alt1 = altitude( ha1 ), alt2 = altitude( ha2 );
+
+    // Upper culmination at 0h and 24h, lower culmination at -12h, 12h and 36h
+    if ( ( ha1 <= 0. && ha2 >= 0. ) || ha2 >= 24. )
+        highest = altitude( 0. );
+    else
+        highest = qMax( alt1, alt2 );
+
+    if ( ha1 == -12. || ha2 >= 12. )
+        lowest = altitude( 12. );
+    else
+        lowest = qMin( alt1, alt2 );
+}
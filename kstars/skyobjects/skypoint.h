@@ -567,6 +567,20 @@ public:
      */
     double minAlt( const dms &lat ) const;
 
+    /**
+     * @short Find the lowest and highest altitudes reached during a time interval, without sampling it
+     *
+     * The altitude only depends on the hour angle, and decreases from the upper to the lower culmination. The
+     * extremes are thus the altitudes at the ends of the interval, or at a culmination crossed during it.
+     * @param lat latitude of the observer
+     * @param startLST local sidereal time at the beginning of the interval
+     * @param siderealHours duration of the interval in sidereal hours
+     * @param lowest will be set to the lowest altitude in degrees
+     * @param highest will be set to the highest altitude in degrees
+     * @note Altitudes are not corrected for refraction. The current RA and Dec are used.
+     */
+    void altitudeRange( const dms &lat, const dms &startLST, double siderealHours, double &lowest, double &highest ) const;
+
 
 
 #ifdef PROFILE_COORDINATE_CONVERSION
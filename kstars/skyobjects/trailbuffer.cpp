@@ -0,0 +1,161 @@
+/*  Trail Buffer
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#include "trailbuffer.h"
+
+#include <cmath>
+
+#include "dms.h"
+#include "projections/projector.h"
+
+// Points the ring holds before it grows for the first time
+#define INITIAL_CAPACITY    16
+
+TrailBuffer::TrailBuffer()
+    : m_First( 0 ), m_Count( 0 ), m_Revision( 1 ), m_ScreenRevision( 0 ), m_ProjectorRevision( 0 )
+{
+}
+
+void TrailBuffer::grow() {
+    const int capacity = m_Labels.size();
+    const int newCapacity = qMax( INITIAL_CAPACITY, 2 * capacity );
+
+    QVector<double> equatorial( 3 * newCapacity ), horizontal( 3 * newCapacity );
+    QVector<QString> labels( newCapacity );
+    for ( int i=0; i<m_Count; ++i ) {
+        int s = slot( i );
+        for ( int c=0; c<3; ++c ) {
+            equatorial[ 3*i + c ] = m_Equatorial[ 3*s + c ];
+            horizontal[ 3*i + c ] = m_Horizontal[ 3*s + c ];
+        }
+        labels[i] = m_Labels[s];
+    }
+
+    m_Equatorial = equatorial;
+    m_Horizontal = horizontal;
+    m_Labels = labels;
+    m_First = 0;
+}
+
+void TrailBuffer::append( const SkyPoint &p, const QString &label ) {
+    if ( m_Count == m_Labels.size() )
+        grow();
+
+    const int s = slot( m_Count );
+    double sinRA, cosRA, sinDec, cosDec;
+    p.ra().SinCos( sinRA, cosRA );
+    p.dec().SinCos( sinDec, cosDec );
+    double *e = m_Equatorial.data() + 3*s;
+    e[0] = cosDec * cosRA;
+    e[1] = cosDec * sinRA;
+    e[2] = sinDec;
+
+    double sinAlt, cosAlt, sinAz, cosAz;
+    p.alt().SinCos( sinAlt, cosAlt );
+    p.az().SinCos( sinAz, cosAz );
+    double *h = m_Horizontal.data() + 3*s;
+    h[0] = cosAlt * cosAz;
+    h[1] = cosAlt * sinAz;
+    h[2] = sinAlt;
+
+    m_Labels[s] = label;
+    ++m_Count;
+    ++m_Revision;
+}
+
+void TrailBuffer::removeFirst() {
+    if ( ! m_Count )
+        return;
+    m_Labels[ m_First ].clear();
+    m_First = slot( 1 );
+    --m_Count;
+    ++m_Revision;
+}
+
+void TrailBuffer::removeLast() {
+    if ( ! m_Count )
+        return;
+    m_Labels[ slot( m_Count - 1 ) ].clear();
+    --m_Count;
+    ++m_Revision;
+}
+
+void TrailBuffer::clear() {
+    m_Equatorial.clear();
+    m_Horizontal.clear();
+    m_Labels.clear();
+    m_Screen.clear();
+    m_Visible.clear();
+    m_First = 0;
+    m_Count = 0;
+    ++m_Revision;
+}
+
+SkyPoint TrailBuffer::at( int i ) const {
+    const int s = slot( i );
+    const double *e = m_Equatorial.constData() + 3*s;
+    const double *h = m_Horizontal.constData() + 3*s;
+
+    SkyPoint p;
+    dms ra;
+    ra.setRadians( atan2( e[1], e[0] ) );
+    p.setRA( ra.reduce() );
+    p.setDec( asin( qBound( -1.0, e[2], 1.0 ) ) / dms::DegToRad );
+
+    dms az;
+    az.setRadians( atan2( h[1], h[0] ) );
+    p.setAz( az.reduce() );
+    p.setAlt( asin( qBound( -1.0, h[2], 1.0 ) ) / dms::DegToRad );
+    return p;
+}
+
+void TrailBuffer::updateHorizontal( const dms *LST, const dms *lat ) {
+    double sinLST, cosLST, sinLat, cosLat;
+    LST->SinCos( sinLST, cosLST );
+    lat->SinCos( sinLat, cosLat );
+
+    // Rotation from the equatorial frame to the north, east and up directions of the observer.
+    // The azimuth is measured from the north towards the east, as in SkyPoint::EquatorialToHorizontal().
+    const double n0 = -sinLat * cosLST, n1 = -sinLat * sinLST, n2 = cosLat;
+    const double e0 = -sinLST, e1 = cosLST;
+    const double u0 = cosLat * cosLST, u1 = cosLat * sinLST, u2 = sinLat;
+
+    const int capacity = m_Labels.size();
+    const double *e = m_Equatorial.constData();
+    double *h = m_Horizontal.data();
+    for ( int i=0; i<m_Count; ++i ) {
+        int s = m_First + i;
+        if ( s >= capacity )
+            s -= capacity;
+        const double x = e[ 3*s ], y = e[ 3*s + 1 ], z = e[ 3*s + 2 ];
+        h[ 3*s ]     = n0 * x + n1 * y + n2 * z;
+        h[ 3*s + 1 ] = e0 * x + e1 * y;
+        h[ 3*s + 2 ] = u0 * x + u1 * y + u2 * z;
+    }
+
+    ++m_Revision;
+}
+
+const QVector<QPointF> &TrailBuffer::project( const Projector *proj ) const {
+    if ( m_ScreenRevision == m_Revision && m_ProjectorRevision == proj->revision() )
+        return m_Screen;
+
+    m_Screen.resize( m_Count );
+    m_Visible.resize( m_Count );
+    for ( int i=0; i<m_Count; ++i ) {
+        SkyPoint p = at( i );
+        bool visible;
+        m_Screen[i] = proj->toScreen( &p, true, &visible );
+        m_Visible[i] = visible;
+    }
+
+    m_ScreenRevision = m_Revision;
+    m_ProjectorRevision = proj->revision();
+    return m_Screen;
+}
@@ -0,0 +1,99 @@
+/*  Trail Buffer
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef TRAILBUFFER_H
+#define TRAILBUFFER_H
+
+#include <QPointF>
+#include <QString>
+#include <QVector>
+
+#include "skypoint.h"
+
+class dms;
+class Projector;
+
+/**
+ *@class TrailBuffer
+ *@short The points of a trail, in a ring buffer of unit vectors.
+ *
+ * Each point is stored as its equatorial and horizontal unit vectors in two contiguous arrays, oldest first from
+ * the head of the ring, so that appending a point and removing the oldest one do not move the others. When the
+ * sidereal time changes, updateHorizontal() rotates all the equatorial vectors with one matrix instead of converting
+ * each point with SkyPoint::EquatorialToHorizontal().
+ *
+ * The screen positions of the points are kept until the trail or the view of the projector changes.
+ *@version 1.0
+ */
+class TrailBuffer
+{
+public:
+    TrailBuffer();
+
+    /** @return the number of points */
+    int size() const { return m_Count; }
+    int count() const { return m_Count; }
+    bool isEmpty() const { return m_Count == 0; }
+
+    /** @short Append @p p with its current equatorial and horizontal coordinates, and its @p label */
+    void append( const SkyPoint &p, const QString &label = QString() );
+
+    /** Remove the oldest point */
+    void removeFirst();
+
+    /** Remove the newest point */
+    void removeLast();
+
+    /** Remove all the points */
+    void clear();
+
+    /** @return point @p i, oldest first, with its equatorial and horizontal coordinates */
+    SkyPoint at( int i ) const;
+
+    /** @return the label of point @p i */
+    const QString &label( int i ) const { return m_Labels[ slot( i ) ]; }
+
+    /**
+     * @short Compute the horizontal coordinates of all the points.
+     * @param LST local sidereal time
+     * @param lat latitude of the observer
+     */
+    void updateHorizontal( const dms *LST, const dms *lat );
+
+    /**
+     * @return the screen positions of the points with @p proj, oldest first, as Projector::toScreen() returns them.
+     * They are computed again only if the points or the view of @p proj changed since the last call.
+     */
+    const QVector<QPointF> &project( const Projector *proj ) const;
+
+    /** @return true if point @p i is on the visible hemisphere, as found by the last call to project() */
+    bool isVisible( int i ) const { return m_Visible[i]; }
+
+private:
+    /** @return the index in the ring of point @p i */
+    int slot( int i ) const { int s = m_First + i; return s < m_Labels.size() ? s : s - m_Labels.size(); }
+
+    /** Double the capacity of the ring, moving the points to its start */
+    void grow();
+
+    QVector<double> m_Equatorial;   // x, y, z of each point
+    QVector<double> m_Horizontal;   // North, east and up components of each point
+    QVector<QString> m_Labels;      // One per slot, the capacity of the ring
+    int m_First;                    // Slot of the oldest point
+    int m_Count;
+    quint64 m_Revision;             // Changed whenever a point is added, removed or moved
+
+    // Screen positions computed by project()
+    mutable QVector<QPointF> m_Screen;
+    mutable QVector<bool> m_Visible;
+    mutable quint64 m_ScreenRevision;
+    mutable quint64 m_ProjectorRevision;
+};
+
+#endif // TRAILBUFFER_H
@@ -51,8 +51,7 @@ TrailObject* TrailObject::clone() const {
 }
 
 void TrailObject::updateTrail( dms *LST, const dms *lat ) {
-    for( int i=0; i < Trail.size(); ++i )
-        Trail[i].EquatorialToHorizontal( LST, lat );
+    Trail.updateHorizontal( LST, lat );
 }
 
 void TrailObject::initPopupMenu( KSPopupMenu *pmenu ) {
@@ -62,24 +61,19 @@ void TrailObject::initPopupMenu( KSPopupMenu *pmenu ) {
 }
 
 void TrailObject::addToTrail( const QString &label ) {
-    Trail.append( SkyPoint( *this ) );
-    m_TrailLabels.append( label );
+    Trail.append( *this, label );
     trailObjects.insert( this );
 }
 
 void TrailObject::clipTrail() {
-    if( Trail.size() ) {
+    if( Trail.size() )
         Trail.removeFirst();
-        Q_ASSERT( m_TrailLabels.size() );
-        m_TrailLabels.removeFirst();
-    }
     if( Trail.size() ) // Eh? Shouldn't this be if( !Trail.size() ) -- asimha
         trailObjects.remove( this );
 }
 
 void TrailObject::clearTrail() {
     Trail.clear();
-    m_TrailLabels.clear();
     trailObjects.remove( this );
 }
 
@@ -109,19 +103,39 @@ void TrailObject::drawTrail(SkyPainter* skyp) const {
     skyp->setPen( QPen(tcolor, 1) );
     SkyLabeler *labeler = SkyLabeler::Instance();
     labeler->setPen( tcolor );
+
+    // Screen positions are only computed again when the trail or the view changed
+    const QVector<QPointF> &points = Trail.project( SkyMap::Instance()->projector() );
+    const bool fade = Options::fadePlanetTrails();
     int n = Trail.size();
+    int first = 0; // First point of the polyline not drawn yet
     for(int i = 1; i < n; ++i) {
-        if ( Options::fadePlanetTrails() ) {
+        if ( fade ) {
             tcolor.setAlphaF(static_cast<qreal>(i)/static_cast<qreal>(n));
             skyp->setPen( QPen( tcolor, 1 ) );
         }
-        SkyPoint a = Trail[i-1];
-        SkyPoint b = Trail[i];
-        skyp->drawSkyLine(&a, &b);
+        bool aVisible = Trail.isVisible( i-1 ), bVisible = Trail.isVisible( i );
+        if ( aVisible && bVisible ) {
+            // Each faded segment has its own pen, otherwise the visible points are drawn as one polyline
+            if ( fade )
+                skyp->drawScreenPolyline( points.constData() + i-1, 2 );
+        } else {
+            if ( !fade && i - first >= 2 )
+                skyp->drawScreenPolyline( points.constData() + first, i - first );
+            first = i;
+            // Let the painter clip the segments crossing the edge of the visible hemisphere
+            if ( aVisible || bVisible ) {
+                SkyPoint a = Trail.at( i-1 );
+                SkyPoint b = Trail.at( i );
+                skyp->drawSkyLine(&a, &b);
+            }
+        }
         if( i % 5 == 1 ) { // TODO: Make drawing of labels configurable, incl. frequency etc.
-            QPointF pt = SkyMap::Instance()->projector()->toScreen( &a );
-            labeler->drawGuideLabel( pt, m_TrailLabels[i - 1], 0.0 );
+            QPointF pt = points[i - 1];
+            labeler->drawGuideLabel( pt, Trail.label( i - 1 ), 0.0 );
         }
     }
+    if ( !fade && n - first >= 2 )
+        skyp->drawScreenPolyline( points.constData() + first, n - first );
 #endif
 }
@@ -21,6 +21,7 @@
 #include <QSet>
 
 #include "skyobject.h"
+#include "trailbuffer.h"
 
 class SkyPainter;
 
@@ -46,7 +47,7 @@ public:
     inline bool hasTrail() const { return ( Trail.count() > 0 ); }
 
     /** @return a reference to the planet's trail */
-    inline const QList<SkyPoint>& trail() const { return Trail; }
+    inline const TrailBuffer& trail() const { return Trail; }
 
     /** @short adds a point to the planet's trail */
     void addToTrail( const QString &label = QString() );
@@ -72,8 +73,7 @@ public:
     virtual void initPopupMenu( KSPopupMenu *pmenu );
 
 protected:
-    QList<SkyPoint> Trail;
-    QList<QString> m_TrailLabels;
+    TrailBuffer Trail;
     /// Store list of objects with trails.
     static QSet<TrailObject*> trailObjects;
 private:
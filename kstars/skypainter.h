@@ -102,6 +102,13 @@ public:
     virtual void drawSkyPolyline(LineList* list, SkipList *skipList = 0,
                                  LineListLabel *label = 0) =0;
 
+    /** @short Draw a polyline of points already projected on the screen.
+        @param points the screen positions
+        @param count the number of points
+        @note no clipping is done, all the points should be on the visible hemisphere.
+        */
+    virtual void drawScreenPolyline(const QPointF *points, int count) =0;
+
     /** @short Draw a polygon in the sky.
         @param list a list of points in the sky
         @param forceClip If true (default), it enforces clipping of the polygon, otherwise, it draws the
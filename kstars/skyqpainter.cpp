@@ -255,6 +255,11 @@ void SkyQPainter::drawSkyLine(SkyPoint* a, SkyPoint* b)
     } //FIXME: what if both are offscreen but the line isn't?
 }
 
+void SkyQPainter::drawScreenPolyline(const QPointF *points, int count)
+{
+    drawPolyline(points, count);
+}
+
 void SkyQPainter::drawSkyPolyline(LineList* list, SkipList* skipList, LineListLabel* label)
 {
     SkyList *points = list->points();
@@ -73,6 +73,7 @@ public:
     // Sky drawing functions
     virtual void drawSkyBackground();
     virtual void drawSkyLine(SkyPoint* a, SkyPoint* b);
+    virtual void drawScreenPolyline(const QPointF *points, int count);
     virtual void drawSkyPolyline(LineList* list, SkipList *skipList = 0,
                                  LineListLabel *label = 0);
     virtual void drawSkyPolygon(LineList* list, bool forceClip=true);
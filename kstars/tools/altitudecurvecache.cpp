@@ -0,0 +1,105 @@
+/*  Altitude Curve Cache
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#include "altitudecurvecache.h"
+
+#include <cmath>
+
+#include "geolocation.h"
+#include "skyobjects/ksplanetbase.h"
+#include "skyobjects/skyobject.h"
+
+// Number of curves kept, enough for the plots of a large observing list
+#define MAX_CURVES  1000
+
+AltitudeCurveCache *AltitudeCurveCache::_AltitudeCurveCache = 0;
+
+AltitudeCurveCache *AltitudeCurveCache::Instance() {
+    if ( ! _AltitudeCurveCache )
+        _AltitudeCurveCache = new AltitudeCurveCache();
+    return _AltitudeCurveCache;
+}
+
+AltitudeCurveCache::AltitudeCurveCache() : m_Curves( MAX_CURVES ) {
+}
+
+bool AltitudeCurveCache::Key::operator==( const Key &other ) const {
+    return name == other.name && ra == other.ra && dec == other.dec &&
+           jd == other.jd && step == other.step && count == other.count &&
+           lng == other.lng && lat == other.lat && height == other.height;
+}
+
+uint qHash( const AltitudeCurveCache::Key &key, uint seed ) {
+    return qHash( key.name, seed ) ^ qHash( key.ra, seed ) ^ qHash( key.dec, seed ) ^ qHash( key.jd, seed ) ^
+           qHash( key.lng, seed ) ^ qHash( key.lat, seed );
+}
+
+QVector<double> AltitudeCurveCache::altitudes( const SkyObject *o, const GeoLocation *geo, const KStarsDateTime &start, double step, int count ) {
+    const KSPlanetBase *body = dynamic_cast<const KSPlanetBase *>( o );
+
+    Key key;
+    key.name = o->name();
+    key.ra = body ? 0.0 : o->ra().Degrees();
+    key.dec = body ? 0.0 : o->dec().Degrees();
+    key.jd = start.djd();
+    key.step = step;
+    key.count = count;
+    key.lng = geo->lng()->Degrees();
+    key.lat = geo->lat()->Degrees();
+    key.height = geo->height();
+
+    if ( const QVector<double> *curve = m_Curves.object( key ) )
+        return *curve;
+
+    QVector<double> *curve;
+    if ( body ) {
+        // Solar system bodies move noticeably during the day, the Moon most of all
+        QVector<double> jds( count );
+        for ( int i=0; i<count; ++i )
+            jds[i] = key.jd + i * step / 24.0;
+
+        QList<const KSPlanetBase *> bodies;
+        bodies.append( body );
+
+        curve = new QVector<double>();
+        curve->reserve( count );
+        foreach ( const EphemerisPoint &point, KSPlanetBase::ephemeris( bodies, jds, geo ).first() )
+            curve->append( point.alt.Degrees() );
+    } else {
+        curve = new QVector<double>( compute( *o, geo, start, step, count ) );
+    }
+
+    m_Curves.insert( key, curve );
+    return *curve;
+}
+
+QVector<double> AltitudeCurveCache::compute( const SkyPoint &p, const GeoLocation *geo, const KStarsDateTime &start, double step, int count ) {
+    QVector<double> altitudes( count );
+
+    double sinLat, cosLat, sinDec, cosDec;
+    geo->lat()->SinCos( sinLat, cosLat );
+    p.dec().SinCos( sinDec, cosDec );
+
+    // Hour angle of the first sample, and its rotation from one sample to the next
+    double sinH, cosH, sinStep, cosStep;
+    dms( geo->GSTtoLST( start.gst() ).Degrees() - p.ra().Degrees() ).SinCos( sinH, cosH );
+    dms( step * 15.0 * SIDEREALSECOND ).SinCos( sinStep, cosStep );
+
+    double *alt = altitudes.data();
+    for ( int i=0; i<count; ++i ) {
+        double sinAlt = sinDec * sinLat + cosDec * cosLat * cosH;
+        alt[i] = asin( qBound( -1.0, sinAlt, 1.0 ) ) / dms::DegToRad;
+
+        double sinNext = sinH * cosStep + cosH * sinStep;
+        cosH = cosH * cosStep - sinH * sinStep;
+        sinH = sinNext;
+    }
+
+    return altitudes;
+}
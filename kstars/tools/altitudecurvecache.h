@@ -0,0 +1,80 @@
+/*  Altitude Curve Cache
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef ALTITUDECURVECACHE_H
+#define ALTITUDECURVECACHE_H
+
+#include <QCache>
+#include <QString>
+#include <QVector>
+
+#include "kstarsdatetime.h"
+
+class GeoLocation;
+class SkyObject;
+class SkyPoint;
+
+/**
+ *@class AltitudeCurveCache
+ *@short Altitude curves of objects over a day, shared by the Altitude vs. Time tool and the Observing Planner.
+ *
+ *A curve is the altitude of an object sampled at a regular step from a start time, at a location.
+ *For objects outside the solar system, the whole curve is computed in one pass: the hour angle is rotated by a
+ *constant sidereal step from one sample to the next, so that no date, sidereal time or coordinate conversion is
+ *needed per sample. Solar system bodies move during the day and are computed with KSPlanetBase::ephemeris().
+ *
+ *Curves are kept by object, start time, step and location, so that selecting an object again or replotting the
+ *same day does not compute it again. The cache must only be used from the GUI thread.
+ *@version 1.0
+ */
+class AltitudeCurveCache {
+public:
+    static AltitudeCurveCache *Instance();
+
+    /**
+     *@return the altitudes of @p o in degrees, at @p count times from @p start every @p step hours.
+     *@param o the object. Its current coordinates are used, unless it is a solar system body
+     *@param geo the location of the observer
+     *@param start UT of the first sample
+     */
+    QVector<double> altitudes( const SkyObject *o, const GeoLocation *geo, const KStarsDateTime &start, double step, int count );
+
+    /**
+     *@short Compute the altitude curve of a fixed point, without caching it.
+     *@return the altitudes of @p p in degrees, at @p count times from @p start every @p step hours.
+     */
+    static QVector<double> compute( const SkyPoint &p, const GeoLocation *geo, const KStarsDateTime &start, double step, int count );
+
+    /** @return the number of cached curves */
+    int size() const { return m_Curves.count(); }
+
+    /** Remove all the cached curves */
+    void clear() { m_Curves.clear(); }
+
+private:
+    AltitudeCurveCache();
+
+    struct Key {
+        QString name;           // Name of the object
+        double ra, dec;         // Coordinates of the object (degrees), 0 for a solar system body
+        double jd;              // Start of the curve
+        double step;
+        int count;
+        double lng, lat, height;
+
+        bool operator==( const Key &other ) const;
+    };
+    friend uint qHash( const Key &key, uint seed );
+
+    static AltitudeCurveCache *_AltitudeCurveCache;
+
+    QCache<Key, QVector<double> > m_Curves;
+};
+
+#endif // ALTITUDECURVECACHE_H
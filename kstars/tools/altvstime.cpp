@@ -36,6 +36,7 @@
 #include "ksnumbers.h"
 #include "simclock.h"
 #include "kssun.h"
+#include "ksplanetbase.h"
 #include "dialogs/finddialog.h"
 #include "dialogs/locationdialog.h"
 #include "geolocation.h"
@@ -45,6 +46,7 @@
 
 #include <kplotwidget.h>
 #include "avtplotwidget.h"
+#include "altitudecurvecache.h"
 #include "ui_altvstime.h"
 
 
@@ -402,8 +404,9 @@ void AltVsTime::processObject( SkyObject *o, bool forceAdd ) {
         // time range: 24h
 
         int offset = 3;
+        QVector<double> altitudes = findAltitudes(o);
         for ( double h=-12.0, i=0; h<=12.0; h+=0.25, i++ ) {
-            y[i] = findAltitude(o, h);
+            y[i] = altitudes[i];
             if(y[i] > maxAlt)
                 maxAlt = y[i];
             if(y[i] < minAlt)
@@ -460,6 +463,12 @@ double AltVsTime::findAltitude( SkyPoint *p, double hour ) {
     return p->alt().Degrees();
 }
 
+QVector<double> AltVsTime::findAltitudes( SkyObject *o ) {
+    //getDate converts the user-entered local time to UT
+    KStarsDateTime start = getDate().addSecs( ( 24.0 * DayOffset - 12.0 ) * 3600.0 );
+    return AltitudeCurveCache::Instance()->altitudes( o, geo, start, 0.25, 97 );
+}
+
 void AltVsTime::slotHighlight( int row )
 {
     if (row < 0)
@@ -979,8 +988,9 @@ void AltVsTime::slotUpdateDateLoc() {
             // compute the new graph values:
             // time range: 24h
             int offset = 3;
+            QVector<double> altitudes = findAltitudes(o);
             for ( double h=-12.0, i=0; h<=12.0; h+=0.25, i++ ) {
-                point_altitudeValue = findAltitude(o, h);
+                point_altitudeValue = altitudes[i];
                 altitude_dataSet.push_back(point_altitudeValue);
                 if(point_altitudeValue > maxAlt)
                     maxAlt = point_altitudeValue;
@@ -1027,8 +1037,9 @@ void AltVsTime::slotUpdateDateLoc() {
             // compute the new graph values:
             // time range: 24h
             int offset = 3;
+            QVector<double> altitudes = findAltitudes(pList.at(i));
             for ( double h=-12.0, i=0; h<=12.0; h+=0.25, i++ ) {
-                point_altitudeValue = findAltitude(pList.at(i), h);
+                point_altitudeValue = altitudes[i];
                 altitude_dataSet.push_back(point_altitudeValue);
                 if(point_altitudeValue > maxAlt)
                     maxAlt = point_altitudeValue;
@@ -103,6 +103,15 @@ public:
      */
     double findAltitude( SkyPoint *p, double hour );
 
+    /** @short Determine the altitudes of an object every 15 minutes of the displayed day.
+     *
+     * Solar system bodies are computed at each time, other objects keep their coordinates.
+     * The curves are shared with the Observing Planner through AltitudeCurveCache.
+     * @param o the object whose altitudes are to be found
+     * @return the altitudes, in degrees, from 12 hours before to 12 hours after the displayed time
+     */
+    QVector<double> findAltitudes( SkyObject *o );
+
 
 
     /** @short get object name. If star has no name, generate a name based on catalog number.
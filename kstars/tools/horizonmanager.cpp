@@ -585,5 +585,6 @@ void HorizonManager::checkRegionState(QStandardItem *item)
 
     horizon->setRegion(item->data(Qt::DisplayRole).toString());
     horizon->setEnabled(item->checkState() == Qt::Checked);
+    horizonComponent->regionsChanged();
     SkyMap::Instance()->forceUpdateNow();
 }
@@ -35,6 +35,7 @@
 #include "dialogs/detaildialog.h"
 #include "dialogs/finddialog.h"
 #include "tools/altvstime.h"
+#include "tools/altitudecurvecache.h"
 #include "tools/wutdialog.h"
 #include "Options.h"
 #include "imageviewer.h"
@@ -235,7 +236,7 @@ ObservingList::ObservingList()
 
     m_NoImagePixmap = QPixmap(":/images/noimage.png").scaledToHeight(ui->ImagePreview->width());
 
-    m_altCostHelper = [ this ]( const SkyPoint &p ) -> QStandardItem * {
+    m_altCostHelper = [ this ]( const SkyPoint &p, QStandardItem *altItem ) {
         const double inf = std::numeric_limits<double>::infinity();
         double altCost = 0.;
         QString itemText;
@@ -260,10 +261,9 @@ ObservingList::ObservingList()
             }
         }
 
-        QStandardItem *altItem = new QStandardItem( itemText );
+        altItem->setData( itemText, Qt::DisplayRole );
         altItem->setData( altCost, Qt::UserRole );
 //        qDebug() << "Updating altitude for " << p.ra().toHMSString() << " " << p.dec().toDMSString() << " alt = " << p.alt().toDMSString() << " info to " << itemText;
-        return altItem;
     };
 
     slotLoadWishList(); //Load the wishlist from disk if present
@@ -386,7 +386,9 @@ void ObservingList::slotAddObject( const SkyObject *_obj, bool session, bool upd
         //     - Weight by declination - latitude (in the northern hemisphere, southern objects get higher precedence)
         //     - Demote objects in the hole
         SkyPoint p = obj->recomputeHorizontalCoords( KStarsDateTime::currentDateTimeUtc(), geo ); // Current => now
-        itemList << m_altCostHelper( p );
+        QStandardItem *altItem = new QStandardItem();
+        m_altCostHelper( p, altItem );
+        itemList << altItem;
         m_WishListModel->appendRow( itemList );
 
         //Note addition in statusbar
@@ -1027,8 +1029,10 @@ void ObservingList::plot( SkyObject *o ) {
     ui->avt->setMoonIllum( ksal->getMoonIllum() );
     ui->avt->update();
     KPlotObject *po = new KPlotObject( Qt::white, KPlotObject::Lines, 2.0 );
-    for ( double h = -12.0; h <= 12.0; h += 0.5 ) {
-        po->addPoint( h, findAltitude( o, ( h + DayOffset * 24.0 ) ) );
+    KStarsDateTime start = ut.addSecs( ( DayOffset * 24.0 - 12.0 ) * 3600.0 );
+    QVector<double> altitudes = AltitudeCurveCache::Instance()->altitudes( o, geo, start, 0.5, 49 );
+    for ( int i = 0; i < altitudes.size(); ++i ) {
+        po->addPoint( -12.0 + 0.5 * i, altitudes[i] );
     }
     ui->avt->removeAllPlotObjects();
     ui->avt->addPlotObject( po );
@@ -1540,17 +1544,17 @@ void ObservingList::slotUpdateAltitudes() {
     // FIXME: Update upon gaining visibility, do not update when not visible
     KStarsDateTime now = KStarsDateTime::currentDateTimeUtc();
 //    qDebug() << "Updating altitudes in observation planner @ JD - J2000 = " << double( now.djd() - J2000 );
+    // Update the items in place, and notify the views once for all the rows
+    m_WishListModel->blockSignals( true );
     for ( int irow = m_WishListModel->rowCount() - 1; irow >= 0; --irow ) {
         QModelIndex idx = m_WishListSortModel->mapToSource( m_WishListSortModel->index( irow, 0 ) );
         SkyObject *o = static_cast<SkyObject *>( idx.data( Qt::UserRole + 1 ).value<void *>() );
         Q_ASSERT( o );
         SkyPoint p = o->recomputeHorizontalCoords( now, geo );
         idx = m_WishListSortModel->mapToSource( m_WishListSortModel->index( irow, m_WishListSortModel->columnCount() - 1 ) );
-        QStandardItem *replacement = m_altCostHelper( p );
-        m_WishListModel->setData( idx, replacement->data( Qt::DisplayRole ), Qt::DisplayRole  );
-        m_WishListModel->setData( idx, replacement->data( Qt::UserRole ), Qt::UserRole );
-        delete replacement;
+        m_altCostHelper( p, m_WishListModel->itemFromIndex( idx ) );
     }
+    m_WishListModel->blockSignals( false );
     emit m_WishListModel->dataChanged( m_WishListModel->index( 0, m_WishListModel->columnCount() - 1 ),
                                        m_WishListModel->index( m_WishListModel->rowCount() - 1, m_WishListModel->columnCount() - 1 ) );
 }
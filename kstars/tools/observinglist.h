@@ -412,7 +412,7 @@ private:
     QHash<SkyObject *, QPixmap> ImagePreviewHash;
     QPixmap m_NoImagePixmap;
     QTimer *m_altitudeUpdater;
-    std::function<QStandardItem *(const SkyPoint &)> m_altCostHelper;
+    std::function<void (const SkyPoint &, QStandardItem *)> m_altCostHelper;
 };
 
 #endif // OBSERVINGLIST_H_
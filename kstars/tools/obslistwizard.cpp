@@ -22,6 +22,7 @@
 #include <QDoubleSpinBox>
 #include <QPushButton>
 #include <QDialogButtonBox>
+#include <QtConcurrent>
 
 #include "kstarsdata.h"
 #include "geolocation.h"
@@ -391,6 +392,7 @@ void ObsListWizard::applyFilters( bool doBuildList )
     KStarsData* data = KStarsData::Instance();
     if ( doBuildList )
         obsList().clear();
+    ObservableCandidates.clear();
 
     //We don't need to call applyRegionFilter() if no region filter is selected, *and*
     //we are just counting items (i.e., doBuildList is false)
@@ -438,6 +440,17 @@ void ObsListWizard::applyFilters( bool doBuildList )
             ObjectCount -= StarCount;
             ObjectCount += starIndex;
         }
+        //Look up the constellations of all the stars at once
+        QStringList starConstellations;
+        if ( needRegion && isItemSelected( i18n("by constellation"), olw->RegionList ) )
+        {
+            QVector<SkyPoint*> points;
+            points.reserve( starIndex );
+            for ( int i=0; i < starIndex; ++i )
+                points.append( starList[i] );
+            starConstellations = data->skyComposite()->constellationBoundary()->constellationNames( points );
+        }
+
         for ( int i=0; i < starIndex; ++i )
         {
             SkyObject *o = (SkyObject*)(starList[i]);
@@ -451,10 +464,11 @@ void ObsListWizard::applyFilters( bool doBuildList )
             }
 
             if ( needRegion )
-                filterPass = applyRegionFilter( o, doBuildList, !doBuildList);
+                filterPass = applyRegionFilter( o, doBuildList, !doBuildList,
+                                                starConstellations.isEmpty() ? QString() : starConstellations.at( i ) );
             //Filter objects visible from geo at Date if region filter passes
             if ( olw->SelectByDate->isChecked() && filterPass)
-                applyObservableFilter( o, doBuildList, !doBuildList);
+                addObservableCandidate( o, doBuildList );
         }
     }
 
@@ -473,7 +487,7 @@ void ObsListWizard::applyFilters( bool doBuildList )
             if ( needRegion && filterPass)
                 filterPass = applyRegionFilter( data->skyComposite()->findByName("Sun"), doBuildList );
             if ( olw->SelectByDate->isChecked()  && filterPass)
-                applyObservableFilter( data->skyComposite()->findByName("Sun"), doBuildList );
+                addObservableCandidate( data->skyComposite()->findByName("Sun"), doBuildList );
 
             if (maglimit < data->skyComposite()->findByName("Moon")->mag())
             {
@@ -486,7 +500,7 @@ void ObsListWizard::applyFilters( bool doBuildList )
             if ( needRegion && filterPass)
                 filterPass = applyRegionFilter( data->skyComposite()->findByName("Moon"), doBuildList );
             if ( olw->SelectByDate->isChecked()  && filterPass)
-                applyObservableFilter( data->skyComposite()->findByName("Moon"), doBuildList );
+                addObservableCandidate( data->skyComposite()->findByName("Moon"), doBuildList );
 
             if (maglimit < data->skyComposite()->findByName("Mercury")->mag())
             {
@@ -499,7 +513,7 @@ void ObsListWizard::applyFilters( bool doBuildList )
             if ( needRegion && filterPass)
                 filterPass = applyRegionFilter( data->skyComposite()->findByName(i18n( "Mercury" )), doBuildList );
             if ( olw->SelectByDate->isChecked()  && filterPass)
-                 applyObservableFilter( data->skyComposite()->findByName(i18n( "Mercury" )), doBuildList );
+                 addObservableCandidate( data->skyComposite()->findByName(i18n( "Mercury" )), doBuildList );
 
             if (maglimit < data->skyComposite()->findByName("Venus")->mag())
             {
@@ -513,7 +527,7 @@ void ObsListWizard::applyFilters( bool doBuildList )
             if ( needRegion && filterPass)
                 filterPass = applyRegionFilter( data->skyComposite()->findByName(i18n( "Venus" )), doBuildList );
             if ( olw->SelectByDate->isChecked()  && filterPass)
-                applyObservableFilter( data->skyComposite()->findByName(i18n( "Venus" )), doBuildList );
+                addObservableCandidate( data->skyComposite()->findByName(i18n( "Venus" )), doBuildList );
 
             if (maglimit < data->skyComposite()->findByName("Mars")->mag())
             {
@@ -526,7 +540,7 @@ void ObsListWizard::applyFilters( bool doBuildList )
             if ( needRegion && filterPass)
                 filterPass = applyRegionFilter( data->skyComposite()->findByName(i18n( "Mars" )), doBuildList );
             if ( olw->SelectByDate->isChecked()  && filterPass)
-                applyObservableFilter( data->skyComposite()->findByName(i18n( "Mars" )), doBuildList );
+                addObservableCandidate( data->skyComposite()->findByName(i18n( "Mars" )), doBuildList );
 
             if (maglimit < data->skyComposite()->findByName("Jupiter")->mag())
             {
@@ -539,7 +553,7 @@ void ObsListWizard::applyFilters( bool doBuildList )
             if ( needRegion && filterPass)
                 filterPass = applyRegionFilter( data->skyComposite()->findByName(i18n( "Jupiter" )), doBuildList );
             if ( olw->SelectByDate->isChecked()  && filterPass)
-                applyObservableFilter( data->skyComposite()->findByName(i18n( "Jupiter" )), doBuildList );
+                addObservableCandidate( data->skyComposite()->findByName(i18n( "Jupiter" )), doBuildList );
 
             if (maglimit < data->skyComposite()->findByName("Saturn")->mag())
             {
@@ -553,7 +567,7 @@ void ObsListWizard::applyFilters( bool doBuildList )
             if ( needRegion && filterPass)
                 filterPass = applyRegionFilter( data->skyComposite()->findByName(i18n( "Saturn" )), doBuildList );
             if ( olw->SelectByDate->isChecked()  && filterPass)
-                applyObservableFilter( data->skyComposite()->findByName(i18n( "Saturn" )), doBuildList );
+                addObservableCandidate( data->skyComposite()->findByName(i18n( "Saturn" )), doBuildList );
 
             if (maglimit < data->skyComposite()->findByName("Uranus")->mag())
             {
@@ -567,7 +581,7 @@ void ObsListWizard::applyFilters( bool doBuildList )
             if ( needRegion && filterPass)
                 filterPass = applyRegionFilter( data->skyComposite()->findByName(i18n( "Uranus" )), doBuildList );
             if ( olw->SelectByDate->isChecked()  && filterPass)
-                applyObservableFilter( data->skyComposite()->findByName(i18n( "Uranus" )), doBuildList );
+                addObservableCandidate( data->skyComposite()->findByName(i18n( "Uranus" )), doBuildList );
 
             if (maglimit < data->skyComposite()->findByName("Neptune")->mag())
             {
@@ -582,7 +596,7 @@ void ObsListWizard::applyFilters( bool doBuildList )
             if ( needRegion && filterPass)
                 filterPass = applyRegionFilter( data->skyComposite()->findByName(i18n( "Neptune" )), doBuildList );
             if ( olw->SelectByDate->isChecked()  && filterPass)
-                applyObservableFilter( data->skyComposite()->findByName(i18n( "Neptune" )), doBuildList );
+                addObservableCandidate( data->skyComposite()->findByName(i18n( "Neptune" )), doBuildList );
 
             if (maglimit < data->skyComposite()->findByName("Pluto")->mag())
             {
@@ -596,7 +610,7 @@ void ObsListWizard::applyFilters( bool doBuildList )
             if ( needRegion && filterPass)
                 filterPass = applyRegionFilter( data->skyComposite()->findByName(i18n( "Pluto" )), doBuildList );
             if ( olw->SelectByDate->isChecked()  && filterPass)
-                applyObservableFilter( data->skyComposite()->findByName(i18n( "Pluto" )), doBuildList );
+                addObservableCandidate( data->skyComposite()->findByName(i18n( "Pluto" )), doBuildList );
         }
 
     //Deep sky objects
@@ -659,7 +673,7 @@ void ObsListWizard::applyFilters( bool doBuildList )
                             if ( needRegion )
                                 filterPass = applyRegionFilter( o, doBuildList );
                             if ( olw->SelectByDate->isChecked() && filterPass)
-                                applyObservableFilter( o, doBuildList );
+                                addObservableCandidate( o, doBuildList );
                         }
                         else if ( ! doBuildList )
                             --ObjectCount;
@@ -671,7 +685,7 @@ void ObsListWizard::applyFilters( bool doBuildList )
                             if ( needRegion )
                                 filterPass = applyRegionFilter( o, doBuildList );
                             if ( olw->SelectByDate->isChecked() && filterPass)
-                                applyObservableFilter( o, doBuildList );
+                                addObservableCandidate( o, doBuildList );
                         } else if ( ! doBuildList )
                             --ObjectCount;
                     }
@@ -681,7 +695,7 @@ void ObsListWizard::applyFilters( bool doBuildList )
                     if ( needRegion )
                         filterPass = applyRegionFilter( o, doBuildList );
                     if ( olw->SelectByDate->isChecked() && filterPass)
-                        applyObservableFilter( o, doBuildList );
+                        addObservableCandidate( o, doBuildList );
                 }
             }
         }
@@ -701,7 +715,7 @@ void ObsListWizard::applyFilters( bool doBuildList )
                         if ( needRegion )
                             filterPass = applyRegionFilter( o, doBuildList );
                         if ( olw->SelectByDate->isChecked() && filterPass)
-                            applyObservableFilter( o, doBuildList );
+                            addObservableCandidate( o, doBuildList );
                     }
                     else if ( ! doBuildList )
                             --ObjectCount;
@@ -713,7 +727,7 @@ void ObsListWizard::applyFilters( bool doBuildList )
                         if ( needRegion )
                             filterPass = applyRegionFilter( o, doBuildList );
                         if ( olw->SelectByDate->isChecked() && filterPass)
-                            applyObservableFilter( o, doBuildList );
+                            addObservableCandidate( o, doBuildList );
                     }
                     else if ( ! doBuildList )
                             --ObjectCount;
@@ -724,7 +738,7 @@ void ObsListWizard::applyFilters( bool doBuildList )
                 if ( needRegion )
                     filterPass = applyRegionFilter( o, doBuildList );
                 if ( olw->SelectByDate->isChecked() && filterPass)
-                    applyObservableFilter( o, doBuildList );
+                    addObservableCandidate( o, doBuildList );
             }
         }
     }
@@ -743,7 +757,7 @@ void ObsListWizard::applyFilters( bool doBuildList )
                         if ( needRegion )
                             filterPass = applyRegionFilter( o, doBuildList );
                         if ( olw->SelectByDate->isChecked() && filterPass)
-                            applyObservableFilter( o, doBuildList );
+                            addObservableCandidate( o, doBuildList );
                     }
                     else if ( ! doBuildList )
                         --ObjectCount;
@@ -755,7 +769,7 @@ void ObsListWizard::applyFilters( bool doBuildList )
                         if ( needRegion )
                             filterPass = applyRegionFilter( o, doBuildList );
                         if ( olw->SelectByDate->isChecked() && filterPass)
-                            applyObservableFilter( o, doBuildList );
+                            addObservableCandidate( o, doBuildList );
                     }
                     else if ( ! doBuildList )
                         --ObjectCount;
@@ -766,11 +780,15 @@ void ObsListWizard::applyFilters( bool doBuildList )
                 if ( needRegion )
                     filterPass = applyRegionFilter( o, doBuildList );
                 if ( olw->SelectByDate->isChecked() && filterPass)
-                    applyObservableFilter( o, doBuildList );
+                    addObservableCandidate( o, doBuildList );
             }
         }
     }
 
+    //Filter objects visible from geo at Date, once all of them are known
+    if ( olw->SelectByDate->isChecked() )
+        applyObservableFilter( doBuildList );
+
     //Update the object count label
     if ( doBuildList )
         ObjectCount = obsList().size();
@@ -779,12 +797,13 @@ void ObsListWizard::applyFilters( bool doBuildList )
 }
 
 bool ObsListWizard::applyRegionFilter( SkyObject *o, bool doBuildList,
-                                       bool doAdjustCount )
+                                       bool doAdjustCount, const QString &constellation )
 {
     //select by constellation
     if ( isItemSelected( i18n("by constellation"), olw->RegionList ) )
     {
-        QString c = KStarsData::Instance()->skyComposite()->constellationBoundary()->constellationName( o );
+        QString c = constellation.isEmpty() ?
+                    KStarsData::Instance()->skyComposite()->constellationBoundary()->constellationName( o ) : constellation;
         if ( isItemSelected( c, olw->ConstellationList ) )
         {
             if ( doBuildList )
@@ -861,11 +880,16 @@ bool ObsListWizard::applyRegionFilter( SkyObject *o, bool doBuildList,
     return true;
 }
 
-bool ObsListWizard::applyObservableFilter( SkyObject *o, bool doBuildList, bool doAdjustCount)
+void ObsListWizard::addObservableCandidate( SkyObject *o, bool doBuildList )
 {
-    SkyPoint p = *o;
+    //The list being built already holds the objects which passed the other filters
+    if ( ! doBuildList )
+        ObservableCandidates.append( o );
+}
 
-    //Check altitude of object every hour from 18:00 to midnight
+void ObsListWizard::applyObservableFilter( bool doBuildList )
+{
+    //Check altitude of object from 18:00 to midnight
     //If it's ever above 15 degrees, flag it as visible
     KStarsDateTime Evening( olw->Date->date(), QTime( 18, 0, 0 ) );
     KStarsDateTime Midnight( olw->Date->date().addDays(1), QTime( 0, 0, 0 ) );
@@ -885,30 +909,27 @@ bool ObsListWizard::applyObservableFilter( SkyObject *o, bool doBuildList, bool
         maxAlt = olw->maxAlt->value();
     }
 
-    bool visible = false;
-    for ( KStarsDateTime t = Evening; t < Midnight; t = t.addSecs( 3600.0 ) )
-    {
-        dms LST = geo->GSTtoLST( t.gst() );
-        p.EquatorialToHorizontal( &LST, geo->lat() );
+    //The altitude range over the whole interval is found from the hour angles, see SkyPoint::altitudeRange()
+    const dms lat( *geo->lat() );
+    const dms startLST( geo->GSTtoLST( Evening.gst() ) );
+    const double siderealHours = Evening.secsTo( Midnight ) * SIDEREALSECOND / 3600.0;
 
-        if ( p.alt().Degrees() >= minAlt && p.alt().Degrees() <= maxAlt )
-        {
-            visible = true;
-            break;
-        }
-    }
+    auto isObservable = [lat, startLST, siderealHours, minAlt, maxAlt]( SkyObject *o ) {
+        double lowest, highest;
+        o->altitudeRange( lat, startLST, siderealHours, lowest, highest );
+        return highest >= minAlt && lowest <= maxAlt;
+    };
 
-
-    if (visible )
-        return true;
-
-    if ( doAdjustCount )
-            --ObjectCount;
     if ( doBuildList )
-            obsList().takeAt( obsList().indexOf(o) );
-
-    return false;
-
+    {
+        obsList() = QtConcurrent::blockingFiltered( obsList(), isObservable );
+    }
+    else
+    {
+        QVector<SkyObject*> observable = QtConcurrent::blockingFiltered( ObservableCandidates, isObservable );
+        ObjectCount -= ObservableCandidates.size() - observable.size();
+        ObservableCandidates.clear();
+    }
 }
 
 
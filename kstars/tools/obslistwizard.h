@@ -18,6 +18,7 @@
 #define OBSLISTWIZARD_H_
 
 #include <QDialog>
+#include <QVector>
 
 #include "ui_obslistwizard.h"
 #include "skyobjects/skypoint.h"
@@ -69,9 +70,15 @@ private slots:
 private:
     void initialize();
     void applyFilters( bool doBuildList );
-    /** @return true if the object passes the filter region constraints, false otherwise.*/
-    bool applyRegionFilter( SkyObject *o, bool doBuildList, bool doAdjustCount=true );
-    bool applyObservableFilter( SkyObject *o, bool doBuildList, bool doAdjustCount=true);
+    /** @return true if the object passes the filter region constraints, false otherwise.
+     * @param constellation the constellation of the object, if already known */
+    bool applyRegionFilter( SkyObject *o, bool doBuildList, bool doAdjustCount=true,
+                            const QString &constellation = QString() );
+    /** @short Queue the object for applyObservableFilter(), once it passed the other filters. */
+    void addObservableCandidate( SkyObject *o, bool doBuildList );
+    /** @short Remove the objects which are not in the altitude range during the selected time interval,
+     * from the list being built or from the object count. */
+    void applyObservableFilter( bool doBuildList );
 
     /**
     	*Convenience function for safely getting the selected state of a QListWidget item by name.
@@ -93,6 +100,7 @@ private:
     void setItemSelected( const QString &name, QListWidget *listWidget, bool value, bool *ok=0 );
 
     QList<SkyObject*> ObsList;
+    QVector<SkyObject*> ObservableCandidates;
     ObsListWizardUI *olw;
     uint ObjectCount, StarCount, PlanetCount, CometCount, AsteroidCount;
     uint GalaxyCount, OpenClusterCount, GlobClusterCount, GasNebCount, PlanNebCount;
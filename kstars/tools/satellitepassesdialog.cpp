@@ -0,0 +1,157 @@
+/*  Satellite Passes Dialog
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#include "satellitepassesdialog.h"
+
+#include <QApplication>
+#include <QCheckBox>
+#include <QDateTimeEdit>
+#include <QDialogButtonBox>
+#include <QDoubleSpinBox>
+#include <QFormLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+#include <KLocalizedString>
+
+#include "geolocation.h"
+#include "kstarsdata.h"
+#include "kstarsdatetime.h"
+#include "skycomponents/satellitescomponent.h"
+#include "skycomponents/skymapcomposite.h"
+
+namespace
+{
+
+enum Columns { SATELLITE, RISE, RISE_AZ, CULMINATION, MAX_ALT, SET, SET_AZ, ILLUMINATION, COLUMN_COUNT };
+
+QTableWidgetItem * timeItem( const KStarsDateTime &ut, const GeoLocation *geo )
+{
+    // Sortable as text
+    return new QTableWidgetItem( geo->UTtoLT( ut ).toString( "yyyy-MM-dd hh:mm:ss" ) );
+}
+
+QTableWidgetItem * angleItem( double degrees )
+{
+    QTableWidgetItem *item = new QTableWidgetItem;
+    item->setData( Qt::DisplayRole, qRound( degrees * 10.0 ) / 10.0 );
+    return item;
+}
+
+}
+
+SatellitePassesDialog::SatellitePassesDialog( QWidget *parent ) : QDialog( parent )
+{
+#ifdef Q_OS_OSX
+    setWindowFlags(Qt::Tool| Qt::WindowStaysOnTopHint);
+#endif
+
+    setWindowTitle( i18n( "Satellite Passes" ) );
+    setModal( false );
+
+    KStarsData *data = KStarsData::Instance();
+
+    QVBoxLayout *mainLayout = new QVBoxLayout;
+    QFormLayout *form = new QFormLayout;
+
+    m_location = new QLabel( data->geo()->fullName() );
+    form->addRow( i18n( "Location:" ), m_location );
+
+    m_start = new QDateTimeEdit( data->lt() );
+    m_start->setDisplayFormat( "yyyy-MM-dd hh:mm" );
+    m_start->setCalendarPopup( true );
+    form->addRow( i18n( "Start (local time):" ), m_start );
+
+    m_hours = new QDoubleSpinBox;
+    m_hours->setRange( 0.5, 72.0 );
+    m_hours->setSingleStep( 1.0 );
+    m_hours->setDecimals( 1 );
+    m_hours->setValue( 8.0 );
+    m_hours->setSuffix( i18nc( "hours", " h" ) );
+    form->addRow( i18n( "Duration:" ), m_hours );
+
+    m_selectedOnly = new QCheckBox( i18n( "Only satellites selected for display" ) );
+    m_selectedOnly->setChecked( true );
+    form->addRow( m_selectedOnly );
+
+    m_visibleOnly = new QCheckBox( i18n( "Only visible passes" ) );
+    form->addRow( m_visibleOnly );
+
+    mainLayout->addLayout( form );
+
+    m_table = new QTableWidget( 0, COLUMN_COUNT );
+    m_table->setHorizontalHeaderLabels( QStringList() << i18n( "Satellite" ) << i18n( "Rise" ) << i18n( "Rise Az." )
+                                        << i18n( "Culmination" ) << i18n( "Max. Alt." ) << i18n( "Set" ) << i18n( "Set Az." )
+                                        << i18n( "Illumination" ) );
+    m_table->setEditTriggers( QAbstractItemView::NoEditTriggers );
+    m_table->setSelectionBehavior( QAbstractItemView::SelectRows );
+    m_table->verticalHeader()->hide();
+    m_table->setMinimumSize( 800, 400 );
+    mainLayout->addWidget( m_table );
+
+    QDialogButtonBox *buttonBox = new QDialogButtonBox( QDialogButtonBox::Close );
+    QPushButton *predictB = new QPushButton( i18n( "&Predict" ) );
+    predictB->setToolTip( i18n( "Find the passes in the time window" ) );
+    buttonBox->addButton( predictB, QDialogButtonBox::ActionRole );
+    connect( predictB, SIGNAL( clicked() ), this, SLOT( slotPredict() ) );
+    connect( buttonBox, SIGNAL( rejected() ), this, SLOT( reject() ) );
+    mainLayout->addWidget( buttonBox );
+
+    setLayout( mainLayout );
+}
+
+void SatellitePassesDialog::slotPredict()
+{
+    KStarsData *data = KStarsData::Instance();
+    GeoLocation *geo = data->geo();
+
+    m_location->setText( geo->fullName() );
+
+    KStarsDateTime start = geo->LTtoUT( KStarsDateTime( m_start->dateTime() ) );
+    KStarsDateTime end = start.addSecs( m_hours->value() * 3600.0 );
+
+    QApplication::setOverrideCursor( Qt::WaitCursor );
+    QList<SatellitePass> passes = data->skyComposite()->satellites()->passes( start, end, geo, m_selectedOnly->isChecked() );
+    QApplication::restoreOverrideCursor();
+
+    m_table->setSortingEnabled( false );
+    m_table->setRowCount( 0 );
+
+    foreach ( const SatellitePass &pass, passes )
+    {
+        if ( m_visibleOnly->isChecked() && ! pass.visible )
+            continue;
+
+        int row = m_table->rowCount();
+        m_table->insertRow( row );
+
+        QString illumination;
+        if ( pass.visible )
+            illumination = i18n( "Visible" );
+        else if ( pass.sunlit )
+            illumination = i18n( "Sunlit" );
+        else
+            illumination = i18n( "Eclipsed" );
+
+        m_table->setItem( row, SATELLITE, new QTableWidgetItem( pass.satellite ) );
+        m_table->setItem( row, RISE, timeItem( pass.rise, geo ) );
+        m_table->setItem( row, RISE_AZ, angleItem( pass.riseAzimuth ) );
+        m_table->setItem( row, CULMINATION, timeItem( pass.culmination, geo ) );
+        m_table->setItem( row, MAX_ALT, angleItem( pass.maxAltitude ) );
+        m_table->setItem( row, SET, timeItem( pass.set, geo ) );
+        m_table->setItem( row, SET_AZ, angleItem( pass.setAzimuth ) );
+        m_table->setItem( row, ILLUMINATION, new QTableWidgetItem( illumination ) );
+    }
+
+    m_table->setSortingEnabled( true );
+    m_table->resizeColumnsToContents();
+}
@@ -0,0 +1,47 @@
+/*  Satellite Passes Dialog
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef SATELLITEPASSESDIALOG_H
+#define SATELLITEPASSESDIALOG_H
+
+#include <QDialog>
+
+class QCheckBox;
+class QDateTimeEdit;
+class QDoubleSpinBox;
+class QLabel;
+class QTableWidget;
+
+/**
+ *@class SatellitePassesDialog
+ *@short Table of the satellite passes above the current location in a time window.
+ *
+ * Times are shown in local time. Passes of the satellites already computed for the same window are reused.
+ */
+class SatellitePassesDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit SatellitePassesDialog( QWidget *parent=0 );
+
+public slots:
+    /** Predict the passes for the time window and fill the table */
+    void slotPredict();
+
+private:
+    QDateTimeEdit *m_start;
+    QDoubleSpinBox *m_hours;
+    QCheckBox *m_selectedOnly;
+    QCheckBox *m_visibleOnly;
+    QLabel *m_location;
+    QTableWidget *m_table;
+};
+
+#endif // SATELLITEPASSESDIALOG_H
@@ -34,6 +34,7 @@
 #include "kstarsdata.h"
 #include "skyobjects/ksplanet.h"
 #include "skycomponents/skymapcomposite.h"
+#include "yearlyephemeris.h"
 
 SkyCalendarUI::SkyCalendarUI( QWidget *parent )
     : QFrame( parent )
@@ -95,22 +96,32 @@ void SkyCalendar::slotFillCalendar() {
     scUI->CalendarView->resetPlot();
     scUI->CalendarView->setHorizon();
     
+    QList<int> planets;
     if ( scUI->checkBox_Mercury->isChecked() )
-        addPlanetEvents( KSPlanetBase::MERCURY );
+        planets.append( KSPlanetBase::MERCURY );
     if ( scUI->checkBox_Venus->isChecked() )
-        addPlanetEvents( KSPlanetBase::VENUS );
+        planets.append( KSPlanetBase::VENUS );
     if ( scUI->checkBox_Mars->isChecked() )
-        addPlanetEvents( KSPlanetBase::MARS );
+        planets.append( KSPlanetBase::MARS );
     if ( scUI->checkBox_Jupiter->isChecked() )
-        addPlanetEvents( KSPlanetBase::JUPITER );
+        planets.append( KSPlanetBase::JUPITER );
     if ( scUI->checkBox_Saturn->isChecked() )
-        addPlanetEvents( KSPlanetBase::SATURN );
+        planets.append( KSPlanetBase::SATURN );
     if ( scUI->checkBox_Uranus->isChecked() )
-        addPlanetEvents( KSPlanetBase::URANUS );
+        planets.append( KSPlanetBase::URANUS );
     if ( scUI->checkBox_Neptune->isChecked() )
-        addPlanetEvents( KSPlanetBase::NEPTUNE );
+        planets.append( KSPlanetBase::NEPTUNE );
     //if ( scUI->checkBox_Pluto->isChecked() )
-        //addPlanetEvents( KSPlanetBase::PLUTO );
+        //planets.append( KSPlanetBase::PLUTO );
+
+    // The events of all the planets over the year are computed at once
+    QList<const KSPlanetBase *> bodies;
+    foreach ( int nPlanet, planets )
+        bodies.append( KStarsData::Instance()->skyComposite()->planet( nPlanet ) );
+    QVector< QVector<RiseSetTransit> > events = YearlyEphemeris::compute( bodies, year(), scUI->spinBox_Interval->value(), geo );
+
+    for ( int i=0; i<planets.size(); ++i )
+        addPlanetEvents( planets[i], events[i] );
     
     scUI->CalendarView->update();
 }
@@ -139,22 +150,20 @@ void SkyCalendar::drawEventLabel( float x1, float y1, float x2, float y2, QStrin
 }
 */
 
-void SkyCalendar::addPlanetEvents( int nPlanet ) {
+void SkyCalendar::addPlanetEvents( int nPlanet, const QVector<RiseSetTransit> &events ) {
     KSPlanetBase *ksp = KStarsData::Instance()->skyComposite()->planet( nPlanet );
     QColor pColor = ksp->color();
     QVector<QPointF> vRise, vSet, vTransit;
 
-    for( KStarsDateTime kdt( QDate( year(), 1, 1 ), QTime( 12, 0, 0 ) );
-         kdt.date().year() == year();
-         kdt = kdt.addDays( scUI->spinBox_Interval->value() ) )
+    foreach ( const RiseSetTransit &event, events )
     {
+        const KStarsDateTime &kdt = event.dt;
         float rTime, sTime, tTime;
         
-        //Compute rise/set/transit times.  If they occur before noon, 
-        //recompute for the following day
-        QTime tmp_rTime = ksp->riseSetTime( kdt, geo, true, true );     //rise time, exact
-        QTime tmp_sTime = ksp->riseSetTime( kdt, geo, false, true );    //set time, exact
-        QTime tmp_tTime = ksp->transitTime( kdt, geo );
+        //Rise/set/transit times, from the ephemeris of the whole year
+        QTime tmp_rTime = event.rise;
+        QTime tmp_sTime = event.set;
+        QTime tmp_tTime = event.transit;
         QTime midday( 12, 0, 0 );
         
         // NOTE: riseSetTime should be fix now, this test is no longer necessary
@@ -177,7 +186,7 @@ void SkyCalendar::addPlanetEvents( int nPlanet ) {
             else
                 sTime = -12.0 - sTime;
         } else {
-            if ( ksp->transitAltitude( kdt, geo ).degree() > 0 ) {
+            if ( event.transitAltitude.degree() > 0 ) {
                 rTime = -24.0;
                 sTime =  24.0;
             } else {
@@ -23,6 +23,7 @@
 #include "ui_skycalendar.h"
 
 class GeoLocation;
+class RiseSetTransit;
 
 class SkyCalendarUI : public QFrame, public Ui::SkyCalendar {
     Q_OBJECT
@@ -54,7 +55,7 @@ class SkyCalendar : public QDialog
         void slotLocation();
         
     private:
-        void addPlanetEvents( int nPlanet );
+        void addPlanetEvents( int nPlanet, const QVector<RiseSetTransit> &events );
         void drawEventLabel( float x1, float y1, float x2, float y2, QString LabelText );
         
         SkyCalendarUI *scUI;
@@ -0,0 +1,254 @@
+/*  Yearly Ephemeris
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#include "yearlyephemeris.h"
+
+#include <cmath>
+
+#include <QtConcurrent>
+
+#include "geolocation.h"
+
+// Length of a segment fitted by one Chebyshev series
+#define SEGMENT_DAYS        16.0
+// Positions sampled in each segment, the degree of the series plus one
+#define CHEBYSHEV_NODES     10
+// Events are searched up to this many days before and after the date
+#define SEARCH_DAYS         0.75
+// Step of the search for sign changes, 20 minutes
+#define SEARCH_STEP         ( 1.0 / 72.0 )
+// Bisections refining an event, down to 0.02 second
+#define BISECTIONS          16
+
+struct YearlyEphemeris::Site {
+    double jd;          // Reference time
+    double lst;         // Local sidereal time at jd (radians)
+    double sinLat, cosLat;
+    double sinH0;
+};
+
+YearlyEphemeris::YearlyEphemeris( double jd0, double jd1, const QVector<EphemerisPoint> &points )
+    : m_JD0( jd0 ), m_Segments( qMax( 1, int( ceil( ( jd1 - jd0 ) / SEGMENT_DAYS ) ) ) )
+{
+    Q_ASSERT( points.size() == m_Segments * CHEBYSHEV_NODES );
+
+    m_Coefficients.resize( m_Segments * 3 * CHEBYSHEV_NODES );
+
+    for ( int s=0; s<m_Segments; ++s ) {
+        // Directions at the nodes
+        double values[3][CHEBYSHEV_NODES];
+        for ( int k=0; k<CHEBYSHEV_NODES; ++k ) {
+            const EphemerisPoint &point = points[ s * CHEBYSHEV_NODES + k ];
+            double sinRA, cosRA, sinDec, cosDec;
+            point.ra.SinCos( sinRA, cosRA );
+            point.dec.SinCos( sinDec, cosDec );
+            values[0][k] = cosDec * cosRA;
+            values[1][k] = cosDec * sinRA;
+            values[2][k] = sinDec;
+        }
+
+        for ( int c=0; c<3; ++c ) {
+            double *coefficients = m_Coefficients.data() + ( s * 3 + c ) * CHEBYSHEV_NODES;
+            for ( int j=0; j<CHEBYSHEV_NODES; ++j ) {
+                double sum = 0.0;
+                for ( int k=0; k<CHEBYSHEV_NODES; ++k )
+                    sum += values[c][k] * cos( dms::PI * j * ( k + 0.5 ) / CHEBYSHEV_NODES );
+                coefficients[j] = 2.0 * sum / CHEBYSHEV_NODES;
+            }
+        }
+    }
+}
+
+QVector<double> YearlyEphemeris::sampleTimes( double jd0, double jd1 ) {
+    int segments = qMax( 1, int( ceil( ( jd1 - jd0 ) / SEGMENT_DAYS ) ) );
+
+    QVector<double> jds;
+    jds.reserve( segments * CHEBYSHEV_NODES );
+    for ( int s=0; s<segments; ++s ) {
+        double middle = jd0 + ( s + 0.5 ) * SEGMENT_DAYS;
+        for ( int k=0; k<CHEBYSHEV_NODES; ++k )
+            jds.append( middle + 0.5 * SEGMENT_DAYS * cos( dms::PI * ( k + 0.5 ) / CHEBYSHEV_NODES ) );
+    }
+    return jds;
+}
+
+void YearlyEphemeris::direction( double jd, double &x, double &y, double &z ) const {
+    int s = qBound( 0, int( floor( ( jd - m_JD0 ) / SEGMENT_DAYS ) ), m_Segments - 1 );
+    double t = 2.0 * ( jd - m_JD0 - s * SEGMENT_DAYS ) / SEGMENT_DAYS - 1.0;
+
+    double result[3];
+    for ( int c=0; c<3; ++c ) {
+        // Clenshaw recurrence
+        const double *coefficients = m_Coefficients.constData() + ( s * 3 + c ) * CHEBYSHEV_NODES;
+        double b1 = 0.0, b2 = 0.0;
+        for ( int j=CHEBYSHEV_NODES-1; j>0; --j ) {
+            double b0 = 2.0 * t * b1 - b2 + coefficients[j];
+            b2 = b1;
+            b1 = b0;
+        }
+        result[c] = t * b1 - b2 + 0.5 * coefficients[0];
+    }
+
+    x = result[0];
+    y = result[1];
+    z = result[2];
+}
+
+void YearlyEphemeris::position( double jd, dms &ra, dms &dec ) const {
+    double x, y, z;
+    direction( jd, x, y, z );
+    ra.setRadians( atan2( y, x ) );
+    ra = ra.reduce();
+    dec.setRadians( atan2( z, sqrt( x*x + y*y ) ) );
+}
+
+double YearlyEphemeris::altitude( const Site &site, double jd, double *H ) const {
+    double x, y, z;
+    direction( jd, x, y, z );
+
+    double r = sqrt( x*x + y*y + z*z );
+    double sinDec = z / r;
+    double cosDec = sqrt( x*x + y*y ) / r;
+
+    // Hour angle: local sidereal time minus right ascension
+    double lst = site.lst + ( jd - site.jd ) * 2.0 * dms::PI * SIDEREALSECOND;
+    double hourAngle = lst - atan2( y, x );
+    if ( H )
+        *H = hourAngle;
+
+    return site.sinLat * sinDec + site.cosLat * cosDec * cos( hourAngle ) - site.sinH0;
+}
+
+namespace {
+
+/** Bisect the sign change of @p f between @p a and @p b, where @p f has the sign of @p fa at @p a */
+template <typename F>
+double bisect( F f, double a, double fa, double b ) {
+    for ( int n=0; n<BISECTIONS; ++n ) {
+        double m = 0.5 * ( a + b );
+        double fm = f( m );
+        if ( ( fm < 0.0 ) == ( fa < 0.0 ) ) {
+            a = m;
+            fa = fm;
+        } else {
+            b = m;
+        }
+    }
+    return 0.5 * ( a + b );
+}
+
+}
+
+RiseSetTransit YearlyEphemeris::events( const KStarsDateTime &dt, const GeoLocation *geo, const dms &h0 ) const {
+    RiseSetTransit result;
+    result.dt = dt;
+
+    const double jd = dt.djd();
+
+    Site site;
+    site.jd = jd;
+    site.lst = geo->GSTtoLST( dt.gst() ).radians();
+    geo->lat()->SinCos( site.sinLat, site.cosLat );
+    site.sinH0 = sin( h0.radians() );
+
+    auto altitudeAt = [this, &site]( double t ) { return altitude( site, t, 0 ); };
+    auto hourAngleAt = [this, &site]( double t ) { double H; altitude( site, t, &H ); return sin( H ); };
+
+    // Refine each sign change around dt, and keep the ones closest to dt
+    double riseJD = 0.0, setJD = 0.0, transitJD = 0.0;
+
+    const int steps = int( 2.0 * SEARCH_DAYS / SEARCH_STEP );
+    double t0 = jd - SEARCH_DAYS;
+    double H;
+    double alt0 = altitude( site, t0, &H );
+    double sinHA0 = sin( H );
+
+    for ( int k=1; k<=steps; ++k ) {
+        double t1 = jd - SEARCH_DAYS + k * SEARCH_STEP;
+        double alt1 = altitude( site, t1, &H );
+        double sinHA1 = sin( H );
+
+        if ( alt0 < 0.0 && alt1 >= 0.0 ) {
+            double t = bisect( altitudeAt, t0, alt0, t1 );
+            if ( riseJD == 0.0 || fabs( t - jd ) < fabs( riseJD - jd ) )
+                riseJD = t;
+        } else if ( alt0 >= 0.0 && alt1 < 0.0 ) {
+            double t = bisect( altitudeAt, t0, alt0, t1 );
+            if ( setJD == 0.0 || fabs( t - jd ) < fabs( setJD - jd ) )
+                setJD = t;
+        }
+
+        // The sine of the hour angle only increases through zero at the upper transit
+        if ( sinHA0 < 0.0 && sinHA1 >= 0.0 ) {
+            double t = bisect( hourAngleAt, t0, sinHA0, t1 );
+            if ( transitJD == 0.0 || fabs( t - jd ) < fabs( transitJD - jd ) )
+                transitJD = t;
+        }
+
+        t0 = t1;
+        alt0 = alt1;
+        sinHA0 = sinHA1;
+    }
+
+    // A body which does not cross the horizon is circumpolar or never rises
+    if ( riseJD != 0.0 && setJD != 0.0 ) {
+        result.riseJD = riseJD;
+        result.setJD = setJD;
+        result.rise = geo->UTtoLT( KStarsDateTime( riseJD ) ).time();
+        result.set = geo->UTtoLT( KStarsDateTime( setJD ) ).time();
+    }
+
+    if ( transitJD == 0.0 )
+        transitJD = jd;
+    result.transitJD = transitJD;
+    result.transit = geo->UTtoLT( KStarsDateTime( transitJD ) ).time();
+
+    dms ra, dec;
+    position( transitJD, ra, dec );
+    double delta = 90.0 - geo->lat()->Degrees() + dec.Degrees();
+    if ( delta > 90.0 )
+        delta = 180.0 - delta;
+    result.transitAltitude = dms( delta );
+
+    return result;
+}
+
+QVector< QVector<RiseSetTransit> > YearlyEphemeris::compute( const QList<const KSPlanetBase *> &bodies, int year, int interval,
+                                                             const GeoLocation *geo, const KSPlanetBase *Earth ) {
+    QVector< QVector<RiseSetTransit> > result( bodies.size() );
+    if ( bodies.isEmpty() )
+        return result;
+
+    QVector<KStarsDateTime> dates;
+    for ( KStarsDateTime kdt( QDate( year, 1, 1 ), QTime( 12, 0, 0 ) );
+          kdt.date().year() == year;
+          kdt = kdt.addDays( interval ) )
+        dates.append( kdt );
+
+    // Cover the search around the first and last dates
+    const double jd0 = dates.first().djd() - SEARCH_DAYS - 1.0;
+    const double jd1 = dates.last().djd() + SEARCH_DAYS + 1.0;
+    QVector< QVector<EphemerisPoint> > points = KSPlanetBase::ephemeris( bodies, sampleTimes( jd0, jd1 ), 0, Earth );
+
+    QVector<RiseSetTransit> *events = result.data();
+    QVector<int> indices;
+    for ( int i=0; i<bodies.size(); ++i )
+        indices.append( i );
+
+    QtConcurrent::blockingMap( indices, [&]( int i ) {
+        YearlyEphemeris ephemeris( jd0, jd1, points.at( i ) );
+        dms h0 = bodies.at( i )->elevationCorrection();
+
+        events[i].reserve( dates.size() );
+        foreach ( const KStarsDateTime &dt, dates )
+            events[i].append( ephemeris.events( dt, geo, h0 ) );
+    } );
+
+    return result;
+}
@@ -0,0 +1,108 @@
+/*  Yearly Ephemeris
+    Copyright (C) 2017 KStars Developers
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#ifndef YEARLYEPHEMERIS_H
+#define YEARLYEPHEMERIS_H
+
+#include <QList>
+#include <QTime>
+#include <QVector>
+
+#include "dms.h"
+#include "kstarsdatetime.h"
+#include "skyobjects/ksplanetbase.h"
+
+class GeoLocation;
+
+/**
+ *@class RiseSetTransit
+ *@short The rise, set and transit of a body around one date, as computed by YearlyEphemeris.
+ *
+ *The times are those SkyObject::riseSetTime() and SkyObject::transitTime() would return for the same date.
+ */
+class RiseSetTransit {
+public:
+    KStarsDateTime dt;      // Date the events are computed for
+    QTime rise;             // Local time of the rise, invalid if the body does not rise or set
+    QTime set;              // Local time of the set, invalid if the body does not rise or set
+    QTime transit;          // Local time of the transit
+    dms transitAltitude;    // Altitude at the transit
+    double riseJD;          // Julian day of the rise, 0 if the body does not rise or set
+    double setJD;           // Julian day of the set, 0 if the body does not rise or set
+    double transitJD;       // Julian day of the transit
+
+    RiseSetTransit() : riseJD(0.0), setJD(0.0), transitJD(0.0) {}
+};
+
+/**
+ *@class YearlyEphemeris
+ *@short The apparent positions of a solar system body over a year, to find its rises, sets and transits.
+ *
+ *The time range is split in segments of 16 days. In each segment, the geocentric direction of the body is sampled at
+ *the Chebyshev nodes and fitted by a Chebyshev series, accurate to a small fraction of an arcsecond for all the
+ *planets. Rises, sets and transits are then found by root-finding on the altitude and hour angle computed from the
+ *fitted positions, without computing the position of the body again.
+ *
+ *The diurnal parallax is ignored, it shifts rise and set times of the planets by a few seconds at most.
+ *@version 1.0
+ */
+class YearlyEphemeris {
+public:
+    /**
+     *@short Fit the positions of a body from @p jd0 to @p jd1.
+     *@param points the positions at the times returned by sampleTimes( jd0, jd1 )
+     */
+    YearlyEphemeris( double jd0, double jd1, const QVector<EphemerisPoint> &points );
+
+    /** @return the times at which the positions must be sampled to fit them from @p jd0 to @p jd1 */
+    static QVector<double> sampleTimes( double jd0, double jd1 );
+
+    /**
+     *@return the fitted apparent right ascension and declination at @p jd
+     *@note @p jd must be between the first and last Julian days given to the constructor
+     */
+    void position( double jd, dms &ra, dms &dec ) const;
+
+    /**
+     *@short Find the rise, set and transit closest to @p dt.
+     *@param dt UT date/time
+     *@param geo geographic location
+     *@param h0 altitude of the center of the body when it rises or sets
+     */
+    RiseSetTransit events( const KStarsDateTime &dt, const GeoLocation *geo, const dms &h0 ) const;
+
+    /**
+     *@short Compute the rises, sets and transits of solar system bodies over a year, as the Sky Calendar draws them.
+     *The positions of all the bodies are computed in one batch with KSPlanetBase::ephemeris(), then the events of
+     *each body are found in parallel.
+     *@param bodies bodies to compute
+     *@param year calendar year
+     *@param interval days between two dates, starting on January 1st at 12h UT
+     *@param geo geographic location
+     *@param Earth the Earth whose positions are computed, the Earth of the sky map if NULL
+     *@return for each body, the events of each date
+     */
+    static QVector< QVector<RiseSetTransit> > compute( const QList<const KSPlanetBase *> &bodies, int year, int interval,
+                                                       const GeoLocation *geo, const KSPlanetBase *Earth=0 );
+
+private:
+    struct Site;
+
+    /** Compute the fitted geocentric direction at @p jd, a unit vector in equatorial coordinates */
+    void direction( double jd, double &x, double &y, double &z ) const;
+
+    /** @return the sine of the altitude minus the sine of h0 at @p jd, and the hour angle in @p H (radians) */
+    double altitude( const Site &site, double jd, double *H ) const;
+
+    double m_JD0;                   // Start of the first segment
+    int m_Segments;                 // Number of segments
+    QVector<double> m_Coefficients; // Chebyshev coefficients of x, y and z for each segment
+};
+
+#endif // YEARLYEPHEMERIS_H
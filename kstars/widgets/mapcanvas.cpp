@@ -78,9 +78,10 @@ void MapCanvas::paintEvent( QPaintEvent * ) {
 
     //Draw cities
     QPoint o;
-    foreach ( GeoLocation *g, KStarsData::Instance()->getGeoList() ) {
-        o.setX( int( g->lng()->Degrees() + origin.x() ) );
-        o.setY( height() - int( g->lat()->Degrees() + origin.y() ) );
+    // Only the positions are needed, the cities themselves are not loaded
+    foreach ( const QPointF &position, KStarsData::Instance()->cityDB()->positions() ) {
+        o.setX( int( position.x() + origin.x() ) );
+        o.setY( height() - int( position.y() + origin.y() ) );
 
         if ( o.x() >= 0 && o.x() <= width() && o.y() >=0 && o.y() <=height() ) {
             p.drawPoint( o.x(), o.y() );